@@ -46,6 +46,7 @@ So in summary, it initializes the core display and hardware functionality, retri
 #include <Update.h>
 #include <math.h>
 #include <esp_heap_caps.h>
+#include <esp_sleep.h>
 #include <mbedtls/x509.h>
 #include "config.h"
 #include "BoardInterface.h"
@@ -85,12 +86,9 @@ namespace
   constexpr uint32_t kGpsFixFreshnessSec = 15;
   constexpr float kGpsHeadingMinDistanceMeters = 3.0f;
   constexpr float kContributeGpsCoordPrecision = 1000000.0f;
-  constexpr uint32_t kMotionWakeResetSec = 900;
-  constexpr uint32_t kChargingQueueHoldSec = 180;
   constexpr time_t kLongParkingClearSec = 2 * 60 * 60;
   constexpr uint16_t kSentryIdleSliceMs = 50;
-  constexpr uint8_t kGpsWakeConfirmSamples = 2;
-  constexpr uint8_t kGyroWakeConfirmSamples = 3;
+  constexpr uint16_t kSentryLightSleepSliceMs = 250; // touch interrupt wakes earlier
   constexpr size_t kContributeJsonDocCapacity = 12288;
   constexpr uint8_t kContributeRawFrameUploadMax = 32;
   constexpr bool kContributeIncludeRawLatency = false;
@@ -143,25 +141,25 @@ namespace
   {
     void *allocate(size_t size)
     {
-      void *ptr = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+      void *ptr = memTaggedMalloc(MEM_TAG_JSON, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
       if (ptr == nullptr)
       {
-        ptr = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        ptr = memTaggedMalloc(MEM_TAG_JSON, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
       }
       return ptr;
     }
 
     void deallocate(void *ptr)
     {
-      free(ptr);
+      memTaggedFree(MEM_TAG_JSON, ptr);
     }
 
     void *reallocate(void *ptr, size_t newSize)
     {
-      void *newPtr = heap_caps_realloc(ptr, newSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+      void *newPtr = memTaggedRealloc(MEM_TAG_JSON, ptr, newSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
       if (newPtr == nullptr)
       {
-        newPtr = heap_caps_realloc(ptr, newSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        newPtr = memTaggedRealloc(MEM_TAG_JSON, ptr, newSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
       }
       return newPtr;
     }
@@ -181,13 +179,13 @@ namespace
   char *allocContributePayloadBuffer(size_t payloadLen, bool &psramBuffer)
   {
     psramBuffer = false;
-    char *buffer = (char *)heap_caps_malloc(payloadLen + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    char *buffer = (char *)memTaggedMalloc(MEM_TAG_UPLOAD, payloadLen + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
     if (buffer != nullptr)
     {
       psramBuffer = true;
       return buffer;
     }
-    return (char *)heap_caps_malloc(payloadLen + 1, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    return (char *)memTaggedMalloc(MEM_TAG_UPLOAD, payloadLen + 1, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
   }
 
   bool isMobileRelayClientConnected()
@@ -614,15 +612,7 @@ namespace
     {
       return false;
     }
-    for (uint8_t i = 0; i < liveData->contributeRawFrameCount; i++)
-    {
-      const LiveData::ContributeRawFrame &raw = liveData->contributeRawFrames[i];
-      if (raw.key[0] != '\0' && raw.value[0] != '\0')
-      {
-        return true;
-      }
-    }
-    return false;
+    return liveData->contributeRawFrames.count() > 0;
   }
 
   bool isContributeV2SnapshotEffectivelyEmpty(const LiveData *liveData)
@@ -767,6 +757,7 @@ void Board320_240::afterSetup()
   }
 
   // Init display
+  bootProfiler.mark("display");
   syslog->println("Init TFT display");
   tft.begin();
   tft.setRotation(liveData->settings.displayRotation);
@@ -784,8 +775,11 @@ void Board320_240::afterSetup()
   spriteColorDepth = (psramUsed) ? 16 : 8;
   spr.setColorDepth(spriteColorDepth);
   spr.createSprite(320, 240);
+  trackFramebufferMemory();
   menuBackbufferActive = false;
   liveData->params.spriteInit = true;
+  initDisplayDma();
+  initGlyphAtlas();
   printHeapMemory();
   showBootProgress("Display initialization...", "Framebuffer ready", TFT_PURPLE);
 
@@ -800,8 +794,15 @@ void Board320_240::afterSetup()
     showBootProgress("Demo mode enabled", "Using static test data", TFT_YELLOW);
   }
 
+  // Init comm device first, the car answers while the rest of the boot runs
+  bootProfiler.mark("comm");
+  showBootProgress("Adapter initialization...", "Starting OBD2/CAN comm", TFT_SILVER);
+  BoardInterface::afterSetup();
+  printHeapMemory();
+
   // Wifi
-  // Starting Wifi after BLE prevents reboot loop
+  // Starting Wifi after BLE prevents reboot loop. Association runs in background (WiFi.begin).
+  bootProfiler.mark("wifi");
   if (!liveData->params.wifiApMode &&
       liveData->settings.wifiEnabled == 1)
   {
@@ -814,19 +815,20 @@ void Board320_240::afterSetup()
     showBootProgress("WiFi initialization...", "Skipped (disabled)", TFT_BLUE);
   }
 
-  // Init GPS
+  // Init GPS; baud probe and module config run on a background task
+  bootProfiler.mark("gps");
   if (liveData->settings.gpsHwSerialPort <= 2)
   {
     showBootProgress("GPS initialization...", "Starting GPS serial", TFT_SKYBLUE);
-    initGPS();
-    printHeapMemory();
+    startGpsInitTask();
   }
   else
   {
     showBootProgress("GPS initialization...", "Skipped (not configured)", TFT_SKYBLUE);
   }
 
-  // SD card
+  // SD card (SPI bus shared with the display, stays on this task)
+  bootProfiler.mark("sdcard");
   if (liveData->settings.sdcardEnabled == 1)
   {
     showBootProgress("SD card initialization...", "Mounting storage", TFT_ORANGE);
@@ -843,14 +845,10 @@ void Board320_240::afterSetup()
     showBootProgress("SD card initialization...", "Skipped (disabled)", TFT_ORANGE);
   }
 
-  // Init comm device
-  showBootProgress("Adapter initialization...", "Starting OBD2/CAN comm", TFT_SILVER);
-  BoardInterface::afterSetup();
-  printHeapMemory();
-
   syslog->println("COMM in main loop (threading removed)");
   syslog->println("NET send in main loop (queue/task removed)");
 
+  bootProfiler.mark("clock");
   showBootProgress("Finalizing startup...", "Syncing clocks", TFT_GREEN);
   showTime();
   showBootProgress("Startup completed", "Loading main screen", TFT_GREEN);
@@ -1257,9 +1255,18 @@ void Board320_240::redrawScreen()
   redrawScreenIsRunning = true;
   messageDialogVisible = false;
 
-  if (drawActiveScreenToSprite())
+  // Compose runs while the previous frame may still be transferring
+  const int64_t composeStartUs = esp_timer_get_time();
+  const bool pushFrame = drawActiveScreenToSprite();
+  displayComposeUs = uint32_t(esp_timer_get_time() - composeStartUs);
+  const uint8_t scene = (liveData->params.displayScreen == SCREEN_AUTO) ? liveData->params.displayScreenAutoMode : liveData->params.displayScreen;
+  if (scene <= SCREEN_HUD)
+  {
+    displaySceneUs[scene] = displayComposeUs;
+  }
+  if (pushFrame)
   {
-    spr.pushSprite(0, 0);
+    pushSpriteFrame(0, 0);
   }
 
   redrawScreenIsRunning = false;
@@ -1321,13 +1328,15 @@ void Board320_240::showScreenSwipePreview(int16_t deltaX)
 
   redrawScreenIsRunning = true;
 
+  waitDisplayTransfer();
   tft.setRotation(liveData->settings.displayRotation);
 
+  // Adjacent screen is composed while the current one is still transferring
   liveData->params.displayScreen = originalScreen;
   liveData->params.displayScreenAutoMode = originalAutoMode;
   if (drawActiveScreenToSprite())
   {
-    spr.pushSprite(deltaX, 0);
+    pushSpriteFrame(deltaX, 0);
   }
 
   liveData->params.displayScreen = adjacentScreen;
@@ -1335,7 +1344,7 @@ void Board320_240::showScreenSwipePreview(int16_t deltaX)
   if (drawActiveScreenToSprite())
   {
     const int16_t adjacentX = deltaX + ((deltaX > 0) ? -320 : 320);
-    spr.pushSprite(adjacentX, 0);
+    pushSpriteFrame(adjacentX, 0);
   }
 
   liveData->params.displayScreen = originalScreen;
@@ -1361,6 +1370,23 @@ void Board320_240::loadTestData()
 void Board320_240::printHeapMemory()
 {
   syslog->printf("Total/free heap: %i/%i-%i, total/free PSRAM %i/%i bytes\n", ESP.getHeapSize(), ESP.getFreeHeap(), heap_caps_get_free_size(MALLOC_CAP_8BIT), ESP.getPsramSize(), ESP.getFreePsram());
+  for (uint8_t i = 0; i < MEM_TAG_COUNT; i++)
+  {
+    const MemTagStats stats = memTagStats(MemTag(i));
+    if (stats.peakBytes > 0)
+    {
+      syslog->printf("  %-8s %7lu B, peak %7lu B\n", memTagName(MemTag(i)), static_cast<unsigned long>(stats.currentBytes),
+                     static_cast<unsigned long>(stats.peakBytes));
+    }
+  }
+}
+
+/**
+ * Report current sprite (frame/menu backbuffer) size to memory stats
+ */
+void Board320_240::trackFramebufferMemory()
+{
+  memTrackSet(MEM_TAG_FRAMEBUFFER, spr.created() ? size_t(spr.width()) * spr.height() * spr.getColorDepth() / 8 : 0);
 }
 
 /**
@@ -1376,20 +1402,8 @@ void Board320_240::commLoop()
     return;
   }
 
-  // Start timing
-  int64_t startTime3 = esp_timer_get_time();
-
   // Read data from BLE/CAN
   commInterface->mainLoop();
-
-  int64_t endTime3 = esp_timer_get_time();
-
-  // Calculate duration
-  int64_t duration3 = endTime3 - startTime3;
-
-  // Print the duration using syslog
-  // Use String constructor to convert int64_t to String
-  // syslog->println("Time taken by function: commLoop() " + String(duration3) + " microseconds");
 }
 
 /**
@@ -1712,14 +1726,9 @@ bool Board320_240::buildContributePayloadV2(String &outJson, bool useReadableTsF
 
   uint8_t rawAdded = 0;
   uint8_t rawDropped = 0;
-  for (uint8_t i = 0; i < liveData->contributeRawFrameCount; i++)
+  for (uint8_t i = 0; i < liveData->contributeRawFrames.count(); i++)
   {
-    const LiveData::ContributeRawFrame &raw = liveData->contributeRawFrames[i];
-    if (raw.key[0] == '\0' || raw.value[0] == '\0')
-    {
-      continue;
-    }
-
+    const RawFrameTable::Frame raw = liveData->contributeRawFrames.frame(i);
     if (rawAdded >= kContributeRawFrameUploadMax)
     {
       rawDropped++;
@@ -1791,7 +1800,7 @@ void Board320_240::syncContributeRelativeTimes(time_t offset)
 }
 
 /**
- * Main loop - primary thread
+ * Main loop - primary thread. Subsystems run as LoopScheduler tasks, CAN/BLE first.
  */
 void Board320_240::mainLoop()
 {
@@ -1800,10 +1809,112 @@ void Board320_240::mainLoop()
   displayFps = (loopDurationMs == 0 ? 0 : (1000.0f / loopDurationMs));
   mainLoopStart = millis();
 
-  // board loop
+  memLoopBegin();
+  memTrackTick(millis());
+  updateCurrentTime();
+  if (loopScheduler.taskCount() == 0)
+  {
+    initLoopTasks();
+  }
+  loopScheduler.run(millis());
+
+  // Descrease loop fps
+  if (powerState.state() == POWER_SENTRY)
+  {
+    const uint32_t idleWaitStartMs = millis();
+    while (liveData->params.stopCommandQueue && (millis() - idleWaitStartMs) < 1000UL)
+    {
+      sentryIdleWait(1000UL - (millis() - idleWaitStartMs));
+      boardLoop();
+      if (mobileRelay != nullptr)
+      {
+        mobileRelay->pumpTx();
+      }
+
+      // Keep Sentry low-power pacing, but poll wake inputs often enough so touch wake feels immediate.
+      isButtonPressed(pinButtonMiddle);
+      if (!liveData->params.stopCommandQueue)
+        break;
+      isButtonPressed(pinButtonLeft);
+      if (!liveData->params.stopCommandQueue)
+        break;
+      isButtonPressed(pinButtonRight);
+    }
+  }
+
+  memLoopEnd();
+}
+
+/**
+ * Registers the main loop subsystems. Priority decides the order within a
+ * loop, comm is critical: it runs first and again between the other tasks.
+ * Budgets are what a task may take before it counts as an overrun.
+ */
+void Board320_240::initLoopTasks()
+{
+  // name, task, context, priority, period ms, budget ms, critical, never deferred
+  loopScheduler.addTask("COMM", [](void *board)
+                        { static_cast<Board320_240 *>(board)->commLoop(); }, this, 0, 0, 20, true);
+  loopScheduler.addTask("INPUT", [](void *board)
+                        { static_cast<Board320_240 *>(board)->loopInput(); }, this, 10, 0, 30, false, true);
+  loopScheduler.addTask("POWER", [](void *board)
+                        { static_cast<Board320_240 *>(board)->loopPower(); }, this, 20, 0, 10, false, true);
+  loopScheduler.addTask("STATS", [](void *board)
+                        { static_cast<Board320_240 *>(board)->loopTripStats(); }, this, 30, 0, 5);
+  loopScheduler.addTask("GPS", [](void *board)
+                        { static_cast<Board320_240 *>(board)->loopGps(); }, this, 40, 0, 5);
+  loopScheduler.addTask("DISPLAY", [](void *board)
+                        { static_cast<Board320_240 *>(board)->loopDisplay(); }, this, 50, 0, 40);
+  loopScheduler.addTask("SDCARD", [](void *board)
+                        { static_cast<Board320_240 *>(board)->loopSdcard(); }, this, 60, 100, 30);
+  loopScheduler.addTask("NET", [](void *board)
+                        { static_cast<Board320_240 *>(board)->loopNet(); }, this, 70, 0, 50);
+}
+
+/**
+ * Current time from RTC/NTP/GPS, once per second
+ */
+void Board320_240::updateCurrentTime()
+{
+  struct tm now = cachedNow;
+  const uint32_t nowMs = millis();
+  if (lastTimeUpdateMs == 0 || (nowMs - lastTimeUpdateMs) >= 1000)
+  {
+    if (getLocalTime(&now, 0))
+    {
+      cachedNow = now;
+      cachedNowEpoch = mktime(&cachedNow);
+    }
+    else if (cachedNowEpoch != 0 && lastTimeUpdateMs != 0)
+    {
+      const uint32_t deltaSec = (nowMs - lastTimeUpdateMs) / 1000U;
+      if (deltaSec > 0)
+      {
+        cachedNowEpoch += deltaSec;
+        localtime_r(&cachedNowEpoch, &cachedNow);
+      }
+    }
+    if (cachedNowEpoch != 0)
+    {
+      liveData->params.currentTime = cachedNowEpoch;
+    }
+    else
+    {
+      // Fallback to uptime seconds when RTC/NTP/GPS time isn't available yet.
+      liveData->params.currentTime = nowMs / 1000U;
+    }
+    lastTimeUpdateMs = nowMs;
+  }
+}
+
+/**
+ * Board input, settings and buttons
+ */
+void Board320_240::loopInput()
+{
   boardLoop();
+  settingsLoop();
 
-  ///////////////////////////////////////////////////////////////////////
   // Handle buttons
   // MIDDLE - menu select
   if (!isButtonPressed(pinButtonMiddle))
@@ -1816,6 +1927,7 @@ void Board320_240::mainLoop()
     {
       btnMiddlePressed = true;
       liveData->params.lastButtonPushedTime = liveData->params.currentTime;
+      waitDisplayTransfer();
       tft.setRotation(liveData->settings.displayRotation);
       if (liveData->menuVisible)
       {
@@ -1838,6 +1950,7 @@ void Board320_240::mainLoop()
     {
       btnLeftPressed = true;
       liveData->params.lastButtonPushedTime = liveData->params.currentTime;
+      waitDisplayTransfer();
       tft.setRotation(liveData->settings.displayRotation);
       // Menu handling
       if (liveData->menuVisible)
@@ -1866,6 +1979,7 @@ void Board320_240::mainLoop()
     {
       btnRightPressed = true;
       liveData->params.lastButtonPushedTime = liveData->params.currentTime;
+      waitDisplayTransfer();
       tft.setRotation(liveData->settings.displayRotation);
       // Menu handling
       if (liveData->menuVisible)
@@ -1902,27 +2016,28 @@ void Board320_240::mainLoop()
   {
     hideMenu();
   }
+}
 
+/**
+ * Applies queued GPS fixes
+ */
+void Board320_240::loopGps()
+{
   const bool allowGpsProcessing = !(liveData->params.stopCommandQueue && liveData->settings.voltmeterEnabled == 1);
   if (allowGpsProcessing)
   {
     // GPS process
-    // Start timing
-    int64_t startTime4 = esp_timer_get_time();
-
-    if (gpsHwUart != NULL)
+    if (gpsHwUart != NULL && !gpsInitRunning)
     {
-      unsigned long start = millis();
-      if (gpsHwUart->available())
+      // Bytes are parsed on the GPS task, apply queued fixes in arrival order
+      if (gpsTaskHandle == nullptr)
       {
-        do
-        {
-          int ch = gpsHwUart->read();
-          if (ch != -1)
-            syslog->infoNolf(DEBUG_GPS, char(ch));
-          gps.encode(ch);
-        } while (gpsHwUart->available());
-        syncGPS();
+        readGpsUart();
+      }
+      GpsFix fix;
+      while (gpsFixQueue != nullptr && xQueueReceive(gpsFixQueue, &fix, 0) == pdTRUE)
+      {
+        syncGPS(fix);
       }
     }
     else
@@ -1938,62 +2053,14 @@ void Board320_240::mainLoop()
       setGpsTime(tmm->tm_year + 1900, tmm->tm_mon + 1, tmm->tm_mday, tmm->tm_hour, tmm->tm_min, tmm->tm_sec);
       liveData->params.setGpsTimeFromCar = 0;
     }
-
-    int64_t endTime4 = esp_timer_get_time();
-    // Calculate duration
-    int64_t duration4 = endTime4 - startTime4;
-
-    // Print the duration using syslog
-    // Use String constructor to convert int64_t to String
-    // syslog->println("Time taken by function: GPS loop " + String(duration4) + " microseconds");
-  }
-
-  // currentTime
-  struct tm now = cachedNow;
-  const uint32_t nowMs = millis();
-  if (lastTimeUpdateMs == 0 || (nowMs - lastTimeUpdateMs) >= 1000)
-  {
-    if (getLocalTime(&now, 0))
-    {
-      cachedNow = now;
-      cachedNowEpoch = mktime(&cachedNow);
-    }
-    else if (cachedNowEpoch != 0 && lastTimeUpdateMs != 0)
-    {
-      const uint32_t deltaSec = (nowMs - lastTimeUpdateMs) / 1000U;
-      if (deltaSec > 0)
-      {
-        cachedNowEpoch += deltaSec;
-        localtime_r(&cachedNowEpoch, &cachedNow);
-      }
-    }
-    if (cachedNowEpoch != 0)
-    {
-      liveData->params.currentTime = cachedNowEpoch;
-    }
-    else
-    {
-      // Fallback to uptime seconds when RTC/NTP/GPS time isn't available yet.
-      liveData->params.currentTime = nowMs / 1000U;
-    }
-    lastTimeUpdateMs = nowMs;
-  }
-
-  // Periodic automatic brightness recalculation (handles sunrise/sunset without new GPS fix)
-  if (liveData->settings.lcdBrightness == 0 &&
-      liveData->params.gpsLat != -1.0 &&
-      liveData->params.gpsLon != -1.0 &&
-      liveData->params.currentTime != 0)
-  {
-    static time_t lastAutoBrightnessCalc = 0;
-    const time_t nowTime = liveData->params.currentTime;
-    if (lastAutoBrightnessCalc == 0 || (nowTime - lastAutoBrightnessCalc) >= 60)
-    {
-      lastAutoBrightnessCalc = nowTime;
-      calcAutomaticBrightnessLatLon();
-    }
   }
+}
 
+/**
+ * WiFi reconnect/fallback and remote uploads
+ */
+void Board320_240::loopNet()
+{
   // Check and eventually reconnect WIFI connection
   const bool wifiEnabled = (liveData->settings.wifiEnabled == 1);
   const bool wifiConnected = (WiFi.status() == WL_CONNECTED);
@@ -2029,9 +2096,15 @@ void Board320_240::mainLoop()
 
   // SIM800L, WiFI remote upload, ABRP remote upload, MQTT
   netLoop();
+}
 
-  // SD card recording
-  int64_t startTime5 = esp_timer_get_time();
+/**
+ * SD card recording
+ */
+void Board320_240::loopSdcard()
+{
+  struct tm now = cachedNow;
+  const uint32_t nowMs = millis();
   const bool sdcardJsonV2 = true;
   const bool sdcardWriteTick = sdcardJsonV2 ? true : liveData->params.sdcardCanNotify;
   const bool sdcardHasPayload =
@@ -2102,6 +2175,7 @@ void Board320_240::mainLoop()
       const bool sizeToFlush = sdcardRecordBuffer.length() >= sdcardFlushSize;
       if ((timeToFlush || sizeToFlush) && sdcardRecordBuffer.length() > 0)
       {
+        waitDisplayTransfer(); // SD shares the SPI bus with the LCD
         if (sdcardJsonV2 &&
             rotateSdV2FileIfNeeded(liveData->params.sdcardFilename,
                                    sizeof(liveData->params.sdcardFilename),
@@ -2132,35 +2206,26 @@ void Board320_240::mainLoop()
       }
     }
   }
+}
 
-  int64_t endTime5 = esp_timer_get_time();
-
-  // Calculate duration
-  int64_t duration5 = endTime5 - startTime5;
-
-  // Print the duration using syslog
-  // Use String constructor to convert int64_t to String
-  // syslog->println("Time taken by function: SD card write loop " + String(duration5) + " microseconds");
-
+/**
+ * Voltmeter, command queue stop/wake and power state
+ */
+void Board320_240::loopPower()
+{
   // Read voltmeter INA3221 (if enabled)
+  bool voltmeterRead = false;
   if (liveData->settings.voltmeterEnabled == 1 && liveData->params.currentTime - liveData->params.lastVoltageReadTime > 5)
   {
     liveData->params.auxVoltage = ina3221.getBusVoltage_V(1);
     liveData->params.lastVoltageReadTime = liveData->params.currentTime;
+    voltmeterRead = true;
+    powerState.sampleCurrent(ina3221.getCurrent_mA(1));
     if (liveData->params.auxVoltage > liveData->settings.voltmeterSleep)
     {
       liveData->params.lastVoltageOkTime = liveData->params.currentTime;
     }
 
-    // Protect AUX battery in screen only mode
-    if (liveData->settings.sleepModeLevel == SLEEP_MODE_SCREEN_ONLY &&
-        liveData->params.auxVoltage > 5 && liveData->params.auxVoltage < liveData->settings.voltmeterCutOff)
-    {
-      syslog->print("AUX voltage under cut-off voltage: ");
-      syslog->println(liveData->settings.voltmeterCutOff);
-      shutdownDevice();
-    }
-
     // Calculate AUX perc for ioniq2018
     if (liveData->settings.carType == CAR_HYUNDAI_IONIQ_2018)
     {
@@ -2169,125 +2234,48 @@ void Board320_240::mainLoop()
     }
   }
 
-  const bool recentlyCharging =
-      (liveData->params.lastChargingOnTime != 0 &&
-       liveData->params.currentTime >= liveData->params.lastChargingOnTime &&
-       (liveData->params.currentTime - liveData->params.lastChargingOnTime) <= kChargingQueueHoldSec);
-  const bool chargingActiveForQueue =
-      (liveData->params.chargingOn ||
-       liveData->params.chargerACconnected ||
-       liveData->params.chargerDCconnected ||
-       recentlyCharging);
-
-  // Reset sentry session when car becomes active
-  if (liveData->params.ignitionOn || chargingActiveForQueue)
+  PowerStateMachine::Inputs inputs;
+  inputs.now = liveData->params.currentTime;
+  inputs.auxVoltage = liveData->params.auxVoltage;
+  inputs.voltmeterRead = voltmeterRead;
+  inputs.ignitionOn = liveData->params.ignitionOn;
+  inputs.charging = (liveData->params.chargingOn ||
+                     liveData->params.chargerACconnected ||
+                     liveData->params.chargerDCconnected);
+  inputs.lastChargingOnTime = liveData->params.lastChargingOnTime;
+  inputs.gpsValid = liveData->params.gpsValid;
+  inputs.gpsSpeedKmh = liveData->params.speedKmhGPS;
+  inputs.gpsSat = liveData->params.gpsSat;
+  inputs.gyroMotion = liveData->params.gyroSensorMotion;
+  inputs.validResponse = liveData->params.getValidResponse;
+  inputs.lastCanResponseTime = liveData->params.lastCanbusResponseTime;
+  inputs.wakeUpTime = liveData->params.wakeUpTime;
+  inputs.doorsClosed = (!liveData->params.leftFrontDoorOpen &&
+                        !liveData->params.rightFrontDoorOpen &&
+                        !liveData->params.trunkDoorOpen);
+  inputs.stopPendingSince = liveData->params.stopCommandQueueTime;
+  inputs.queueStopped = liveData->params.stopCommandQueue;
+  inputs.snapshotWake = liveData->params.sleepSnapshotWake;
+  inputs.autoStop = (liveData->settings.commandQueueAutoStop == 1);
+  inputs.voltmeter = (liveData->settings.voltmeterEnabled == 1);
+  inputs.voltmeterCutOff = liveData->settings.voltmeterCutOff;
+  inputs.screenOnlySleep = (liveData->settings.sleepModeLevel == SLEEP_MODE_SCREEN_ONLY);
+  inputs.sentryShutdownHrs = liveData->settings.sleepModeShutdownHrs;
+  inputs.deepSleepWakeSource = (liveData->settings.commType == COMM_TYPE_CAN_COMMU || liveData->settings.voltmeterEnabled == 1);
+
+  PowerStateMachine::Result power;
+  powerState.update(inputs, millis(), power);
+  liveData->params.sentrySessionActive = powerState.sentrySessionActive();
+  liveData->params.gpsWakeCount = powerState.gpsWakeCount();
+  liveData->params.gyroWakeCount = powerState.gyroWakeCount();
+  liveData->params.motionWakeLocked = powerState.motionWakeLocked();
+
+  if (power.continueQueue)
   {
-    if (liveData->params.sentrySessionActive)
-    {
-      liveData->params.sentrySessionActive = false;
-      liveData->params.motionWakeLocked = false;
-      liveData->params.gpsWakeCount = 0;
-      liveData->params.gyroWakeCount = 0;
-      liveData->params.motionWakeLastTime = 0;
-    }
-  }
-
-  // Wake up from stopped command queue
-  //  - ignitions on and aux >= 11.5v
-  //  - ina3221 & voltage is >= 14V (DCDC is running)
-  //  - gps speed >= 5kmh & 4+ satellites (only when voltmeter is disabled)
-  //  - gyro motion (only when voltmeter is disabled)
-  const bool queueStopped = liveData->params.stopCommandQueue;
-  const bool queueSleeping = (queueStopped || liveData->params.stopCommandQueueTime != 0);
-  const bool allowMotionWake = (liveData->settings.voltmeterEnabled == 0);
-  static uint8_t gpsWakeConfirmCount = 0;
-  static uint8_t gyroWakeConfirmCount = 0;
-
-  if (!queueStopped)
-  {
-    gpsWakeConfirmCount = 0;
-    gyroWakeConfirmCount = 0;
-
-    // Charging started while autostop was preparing: cancel pending stop timer.
-    if (liveData->params.stopCommandQueueTime != 0 && chargingActiveForQueue)
-    {
-      liveData->continueWithCommandQueue();
-    }
-  }
-
-  if (queueSleeping)
-  {
-    if (liveData->params.motionWakeLastTime == 0)
-    {
-      liveData->params.motionWakeLastTime = liveData->params.currentTime;
-    }
-    else if (liveData->params.currentTime - liveData->params.motionWakeLastTime >= kMotionWakeResetSec)
-    {
-      liveData->params.gpsWakeCount = 0;
-      liveData->params.gyroWakeCount = 0;
-      liveData->params.motionWakeLocked = false;
-      liveData->params.motionWakeLastTime = liveData->params.currentTime;
-    }
-  }
-  const uint16_t maxGpsWakePerSession = 1;
-  const uint16_t maxGyroWakePerSession = 5;
-  const bool gpsWakeRemaining = (liveData->params.gpsWakeCount < maxGpsWakePerSession);
-  const bool gyroWakeRemaining = (liveData->params.gyroWakeCount < maxGyroWakePerSession);
-  const bool motionWakeLocked = (!gpsWakeRemaining && !gyroWakeRemaining);
-  liveData->params.motionWakeLocked = motionWakeLocked;
-  const bool motionWakeAllowed = allowMotionWake && !motionWakeLocked;
-  const bool gpsWakeCandidate =
-      motionWakeAllowed && gpsWakeRemaining &&
-      (liveData->params.gpsValid && liveData->params.speedKmhGPS >= 5 && liveData->params.gpsSat >= 4); // 5 floor parking house, satelites 5 & gps speed = 274kmh :/
-  const bool gyroWakeCandidate = motionWakeAllowed && gyroWakeRemaining && liveData->params.gyroSensorMotion;
-
-  if (queueStopped && gpsWakeCandidate)
-  {
-    if (gpsWakeConfirmCount < kGpsWakeConfirmSamples)
-      gpsWakeConfirmCount++;
-  }
-  else
-  {
-    gpsWakeConfirmCount = 0;
-  }
-
-  if (queueStopped && gyroWakeCandidate)
-  {
-    if (gyroWakeConfirmCount < kGyroWakeConfirmSamples)
-      gyroWakeConfirmCount++;
+    liveData->continueWithCommandQueue();
   }
-  else
+  if (power.resumeComm)
   {
-    gyroWakeConfirmCount = 0;
-  }
-
-  const bool gpsWake = queueStopped && (gpsWakeConfirmCount >= kGpsWakeConfirmSamples);
-  const bool gyroWake = queueStopped && (gyroWakeConfirmCount >= kGyroWakeConfirmSamples);
-  const bool motionWake = gpsWake || gyroWake;
-  if (queueStopped &&
-      ((liveData->params.ignitionOn && (liveData->params.auxVoltage <= 3 || liveData->params.auxVoltage >= 11.5)) ||
-       chargingActiveForQueue ||
-       (liveData->settings.voltmeterEnabled == 1 && liveData->params.auxVoltage > 14.0) ||
-       motionWake))
-  {
-    if (motionWake)
-    {
-      if (gpsWake)
-      {
-        liveData->params.gpsWakeCount++;
-      }
-      if (gyroWake)
-      {
-        liveData->params.gyroWakeCount++;
-      }
-      liveData->params.motionWakeLastTime = liveData->params.currentTime;
-      liveData->params.motionWakeLocked =
-          (liveData->params.gpsWakeCount >= maxGpsWakePerSession &&
-           liveData->params.gyroWakeCount >= maxGyroWakePerSession);
-    }
-    gpsWakeConfirmCount = 0;
-    gyroWakeConfirmCount = 0;
-    liveData->continueWithCommandQueue();
     if (commInterface->isSuspended())
     {
       commInterface->resumeDevice();
@@ -2315,24 +2303,27 @@ void Board320_240::mainLoop()
       }
     }
   }
-  // Stop command queue
-  //  - automatically turns off CAN scanning after 1-2 minutes of inactivity
-  //  - ignition is off
-  //  - AUX voltage is under 11.5V
-  const time_t doorStateStaleAfterSec = 15;
-  const bool doorStateStale = (liveData->params.currentTime - liveData->params.lastCanbusResponseTime > doorStateStaleAfterSec);
-  const bool doorsClosed = (!liveData->params.leftFrontDoorOpen &&
-                            !liveData->params.rightFrontDoorOpen &&
-                            !liveData->params.trunkDoorOpen);
-  const bool doorsOk = (doorsClosed || doorStateStale);
-  const bool parkingLikely =
-      (!liveData->params.ignitionOn &&
-       !chargingActiveForQueue &&
-       doorsOk);
-  const bool lowAuxVoltage = (!chargingActiveForQueue &&
-                              liveData->params.auxVoltage > 3 &&
-                              liveData->params.auxVoltage < 11.5);
-  const bool autoStopByCanSignals = (parkingLikely || lowAuxVoltage);
+  if (power.prepareStop)
+  {
+    if (power.canFallback)
+    {
+      syslog->println("Sentry fallback: no valid CAN data, preparing autostop.");
+    }
+    liveData->prepareForStopCommandQueue();
+  }
+  if (power.stopQueue)
+  {
+    liveData->params.stopCommandQueue = true;
+    commInterface->suspendDevice();
+    syslog->println("CAN Command queue stopped...");
+  }
+  for (uint8_t i = 0; i < power.transitionCount; i++)
+  {
+    logPowerTransition(power.transitions[i]);
+  }
+
+  // Clear driving stats on the next drive after a long parking
+  const bool chargingActiveForQueue = PowerStateMachine::chargingActive(inputs);
   const bool longParkingCandidate =
       (liveData->params.currentTime != 0 &&
        !chargingActiveForQueue &&
@@ -2364,54 +2355,45 @@ void Board320_240::mainLoop()
   {
     liveData->params.parkedModeStartTime = 0;
   }
+  updateGpsV21PpsMode();
 
-  // Fallback when CAN never yields a valid response (e.g. adapter/config issue):
-  // still allow Sentry autostop after a grace period so AUX battery is protected.
-  const time_t autoStopWithoutCanGraceSec = 180;
-  const bool canDataMissingTooLong =
-      (!liveData->params.getValidResponse &&
-       (liveData->params.currentTime - liveData->params.wakeUpTime > autoStopWithoutCanGraceSec));
-  const bool dcDcLikelyRunning = (liveData->params.auxVoltage >= 13.8);
-  const bool autoStopFallbackSafe = (parkingLikely && !dcDcLikelyRunning);
-
-  if (liveData->settings.commandQueueAutoStop == 1 &&
-      ((liveData->params.getValidResponse && autoStopByCanSignals) ||
-       (canDataMissingTooLong && autoStopFallbackSafe)))
-  {
-    if (canDataMissingTooLong && !liveData->params.getValidResponse && liveData->params.stopCommandQueueTime == 0)
-    {
-      syslog->println("Sentry fallback: no valid CAN data, preparing autostop.");
-    }
-    liveData->prepareForStopCommandQueue();
-  }
-  if (!liveData->params.stopCommandQueue &&
-      !chargingActiveForQueue &&
-      ((liveData->params.stopCommandQueueTime != 0 && liveData->params.currentTime - liveData->params.stopCommandQueueTime > 60) ||
-       (liveData->params.auxVoltage > 3 && liveData->params.auxVoltage < 11.0)))
+  switch (power.shutdown)
   {
-    liveData->params.stopCommandQueue = true;
-    commInterface->suspendDevice();
-    syslog->println("CAN Command queue stopped...");
+  case POWER_SHUTDOWN_AUX_CUTOFF:
+    syslog->print("AUX voltage under cut-off voltage: ");
+    syslog->println(liveData->settings.voltmeterCutOff);
+    shutdownDevice();
+    break;
+  case POWER_SHUTDOWN_NO_CAR:
+    syslog->println("Deep sleep wake without car response, deep sleep again.");
+    shutdownDevice();
+    break;
+  case POWER_SHUTDOWN_SENTRY_TIMEOUT:
+    syslog->println("Sentry timeout, deep sleep until the car wakes.");
+    shutdownDevice();
+    break;
+  default:
+    break;
   }
-  updateGpsV21PpsMode();
+}
 
-  // Descrease loop fps
-  if (liveData->params.stopCommandQueue)
+/**
+ * Brightness, screen off after inactivity and redraw
+ */
+void Board320_240::loopDisplay()
+{
+  // Periodic automatic brightness recalculation (handles sunrise/sunset without new GPS fix)
+  if (liveData->settings.lcdBrightness == 0 &&
+      liveData->params.gpsLat != -1.0 &&
+      liveData->params.gpsLon != -1.0 &&
+      liveData->params.currentTime != 0)
   {
-    const uint32_t idleWaitStartMs = millis();
-    while (liveData->params.stopCommandQueue && (millis() - idleWaitStartMs) < 1000UL)
+    static time_t lastAutoBrightnessCalc = 0;
+    const time_t nowTime = liveData->params.currentTime;
+    if (lastAutoBrightnessCalc == 0 || (nowTime - lastAutoBrightnessCalc) >= 60)
     {
-      delay(kSentryIdleSliceMs);
-      boardLoop();
-
-      // Keep Sentry low-power pacing, but poll wake inputs often enough so touch wake feels immediate.
-      isButtonPressed(pinButtonMiddle);
-      if (!liveData->params.stopCommandQueue)
-        break;
-      isButtonPressed(pinButtonLeft);
-      if (!liveData->params.stopCommandQueue)
-        break;
-      isButtonPressed(pinButtonRight);
+      lastAutoBrightnessCalc = nowTime;
+      calcAutomaticBrightnessLatLon();
     }
   }
 
@@ -2428,9 +2410,6 @@ void Board320_240::mainLoop()
     setBrightness();
   }
 
-  // Read data from BLE/CAN
-  commLoop();
-
   // force redraw (min 1 sec update; slower while in Sentry)
   const time_t redrawIntervalSec = liveData->params.stopCommandQueue ? 2 : 1;
   if (!screenSwipePreviewActive &&
@@ -2438,7 +2417,13 @@ void Board320_240::mainLoop()
   {
     redrawScreen();
   }
+}
 
+/**
+ * Drive/charge statistics, contribute samples and history
+ */
+void Board320_240::loopTripStats()
+{
   // Calculating avg.speed and time in forward mode
   if (liveData->params.odoKm != -1 && forwardDriveOdoKmLast == -1)
   {
@@ -2484,6 +2469,8 @@ void Board320_240::mainLoop()
   handleContributeChargingTransitions();
   lastChargingOn = liveData->params.chargingOn;
   recordContributeSample();
+  liveData->updateHot();
+  liveData->recordHistory();
 
   if (liveData->params.chargingOn && liveData->params.carMode != CAR_MODE_CHARGING)
   {
@@ -2542,7 +2529,9 @@ void Board320_240::setGpsTime(uint16_t year, uint8_t month, uint8_t day, uint8_t
   M5.Rtc.SetDate(&RTCdate);
 #endif // BOARD_M5STACK_CORE2
 #ifdef BOARD_M5STACK_CORES3
+  takeInputBus(portMAX_DELAY);
   CoreS3.Rtc.setDateTime(gmtime(&t));
+  giveInputBus();
 #endif // BOARD_M5STACK_CORES3
 }
 
@@ -2566,7 +2555,6 @@ void Board320_240::syncTimes(time_t newTime)
       &liveData->params.wakeUpTime,
       &liveData->params.lastIgnitionOnTime,
       &liveData->params.stopCommandQueueTime,
-      &liveData->params.motionWakeLastTime,
       &liveData->params.parkedModeStartTime,
       &liveData->params.lastChargingOnTime,
       &liveData->params.lastVoltageReadTime,
@@ -2582,6 +2570,7 @@ void Board320_240::syncTimes(time_t newTime)
   }
 
   syncContributeRelativeTimes(offset);
+  powerState.shiftTime(offset);
 
   // Reset avg speed counter
   lastForwardDriveModeStart = 0;
@@ -2615,6 +2604,7 @@ bool Board320_240::sdcardMount()
   }
 
   bool SdState = false;
+  waitDisplayTransfer();
   syslog->print("Initializing SD card...");
   SdState = SD.begin(TFCARD_CS_PIN, SPI, 40000000);
   if (SdState)
@@ -2682,6 +2672,7 @@ void Board320_240::sdcardToggleRecording()
   {
     if (sdcardRecordBuffer.length() > 0 && strlen(liveData->params.sdcardFilename) != 0)
     {
+      waitDisplayTransfer();
       if (rotateSdV2FileIfNeeded(liveData->params.sdcardFilename,
                                  sizeof(liveData->params.sdcardFilename),
                                  sdcardRecordBuffer.length()))
@@ -2785,13 +2776,14 @@ void Board320_240::sdcardEraseLogs()
  * Synchronizes GPS data with the liveData structure.
  *
  * This function updates GPS-related parameters such as latitude, longitude,
- * altitude, satellite count, speed, and time synchronization if valid data is received.
+ * altitude, satellite count, speed, and time synchronization from one parsed fix
+ * (see Board320_240_gps.cpp).
  */
-void Board320_240::syncGPS()
+void Board320_240::syncGPS(const GpsFix &fix)
 {
-  if (gps.satellites.isValid())
+  if (fix.satValid)
   {
-    liveData->params.gpsSat = gps.satellites.value();
+    liveData->params.gpsSat = fix.sat;
   }
 
   const float prevLat = liveData->params.gpsLat;
@@ -2802,10 +2794,10 @@ void Board320_240::syncGPS()
   float newLat = 0.0f;
   float newLon = 0.0f;
 
-  if (gps.location.isValid())
+  if (fix.locationValid)
   {
-    newLat = gps.location.lat();
-    newLon = gps.location.lng();
+    newLat = fix.lat;
+    newLon = fix.lon;
 
     if (isGpsCoordSane(newLat, newLon))
     {
@@ -2845,9 +2837,9 @@ void Board320_240::syncGPS()
             maxSpeedKmh = candidate;
           }
         }
-        if (gps.speed.isValid())
+        if (fix.speedValid)
         {
-          float candidate = gps.speed.kmph() + 30.0f;
+          float candidate = fix.speedKmh + 30.0f;
           if (candidate > maxSpeedKmh)
           {
             maxSpeedKmh = candidate;
@@ -2884,9 +2876,9 @@ void Board320_240::syncGPS()
     liveData->params.gpsValid = true;
     liveData->params.gpsLat = newLat;
     liveData->params.gpsLon = newLon;
-    liveData->params.gpsAlt = gps.altitude.meters();
+    liveData->params.gpsAlt = fix.altM;
     liveData->params.gpsLastFixTime = liveData->params.currentTime;
-    liveData->params.gpsLastFixMs = millis();
+    liveData->params.gpsLastFixMs = uint32_t(fix.arrivalUs / 1000); // UART arrival, not loop time
     calcAutomaticBrightnessLatLon(); // Adjust screen brightness based on location
   }
   else
@@ -2895,9 +2887,9 @@ void Board320_240::syncGPS()
   }
 
   // Update GPS speed if valid and enough satellites are available
-  if (gps.speed.isValid() && liveData->params.gpsSat >= 4)
+  if (fix.speedValid && liveData->params.gpsSat >= 4)
   {
-    liveData->params.speedKmhGPS = gps.speed.kmph();
+    liveData->params.speedKmhGPS = fix.speedKmh;
   }
   else
   {
@@ -2921,9 +2913,9 @@ void Board320_240::syncGPS()
 
     // Some V2.1 modules provide an onboard course value even when movement between
     // two accepted fixes is too small for stable coordinate-based heading.
-    if (headingFromMovement < 0.0f && gps.course.isValid() && liveData->params.gpsSat >= 4)
+    if (headingFromMovement < 0.0f && fix.courseValid && liveData->params.gpsSat >= 4)
     {
-      headingFromMovement = normalizeHeadingDeg(gps.course.deg());
+      headingFromMovement = normalizeHeadingDeg(fix.courseDeg);
     }
 
     if (headingFromMovement >= 0.0f)
@@ -2936,9 +2928,9 @@ void Board320_240::syncGPS()
       liveData->params.gpsHeadingDeg = -1;
     }
   }
-  else if (gps.course.isValid() && liveData->params.gpsSat >= 4)
+  else if (fix.courseValid && liveData->params.gpsSat >= 4)
   {
-    liveData->params.gpsHeadingDeg = normalizeHeadingDeg(gps.course.deg());
+    liveData->params.gpsHeadingDeg = normalizeHeadingDeg(fix.courseDeg);
   }
   else
   {
@@ -2947,11 +2939,11 @@ void Board320_240::syncGPS()
 
   // Synchronize time with GPS if it has not been synchronized yet.
   // When NTP is enabled, wait for the NTP priority window to expire before falling back to GPS time.
-  if (!liveData->params.currTimeSyncWithGps && gps.date.isValid() && gps.time.isValid())
+  if (!liveData->params.currTimeSyncWithGps && fix.dateTimeValid)
   {
     if (liveData->settings.ntpEnabled == 0 || liveData->params.ntpTimeSet || gpsTimeFallbackAllowed)
     {
-      setGpsTime(gps.date.year(), gps.date.month(), gps.date.day(), gps.time.hour(), gps.time.minute(), gps.time.second());
+      setGpsTime(fix.year, fix.month, fix.day, fix.hour, fix.minute, fix.second);
     }
   }
 }
@@ -3106,6 +3098,7 @@ bool Board320_240::wifiScanToMenu()
 
 bool Board320_240::promptKeyboard(const char *title, String &value, bool mask, uint8_t maxLen)
 {
+  waitDisplayTransfer();
   keyboardInputActive = true;
   const int16_t screenW = tft.width();
   const int16_t screenH = tft.height();
@@ -3456,6 +3449,13 @@ bool Board320_240::promptKeyboard(const char *title, String &value, bool mask, u
 
   auto readTouchRaw = [&](int16_t &x, int16_t &y) -> bool
   {
+    if (inputTaskHandle != nullptr)
+    {
+      // Touch controller belongs to the input task, use its last sample
+      if (!readTouchSample(x, y))
+        return false;
+      return !(x < 0 || y < 0 || x >= screenW || y >= screenH);
+    }
 #ifdef BOARD_M5STACK_CORE2
     if (M5.Touch.ispressed() && M5.Touch.points > 0 && M5.Touch.point[0].valid())
     {
@@ -5055,6 +5055,7 @@ void Board320_240::queueAbrpSdLog(const char *payload, size_t length, time_t cur
     return;
   }
 
+  waitDisplayTransfer();
   File file = SD.open(liveData->params.sdcardAbrpFilename, FILE_APPEND);
   if (!file)
   {
@@ -5626,7 +5627,7 @@ bool Board320_240::netContributeData()
       scheduleNextContributeCycle();
       updateNetAvailability(false);
     }
-    free(payloadForPost);
+    memTaggedFree(MEM_TAG_UPLOAD, payloadForPost);
   }
 #endif // BOARD_M5STACK_CORE2 || BOARD_M5STACK_CORES3
 
@@ -5636,6 +5637,7 @@ bool Board320_240::netContributeData()
 void Board320_240::runSdV2BackgroundTasks(bool netReady)
 {
   const uint32_t nowMs = millis();
+  waitDisplayTransfer();
 
   if (nextSdV2CleanupAtMs == 0 || static_cast<int32_t>(nowMs - nextSdV2CleanupAtMs) >= 0)
   {
@@ -6075,6 +6077,7 @@ void Board320_240::initGPS()
   gpsHwUart = new HardwareSerial(liveData->settings.gpsHwSerialPort);
   auto beginGpsUart = [&](unsigned long baud)
   {
+    gpsHwUart->setRxBufferSize(kGpsRxBufferSize);
     if (liveData->settings.gpsHwSerialPort == 1 || liveData->settings.gpsHwSerialPort == 2)
     {
       gpsHwUart->begin(baud, SERIAL_8N1, SERIAL2_RX, SERIAL2_TX);
@@ -6300,6 +6303,9 @@ void Board320_240::initGPS()
     setGpsV21Pps(false);
     syslog->println("GPS v2.1 PCAS init applied (200ms, GGA+RMC).");
   }
+  gpsBinaryNavActive = (liveData->settings.gpsBinaryNav == 1) && configureGpsBinaryNav(detectedBaud);
+
+  startGpsTask();
 }
 
 /**
@@ -6366,12 +6372,61 @@ void Board320_240::setGpsV21Pps(bool enabled)
   syslog->println(enabled ? "GPS v2.1 PPS LED enabled." : "GPS v2.1 PPS LED disabled.");
 }
 
+/**
+ * Logs a power state transition with the time and average current of the
+ * state being left.
+ */
+void Board320_240::logPowerTransition(const PowerStateMachine::Transition &transition)
+{
+  syslog->printf("Power %s -> %s after %lu s", PowerStateMachine::name(transition.from),
+                 PowerStateMachine::name(transition.to), (unsigned long)(transition.durationMs / 1000));
+  if (transition.avgCurrentMa >= 0)
+  {
+    syslog->printf(", avg %d mA", transition.avgCurrentMa);
+  }
+  syslog->println("");
+}
+
+/**
+ * Sentry idle between wake polls. Light sleep only when nothing in the
+ * background needs the CPU or radio (comm suspended, WiFi off, BLE relay off,
+ * GPS not used for motion wake) and the board has a touch interrupt to wake it
+ * early; otherwise a plain delay as before.
+ */
+void Board320_240::sentryIdleWait(uint32_t maxMs)
+{
+  const bool gpsMotionWake = (liveData->settings.voltmeterEnabled == 0 && liveData->settings.gpsHwSerialPort != 255);
+  // Light sleep stops the BLE controller clock: advertising and a connected phone would drop
+  const bool bleRelayActive = (liveData->settings.relayForMobileEnabled == 1 || isMobileRelayClientConnected());
+  if (maxMs == 0 || !commInterface->isSuspended() || WiFi.getMode() != WIFI_OFF || gpsMotionWake || bleRelayActive ||
+      !enableTouchWake())
+  {
+    delay(kSentryIdleSliceMs);
+    return;
+  }
+
+  const uint32_t sliceMs = (maxMs < kSentryLightSleepSliceMs) ? maxMs : kSentryLightSleepSliceMs;
+  syslog->flush();
+  esp_sleep_enable_timer_wakeup(uint64_t(sliceMs) * 1000ULL);
+  const bool slept = (esp_light_sleep_start() == ESP_OK);
+  // Keep the timer out of a later esp_deep_sleep_start() in shutdownDevice()
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+  if (!slept)
+  {
+    delay(kSentryIdleSliceMs);
+  }
+  else if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO)
+  {
+    delay(kInputSamplePeriodMs * 2); // input task reads the touch
+  }
+}
+
 /**
  * Sync GPS v2.1 PPS output with Sentry/suspend state.
  */
 void Board320_240::updateGpsV21PpsMode()
 {
-  if (liveData->settings.gpsModuleType == GPS_MODULE_TYPE_GPS_V21_GNSS)
+  if (liveData->settings.gpsModuleType == GPS_MODULE_TYPE_GPS_V21_GNSS && !gpsInitRunning)
   {
     setGpsV21Pps(liveData->params.stopCommandQueue);
   }
@@ -6382,6 +6437,7 @@ void Board320_240::updateGpsV21PpsMode()
  */
 void Board320_240::uploadSdCardLogToEvDashServer(bool silent)
 {
+  waitDisplayTransfer();
   if (!silent)
   {
     syslog->println("uploadSdCardLogToEvDashServer");
@@ -2,9 +2,16 @@
 
 //
 #include <TinyGPS++.h>
+#include "GpsBinaryParser.h"
+#include "GpsNmeaParser.h"
+#include "MemStats.h"
+#include "PowerState.h"
+#include "LoopScheduler.h"
 #include "BoardInterface.h"
 #include <SD.h>
 #include <SPI.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "SDL_Arduino_INA3221.h"
 
 #ifdef BOARD_M5STACK_CORE2
@@ -30,6 +37,38 @@
 class Board320_240 : public BoardInterface
 {
 
+public:
+  // Big number glyph atlas faces
+  enum GlyphFaceId : uint8_t
+  {
+    GLYPH_FACE_FONT7 = 0,
+    GLYPH_FACE_FONT7_X2,
+    GLYPH_FACE_ORBITRON32,
+    GLYPH_FACE_ORBITRON24,
+    GLYPH_FACE_COUNT
+  };
+  static constexpr uint8_t kGlyphCharCount = 13; // "0123456789.-%"
+  struct GlyphSpan
+  {
+    int16_t x;
+    int16_t y;
+    uint16_t len;
+  };
+  struct GlyphEntry
+  {
+    uint16_t firstSpan;
+    uint16_t spanCount;
+    int16_t advance;
+    int16_t lastWidth; // width when last in string (may exceed advance)
+  };
+  struct GlyphFace
+  {
+    bool ready;
+    int16_t rowOffset[3]; // top/middle/bottom datum shift against top
+    GlyphEntry glyphs[kGlyphCharCount];
+    GlyphSpan *spans;
+  };
+
 protected:
 // TFT, SD SPI
 #if BOARD_M5STACK_CORE2
@@ -50,10 +89,86 @@ protected:
   bool ensureMenuBackbuffer();
   void releaseMenuBackbuffer();
   void sprDrawString(const char *string, int32_t poX, int32_t poY);
+  // Display DMA transfer (Board320_240_dma.cpp)
+  static constexpr int16_t kDisplayDmaLines = 8; // lines per bounce buffer
+  uint16_t *displayDmaBounce[2] = {nullptr, nullptr};
+  uint16_t *displayDmaSnapshot = nullptr;
+  uint16_t displayDmaPalette[256];
+  bool displayDmaReady = false;
+  bool displayDmaAsync = false;
+  volatile bool displayDmaBusy = false;
+  TaskHandle_t displayDmaTaskHandle = nullptr;
+  SemaphoreHandle_t displayDmaDone = nullptr;
+  int16_t displayDmaJobX = 0;
+  int16_t displayDmaJobY = 0;
+  int16_t displayDmaJobW = 0;
+  int16_t displayDmaJobH = 0;
+  uint32_t displayComposeUs = 0;
+  uint32_t displayDmaSnapshotUs = 0;
+  volatile uint32_t displayDmaTransferUs = 0;
+  uint32_t displayDmaWaitUs = 0;
+  bool initDisplayDma();
+  void pushSpriteFrame(int16_t x, int16_t y);
+  void streamFrameToPanel(const uint8_t *src, size_t srcStride, uint8_t bytesPerPixel,
+                          int16_t dstX, int16_t dstY, int16_t visW, int16_t visH);
+  static void displayDmaTask(void *param);
+  uint32_t displaySceneUs[SCREEN_HUD + 1] = {};
+  // Big number glyph atlas (Board320_240_glyphs.cpp)
+  GlyphFace glyphFaces[GLYPH_FACE_COUNT] = {};
+  uint32_t glyphAtlasBytes = 0;
+  uint32_t glyphDrawCount = 0;
+  uint32_t glyphFallbackCount = 0;
+  void initGlyphAtlas();
+  void sprSetGlyphFace(uint8_t face);
+  void sprDrawBigNumber(const char *text, int32_t x, int32_t y, uint8_t face, uint8_t datum, uint16_t color);
   void tftDrawStringFont7(const char *string, int32_t poX, int32_t poY);
+  // Input task (Board320_240_input.cpp)
+  static constexpr uint16_t kInputSamplePeriodMs = 10;
+  TaskHandle_t inputTaskHandle = nullptr;
+  uint32_t inputQueueDrops = 0;
+  int64_t inputPendingUs = 0;       // oldest input consumed since last frame push
+  int64_t displayDmaJobInputUs = 0; // same, for the frame owned by the transfer task
+  static constexpr uint32_t kInputLatencyWindowUs = 10000000;
+  volatile uint32_t inputLatencyUs = 0;
+  volatile uint32_t inputLatencyMaxUs = 0; // max of the current and previous 10 s window
+  uint32_t inputLatencyWindowMaxUs = 0;
+  int64_t inputLatencyWindowStartUs = 0;
+  // Touch controller shares the internal I2C bus with IMU and RTC (CoreS3)
+  SemaphoreHandle_t inputBusMutex = nullptr;
+  bool startInputTask();
+  static void inputTask(void *param);
+  virtual void sampleInput() {}
+  bool takeInputBus(uint32_t waitMs);
+  void giveInputBus();
+  void markInputConsumed(int64_t sampledUs);
+  void recordInputToPixel(int64_t sampledUs);
+  // Latest touch point from sampleInput(), read by promptKeyboard() instead of the controller
+  portMUX_TYPE touchSampleMux = portMUX_INITIALIZER_UNLOCKED;
+  bool touchSamplePressed = false;
+  int16_t touchSampleX = 0;
+  int16_t touchSampleY = 0;
+  void publishTouchSample(bool pressed, int16_t x, int16_t y);
+  bool readTouchSample(int16_t &x, int16_t &y);
   HardwareSerial *gpsHwUart = NULL;
   SDL_Arduino_INA3221 ina3221;
-  TinyGPSPlus gps;
+  GpsNmeaParser gpsNmea; // parser state, owned by the GPS task (Board320_240_gps.cpp)
+  static constexpr size_t kGpsRxBufferSize = 2048;
+  static constexpr uint8_t kGpsFixQueueLength = 8;
+  QueueHandle_t gpsFixQueue = nullptr;
+  TaskHandle_t gpsTaskHandle = nullptr;
+  uint32_t gpsFixDrops = 0;
+  bool startGpsTask();
+  static void gpsTask(void *param);
+  volatile bool gpsInitRunning = false; // boot baud probe on gpsInitTask, loop keeps off the UART
+  uint8_t gpsInitStage = BootProfiler::kNoStage;
+  void startGpsInitTask();
+  static void gpsInitTask(void *param);
+  void readGpsUart();
+  void pushGpsFix(const GpsFix &fix);
+  GpsBinaryParser gpsBinary; // binary navigation mode (settings.gpsBinaryNav)
+  volatile bool gpsBinaryNavActive = false; // module was switched by configureGpsBinaryNav()
+  bool configureGpsBinaryNav(unsigned long baud);
+  void sendUbxGpsCommand(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t payloadLen);
   char tmpStr1[64];
   char tmpStr2[20];
   char tmpStr3[20];
@@ -198,6 +313,22 @@ protected:
   void sendCasicGpsCommand(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t payloadLen);
   void setGpsV21Pps(bool enabled);
   void updateGpsV21PpsMode();
+  // Power state (Board320_240.cpp)
+  PowerStateMachine powerState;
+  void logPowerTransition(const PowerStateMachine::Transition &transition);
+  void sentryIdleWait(uint32_t maxMs);
+  virtual bool enableTouchWake() { return false; } // light sleep wake source for touch, false = none
+  // Main loop tasks (Board320_240.cpp)
+  LoopScheduler loopScheduler{esp_timer_get_time};
+  void initLoopTasks();
+  void updateCurrentTime();
+  void loopInput();
+  void loopGps();
+  void loopNet();
+  void loopSdcard();
+  void loopPower();
+  void loopDisplay();
+  void loopTripStats();
 
 public:
   byte pinButtonLeft = 0;
@@ -223,7 +354,7 @@ public:
   void sdcardEraseLogs();
   // GPS
   void initGPS();
-  void syncGPS();
+  void syncGPS(const GpsFix &fix);
   void syncTimes(time_t newTime);
   void setGpsTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t seconds);
   // Notwork
@@ -275,6 +406,7 @@ public:
   bool isKeyboardInputActive() const;
   bool isMessageDialogVisible() const;
   bool dismissMessageDialog();
+  void waitDisplayTransfer();
   // Menu
   uint16_t menuItemsCountCurrent();
   void menuScrollByPixels(int16_t deltaTopPx);
@@ -287,5 +419,6 @@ public:
   //
   void loadTestData();
   void printHeapMemory();
+  void trackFramebufferMemory();
   //
 };
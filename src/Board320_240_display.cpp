@@ -1,6 +1,7 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include <math.h>
+#include <esp_heap_caps.h>
 #include "config.h"
 #include "Board320_240.h"
 
@@ -229,10 +230,8 @@ void Board320_240::drawSceneSpeed()
   else
   {
     // Speed
-    spr.setTextSize(2);
     sprintf(tmpStr3, "%01.00f", liveData->km2distance((((liveData->params.speedKmhGPS > 10 && liveData->settings.carSpeedType == CAR_SPEED_TYPE_AUTO) || liveData->settings.carSpeedType == CAR_SPEED_TYPE_GPS) ? liveData->params.speedKmhGPS : ((((liveData->params.speedKmh > 10 && liveData->settings.carSpeedType == CAR_SPEED_TYPE_AUTO) || liveData->settings.carSpeedType == CAR_SPEED_TYPE_CAR)) ? liveData->params.speedKmh : 0))));
-    sprSetFont(fontFont7);
-    sprDrawString(tmpStr3, 200, posy);
+    sprDrawBigNumber(tmpStr3, 200, posy, GLYPH_FACE_FONT7_X2, TR_DATUM, TFT_WHITE);
   }
 
   posy = 140;
@@ -250,8 +249,7 @@ void Board320_240::drawSceneSpeed()
     sprSetFont(fontFont2);
     sprDrawString("kW", 200, posy + 48);
   }
-  sprSetFont(fontFont7);
-  sprDrawString(tmpStr3, 200, posy);
+  sprDrawBigNumber(tmpStr3, 200, posy, GLYPH_FACE_FONT7, TR_DATUM, TFT_WHITE);
 
   // Bottom 2 numbers with charged/discharged kWh from start
   sprSetFont(fontRobotoThin24);
@@ -532,14 +530,11 @@ void Board320_240::drawSceneSpeed()
   spr.fillRect(170, 26, 20, 4, tmpWord);
 
   // Soc%, bat.kWh
-  spr.setTextColor((liveData->params.socPerc <= 15) ? TFT_RED : (liveData->params.socPerc > 80 || (liveData->params.socPerc == -1 && liveData->params.socPerc > 80)) ? TFT_YELLOW
-                                                                                                                                                                     : TFT_GREEN);
-  spr.setTextDatum(BR_DATUM);
+  const uint16_t socColor = (liveData->params.socPerc <= 15) ? TFT_RED : (liveData->params.socPerc > 80 || (liveData->params.socPerc == -1 && liveData->params.socPerc > 80)) ? TFT_YELLOW
+                                                                                                                                                                               : TFT_GREEN;
   sprintf(tmpStr3, (liveData->params.socPerc == -1) ? "n/a" : "%01.00f", liveData->params.socPerc);
-  sprSetFont(fontOrbitronLight32);
-  sprDrawString(tmpStr3, 285, 165);
-  sprSetFont(fontOrbitronLight24);
-  sprDrawString("%", 319, 155);
+  sprDrawBigNumber(tmpStr3, 285, 165, GLYPH_FACE_ORBITRON32, BR_DATUM, socColor);
+  sprDrawBigNumber("%", 319, 155, GLYPH_FACE_ORBITRON24, BR_DATUM, socColor);
   if (liveData->params.socPerc > 0)
   {
     float capacity = liveData->params.batteryTotalAvailableKWh * (liveData->params.socPerc / 100);
@@ -548,13 +543,10 @@ void Board320_240::drawSceneSpeed()
     {
       capacity = (liveData->params.socPerc * 0.615) * (1 + (liveData->params.socPerc * 0.0008));
     }
-    spr.setTextColor(TFT_WHITE);
-    sprSetFont(fontOrbitronLight32);
     sprintf(tmpStr3, "%01.00f", capacity);
-    sprDrawString(tmpStr3, 285, 200);
-    sprSetFont(fontOrbitronLight24);
+    sprDrawBigNumber(tmpStr3, 285, 200, GLYPH_FACE_ORBITRON32, BR_DATUM, TFT_WHITE);
     sprintf(tmpStr3, ".%d", int(10 * (capacity - (int)capacity)));
-    sprDrawString(tmpStr3, 319, 200);
+    sprDrawBigNumber(tmpStr3, 319, 200, GLYPH_FACE_ORBITRON24, BR_DATUM, TFT_WHITE);
     spr.setTextColor(TFT_SILVER);
     sprSetFont(fontFont2);
     sprDrawString("kWh", 319, 174);
@@ -571,6 +563,9 @@ void Board320_240::drawSceneHud()
 {
   float batColor;
 
+  // HUD draws directly to the panel
+  waitDisplayTransfer();
+
   // Change rotation to vertical & mirror
   if (tft.getRotation() != 7)
   {
@@ -735,7 +730,7 @@ void Board320_240::batteryCellsPageMove(bool forward)
  */
 uint8_t Board320_240::debugInfoPageCount()
 {
-  return 2;
+  return 6;
 }
 
 /**
@@ -828,16 +823,18 @@ void Board320_240::drawSceneBatteryCells()
     spr.setTextDatum(TL_DATUM);
   }
 
-  // Find min and max val
-  float minVal = -1, maxVal = -1;
-  for (int i = 0; i < liveData->params.cellCount; i++)
+  // Min/max and spread from shared cell stats (updated by car decoders)
+  CellStats &stats = liveData->cellStats;
+  const uint16_t *cellMv = stats.millivolts();
+  const uint16_t minMv = stats.minMv();
+  const uint16_t maxMv = stats.maxMv();
+  if (stats.validCount() > 1)
   {
-    if ((liveData->params.cellVoltage[i] < minVal || minVal == -1) && liveData->params.cellVoltage[i] != -1)
-      minVal = liveData->params.cellVoltage[i];
-    if ((liveData->params.cellVoltage[i] > maxVal || maxVal == -1) && liveData->params.cellVoltage[i] != -1)
-      maxVal = liveData->params.cellVoltage[i];
-    /*if (liveData->params.cellVoltage[i] > 0 && i > liveData->params.cellCount + 1)
-      liveData->params.cellCount = i + 1;*/
+    spr.setTextDatum(TL_DATUM);
+    spr.setTextColor(TFT_CYAN);
+    sprSetFont(fontFont2);
+    snprintf(tmpStr1, sizeof(tmpStr1), "%01.03fV sd%01.01f dM%u", stats.avgV(), stats.stddevMv(), stats.maxModuleDeltaMv());
+    sprDrawString(tmpStr1, 164, 2);
   }
 
   // Draw cell matrix
@@ -850,9 +847,9 @@ void Board320_240::drawSceneBatteryCells()
     posy = ((localIndex / 8) * 13) + lastPosY + 16;
     sprintf(tmpStr3, "%01.02f", liveData->params.cellVoltage[i]);
     spr.setTextColor(TFT_SILVER);
-    if (liveData->params.cellVoltage[i] == minVal && minVal != maxVal)
+    if (i < CellStats::kMaxCells && cellMv[i] == minMv && minMv != maxMv)
       spr.setTextColor(TFT_RED);
-    if (liveData->params.cellVoltage[i] == maxVal && minVal != maxVal)
+    if (i < CellStats::kMaxCells && cellMv[i] == maxMv && minMv != maxMv)
       spr.setTextColor(TFT_GREEN);
     // Battery cell imbalance detetection
     if (liveData->params.cellVoltage[i] > 1.5 && liveData->params.cellVoltage[i] < 3.0)
@@ -877,9 +874,9 @@ void Board320_240::drawSceneChargingGraph()
   // Determine the maximum kW value to scale the Y-axis properly
   for (int i = 0; i <= 100; i++)
   {
-    if (liveData->params.chargingGraphMaxKw[i] > maxKw)
+    if (liveData->chargingGraph.valid(ChargingGraph::MAX_KW, i) && liveData->chargingGraph.value(ChargingGraph::MAX_KW, i) > maxKw)
     {
-      maxKw = liveData->params.chargingGraphMaxKw[i];
+      maxKw = liveData->chargingGraph.value(ChargingGraph::MAX_KW, i);
     }
   }
 
@@ -944,25 +941,30 @@ void Board320_240::drawSceneChargingGraph()
   }
 
   // Draw real-time values (temperature and kW lines)
+  struct GraphLine
+  {
+    ChargingGraph::Series series;
+    float minValue;
+    uint16_t color;
+  };
+  static const GraphLine kGraphLines[] = {
+      {ChargingGraph::BAT_MIN_C, -10, TFT_BLUE},
+      {ChargingGraph::BAT_MAX_C, -10, TFT_BLUE},
+      {ChargingGraph::COOLANT_C, -10, TFT_PURPLE},
+      {ChargingGraph::HEATER_C, -10, TFT_RED},
+      {ChargingGraph::MIN_KW, 0, TFT_GREENYELLOW},
+      {ChargingGraph::MAX_KW, 0, TFT_YELLOW},
+  };
   for (int i = 0; i <= 100; i++)
   {
-    if (liveData->params.chargingGraphBatMinTempC[i] > -10)
-      spr.drawFastHLine(zeroX + (i * mulX) - (mulX / 2), zeroY - (liveData->params.chargingGraphBatMinTempC[i] * mulY), mulX, TFT_BLUE);
-
-    if (liveData->params.chargingGraphBatMaxTempC[i] > -10)
-      spr.drawFastHLine(zeroX + (i * mulX) - (mulX / 2), zeroY - (liveData->params.chargingGraphBatMaxTempC[i] * mulY), mulX, TFT_BLUE);
-
-    if (liveData->params.chargingGraphWaterCoolantTempC[i] > -10)
-      spr.drawFastHLine(zeroX + (i * mulX) - (mulX / 2), zeroY - (liveData->params.chargingGraphWaterCoolantTempC[i] * mulY), mulX, TFT_PURPLE);
-
-    if (liveData->params.chargingGraphHeaterTempC[i] > -10)
-      spr.drawFastHLine(zeroX + (i * mulX) - (mulX / 2), zeroY - (liveData->params.chargingGraphHeaterTempC[i] * mulY), mulX, TFT_RED);
-
-    if (liveData->params.chargingGraphMinKw[i] > 0)
-      spr.drawFastHLine(zeroX + (i * mulX) - (mulX / 2), zeroY - (liveData->params.chargingGraphMinKw[i] * mulY), mulX, TFT_GREENYELLOW);
-
-    if (liveData->params.chargingGraphMaxKw[i] > 0)
-      spr.drawFastHLine(zeroX + (i * mulX) - (mulX / 2), zeroY - (liveData->params.chargingGraphMaxKw[i] * mulY), mulX, TFT_YELLOW);
+    for (const GraphLine &line : kGraphLines)
+    {
+      if (!liveData->chargingGraph.valid(line.series, i))
+        continue;
+      const float value = liveData->chargingGraph.value(line.series, i);
+      if (value > line.minValue)
+        spr.drawFastHLine(zeroX + (i * mulX) - (mulX / 2), zeroY - (value * mulY), mulX, line.color);
+    }
   }
 
   // Print the charging time
@@ -1253,6 +1255,106 @@ void Board320_240::drawSceneDebug()
     snprintf(tmpStr1, sizeof(tmpStr1), "NET %s FAIL %u VOLT %s", liveData->params.netAvailable ? "OK" : "DOWN", liveData->params.netFailureCount, onOff(liveData->settings.voltmeterEnabled == 1));
     drawLine(tmpStr1);
   }
+  else if (debugInfoPage == 2)
+  {
+    // Performance counters (previous frame; this one is still being composed)
+    snprintf(tmpStr1, sizeof(tmpStr1), "PERF FPS %.1f", displayFps);
+    drawLine(tmpStr1, TFT_WHITE);
+
+    snprintf(tmpStr1, sizeof(tmpStr1), "DMA %s", !displayDmaReady ? "OFF" : (displayDmaAsync ? "ASYNC" : "CHUNKED"));
+    drawLine(tmpStr1);
+
+    snprintf(tmpStr1, sizeof(tmpStr1), "COMPOSE %.1fms", displayComposeUs / 1000.0f);
+    drawLine(tmpStr1);
+
+    snprintf(tmpStr1, sizeof(tmpStr1), "SNAPSHOT %.1fms", displayDmaSnapshotUs / 1000.0f);
+    drawLine(tmpStr1);
+
+    snprintf(tmpStr1, sizeof(tmpStr1), "XFER %.1fms WAIT %.1fms", displayDmaTransferUs / 1000.0f, displayDmaWaitUs / 1000.0f);
+    drawLine(tmpStr1);
+
+    snprintf(tmpStr1, sizeof(tmpStr1), "SPD %.1f DASH %.1f HUD %.1fms", displaySceneUs[SCREEN_SPEED] / 1000.0f,
+             displaySceneUs[SCREEN_DASH] / 1000.0f, displaySceneUs[SCREEN_HUD] / 1000.0f);
+    drawLine(tmpStr1);
+
+    snprintf(tmpStr1, sizeof(tmpStr1), "GLYPHS %luB HIT %lu MISS %lu", static_cast<unsigned long>(glyphAtlasBytes),
+             static_cast<unsigned long>(glyphDrawCount), static_cast<unsigned long>(glyphFallbackCount));
+    drawLine(tmpStr1);
+
+    snprintf(tmpStr1, sizeof(tmpStr1), "INPUT->PX %.1f MAX %.1fms DROP %lu", inputLatencyUs / 1000.0f,
+             inputLatencyMaxUs / 1000.0f, static_cast<unsigned long>(inputQueueDrops));
+    drawLine(tmpStr1);
+  }
+  else if (debugInfoPage == 3)
+  {
+    // Boot timeline, concurrent stages marked with |
+    snprintf(tmpStr1, sizeof(tmpStr1), "BOOT SETUP %lums RESP %lums", static_cast<unsigned long>(bootProfiler.setupMs()),
+             static_cast<unsigned long>(bootProfiler.firstResponseAtMs()));
+    drawLine(tmpStr1, TFT_WHITE);
+
+    for (uint8_t i = 0; i < bootProfiler.stageCount(); i++)
+    {
+      const BootProfiler::Stage &stage = bootProfiler.stage(i);
+      if (stage.endMs == 0)
+        snprintf(tmpStr1, sizeof(tmpStr1), "%s%s @%lu RUN", stage.concurrent ? "| " : "", stage.name,
+                 static_cast<unsigned long>(stage.startMs));
+      else
+        snprintf(tmpStr1, sizeof(tmpStr1), "%s%s @%lu +%lums", stage.concurrent ? "| " : "", stage.name,
+                 static_cast<unsigned long>(stage.startMs), static_cast<unsigned long>(stage.endMs - stage.startMs));
+      drawLine(tmpStr1, stage.concurrent ? TFT_CYAN : TFT_SILVER);
+    }
+  }
+  else if (debugInfoPage == 4)
+  {
+    // Memory budget per subsystem: current/peak kB, allocations per second
+    snprintf(tmpStr1, sizeof(tmpStr1), "MEM INT %luk MAX %luk PS %luk",
+             static_cast<unsigned long>(heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT) / 1024),
+             static_cast<unsigned long>(heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT) / 1024),
+             static_cast<unsigned long>(ESP.getFreePsram() / 1024));
+    drawLine(tmpStr1, TFT_WHITE);
+
+    snprintf(tmpStr1, sizeof(tmpStr1), "LD PAR %u SET %u RAW %u/%u %uB", unsigned(sizeof(liveData->params)),
+             unsigned(sizeof(liveData->settings)), unsigned(liveData->contributeRawFrames.count()),
+             unsigned(liveData->contributeRawFrames.drops()), unsigned(liveData->contributeRawFrames.arenaUsed()));
+    drawLine(tmpStr1);
+
+    for (uint8_t i = 0; i < MEM_TAG_COUNT; i++)
+    {
+      const MemTagStats stats = memTagStats(MemTag(i));
+      snprintf(tmpStr1, sizeof(tmpStr1), "%s %.1f/%.1fk %u/s", memTagName(MemTag(i)), stats.currentBytes / 1024.0f,
+               stats.peakBytes / 1024.0f, stats.allocsPerSec);
+      drawLine(tmpStr1, stats.allocsPerSec > 0 ? TFT_CYAN : TFT_SILVER);
+    }
+
+    snprintf(tmpStr1, sizeof(tmpStr1), "LOOP ALLOC MAX %u OVER %lu", memLoopAllocsMax(),
+             static_cast<unsigned long>(memLoopBudgetOverruns()));
+    drawLine(tmpStr1, memLoopBudgetOverruns() > 0 ? TFT_ORANGE : TFT_SILVER);
+  }
+  else if (debugInfoPage == 5)
+  {
+    // Main loop tasks: last/max ms, budget overruns, deferred runs
+    snprintf(tmpStr1, sizeof(tmpStr1), "LOOP %.1f/%.1fms OVER %lu", loopScheduler.loopLastUs() / 1000.0f,
+             loopScheduler.loopMaxUs() / 1000.0f, static_cast<unsigned long>(loopScheduler.loopOverruns()));
+    drawLine(tmpStr1, TFT_WHITE);
+
+    for (uint8_t i = 0; i < loopScheduler.taskCount(); i++)
+    {
+      const LoopScheduler::Task &task = loopScheduler.task(i);
+      snprintf(tmpStr1, sizeof(tmpStr1), "%s %.1f/%.1fms OV %lu DF %lu", task.name, task.lastUs / 1000.0f, task.maxUs / 1000.0f,
+               static_cast<unsigned long>(task.overruns), static_cast<unsigned long>(task.deferred));
+      drawLine(tmpStr1, task.overruns > 0 ? TFT_ORANGE : TFT_SILVER);
+    }
+
+    // Loop time histogram in % of loops: <1 <2 <5 <10 <20 <50 <100 >=100 ms
+    const uint32_t *bins = loopScheduler.loopHistogram();
+    uint32_t loops = 0;
+    for (uint8_t i = 0; i < LoopScheduler::kHistogramBins; i++)
+      loops += bins[i];
+    int len = snprintf(tmpStr1, sizeof(tmpStr1), "HIST%%");
+    for (uint8_t i = 0; i < LoopScheduler::kHistogramBins && len > 0 && len < int(sizeof(tmpStr1)); i++)
+      len += snprintf(tmpStr1 + len, sizeof(tmpStr1) - len, " %lu", static_cast<unsigned long>(loops == 0 ? 0 : (bins[i] * 100ULL) / loops));
+    drawLine(tmpStr1, TFT_CYAN);
+  }
   else
   {
     if (liveData->settings.gpsHwSerialPort <= 2)
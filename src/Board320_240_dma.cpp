@@ -0,0 +1,264 @@
+/**
+ * Board 320x240 display transfer (DMA)
+ *
+ * Composed frames are streamed to the LCD through two small DMA-capable bounce
+ * buffers in internal RAM. 8bpp sprites are expanded from RGB332 through a
+ * palette LUT line by line, 16bpp sprites are already stored in panel byte order
+ * and are copied as is. Only the visible part of every line is sent, so swipe
+ * previews do not push off-screen pixels.
+ *
+ * With PSRAM the frame is snapshotted and handed to a small transfer task, so the
+ * main loop returns immediately (CAN, net, next frame compose run meanwhile).
+ * Anything that touches the panel or the shared SPI bus directly must call
+ * waitDisplayTransfer() first.
+ */
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include "Board320_240.h"
+
+/**
+ * Allocate bounce buffers, palette and (with PSRAM) the snapshot + transfer task.
+ */
+bool Board320_240::initDisplayDma()
+{
+  if (displayDmaReady)
+  {
+    return true;
+  }
+
+  // RGB332 -> RGB565 (same mapping as TFT_eSPI color8to16), stored byte-swapped for the panel
+  static const uint8_t blue[] = {0, 11, 21, 31};
+  for (uint16_t i = 0; i < 256; i++)
+  {
+    uint16_t color16 = (i & 0xE0) << 8;
+    color16 |= (i & 0xE0) << 5;
+    color16 |= (i & 0x1C) << 6;
+    color16 |= (i & 0x1C) << 3;
+    color16 |= blue[i & 0x03];
+    displayDmaPalette[i] = (color16 >> 8) | (color16 << 8);
+  }
+
+  const size_t bounceBytes = size_t(kDisplayDmaLines) * 320U * sizeof(uint16_t);
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    displayDmaBounce[i] = static_cast<uint16_t *>(heap_caps_malloc(bounceBytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL));
+    if (displayDmaBounce[i] == nullptr)
+    {
+      syslog->println("Display DMA: bounce buffer allocation failed, using blocking push");
+      for (uint8_t j = 0; j < 2; j++)
+      {
+        if (displayDmaBounce[j] != nullptr)
+        {
+          heap_caps_free(displayDmaBounce[j]);
+          displayDmaBounce[j] = nullptr;
+        }
+      }
+      return false;
+    }
+  }
+
+#ifdef BOARD_M5STACK_CORE2
+  if (!tft.initDMA())
+  {
+    syslog->println("Display DMA: SPI DMA init failed, using blocking push");
+    for (uint8_t i = 0; i < 2; i++)
+    {
+      heap_caps_free(displayDmaBounce[i]);
+      displayDmaBounce[i] = nullptr;
+    }
+    return false;
+  }
+#endif // BOARD_M5STACK_CORE2
+
+  // Async transfer needs a stable copy of the frame; only worth it (and affordable) with PSRAM.
+  if (spriteColorDepth == 16 && psramFound())
+  {
+    displayDmaSnapshot = static_cast<uint16_t *>(heap_caps_malloc(320U * 240U * sizeof(uint16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    displayDmaDone = xSemaphoreCreateBinary();
+    if (displayDmaSnapshot != nullptr && displayDmaDone != nullptr &&
+        xTaskCreatePinnedToCore(displayDmaTask, "dispDma", 3072, this, 2, &displayDmaTaskHandle, 0) == pdPASS)
+    {
+      displayDmaAsync = true;
+    }
+    else
+    {
+      syslog->println("Display DMA: async transfer unavailable, using chunked push");
+    }
+  }
+
+  displayDmaReady = true;
+  memTrackSet(MEM_TAG_DMA, (2 * bounceBytes) + (displayDmaSnapshot != nullptr ? 320U * 240U * sizeof(uint16_t) : 0));
+  syslog->print("Display DMA: ");
+  syslog->println(displayDmaAsync ? "async (PSRAM snapshot)" : "chunked");
+  return true;
+}
+
+/**
+ * Block until the in-flight frame transfer (if any) has finished.
+ */
+void Board320_240::waitDisplayTransfer()
+{
+  if (!displayDmaBusy)
+  {
+    return;
+  }
+
+  const int64_t startUs = esp_timer_get_time();
+  while (displayDmaBusy)
+  {
+    // Stale gives from frames nobody waited for are simply consumed here.
+    xSemaphoreTake(displayDmaDone, pdMS_TO_TICKS(100));
+  }
+  displayDmaWaitUs = uint32_t(esp_timer_get_time() - startUs);
+}
+
+/**
+ * Push current sprite to LCD at x,y. Replaces spr.pushSprite() for full frames.
+ */
+void Board320_240::pushSpriteFrame(int16_t x, int16_t y)
+{
+  waitDisplayTransfer();
+
+  // Input consumed since the previous frame is on screen once this frame is
+  const int64_t inputUs = inputPendingUs;
+  inputPendingUs = 0;
+
+  if (!displayDmaReady)
+  {
+    const int64_t startUs = esp_timer_get_time();
+    spr.pushSprite(x, y);
+    displayDmaTransferUs = uint32_t(esp_timer_get_time() - startUs);
+    recordInputToPixel(inputUs);
+    return;
+  }
+
+  // Clip sprite to the panel, only visible line spans are transferred
+  const int16_t frameW = spr.width();
+  const int16_t frameH = spr.height();
+  const int16_t panelW = tft.width();
+  const int16_t panelH = tft.height();
+  const int16_t dstX = (x < 0) ? 0 : x;
+  const int16_t dstY = (y < 0) ? 0 : y;
+  const int16_t visW = ((x + frameW > panelW) ? panelW : (x + frameW)) - dstX;
+  const int16_t visH = ((y + frameH > panelH) ? panelH : (y + frameH)) - dstY;
+  if (visW <= 0 || visH <= 0 || visW > 320)
+  {
+    return;
+  }
+
+#ifdef BOARD_M5STACK_CORE2
+  const uint8_t *frame = static_cast<const uint8_t *>(spr.getPointer());
+#endif // BOARD_M5STACK_CORE2
+#ifdef BOARD_M5STACK_CORES3
+  const uint8_t *frame = static_cast<const uint8_t *>(spr.getBuffer());
+#endif // BOARD_M5STACK_CORES3
+  if (frame == nullptr)
+  {
+    return;
+  }
+
+  const uint8_t bytesPerPixel = (spriteColorDepth == 16) ? 2 : 1;
+  const size_t srcStride = size_t(frameW) * bytesPerPixel;
+  const uint8_t *src = frame + size_t(dstY - y) * srcStride + size_t(dstX - x) * bytesPerPixel;
+
+  if (displayDmaAsync && bytesPerPixel == 2 && size_t(visW) * visH <= 320U * 240U)
+  {
+    // Snapshot visible spans (compacted) and let the transfer task stream them
+    const int64_t startUs = esp_timer_get_time();
+    uint8_t *dst = reinterpret_cast<uint8_t *>(displayDmaSnapshot);
+    const size_t spanBytes = size_t(visW) * 2U;
+    for (int16_t row = 0; row < visH; row++)
+    {
+      memcpy(dst, src, spanBytes);
+      dst += spanBytes;
+      src += srcStride;
+    }
+    displayDmaSnapshotUs = uint32_t(esp_timer_get_time() - startUs);
+
+    displayDmaJobX = dstX;
+    displayDmaJobY = dstY;
+    displayDmaJobW = visW;
+    displayDmaJobH = visH;
+    displayDmaJobInputUs = inputUs;
+    displayDmaBusy = true;
+    xTaskNotifyGive(displayDmaTaskHandle);
+    return;
+  }
+
+  streamFrameToPanel(src, srcStride, bytesPerPixel, dstX, dstY, visW, visH);
+  recordInputToPixel(inputUs);
+}
+
+/**
+ * Stream visible frame lines through the bounce buffers. Chunk N+1 is prepared
+ * while chunk N is being sent by DMA.
+ */
+void Board320_240::streamFrameToPanel(const uint8_t *src, size_t srcStride, uint8_t bytesPerPixel,
+                                      int16_t dstX, int16_t dstY, int16_t visW, int16_t visH)
+{
+  const int64_t startUs = esp_timer_get_time();
+  uint8_t bufferIndex = 0;
+
+  tft.startWrite();
+  for (int16_t row = 0; row < visH; row += kDisplayDmaLines)
+  {
+    const int16_t lines = (visH - row < kDisplayDmaLines) ? (visH - row) : kDisplayDmaLines;
+    uint16_t *out = displayDmaBounce[bufferIndex];
+    uint16_t *outLine = out;
+    for (int16_t line = 0; line < lines; line++)
+    {
+      if (bytesPerPixel == 2)
+      {
+        memcpy(outLine, src, size_t(visW) * 2U);
+      }
+      else
+      {
+        for (int16_t px = 0; px < visW; px++)
+        {
+          outLine[px] = displayDmaPalette[src[px]];
+        }
+      }
+      outLine += visW;
+      src += srcStride;
+    }
+
+#ifdef BOARD_M5STACK_CORE2
+    tft.dmaWait();
+    tft.pushImageDMA(dstX, dstY + row, visW, lines, out);
+#endif // BOARD_M5STACK_CORE2
+#ifdef BOARD_M5STACK_CORES3
+    tft.waitDMA();
+    tft.pushImageDMA(dstX, dstY + row, visW, lines, reinterpret_cast<const lgfx::swap565_t *>(out));
+#endif // BOARD_M5STACK_CORES3
+    bufferIndex ^= 1;
+  }
+#ifdef BOARD_M5STACK_CORE2
+  tft.dmaWait();
+#endif // BOARD_M5STACK_CORE2
+#ifdef BOARD_M5STACK_CORES3
+  tft.waitDMA();
+#endif // BOARD_M5STACK_CORES3
+  tft.endWrite();
+
+  displayDmaTransferUs = uint32_t(esp_timer_get_time() - startUs);
+}
+
+/**
+ * Transfer task, streams snapshotted frames while the main loop keeps running.
+ */
+void Board320_240::displayDmaTask(void *param)
+{
+  Board320_240 *board = static_cast<Board320_240 *>(param);
+  for (;;)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    board->streamFrameToPanel(reinterpret_cast<const uint8_t *>(board->displayDmaSnapshot),
+                              size_t(board->displayDmaJobW) * 2U, 2,
+                              board->displayDmaJobX, board->displayDmaJobY,
+                              board->displayDmaJobW, board->displayDmaJobH);
+    board->recordInputToPixel(board->displayDmaJobInputUs);
+    board->displayDmaBusy = false;
+    xSemaphoreGive(board->displayDmaDone);
+  }
+}
@@ -0,0 +1,357 @@
+/**
+ * Board 320x240 big number glyph atlas
+ *
+ * The large numeric readouts (speed, power, SoC, big dashboard cell) are redrawn
+ * every frame with the same handful of glyphs. Decoding Font7 RLE data or GFX
+ * bitmaps for every digit is the most expensive part of composing those scenes,
+ * so digits are rasterized once at boot into horizontal pixel spans (PSRAM when
+ * available). Drawing a number is then a few span fills per glyph written
+ * straight into the sprite buffer.
+ *
+ * Layout (advance, datum offsets) is measured from the font library itself, so
+ * cached output lands on the same pixels as sprDrawString(). Strings with any
+ * character outside the atlas fall back to the library renderer.
+ */
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include "Board320_240.h"
+
+static const char kGlyphChars[] = "0123456789.-%";
+static constexpr int16_t kGlyphPad = 8;
+
+#ifdef BOARD_M5STACK_CORE2
+typedef TFT_eSprite GlyphCanvas;
+#endif // BOARD_M5STACK_CORE2
+#ifdef BOARD_M5STACK_CORES3
+typedef M5Canvas GlyphCanvas;
+#endif // BOARD_M5STACK_CORES3
+
+/**
+ * Select face font + text size on the scratch canvas
+ */
+static void glyphCanvasSetFace(GlyphCanvas &canvas, uint8_t face)
+{
+  canvas.setTextSize(face == Board320_240::GLYPH_FACE_FONT7_X2 ? 2 : 1);
+#ifdef BOARD_M5STACK_CORE2
+  if (face == Board320_240::GLYPH_FACE_FONT7 || face == Board320_240::GLYPH_FACE_FONT7_X2)
+    canvas.setTextFont(7);
+  else
+    canvas.setFont(face == Board320_240::GLYPH_FACE_ORBITRON32 ? fontOrbitronLight32 : fontOrbitronLight24);
+#endif // BOARD_M5STACK_CORE2
+#ifdef BOARD_M5STACK_CORES3
+  if (face == Board320_240::GLYPH_FACE_FONT7 || face == Board320_240::GLYPH_FACE_FONT7_X2)
+    canvas.setFont(fontFont7bmp);
+  else
+    canvas.setFont(face == Board320_240::GLYPH_FACE_ORBITRON32 ? fontOrbitronLight32 : fontOrbitronLight24);
+#endif // BOARD_M5STACK_CORES3
+}
+
+static int16_t glyphCanvasTextWidth(GlyphCanvas &canvas, const char *text, uint8_t face)
+{
+#ifdef BOARD_M5STACK_CORE2
+  const bool font7 = (face == Board320_240::GLYPH_FACE_FONT7 || face == Board320_240::GLYPH_FACE_FONT7_X2);
+  return canvas.textWidth(text, font7 ? 7 : GFXFF);
+#endif // BOARD_M5STACK_CORE2
+#ifdef BOARD_M5STACK_CORES3
+  (void)face;
+  return canvas.textWidth(text);
+#endif // BOARD_M5STACK_CORES3
+}
+
+static int16_t glyphCanvasFontHeight(GlyphCanvas &canvas, uint8_t face)
+{
+#ifdef BOARD_M5STACK_CORE2
+  const bool font7 = (face == Board320_240::GLYPH_FACE_FONT7 || face == Board320_240::GLYPH_FACE_FONT7_X2);
+  return canvas.fontHeight(font7 ? 7 : GFXFF);
+#endif // BOARD_M5STACK_CORE2
+#ifdef BOARD_M5STACK_CORES3
+  (void)face;
+  return canvas.fontHeight();
+#endif // BOARD_M5STACK_CORES3
+}
+
+static void glyphCanvasDrawString(GlyphCanvas &canvas, const char *text, int32_t x, int32_t y, uint8_t face)
+{
+#ifdef BOARD_M5STACK_CORE2
+  const bool font7 = (face == Board320_240::GLYPH_FACE_FONT7 || face == Board320_240::GLYPH_FACE_FONT7_X2);
+  canvas.drawString(text, x, y, font7 ? 7 : GFXFF);
+#endif // BOARD_M5STACK_CORE2
+#ifdef BOARD_M5STACK_CORES3
+  (void)face;
+  canvas.drawString(text, x, y);
+#endif // BOARD_M5STACK_CORES3
+}
+
+/**
+ * First canvas row with any lit pixel, -1 if empty
+ */
+static int16_t glyphCanvasFirstRow(GlyphCanvas &canvas)
+{
+  for (int16_t y = 0; y < canvas.height(); y++)
+  {
+    for (int16_t x = 0; x < canvas.width(); x++)
+    {
+      if (canvas.readPixel(x, y) != 0)
+      {
+        return y;
+      }
+    }
+  }
+  return -1;
+}
+
+/**
+ * Collect lit pixel runs relative to anchor. With out == nullptr only counts them.
+ */
+static uint16_t glyphCanvasSpans(GlyphCanvas &canvas, int16_t anchorX, int16_t anchorY, Board320_240::GlyphSpan *out)
+{
+  uint16_t count = 0;
+  for (int16_t y = 0; y < canvas.height(); y++)
+  {
+    int16_t runStart = -1;
+    for (int16_t x = 0; x <= canvas.width(); x++)
+    {
+      const bool lit = (x < canvas.width()) && canvas.readPixel(x, y) != 0;
+      if (lit && runStart < 0)
+      {
+        runStart = x;
+      }
+      else if (!lit && runStart >= 0)
+      {
+        if (out != nullptr)
+        {
+          out[count].x = runStart - anchorX;
+          out[count].y = y - anchorY;
+          out[count].len = x - runStart;
+        }
+        count++;
+        runStart = -1;
+      }
+    }
+  }
+  return count;
+}
+
+/**
+ * Rasterize all faces. Called once from afterSetup() after the sprite exists.
+ */
+void Board320_240::initGlyphAtlas()
+{
+  const int64_t startUs = esp_timer_get_time();
+  const uint8_t charCount = sizeof(kGlyphChars) - 1;
+  char text[3] = {0, 0, 0};
+
+  glyphAtlasBytes = 0;
+  for (uint8_t face = 0; face < GLYPH_FACE_COUNT; face++)
+  {
+    GlyphFace &cache = glyphFaces[face];
+    cache.ready = false;
+
+    GlyphCanvas canvas = GlyphCanvas(&tft);
+    glyphCanvasSetFace(canvas, face);
+
+    // Metrics straight from the library: advance = width("cc") - width("c")
+    int16_t maxWidth = 0;
+    for (uint8_t i = 0; i < charCount; i++)
+    {
+      text[0] = kGlyphChars[i];
+      text[1] = 0;
+      cache.glyphs[i].lastWidth = glyphCanvasTextWidth(canvas, text, face);
+      text[1] = kGlyphChars[i];
+      cache.glyphs[i].advance = glyphCanvasTextWidth(canvas, text, face) - cache.glyphs[i].lastWidth;
+      if (cache.glyphs[i].lastWidth > maxWidth)
+        maxWidth = cache.glyphs[i].lastWidth;
+    }
+    const int16_t fontHeight = glyphCanvasFontHeight(canvas, face);
+    if (maxWidth <= 0 || fontHeight <= 0)
+    {
+      continue;
+    }
+
+    // Anchor in the middle band so bottom/middle datums and glyph overhangs stay inside
+    const int16_t anchorX = kGlyphPad;
+    const int16_t anchorY = kGlyphPad + fontHeight;
+    canvas.setColorDepth(8);
+    if (canvas.createSprite(maxWidth + (2 * kGlyphPad), (3 * fontHeight) + (2 * kGlyphPad)) == nullptr)
+    {
+      syslog->println("Glyph atlas: scratch canvas allocation failed");
+      break;
+    }
+    canvas.setTextColor(TFT_WHITE);
+
+    // Vertical shift of left/middle/bottom datums against top datum
+    int16_t firstRow[3];
+    for (uint8_t row = 0; row < 3; row++)
+    {
+      canvas.fillSprite(TFT_BLACK);
+      canvas.setTextDatum(row * 3);
+      glyphCanvasDrawString(canvas, "8", anchorX, anchorY, face);
+      firstRow[row] = glyphCanvasFirstRow(canvas);
+    }
+    for (uint8_t row = 0; row < 3; row++)
+    {
+      cache.rowOffset[row] = firstRow[row] - firstRow[0];
+    }
+
+    // Count pass, then fill pass into one allocation
+    canvas.setTextDatum(TL_DATUM);
+    uint32_t totalSpans = 0;
+    text[1] = 0;
+    for (uint8_t i = 0; i < charCount; i++)
+    {
+      text[0] = kGlyphChars[i];
+      canvas.fillSprite(TFT_BLACK);
+      if (cache.glyphs[i].lastWidth > 0)
+        glyphCanvasDrawString(canvas, text, anchorX, anchorY, face);
+      cache.glyphs[i].spanCount = glyphCanvasSpans(canvas, anchorX, anchorY, nullptr);
+      cache.glyphs[i].firstSpan = totalSpans;
+      totalSpans += cache.glyphs[i].spanCount;
+    }
+
+    const size_t spanBytes = totalSpans * sizeof(GlyphSpan);
+    if (cache.spans != nullptr)
+    {
+      heap_caps_free(cache.spans);
+      cache.spans = nullptr;
+    }
+    if (totalSpans == 0 || totalSpans > 0xFFFF)
+    {
+      canvas.deleteSprite();
+      continue;
+    }
+    cache.spans = static_cast<GlyphSpan *>(heap_caps_malloc(spanBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (cache.spans == nullptr)
+    {
+      cache.spans = static_cast<GlyphSpan *>(heap_caps_malloc(spanBytes, MALLOC_CAP_8BIT));
+    }
+    if (cache.spans == nullptr)
+    {
+      syslog->println("Glyph atlas: span allocation failed");
+      canvas.deleteSprite();
+      continue;
+    }
+
+    for (uint8_t i = 0; i < charCount; i++)
+    {
+      text[0] = kGlyphChars[i];
+      canvas.fillSprite(TFT_BLACK);
+      if (cache.glyphs[i].lastWidth > 0)
+        glyphCanvasDrawString(canvas, text, anchorX, anchorY, face);
+      glyphCanvasSpans(canvas, anchorX, anchorY, cache.spans + cache.glyphs[i].firstSpan);
+    }
+    canvas.deleteSprite();
+
+    cache.ready = true;
+    glyphAtlasBytes += spanBytes;
+  }
+
+  memTrackSet(MEM_TAG_GLYPHS, glyphAtlasBytes);
+  syslog->print("Glyph atlas: ");
+  syslog->print(glyphAtlasBytes);
+  syslog->print(" B, ");
+  syslog->print(uint32_t(esp_timer_get_time() - startUs) / 1000);
+  syslog->println(" ms");
+}
+
+/**
+ * Select face font on the main sprite (library state matches a sprDrawString call).
+ * sprSetFont() keeps lastFont in sync, so an unchanged font skips the font compares.
+ */
+void Board320_240::sprSetGlyphFace(uint8_t face)
+{
+  spr.setTextSize(face == GLYPH_FACE_FONT7_X2 ? 2 : 1);
+  decltype(lastFont) font = fontOrbitronLight24;
+  if (face == GLYPH_FACE_FONT7 || face == GLYPH_FACE_FONT7_X2)
+    font = fontFont7;
+  else if (face == GLYPH_FACE_ORBITRON32)
+    font = fontOrbitronLight32;
+  if (lastFont != font)
+    sprSetFont(font);
+}
+
+/**
+ * Draw number with cached glyphs. Same result as setting datum/color/face and
+ * calling sprDrawString().
+ */
+void Board320_240::sprDrawBigNumber(const char *text, int32_t x, int32_t y, uint8_t face, uint8_t datum, uint16_t color)
+{
+  spr.setTextDatum(datum);
+  spr.setTextColor(color);
+  sprSetGlyphFace(face);
+
+  const GlyphFace &cache = glyphFaces[face];
+  uint8_t index[16];
+  uint8_t length = 0;
+  int32_t width = 0;
+  bool cached = cache.ready && datum <= BR_DATUM && text[0] != 0;
+  for (; cached && text[length] != 0; length++)
+  {
+    const char *pos = strchr(kGlyphChars, text[length]);
+    if (length >= sizeof(index) || pos == nullptr || cache.glyphs[pos - kGlyphChars].lastWidth <= 0)
+    {
+      cached = false;
+      break;
+    }
+    index[length] = pos - kGlyphChars;
+    width += (text[length + 1] != 0) ? cache.glyphs[index[length]].advance : cache.glyphs[index[length]].lastWidth;
+  }
+
+#ifdef BOARD_M5STACK_CORE2
+  uint8_t *frame = static_cast<uint8_t *>(spr.getPointer());
+#endif // BOARD_M5STACK_CORE2
+#ifdef BOARD_M5STACK_CORES3
+  uint8_t *frame = static_cast<uint8_t *>(spr.getBuffer());
+#endif // BOARD_M5STACK_CORES3
+  if (!cached || frame == nullptr)
+  {
+    glyphFallbackCount++;
+    sprDrawString(text, x, y);
+    return;
+  }
+
+  const uint8_t column = datum % 3;
+  int32_t penX = x - ((column == 1) ? (width / 2) : ((column == 2) ? width : 0));
+  const int32_t originY = y + cache.rowOffset[datum / 3];
+  const int32_t frameW = spr.width();
+  const int32_t frameH = spr.height();
+  // Sprite pixel formats: 16bpp byte-swapped RGB565, 8bpp RGB332
+  const uint16_t color16 = (color >> 8) | (color << 8);
+  const uint8_t color8 = ((color & 0xE000) >> 8) | ((color & 0x0700) >> 6) | ((color & 0x0018) >> 3);
+
+  for (uint8_t i = 0; i < length; i++)
+  {
+    const GlyphEntry &glyph = cache.glyphs[index[i]];
+    const GlyphSpan *span = cache.spans + glyph.firstSpan;
+    for (uint16_t s = 0; s < glyph.spanCount; s++, span++)
+    {
+      const int32_t py = originY + span->y;
+      int32_t px = penX + span->x;
+      int32_t len = span->len;
+      if (py < 0 || py >= frameH)
+        continue;
+      if (px < 0)
+      {
+        len += px;
+        px = 0;
+      }
+      if (px + len > frameW)
+        len = frameW - px;
+      if (len <= 0)
+        continue;
+
+      if (spriteColorDepth == 16)
+      {
+        uint16_t *dst = reinterpret_cast<uint16_t *>(frame) + (py * frameW) + px;
+        for (int32_t n = 0; n < len; n++)
+          dst[n] = color16;
+      }
+      else
+      {
+        memset(frame + (py * frameW) + px, color8, len);
+      }
+    }
+    penX += glyph.advance;
+  }
+  glyphDrawCount++;
+}
@@ -0,0 +1,232 @@
+/**
+ * Board 320x240 GPS ingestion
+ *
+ * The UART driver collects bytes into a 2 kB ring buffer (interrupt driven, no
+ * loop involvement). HardwareSerial's receive event wakes a small task which
+ * parses NMEA with GpsNmeaParser and, once per RMC/GGA epoch, pushes a fix
+ * stamped with its UART arrival time into a queue. The main loop applies
+ * the queued fixes in order (syncGPS), so a loop stalled by HTTPS upload or SD
+ * flush only delays them, it no longer loses or ages them.
+ *
+ * At boot, the baud probe and module configuration (initGPS, up to a few
+ * seconds of delays) run on a one-shot task so comm, WiFi and SD init do not
+ * wait for it.
+ *
+ * Optional binary navigation mode (settings.gpsBinaryNav) switches u-blox
+ * modules to UBX NAV-PVT and GPS v2.1 (CASIC) to NAV-PV at 5-10 Hz: ~100 bytes
+ * per fix instead of two NMEA sentences, no text to float parsing and mm/s
+ * speed resolution.
+ */
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "Board320_240.h"
+
+/**
+ * Run initGPS() in background during boot, inline if the task cannot start
+ */
+void Board320_240::startGpsInitTask()
+{
+  gpsInitStage = bootProfiler.begin("gps probe");
+  gpsInitRunning = true;
+  if (xTaskCreatePinnedToCore(gpsInitTask, "gpsInit", 6144, this, 1, nullptr, 0) != pdPASS)
+  {
+    syslog->println("GPS: init task start failed, probing inline");
+    initGPS();
+    bootProfiler.end(gpsInitStage);
+    gpsInitRunning = false;
+  }
+}
+
+void Board320_240::gpsInitTask(void *param)
+{
+  Board320_240 *board = static_cast<Board320_240 *>(param);
+  board->initGPS();
+  board->bootProfiler.end(board->gpsInitStage);
+  board->gpsInitRunning = false;
+  vTaskDelete(nullptr);
+}
+
+/**
+ * Start the parser task; without it the main loop keeps parsing inline.
+ */
+bool Board320_240::startGpsTask()
+{
+  if (gpsHwUart == NULL || gpsTaskHandle != nullptr)
+  {
+    return gpsTaskHandle != nullptr;
+  }
+  if (gpsFixQueue == nullptr)
+  {
+    gpsFixQueue = xQueueCreate(kGpsFixQueueLength, sizeof(GpsFix));
+    if (gpsFixQueue == nullptr)
+    {
+      syslog->println("GPS: fix queue allocation failed");
+      return false;
+    }
+  }
+  if (xTaskCreatePinnedToCore(gpsTask, "gps", 4096, this, 2, &gpsTaskHandle, 0) != pdPASS)
+  {
+    gpsTaskHandle = nullptr;
+    syslog->println("GPS: task start failed, parsing in main loop");
+    return false;
+  }
+
+  gpsHwUart->onReceive([this]()
+                       {
+                         if (gpsTaskHandle != nullptr)
+                           xTaskNotifyGive(gpsTaskHandle);
+                       });
+  syslog->println("GPS: UART task started");
+  return true;
+}
+
+void Board320_240::gpsTask(void *param)
+{
+  Board320_240 *board = static_cast<Board320_240 *>(param);
+  for (;;)
+  {
+    // Woken by UART receive event; timeout only as a safety net for a missed event
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(250));
+    board->readGpsUart();
+  }
+}
+
+/**
+ * Drain UART ring buffer into the parser
+ */
+void Board320_240::readGpsUart()
+{
+  if (gpsHwUart == NULL)
+  {
+    return;
+  }
+  while (gpsHwUart->available())
+  {
+    const int ch = gpsHwUart->read();
+    if (ch < 0)
+    {
+      break;
+    }
+    const int64_t arrivalUs = esp_timer_get_time();
+    if (gpsBinaryNavActive)
+    {
+      // Binary fixes; NMEA still parsed for the CASIC date/time (RMC at 1 Hz)
+      if (gpsBinary.encode(uint8_t(ch)))
+      {
+        pushGpsFix(gpsNmea.binaryFix(gpsBinary.nav(), arrivalUs));
+      }
+      gpsNmea.encode(char(ch), arrivalUs);
+      continue;
+    }
+    syslog->infoNolf(DEBUG_GPS, char(ch));
+    if (gpsNmea.encode(char(ch), arrivalUs))
+    {
+      pushGpsFix(gpsNmea.fix());
+    }
+  }
+}
+
+/**
+ * Queue a fix for the main loop (oldest fix dropped when full)
+ */
+void Board320_240::pushGpsFix(const GpsFix &fix)
+{
+  if (gpsFixQueue == nullptr)
+  {
+    return;
+  }
+
+  if (xQueueSend(gpsFixQueue, &fix, 0) != pdTRUE)
+  {
+    GpsFix dropped;
+    xQueueReceive(gpsFixQueue, &dropped, 0);
+    xQueueSend(gpsFixQueue, &fix, 0);
+    gpsFixDrops++;
+  }
+}
+
+/**
+ * Send UBX command (sync, header and Fletcher checksum added here)
+ */
+void Board320_240::sendUbxGpsCommand(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t payloadLen)
+{
+  if (gpsHwUart == NULL || payloadLen > 48)
+  {
+    return;
+  }
+
+  uint8_t command[56];
+  command[0] = 0xB5;
+  command[1] = 0x62;
+  command[2] = msgClass;
+  command[3] = msgId;
+  command[4] = payloadLen & 0xFF;
+  command[5] = (payloadLen >> 8) & 0xFF;
+  for (uint16_t i = 0; i < payloadLen; i++)
+  {
+    command[6 + i] = payload[i];
+  }
+  uint8_t ckA, ckB;
+  GpsBinaryParser::ubxChecksum(command + 2, payloadLen + 4, ckA, ckB);
+  command[6 + payloadLen] = ckA;
+  command[7 + payloadLen] = ckB;
+  gpsHwUart->write(command, payloadLen + 8);
+  delay(60);
+}
+
+/**
+ * Switch module output to binary navigation messages (RAM only, module boots in NMEA
+ * again so baud auto-detect keeps working). Rate limited by UART bandwidth.
+ * The UART is decoded as binary only after this returned true, so toggling the
+ * setting takes effect with the next GPS init and other modules stay on NMEA.
+ */
+bool Board320_240::configureGpsBinaryNav(unsigned long baud)
+{
+  const uint16_t periodMs = (baud >= 38400) ? 100 : 200;
+
+  if (liveData->settings.gpsModuleType == GPS_MODULE_TYPE_NEO_M8N ||
+      liveData->settings.gpsModuleType == GPS_MODULE_TYPE_M5_GNSS)
+  {
+    // CFG-MSG (current port): NAV-PVT every fix, NMEA GGA/RMC off
+    const uint8_t navPvtOn[] = {0x01, 0x07, 0x01};
+    const uint8_t ggaOff[] = {0xF0, 0x00, 0x00};
+    const uint8_t rmcOff[] = {0xF0, 0x04, 0x00};
+    sendUbxGpsCommand(0x06, 0x01, navPvtOn, sizeof(navPvtOn));
+    sendUbxGpsCommand(0x06, 0x01, ggaOff, sizeof(ggaOff));
+    sendUbxGpsCommand(0x06, 0x01, rmcOff, sizeof(rmcOff));
+    // CFG-RATE: measurement period, 1 nav solution per measurement, UTC
+    const uint8_t rate[] = {uint8_t(periodMs & 0xFF), uint8_t(periodMs >> 8), 0x01, 0x00, 0x01, 0x00};
+    sendUbxGpsCommand(0x06, 0x08, rate, sizeof(rate));
+  }
+  else if (liveData->settings.gpsModuleType == GPS_MODULE_TYPE_GPS_V21_GNSS)
+  {
+    // Fix rate, then RMC only every 10th fix (date/time), CFG-MSG NAV-PV every fix
+    char command[32];
+    snprintf(command, sizeof(command), "PCAS02,%u", periodMs);
+    uint8_t checksum = 0;
+    for (const char *p = command; *p != '\0'; p++)
+    {
+      checksum ^= uint8_t(*p);
+    }
+    gpsHwUart->printf("$%s*%02X\r\n", command, checksum);
+    delay(60);
+    const char *rmcSlow = "PCAS03,0,0,0,0,10,0,0,0";
+    checksum = 0;
+    for (const char *p = rmcSlow; *p != '\0'; p++)
+    {
+      checksum ^= uint8_t(*p);
+    }
+    gpsHwUart->printf("$%s*%02X\r\n", rmcSlow, checksum);
+    delay(60);
+    const uint8_t navPvOn[] = {0x01, 0x03, 0x01, 0x00};
+    sendCasicGpsCommand(0x06, 0x01, navPvOn, sizeof(navPvOn));
+  }
+  else
+  {
+    return false;
+  }
+
+  syslog->print("GPS binary navigation enabled, period ms: ");
+  syslog->println(periodMs);
+  return true;
+}
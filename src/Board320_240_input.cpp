@@ -0,0 +1,143 @@
+/**
+ * Board 320x240 input task
+ *
+ * Touch and buttons are sampled by a small high priority task at a fixed rate,
+ * independent of how long the main loop is blocked in CAN, network or frame
+ * compose. The board specific sampleInput() timestamps events and pushes them
+ * into a queue; the main loop drains the queue and runs the gesture handlers
+ * with the sample time, so tap/long press/swipe timing does not stretch with
+ * a slow loop.
+ *
+ * Input-to-pixel latency (sample time -> first frame pushed after the event was
+ * handled) is shown on the debug PERF page, with its max over the last 10-20 s.
+ */
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "Board320_240.h"
+
+/**
+ * Start sampling task. Main loop keeps calling M5.update() if this fails.
+ */
+bool Board320_240::startInputTask()
+{
+  if (inputTaskHandle != nullptr)
+  {
+    return true;
+  }
+
+  if (inputBusMutex == nullptr)
+  {
+    inputBusMutex = xSemaphoreCreateMutex();
+  }
+
+  // Above the main loop (1) and display transfer (2), on the loop core next to the touch I2C users
+  if (xTaskCreatePinnedToCore(inputTask, "input", 4096, this, 3, &inputTaskHandle, 1) != pdPASS)
+  {
+    inputTaskHandle = nullptr;
+    syslog->println("Input: task start failed, sampling in main loop");
+    return false;
+  }
+
+  syslog->println("Input: sampling task started");
+  return true;
+}
+
+void Board320_240::inputTask(void *param)
+{
+  Board320_240 *board = static_cast<Board320_240 *>(param);
+  TickType_t lastWake = xTaskGetTickCount();
+  for (;;)
+  {
+    board->sampleInput();
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(kInputSamplePeriodMs));
+  }
+}
+
+/**
+ * Lock the I2C bus of the touch controller against the input task. Mutex
+ * priority inheritance keeps the main loop holder from being starved.
+ * Returns false if the bus stayed busy for waitMs (portMAX_DELAY = no limit),
+ * caller skips its access.
+ */
+bool Board320_240::takeInputBus(uint32_t waitMs)
+{
+  if (inputBusMutex == nullptr)
+  {
+    return true; // no input task, main loop is the only bus user
+  }
+  return xSemaphoreTake(inputBusMutex, (waitMs == portMAX_DELAY) ? portMAX_DELAY : pdMS_TO_TICKS(waitMs)) == pdTRUE;
+}
+
+void Board320_240::giveInputBus()
+{
+  if (inputBusMutex != nullptr)
+  {
+    xSemaphoreGive(inputBusMutex);
+  }
+}
+
+/**
+ * Called by the main loop for every dequeued event before it is handled
+ */
+void Board320_240::markInputConsumed(int64_t sampledUs)
+{
+  if (inputPendingUs == 0)
+  {
+    inputPendingUs = sampledUs;
+  }
+}
+
+/**
+ * Input task: store the current touch point for readTouchSample()
+ */
+void Board320_240::publishTouchSample(bool pressed, int16_t x, int16_t y)
+{
+  portENTER_CRITICAL(&touchSampleMux);
+  touchSamplePressed = pressed;
+  touchSampleX = x;
+  touchSampleY = y;
+  portEXIT_CRITICAL(&touchSampleMux);
+}
+
+/**
+ * Touch point as last sampled by the input task; the controller itself is
+ * only accessed from that task while it runs
+ */
+bool Board320_240::readTouchSample(int16_t &x, int16_t &y)
+{
+  portENTER_CRITICAL(&touchSampleMux);
+  const bool pressed = touchSamplePressed;
+  x = touchSampleX;
+  y = touchSampleY;
+  portEXIT_CRITICAL(&touchSampleMux);
+  return pressed;
+}
+
+/**
+ * Frame containing the reaction to input sampled at sampledUs is on the panel
+ */
+void Board320_240::recordInputToPixel(int64_t sampledUs)
+{
+  if (sampledUs == 0)
+  {
+    return;
+  }
+  const int64_t nowUs = esp_timer_get_time();
+  const uint32_t latencyUs = uint32_t(nowUs - sampledUs);
+  inputLatencyUs = latencyUs;
+  // Windowed max, an old spike (boot, OTA, SD mount) drops out after 10-20 s
+  if (nowUs - inputLatencyWindowStartUs >= kInputLatencyWindowUs)
+  {
+    inputLatencyMaxUs = inputLatencyWindowMaxUs;
+    inputLatencyWindowMaxUs = 0;
+    inputLatencyWindowStartUs = nowUs;
+  }
+  if (latencyUs > inputLatencyWindowMaxUs)
+  {
+    inputLatencyWindowMaxUs = latencyUs;
+  }
+  if (latencyUs > inputLatencyMaxUs)
+  {
+    inputLatencyMaxUs = latencyUs;
+  }
+}
@@ -353,6 +353,10 @@ String Board320_240::menuItemText(int16_t menuItemId, String title)
       suffix = "[unknown]";
     }
     break;
+  case MENU_SLEEP_MODE_SHUTDOWNHRS:
+    sprintf(tmpStr1, "[%d h]", liveData->settings.sleepModeShutdownHrs);
+    suffix = (liveData->settings.sleepModeShutdownHrs == 0) ? "[off]" : tmpStr1;
+    break;
   case MENU_GPS_MODULE_TYPE:
     switch (liveData->settings.gpsModuleType)
     {
@@ -378,6 +382,9 @@ String Board320_240::menuItemText(int16_t menuItemId, String title)
     sprintf(tmpStr1, "[%d bps]", liveData->settings.gpsSerialPortSpeed);
     suffix = tmpStr1;
     break;
+  case MENU_GPS_BINARY_NAV:
+    suffix = (liveData->settings.gpsBinaryNav == 1) ? "[on]" : "[off]";
+    break;
   case MENU_CAR_SPEED_TYPE:
     switch (liveData->settings.carSpeedType)
     {
@@ -772,7 +779,7 @@ void Board320_240::showMenu()
     spr.fillRoundRect(scrollTrackX, thumbY, scrollTrackW, thumbH, 1, scrollThumbColor);
   }
 
-  spr.pushSprite(0, -renderOffsetY);
+  pushSpriteFrame(0, -renderOffsetY);
 }
 
 /**
@@ -1168,6 +1175,7 @@ void Board320_240::menuItemClick()
     // Screen orientation
     case MENU_SCREEN_ROTATION:
       liveData->settings.displayRotation = (liveData->settings.displayRotation == 1) ? 3 : 1;
+      waitDisplayTransfer();
       tft.setRotation(liveData->settings.displayRotation);
       showMenu();
       return;
@@ -1203,6 +1211,12 @@ void Board320_240::menuItemClick()
       showMenu();
       return;
       break;
+    case MENU_SLEEP_MODE_SHUTDOWNHRS:
+      // Cycle through: off (default), 12, 24 ... 72 hours of screen-only Sentry before deep sleep.
+      liveData->settings.sleepModeShutdownHrs = (liveData->settings.sleepModeShutdownHrs >= 72) ? 0 : (liveData->settings.sleepModeShutdownHrs / 12 + 1) * 12;
+      showMenu();
+      return;
+      break;
     case MENU_SCREEN_BRIGHTNESS:
       liveData->settings.lcdBrightness += 20;
       if (liveData->settings.lcdBrightness > 100)
@@ -1414,6 +1428,11 @@ void Board320_240::menuItemClick()
       showMenu();
       return;
       break;
+    case MENU_GPS_BINARY_NAV:
+      liveData->settings.gpsBinaryNav = (liveData->settings.gpsBinaryNav == 1) ? 0 : 1;
+      showMenu();
+      return;
+      break;
     case MENU_SERIAL_CONSOLE:
       liveData->settings.serialConsolePort = (liveData->settings.serialConsolePort == 0) ? 255 : liveData->settings.serialConsolePort + 1;
       showMenu();
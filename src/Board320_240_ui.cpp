@@ -10,6 +10,7 @@
 
 void Board320_240::showBootProgress(const char *step, const char *detail, uint16_t bgColor)
 {
+  waitDisplayTransfer();
   tft.fillScreen(bgColor);
   tft.setTextColor(TFT_WHITE, bgColor);
   tft.setTextDatum(TL_DATUM);
@@ -154,6 +155,7 @@ bool Board320_240::ensureMenuBackbuffer()
     return true;
   }
 
+  waitDisplayTransfer();
   spr.deleteSprite();
   spr.setColorDepth(spriteColorDepth);
   if (spr.createSprite(320, 240 + (menuBackbufferOverscanPx * 2)) == nullptr)
@@ -165,10 +167,12 @@ bool Board320_240::ensureMenuBackbuffer()
     {
       liveData->params.spriteInit = false;
     }
+    trackFramebufferMemory();
     return false;
   }
 
   menuBackbufferActive = true;
+  trackFramebufferMemory();
   return true;
 }
 
@@ -179,12 +183,14 @@ void Board320_240::releaseMenuBackbuffer()
     return;
   }
 
+  waitDisplayTransfer();
   spr.deleteSprite();
   spr.setColorDepth(spriteColorDepth);
   if (spr.createSprite(320, 240) == nullptr)
   {
     liveData->params.spriteInit = false;
   }
+  trackFramebufferMemory();
   menuBackbufferActive = false;
 }
 
@@ -220,6 +226,7 @@ void Board320_240::setBrightness()
     if (blankScreenStartMs == 0)
     {
       blankScreenStartMs = nowMs;
+      waitDisplayTransfer();
       tft.fillScreen(TFT_BLACK);
     }
     if (nowMs - blankScreenStartMs >= 5000U)
@@ -272,6 +279,7 @@ void Board320_240::displayMessage(const char *row1, const char *row2)
 
 void Board320_240::displayMessage(const char *row1, const char *row2, const char *row3)
 {
+  waitDisplayTransfer();
   const uint16_t height = tft.height();
   const uint16_t width = tft.width();
   const char *rows[3] = {row1, row2, row3};
@@ -316,7 +324,7 @@ void Board320_240::displayMessage(const char *row1, const char *row2, const char
         textY += 32;
       }
     }
-    spr.pushSprite(0, 0);
+    pushSpriteFrame(0, 0);
   }
   else
   {
@@ -350,6 +358,7 @@ void Board320_240::displayMessage(const char *row1, const char *row2, const char
  */
 bool Board320_240::confirmMessage(const char *row1, const char *row2)
 {
+  waitDisplayTransfer();
   const uint16_t height = tft.height();
   const uint16_t width = tft.width();
   const int16_t dialogW = width - 24;
@@ -395,7 +404,7 @@ bool Board320_240::confirmMessage(const char *row1, const char *row2)
     sprDrawString("YES", btnYesX + btnW / 2, btnY + btnH / 2 + 1);
     spr.setTextColor(TFT_WHITE, noBg);
     sprDrawString("NO", btnNoX + btnW / 2, btnY + btnH / 2 + 1);
-    spr.pushSprite(0, 0);
+    pushSpriteFrame(0, 0);
   }
   else
   {
@@ -493,10 +502,7 @@ void Board320_240::drawBigCell(int32_t x, int32_t y, int32_t w, int32_t h, const
 
     // Main number - kwh on roads, amps on charges
     posy = (y * 60) + 24;
-    spr.setTextColor(fgColor);
-    // sprSetFont(fontOrbitronLight32);
-    sprSetFont(fontFont7);
-    sprDrawString(text, posx, posy);
+    sprDrawBigNumber(text, posx, posy, GLYPH_FACE_FONT7, TR_DATUM, fgColor);
   }
   else
   {
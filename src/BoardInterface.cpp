@@ -8,12 +8,13 @@ It provides methods for:
 ShutdownDevice() - Shuts down the device by disconnecting communications, turning off peripherals, and putting the microcontroller into deep sleep mode.
 It displays a countdown message, reduces the CPU speed, turns off the screen, disables wifi/BT, disconnects the comm interface, and finally puts the ESP32 into deep sleep.
 
-SaveSettings() - Saves settings from the LiveData object into EEPROM flash memory. This persists settings across reboots.
+SaveSettings() - Schedules a save of the LiveData settings into the NVS key/value store (SettingsStore). Only changed fields are written,
+in one debounced commit. This persists settings across reboots.
 
-ResetSettings() - Resets settings to factory defaults, erases EEPROM, and restarts the device.
+ResetSettings() - Resets settings to factory defaults, erases the settings store and legacy EEPROM blob, and restarts the device.
 
-LoadSettings() - Loads settings from EEPROM into the LiveData object on startup. It first initializes the settings struct with default values.
-Then it loads the actual values from EEPROM if they exist. It handles upgrading old format settings.
+LoadSettings() - Loads settings from the store into the LiveData object on startup. It first initializes the settings struct with default values,
+then overlays the stored fields. On first boot with the store empty it imports (and upgrades) the legacy EEPROM blob once.
 
 attachCar() - Attaches a CarInterface object to allow communicating with the car's OBD port.
 
@@ -33,8 +34,94 @@ It handles attaching communications and live data objects. And provides methods
 #include "CommObd2Ble4.h"
 #include "CommObd2Can.h"
 #include "LiveData.h"
+#include "SettingsStore.h"
+#include "SleepWake.h"
 #include "Solarlib.h"
 
+// Persisted settings fields. IDs are storage keys: append only, never renumber or reuse.
+// 23, 25, 28 - deprecated gprsEnabled, remoteUploadEnabled, headlightsReminder (not stored)
+// 42 - sleepModeShutdownHrs with the old 72 h default (not read), opt-in value is stored as 80
+#define EVDASH_SETTINGS_FIELD(id, member, text) SETTINGS_FIELD(SETTINGS_STRUC, id, member, text)
+static const SettingsField kSettingsFields[] = {
+    EVDASH_SETTINGS_FIELD(1, carType, false),
+    EVDASH_SETTINGS_FIELD(2, obdMacAddress, true),
+    EVDASH_SETTINGS_FIELD(3, serviceUUID, true),
+    EVDASH_SETTINGS_FIELD(4, charTxUUID, true),
+    EVDASH_SETTINGS_FIELD(5, charRxUUID, true),
+    EVDASH_SETTINGS_FIELD(6, displayRotation, false),
+    EVDASH_SETTINGS_FIELD(7, distanceUnit, false),
+    EVDASH_SETTINGS_FIELD(8, temperatureUnit, false),
+    EVDASH_SETTINGS_FIELD(9, pressureUnit, false),
+    EVDASH_SETTINGS_FIELD(10, defaultScreen, false),
+    EVDASH_SETTINGS_FIELD(11, lcdBrightness, false),
+    EVDASH_SETTINGS_FIELD(12, voltmeterEnabled, false),
+    EVDASH_SETTINGS_FIELD(13, predrawnChargingGraphs, false),
+    EVDASH_SETTINGS_FIELD(14, commType, false),
+    EVDASH_SETTINGS_FIELD(15, wifiEnabled, false),
+    EVDASH_SETTINGS_FIELD(16, wifiSsid, true),
+    EVDASH_SETTINGS_FIELD(17, wifiPassword, true),
+    EVDASH_SETTINGS_FIELD(18, ntpEnabled, false),
+    EVDASH_SETTINGS_FIELD(19, ntpTimezone, false),
+    EVDASH_SETTINGS_FIELD(20, ntpDaySaveTime, false),
+    EVDASH_SETTINGS_FIELD(21, sdcardEnabled, false),
+    EVDASH_SETTINGS_FIELD(22, sdcardAutstartLog, false),
+    EVDASH_SETTINGS_FIELD(24, gprsApn, true),
+    EVDASH_SETTINGS_FIELD(26, remoteApiUrl, true),
+    EVDASH_SETTINGS_FIELD(27, remoteApiKey, true),
+    EVDASH_SETTINGS_FIELD(29, gpsHwSerialPort, false),
+    EVDASH_SETTINGS_FIELD(30, gprsHwSerialPort, false),
+    EVDASH_SETTINGS_FIELD(31, serialConsolePort, false),
+    EVDASH_SETTINGS_FIELD(32, debugLevel, false),
+    EVDASH_SETTINGS_FIELD(33, sdcardLogIntervalSec, false),
+    EVDASH_SETTINGS_FIELD(34, gprsLogIntervalSec, false),
+    EVDASH_SETTINGS_FIELD(35, sleepModeLevel, false),
+    EVDASH_SETTINGS_FIELD(36, voltmeterCutOff, false),
+    EVDASH_SETTINGS_FIELD(37, voltmeterSleep, false),
+    EVDASH_SETTINGS_FIELD(38, voltmeterWakeUp, false),
+    EVDASH_SETTINGS_FIELD(39, voltmeterBasedSleep, false),
+    EVDASH_SETTINGS_FIELD(40, remoteUploadIntervalSec, false),
+    EVDASH_SETTINGS_FIELD(41, sleepModeIntervalSec, false),
+    EVDASH_SETTINGS_FIELD(43, remoteUploadModuleType, false),
+    EVDASH_SETTINGS_FIELD(44, remoteUploadAbrpIntervalSec, false),
+    EVDASH_SETTINGS_FIELD(45, abrpApiToken, true),
+    EVDASH_SETTINGS_FIELD(46, timezone, false),
+    EVDASH_SETTINGS_FIELD(47, daylightSaving, false),
+    EVDASH_SETTINGS_FIELD(48, rightHandDrive, false),
+    EVDASH_SETTINGS_FIELD(49, wifiSsid2, true),
+    EVDASH_SETTINGS_FIELD(50, wifiPassword2, true),
+    EVDASH_SETTINGS_FIELD(51, backupWifiEnabled, false),
+    EVDASH_SETTINGS_FIELD(52, threading, false),
+    EVDASH_SETTINGS_FIELD(53, speedCorrection, false),
+    EVDASH_SETTINGS_FIELD(54, disableCommandOptimizer, false),
+    EVDASH_SETTINGS_FIELD(55, abrpSdcardLog, false),
+    EVDASH_SETTINGS_FIELD(56, obd2Name, true),
+    EVDASH_SETTINGS_FIELD(57, obd2WifiIp, true),
+    EVDASH_SETTINGS_FIELD(58, obd2WifiPort, false),
+    EVDASH_SETTINGS_FIELD(59, contributeData, false),
+    EVDASH_SETTINGS_FIELD(60, contributeToken, true),
+    EVDASH_SETTINGS_FIELD(61, mqttEnabled, false),
+    EVDASH_SETTINGS_FIELD(62, mqttServer, true),
+    EVDASH_SETTINGS_FIELD(63, mqttId, true),
+    EVDASH_SETTINGS_FIELD(64, mqttUsername, true),
+    EVDASH_SETTINGS_FIELD(65, mqttPassword, true),
+    EVDASH_SETTINGS_FIELD(66, mqttPubTopic, true),
+    EVDASH_SETTINGS_FIELD(67, commandQueueAutoStop, false),
+    EVDASH_SETTINGS_FIELD(68, gpsSerialPortSpeed, false),
+    EVDASH_SETTINGS_FIELD(69, boardPowerMode, false),
+    EVDASH_SETTINGS_FIELD(70, gpsModuleType, false),
+    EVDASH_SETTINGS_FIELD(71, carSpeedType, false),
+    EVDASH_SETTINGS_FIELD(72, contributeJsonType, false),
+    EVDASH_SETTINGS_FIELD(73, traccarEnabled, false),
+    EVDASH_SETTINGS_FIELD(74, traccarServerHost, true),
+    EVDASH_SETTINGS_FIELD(75, traccarServerPort, false),
+    EVDASH_SETTINGS_FIELD(76, relayForMobileEnabled, false),
+    EVDASH_SETTINGS_FIELD(77, relayToken, true),
+    EVDASH_SETTINGS_FIELD(78, relayMobileId, true),
+    EVDASH_SETTINGS_FIELD(79, gpsBinaryNav, false),
+    EVDASH_SETTINGS_FIELD(80, sleepModeShutdownHrs, false),
+};
+#undef EVDASH_SETTINGS_FIELD
+
 /**
  * Set live data
  */
@@ -66,12 +153,17 @@ void BoardInterface::shutdownDevice()
     delay(1000);
   }
 
+  commitSettings();
   setCpuFrequencyMhz(80);
   turnOffScreen();
   // WiFi.disconnect(true);
   // WiFi.mode(WIFI_OFF);
 
   commInterface->disconnectDevice();
+  if (sleepWakeArm(liveData, commInterface->armWakeOnActivity()))
+  {
+    syslog->println("Wake on CAN activity / AUX voltage armed.");
+  }
   // adc_power_off();
   // esp_wifi_stop();
   esp_bt_controller_disable();
@@ -82,13 +174,38 @@ void BoardInterface::shutdownDevice()
 }
 
 /**
- * Save setting to flash memory
+ * Save setting to flash memory (debounced, see settingsLoop)
  */
 void BoardInterface::saveSettings()
 {
-  syslog->println("Settings saved to eeprom.");
-  EEPROM.put(0, liveData->settings);
-  EEPROM.commit();
+  settingsStore.requestCommit(millis());
+}
+
+/**
+ * Write pending settings now
+ */
+void BoardInterface::commitSettings()
+{
+  const uint16_t written = settingsStore.commit();
+  syslog->print("Settings saved, fields written: ");
+  syslog->println(written);
+}
+
+/**
+ * Commit settings once they stay unchanged for a while (one write per menu session)
+ */
+void BoardInterface::settingsLoop()
+{
+  if (settingsStore.isDirty())
+  {
+    const uint32_t writesBefore = settingsStore.fieldWrites();
+    settingsStore.loop(millis());
+    if (!settingsStore.isDirty())
+    {
+      syslog->print("Settings saved, fields written: ");
+      syslog->println(settingsStore.fieldWrites() - writesBefore);
+    }
+  }
 }
 
 /**
@@ -97,6 +214,9 @@ void BoardInterface::saveSettings()
 void BoardInterface::resetSettings()
 {
   syslog->println("Factory reset.");
+  settingsStore.erase();
+  // Invalidate legacy blob too, otherwise next boot imports it again
+  EEPROM.begin(sizeof(SETTINGS_STRUC));
   liveData->settings.initFlag = 1;
   EEPROM.put(0, liveData->settings);
   EEPROM.commit();
@@ -167,7 +287,7 @@ void BoardInterface::loadSettings()
   liveData->settings.voltmeterWakeUp = 13.0;
   liveData->settings.remoteUploadIntervalSec = 60;
   liveData->settings.sleepModeIntervalSec = 30;
-  liveData->settings.sleepModeShutdownHrs = 72;
+  liveData->settings.sleepModeShutdownHrs = 0;
   liveData->settings.remoteUploadModuleType = REMOTE_UPLOAD_WIFI;
   liveData->settings.remoteUploadAbrpIntervalSec = 0;
   tmpStr = "empty";
@@ -236,18 +356,119 @@ void BoardInterface::loadSettings()
   tmpStr.toCharArray(liveData->settings.traccarServerHost, tmpStr.length() + 1);
   liveData->settings.traccarServerPort = 5055;
   // v25
-  liveData->settings.settingsVersion = SETTINGS_VERSION_CURRENT;
+  liveData->settings.settingsVersion = 25;
   liveData->settings.relayForMobileEnabled = 0;
   liveData->settings.relayToken[0] = '\0';
   liveData->settings.relayMobileId[0] = '\0';
+  // v26
+  liveData->settings.settingsVersion = SETTINGS_VERSION_CURRENT;
+  liveData->settings.gpsBinaryNav = 0;
 
   // Load settings and replace default values
+  settingsStore.begin(&liveData->settings, sizeof(SETTINGS_STRUC), kSettingsFields, sizeof(kSettingsFields) / sizeof(kSettingsFields[0]));
+  if (settingsStore.load())
+  {
+    syslog->print("Settings loaded, fields: ");
+    syslog->println(settingsStore.loadedFields());
+  }
+  else
+  {
+    loadLegacySettings();
+    // One-time import; the EEPROM blob is kept for firmware downgrade
+    settingsStore.commit(true);
+  }
+  liveData->settings.initFlag = 183;
+  liveData->settings.settingsVersion = SETTINGS_VERSION_CURRENT;
+
+  // Defensive: force NUL termination on char[] settings fields loaded from flash,
+  // so a blob corrupted by an older firmware can never be read past the array end
+  // (garbage hostname/SSID DNS queries, issue #123).
+#define EVDASH_TERMINATE_FIELD(f) liveData->settings.f[sizeof(liveData->settings.f) - 1] = '\0'
+  EVDASH_TERMINATE_FIELD(obdMacAddress);
+  EVDASH_TERMINATE_FIELD(serviceUUID);
+  EVDASH_TERMINATE_FIELD(charTxUUID);
+  EVDASH_TERMINATE_FIELD(charRxUUID);
+  EVDASH_TERMINATE_FIELD(wifiSsid);
+  EVDASH_TERMINATE_FIELD(wifiPassword);
+  EVDASH_TERMINATE_FIELD(gprsApn);
+  EVDASH_TERMINATE_FIELD(remoteApiUrl);
+  EVDASH_TERMINATE_FIELD(remoteApiKey);
+  EVDASH_TERMINATE_FIELD(abrpApiToken);
+  EVDASH_TERMINATE_FIELD(wifiSsid2);
+  EVDASH_TERMINATE_FIELD(wifiPassword2);
+  EVDASH_TERMINATE_FIELD(obd2Name);
+  EVDASH_TERMINATE_FIELD(obd2WifiIp);
+  EVDASH_TERMINATE_FIELD(contributeToken);
+  EVDASH_TERMINATE_FIELD(mqttServer);
+  EVDASH_TERMINATE_FIELD(mqttId);
+  EVDASH_TERMINATE_FIELD(mqttUsername);
+  EVDASH_TERMINATE_FIELD(mqttPassword);
+  EVDASH_TERMINATE_FIELD(mqttPubTopic);
+  EVDASH_TERMINATE_FIELD(traccarServerHost);
+  EVDASH_TERMINATE_FIELD(relayToken);
+  EVDASH_TERMINATE_FIELD(relayMobileId);
+#undef EVDASH_TERMINATE_FIELD
+
+  if (liveData->settings.contributeJsonType != CONTRIBUTE_JSON_TYPE_V2)
+  {
+    liveData->settings.contributeJsonType = CONTRIBUTE_JSON_TYPE_V2;
+    saveSettings();
+  }
+
+  if (liveData->settings.remoteUploadModuleType != REMOTE_UPLOAD_WIFI)
+  {
+    liveData->settings.remoteUploadModuleType = REMOTE_UPLOAD_WIFI;
+    saveSettings();
+  }
+
+  if (liveData->settings.traccarEnabled > 1)
+  {
+    liveData->settings.traccarEnabled = 0;
+    saveSettings();
+  }
+
+  if (strlen(liveData->settings.traccarServerHost) == 0)
+  {
+    tmpStr = "demo3.traccar.org";
+    tmpStr.toCharArray(liveData->settings.traccarServerHost, tmpStr.length() + 1);
+    saveSettings();
+  }
+  if (liveData->settings.traccarServerPort == 0)
+  {
+    liveData->settings.traccarServerPort = 5055;
+    saveSettings();
+  }
+
+  if (liveData->settings.commType != COMM_TYPE_OBD2_BLE4 &&
+      liveData->settings.commType != COMM_TYPE_CAN_COMMU)
+  {
+    liveData->settings.commType = COMM_TYPE_OBD2_BLE4;
+    saveSettings();
+  }
+
+  syslog->setDebugLevel(liveData->settings.debugLevel);
+}
+
+/**
+ * Import settings from the legacy EEPROM blob, upgrade structure if version differs.
+ * Frozen: new fields only need a kSettingsFields entry and a default in loadSettings().
+ */
+void BoardInterface::loadLegacySettings()
+{
   syslog->println("Reading settings from eeprom.");
+  // Import-only copy, lives on the heap for the duration of the import instead of in LiveData
+  SETTINGS_STRUC *legacy = static_cast<SETTINGS_STRUC *>(malloc(sizeof(SETTINGS_STRUC)));
+  if (legacy == nullptr)
+  {
+    syslog->println("Settings import: out of memory.");
+    return;
+  }
+  SETTINGS_STRUC &tmpSettings = *legacy;
   EEPROM.begin(sizeof(SETTINGS_STRUC));
-  EEPROM.get(0, liveData->tmpSettings);
+  EEPROM.get(0, tmpSettings);
 
   // Init flash with default settings
-  if (liveData->tmpSettings.initFlag != 183)
+  if (tmpSettings.initFlag != 183)
   {
     syslog->println("Settings not found. Initialization.");
     saveSettings();
@@ -255,268 +476,208 @@ void BoardInterface::loadSettings()
   else
   {
     syslog->print("Loaded settings ver.: ");
-    syslog->println(liveData->tmpSettings.settingsVersion);
+    syslog->println(tmpSettings.settingsVersion);
 
     // Upgrade structure
-    if (liveData->settings.settingsVersion != liveData->tmpSettings.settingsVersion)
+    if (liveData->settings.settingsVersion != tmpSettings.settingsVersion)
     {
-      if (liveData->tmpSettings.settingsVersion == 1)
+      if (tmpSettings.settingsVersion == 1)
       {
-        liveData->tmpSettings.settingsVersion = 2;
-        liveData->tmpSettings.defaultScreen = liveData->settings.defaultScreen;
-        liveData->tmpSettings.lcdBrightness = liveData->settings.lcdBrightness;
+        tmpSettings.settingsVersion = 2;
+        tmpSettings.defaultScreen = liveData->settings.defaultScreen;
+        tmpSettings.lcdBrightness = liveData->settings.lcdBrightness;
       }
-      if (liveData->tmpSettings.settingsVersion == 2)
+      if (tmpSettings.settingsVersion == 2)
       {
-        liveData->tmpSettings.settingsVersion = 3;
-        liveData->tmpSettings.predrawnChargingGraphs = liveData->settings.predrawnChargingGraphs;
+        tmpSettings.settingsVersion = 3;
+        tmpSettings.predrawnChargingGraphs = liveData->settings.predrawnChargingGraphs;
       }
-      if (liveData->tmpSettings.settingsVersion == 3)
+      if (tmpSettings.settingsVersion == 3)
       {
-        liveData->tmpSettings.settingsVersion = 4;
-        liveData->tmpSettings.commType = COMM_TYPE_OBD2_BLE4; // BLE4
-        liveData->tmpSettings.wifiEnabled = 0;
+        tmpSettings.settingsVersion = 4;
+        tmpSettings.commType = COMM_TYPE_OBD2_BLE4; // BLE4
+        tmpSettings.wifiEnabled = 0;
         tmpStr = "empty";
-        tmpStr.toCharArray(liveData->tmpSettings.wifiSsid, tmpStr.length() + 1);
+        tmpStr.toCharArray(tmpSettings.wifiSsid, tmpStr.length() + 1);
         tmpStr = "not_set";
-        tmpStr.toCharArray(liveData->tmpSettings.wifiPassword, tmpStr.length() + 1);
-        liveData->tmpSettings.ntpEnabled = 1;
-        liveData->tmpSettings.ntpTimezone = 1;
-        liveData->tmpSettings.ntpDaySaveTime = 0;
-        liveData->tmpSettings.sdcardEnabled = 0;
-        liveData->tmpSettings.sdcardAutstartLog = 1;
+        tmpStr.toCharArray(tmpSettings.wifiPassword, tmpStr.length() + 1);
+        tmpSettings.ntpEnabled = 1;
+        tmpSettings.ntpTimezone = 1;
+        tmpSettings.ntpDaySaveTime = 0;
+        tmpSettings.sdcardEnabled = 0;
+        tmpSettings.sdcardAutstartLog = 1;
         tmpStr = "internet.t-mobile.cz";
-        tmpStr.toCharArray(liveData->tmpSettings.gprsApn, tmpStr.length() + 1);
+        tmpStr.toCharArray(tmpSettings.gprsApn, tmpStr.length() + 1);
         // Remote upload
         tmpStr = "http://api.example.com";
-        tmpStr.toCharArray(liveData->tmpSettings.remoteApiUrl, tmpStr.length() + 1);
+        tmpStr.toCharArray(tmpSettings.remoteApiUrl, tmpStr.length() + 1);
         tmpStr = "example";
-        tmpStr.toCharArray(liveData->tmpSettings.remoteApiKey, tmpStr.length() + 1);
-        liveData->tmpSettings.headlightsReminder = 0;
+        tmpStr.toCharArray(tmpSettings.remoteApiKey, tmpStr.length() + 1);
+        tmpSettings.headlightsReminder = 0;
       }
-      if (liveData->tmpSettings.settingsVersion == 4)
+      if (tmpSettings.settingsVersion == 4)
       {
-        liveData->tmpSettings.settingsVersion = 5;
-        liveData->tmpSettings.gpsHwSerialPort = 255; // off
+        tmpSettings.settingsVersion = 5;
+        tmpSettings.gpsHwSerialPort = 255; // off
       }
-      if (liveData->tmpSettings.settingsVersion == 5)
+      if (tmpSettings.settingsVersion == 5)
       {
-        liveData->tmpSettings.settingsVersion = 6;
-        liveData->tmpSettings.serialConsolePort = 0; // hwuart0
-        liveData->tmpSettings.debugLevel = 0;        // show all
-        liveData->tmpSettings.sdcardLogIntervalSec = 2;
-        liveData->tmpSettings.gprsLogIntervalSec = 60;
+        tmpSettings.settingsVersion = 6;
+        tmpSettings.serialConsolePort = 0; // hwuart0
+        tmpSettings.debugLevel = 0;        // show all
+        tmpSettings.sdcardLogIntervalSec = 2;
+        tmpSettings.gprsLogIntervalSec = 60;
       }
-      if (liveData->tmpSettings.settingsVersion == 6)
+      if (tmpSettings.settingsVersion == 6)
       {
-        liveData->tmpSettings.settingsVersion = 7;
-        liveData->tmpSettings.sleepModeLevel = SLEEP_MODE_OFF;
+        tmpSettings.settingsVersion = 7;
+        tmpSettings.sleepModeLevel = SLEEP_MODE_OFF;
       }
-      if (liveData->tmpSettings.settingsVersion == 7)
+      if (tmpSettings.settingsVersion == 7)
       {
-        liveData->tmpSettings.settingsVersion = 8;
-        liveData->tmpSettings.voltmeterEnabled = 0;
-        liveData->tmpSettings.voltmeterBasedSleep = 0;
-        liveData->tmpSettings.voltmeterCutOff = 12.0;
-        liveData->tmpSettings.voltmeterSleep = 12.8;
-        liveData->tmpSettings.voltmeterWakeUp = 13.0;
+        tmpSettings.settingsVersion = 8;
+        tmpSettings.voltmeterEnabled = 0;
+        tmpSettings.voltmeterBasedSleep = 0;
+        tmpSettings.voltmeterCutOff = 12.0;
+        tmpSettings.voltmeterSleep = 12.8;
+        tmpSettings.voltmeterWakeUp = 13.0;
       }
-      if (liveData->tmpSettings.settingsVersion == 8)
+      if (tmpSettings.settingsVersion == 8)
       {
-        liveData->tmpSettings.settingsVersion = 9;
-        liveData->tmpSettings.remoteUploadIntervalSec = 60;
-        liveData->tmpSettings.sleepModeIntervalSec = 30;
-        liveData->tmpSettings.sleepModeShutdownHrs = 72;
-        liveData->tmpSettings.remoteUploadModuleType = REMOTE_UPLOAD_WIFI;
+        tmpSettings.settingsVersion = 9;
+        tmpSettings.remoteUploadIntervalSec = 60;
+        tmpSettings.sleepModeIntervalSec = 30;
+        tmpSettings.sleepModeShutdownHrs = 0;
+        tmpSettings.remoteUploadModuleType = REMOTE_UPLOAD_WIFI;
       }
-      if (liveData->tmpSettings.settingsVersion == 9)
+      if (tmpSettings.settingsVersion == 9)
       {
-        liveData->tmpSettings.settingsVersion = 10;
-        liveData->tmpSettings.remoteUploadAbrpIntervalSec = 0;
+        tmpSettings.settingsVersion = 10;
+        tmpSettings.remoteUploadAbrpIntervalSec = 0;
         tmpStr = "empty";
-        tmpStr.toCharArray(liveData->tmpSettings.abrpApiToken, tmpStr.length() + 1);
+        tmpStr.toCharArray(tmpSettings.abrpApiToken, tmpStr.length() + 1);
       }
-      if (liveData->tmpSettings.settingsVersion == 10)
+      if (tmpSettings.settingsVersion == 10)
       {
-        liveData->tmpSettings.settingsVersion = 11;
-        liveData->tmpSettings.timezone = 0;
-        liveData->tmpSettings.daylightSaving = 0;
-        liveData->tmpSettings.rightHandDrive = 0;
+        tmpSettings.settingsVersion = 11;
+        tmpSettings.timezone = 0;
+        tmpSettings.daylightSaving = 0;
+        tmpSettings.rightHandDrive = 0;
       }
-      if (liveData->tmpSettings.settingsVersion == 11)
+      if (tmpSettings.settingsVersion == 11)
       {
-        liveData->tmpSettings.settingsVersion = 12;
+        tmpSettings.settingsVersion = 12;
         tmpStr = "empty";
-        tmpStr.toCharArray(liveData->tmpSettings.wifiSsid2, tmpStr.length() + 1);
+        tmpStr.toCharArray(tmpSettings.wifiSsid2, tmpStr.length() + 1);
         tmpStr = "not_set";
-        tmpStr.toCharArray(liveData->tmpSettings.wifiPassword2, tmpStr.length() + 1);
-        liveData->tmpSettings.backupWifiEnabled = 0;
+        tmpStr.toCharArray(tmpSettings.wifiPassword2, tmpStr.length() + 1);
+        tmpSettings.backupWifiEnabled = 0;
       }
-      if (liveData->tmpSettings.settingsVersion == 12)
+      if (tmpSettings.settingsVersion == 12)
       {
-        liveData->tmpSettings.settingsVersion = 13;
-        liveData->tmpSettings.threading = 0;
-        liveData->tmpSettings.speedCorrection = 0;
+        tmpSettings.settingsVersion = 13;
+        tmpSettings.threading = 0;
+        tmpSettings.speedCorrection = 0;
       }
-      if (liveData->tmpSettings.settingsVersion == 13)
+      if (tmpSettings.settingsVersion == 13)
       {
-        liveData->tmpSettings.settingsVersion = 14;
-        liveData->tmpSettings.disableCommandOptimizer = 0;
+        tmpSettings.settingsVersion = 14;
+        tmpSettings.disableCommandOptimizer = 0;
       }
-      if (liveData->tmpSettings.settingsVersion == 14)
+      if (tmpSettings.settingsVersion == 14)
       {
-        liveData->tmpSettings.settingsVersion = 15;
-        liveData->tmpSettings.abrpSdcardLog = 0;
+        tmpSettings.settingsVersion = 15;
+        tmpSettings.abrpSdcardLog = 0;
       }
-      if (liveData->tmpSettings.settingsVersion == 15)
+      if (tmpSettings.settingsVersion == 15)
       {
-        liveData->tmpSettings.settingsVersion = 16;
+        tmpSettings.settingsVersion = 16;
         tmpStr = "OBD2"; // default BLE4 OBD2 adapter name
-        tmpStr.toCharArray(liveData->tmpSettings.obd2Name, tmpStr.length() + 1);
+        tmpStr.toCharArray(tmpSettings.obd2Name, tmpStr.length() + 1);
         tmpStr = "192.168.0.10"; // legacy obd2wifi adapter ip
-        tmpStr.toCharArray(liveData->tmpSettings.obd2WifiIp, tmpStr.length() + 1);
-        liveData->tmpSettings.obd2WifiPort = 35000;
+        tmpStr.toCharArray(tmpSettings.obd2WifiIp, tmpStr.length() + 1);
+        tmpSettings.obd2WifiPort = 35000;
       }
-      if (liveData->tmpSettings.settingsVersion == 16)
+      if (tmpSettings.settingsVersion == 16)
       {
-        liveData->tmpSettings.settingsVersion = 17;
-        liveData->tmpSettings.contributeData = 1;
+        tmpSettings.settingsVersion = 17;
+        tmpSettings.contributeData = 1;
         tmpStr = "\n";
-        tmpStr.toCharArray(liveData->tmpSettings.contributeToken, tmpStr.length() + 1);
-        liveData->tmpSettings.mqttEnabled = 0;
+        tmpStr.toCharArray(tmpSettings.contributeToken, tmpStr.length() + 1);
+        tmpSettings.mqttEnabled = 0;
         tmpStr = "192.168.0.1";
-        tmpStr.toCharArray(liveData->tmpSettings.mqttServer, tmpStr.length() + 1);
+        tmpStr.toCharArray(tmpSettings.mqttServer, tmpStr.length() + 1);
         tmpStr = "evdash";
-        tmpStr.toCharArray(liveData->tmpSettings.mqttId, tmpStr.length() + 1);
+        tmpStr.toCharArray(tmpSettings.mqttId, tmpStr.length() + 1);
         tmpStr = "evuser";
-        tmpStr.toCharArray(liveData->tmpSettings.mqttUsername, tmpStr.length() + 1);
+        tmpStr.toCharArray(tmpSettings.mqttUsername, tmpStr.length() + 1);
         tmpStr = "evpass";
-        tmpStr.toCharArray(liveData->tmpSettings.mqttPassword, tmpStr.length() + 1);
+        tmpStr.toCharArray(tmpSettings.mqttPassword, tmpStr.length() + 1);
         tmpStr = "evdash/sensors";
-        tmpStr.toCharArray(liveData->tmpSettings.mqttPubTopic, tmpStr.length() + 1);
+        tmpStr.toCharArray(tmpSettings.mqttPubTopic, tmpStr.length() + 1);
       }
-      if (liveData->tmpSettings.settingsVersion == 17)
+      if (tmpSettings.settingsVersion == 17)
       {
-        liveData->tmpSettings.settingsVersion = 18;
-        liveData->tmpSettings.commandQueueAutoStop = 1;
-        liveData->tmpSettings.gpsSerialPortSpeed = 9600;
+        tmpSettings.settingsVersion = 18;
+        tmpSettings.commandQueueAutoStop = 1;
+        tmpSettings.gpsSerialPortSpeed = 9600;
       }
-      if (liveData->tmpSettings.settingsVersion == 18)
+      if (tmpSettings.settingsVersion == 18)
       {
-        liveData->tmpSettings.settingsVersion = 19;
-        liveData->tmpSettings.boardPowerMode = 1;
+        tmpSettings.settingsVersion = 19;
+        tmpSettings.boardPowerMode = 1;
       }
-      if (liveData->tmpSettings.settingsVersion == 19)
+      if (tmpSettings.settingsVersion == 19)
       {
-        liveData->tmpSettings.settingsVersion = 20;
-        liveData->tmpSettings.gpsModuleType = GPS_MODULE_TYPE_NEO_M8N;
+        tmpSettings.settingsVersion = 20;
+        tmpSettings.gpsModuleType = GPS_MODULE_TYPE_NEO_M8N;
       }
-      if (liveData->tmpSettings.settingsVersion == 20)
+      if (tmpSettings.settingsVersion == 20)
       {
-        liveData->tmpSettings.settingsVersion = 21;
-        liveData->tmpSettings.carSpeedType = CAR_SPEED_TYPE_AUTO;
+        tmpSettings.settingsVersion = 21;
+        tmpSettings.carSpeedType = CAR_SPEED_TYPE_AUTO;
       }
-      if (liveData->tmpSettings.settingsVersion == 21)
+      if (tmpSettings.settingsVersion == 21)
       {
-        liveData->tmpSettings.settingsVersion = 22;
-        liveData->tmpSettings.contributeJsonType = CONTRIBUTE_JSON_TYPE_V2;
+        tmpSettings.settingsVersion = 22;
+        tmpSettings.contributeJsonType = CONTRIBUTE_JSON_TYPE_V2;
       }
-      if (liveData->tmpSettings.settingsVersion == 22)
+      if (tmpSettings.settingsVersion == 22)
       {
-        liveData->tmpSettings.settingsVersion = 23;
-        liveData->tmpSettings.traccarEnabled = 0;
+        tmpSettings.settingsVersion = 23;
+        tmpSettings.traccarEnabled = 0;
       }
-      if (liveData->tmpSettings.settingsVersion == 23)
+      if (tmpSettings.settingsVersion == 23)
       {
-        liveData->tmpSettings.settingsVersion = 24;
+        tmpSettings.settingsVersion = 24;
         tmpStr = "demo3.traccar.org";
-        tmpStr.toCharArray(liveData->tmpSettings.traccarServerHost, tmpStr.length() + 1);
-        liveData->tmpSettings.traccarServerPort = 5055;
+        tmpStr.toCharArray(tmpSettings.traccarServerHost, tmpStr.length() + 1);
+        tmpSettings.traccarServerPort = 5055;
+      }
+      if (tmpSettings.settingsVersion == 24)
+      {
+        tmpSettings.settingsVersion = 25;
+        tmpSettings.relayForMobileEnabled = 0;
+        tmpSettings.relayToken[0] = '\0';
+        tmpSettings.relayMobileId[0] = '\0';
       }
-      if (liveData->tmpSettings.settingsVersion == 24)
+      if (tmpSettings.settingsVersion == 25)
       {
-        liveData->tmpSettings.settingsVersion = SETTINGS_VERSION_CURRENT;
-        liveData->tmpSettings.relayForMobileEnabled = 0;
-        liveData->tmpSettings.relayToken[0] = '\0';
-        liveData->tmpSettings.relayMobileId[0] = '\0';
+        tmpSettings.settingsVersion = SETTINGS_VERSION_CURRENT;
+        tmpSettings.gpsBinaryNav = 0;
       }
 
       // Save upgraded structure
-      liveData->settings = liveData->tmpSettings;
+      liveData->settings = tmpSettings;
       saveSettings();
     }
 
     // Apply settings from flash if needed
-    liveData->settings = liveData->tmpSettings;
-  }
-
-  // Defensive: force NUL termination on char[] settings fields loaded from flash,
-  // so a blob corrupted by an older firmware can never be read past the array end
-  // (garbage hostname/SSID DNS queries, issue #123).
-#define EVDASH_TERMINATE_FIELD(f) liveData->settings.f[sizeof(liveData->settings.f) - 1] = '\0'
-  EVDASH_TERMINATE_FIELD(obdMacAddress);
-  EVDASH_TERMINATE_FIELD(serviceUUID);
-  EVDASH_TERMINATE_FIELD(charTxUUID);
-  EVDASH_TERMINATE_FIELD(charRxUUID);
-  EVDASH_TERMINATE_FIELD(wifiSsid);
-  EVDASH_TERMINATE_FIELD(wifiPassword);
-  EVDASH_TERMINATE_FIELD(gprsApn);
-  EVDASH_TERMINATE_FIELD(remoteApiUrl);
-  EVDASH_TERMINATE_FIELD(remoteApiKey);
-  EVDASH_TERMINATE_FIELD(abrpApiToken);
-  EVDASH_TERMINATE_FIELD(wifiSsid2);
-  EVDASH_TERMINATE_FIELD(wifiPassword2);
-  EVDASH_TERMINATE_FIELD(obd2Name);
-  EVDASH_TERMINATE_FIELD(obd2WifiIp);
-  EVDASH_TERMINATE_FIELD(contributeToken);
-  EVDASH_TERMINATE_FIELD(mqttServer);
-  EVDASH_TERMINATE_FIELD(mqttId);
-  EVDASH_TERMINATE_FIELD(mqttUsername);
-  EVDASH_TERMINATE_FIELD(mqttPassword);
-  EVDASH_TERMINATE_FIELD(mqttPubTopic);
-  EVDASH_TERMINATE_FIELD(traccarServerHost);
-  EVDASH_TERMINATE_FIELD(relayToken);
-  EVDASH_TERMINATE_FIELD(relayMobileId);
-#undef EVDASH_TERMINATE_FIELD
-
-  if (liveData->settings.contributeJsonType != CONTRIBUTE_JSON_TYPE_V2)
-  {
-    liveData->settings.contributeJsonType = CONTRIBUTE_JSON_TYPE_V2;
-    saveSettings();
-  }
-
-  if (liveData->settings.remoteUploadModuleType != REMOTE_UPLOAD_WIFI)
-  {
-    liveData->settings.remoteUploadModuleType = REMOTE_UPLOAD_WIFI;
-    saveSettings();
-  }
-
-  if (liveData->settings.traccarEnabled > 1)
-  {
-    liveData->settings.traccarEnabled = 0;
-    saveSettings();
-  }
-
-  if (strlen(liveData->settings.traccarServerHost) == 0)
-  {
-    tmpStr = "demo3.traccar.org";
-    tmpStr.toCharArray(liveData->settings.traccarServerHost, tmpStr.length() + 1);
-    saveSettings();
+    liveData->settings = tmpSettings;
+    // Old blobs carry the 72 h default nobody chose, deep sleep after Sentry is opt-in
+    liveData->settings.sleepModeShutdownHrs = 0;
   }
-  if (liveData->settings.traccarServerPort == 0)
-  {
-    liveData->settings.traccarServerPort = 5055;
-    saveSettings();
-  }
-
-  if (liveData->settings.commType != COMM_TYPE_OBD2_BLE4 &&
-      liveData->settings.commType != COMM_TYPE_CAN_COMMU)
-  {
-    liveData->settings.commType = COMM_TYPE_OBD2_BLE4;
-    saveSettings();
-  }
-
-  syslog->setDebugLevel(liveData->settings.debugLevel);
+  free(legacy);
 }
 
 /**
@@ -545,6 +706,33 @@ void BoardInterface::afterSetup()
   carInterface->setCommInterface(commInterface);
 }
 
+/**
+ * Print boot stages (ms since reset) to serial console
+ */
+void BoardInterface::printBootTimeline()
+{
+  char line[64];
+  syslog->println("Boot timeline (start +duration ms):");
+  for (uint8_t i = 0; i < bootProfiler.stageCount(); i++)
+  {
+    const BootProfiler::Stage &stage = bootProfiler.stage(i);
+    if (stage.endMs == 0)
+    {
+      snprintf(line, sizeof(line), "  %c%-10s %5lu running", stage.concurrent ? '|' : ' ', stage.name,
+               static_cast<unsigned long>(stage.startMs));
+    }
+    else
+    {
+      snprintf(line, sizeof(line), "  %c%-10s %5lu +%lu", stage.concurrent ? '|' : ' ', stage.name,
+               static_cast<unsigned long>(stage.startMs), static_cast<unsigned long>(stage.endMs - stage.startMs));
+    }
+    syslog->println(line);
+  }
+  snprintf(line, sizeof(line), "  setup done %lu, first response %lu", static_cast<unsigned long>(bootProfiler.setupMs()),
+           static_cast<unsigned long>(bootProfiler.firstResponseAtMs()));
+  syslog->println(line);
+}
+
 /**
  * Custom commands
  */
@@ -553,11 +741,13 @@ void BoardInterface::customConsoleCommand(String cmd)
   if (cmd.equals("reboot"))
     ESP.restart();
   if (cmd.equals("saveSettings"))
-    saveSettings();
+    commitSettings();
   if (cmd.equals("factoryReset"))
     resetSettings();
   if (cmd.equals("time"))
     showTime();
+  if (cmd.equals("boot"))
+    printBootTimeline();
   if (cmd.equals("ntpSync"))
     ntpSync();
   if (cmd.equals("ipconfig"))
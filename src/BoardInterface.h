@@ -4,6 +4,8 @@
 #include "LiveData.h"
 #include "CarInterface.h"
 #include "CommInterface.h"
+#include "SettingsStore.h"
+#include "BootProfiler.h"
 class BoardInterface
 {
 
@@ -12,6 +14,8 @@ protected:
   CarInterface *carInterface;
   CommInterface *commInterface;
   bool redrawScreenIsRunning = false;
+  SettingsStore settingsStore;
+  void loadLegacySettings();
 
 public:
   // Screens, buttons
@@ -23,6 +27,7 @@ public:
   bool scanDevices = false;
   bool adapterSearchInProgress = false;
   String sdcardRecordBuffer = "";
+  BootProfiler bootProfiler;
   //
   void setLiveData(LiveData *pLiveData);
   void attachCar(CarInterface *pCarInterface);
@@ -36,6 +41,7 @@ public:
   virtual void enterSleepMode(int secs) = 0;
   virtual bool skipAdapterScan() { return false; };
   bool carCommandAllowed() { return carInterface->commandAllowed(); }
+  void registerCanAcceptance(CanAcceptance &acceptance) { carInterface->registerCanAcceptance(acceptance); }
   void showTime();
   void showNet();
   virtual void setTime(String timestamp);
@@ -56,9 +62,12 @@ public:
   void shutdownDevice();
   virtual void otaUpdate() = 0;
   void saveSettings();
+  void commitSettings();
+  void settingsLoop();
   void resetSettings();
   void loadSettings();
   void customConsoleCommand(String cmd);
+  void printBootTimeline();
   // Sdcard
   virtual bool sdcardMount() { return false; };
   virtual void sdcardToggleRecording() = 0;
@@ -21,6 +21,9 @@ Overall, this initializes the specific hardware on the M5Stack Core2, configures
 #include "BoardInterface.h"
 #include "Board320_240.h"
 #include "BoardM5stackCore2.h"
+#include <esp_timer.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
 
 // GNSS Module with Barometric Pressure, IMU, Magnetometer Sensors (NEO-M9N, BMP280, BMI270, BMM150)
 // https://github.com/m5stack/M5Module-GNSS/blob/main/examples/getSensorData/getSensorData.ino
@@ -53,6 +56,15 @@ bool btnBPressed = false;
 bool btnCPressed = false;
 static BoardM5stackCore2 *core2Board = nullptr;
 
+// Events fired by M5.update() on the input task, handled in boardLoop()
+struct Core2InputEvent
+{
+  Event event;
+  int64_t timeUs;
+};
+static QueueHandle_t inputQueue = nullptr;
+static uint32_t eventTimeMs = 0; // sample time of the event being handled
+
 static constexpr int16_t MENU_DRAG_THRESHOLD_PX = 6;
 static constexpr int16_t TOUCH_TAP_SLOP_PX = 8;
 static constexpr int16_t TOUCH_SWIPE_THRESHOLD_PX = 18;
@@ -127,8 +139,14 @@ void BoardM5stackCore2::afterSetup()
   M5.background.longPressTime = 700;
   M5.background.repeatDelay = 250;
   M5.background.repeatInterval = 250;
-  M5.background.addHandler(eventDisplay, events);
-  M5.Buttons.addHandler(eventDisplay, events);
+  M5.background.addHandler(queueDisplayEvent, events);
+  M5.Buttons.addHandler(queueDisplayEvent, events);
+
+  inputQueue = xQueueCreate(32, sizeof(Core2InputEvent));
+  if (inputQueue != nullptr)
+  {
+    startInputTask();
+  }
 }
 
 /**
@@ -258,6 +276,7 @@ bool BoardM5stackCore2::isButtonPressed(int button)
       int16_t swipeCommitThresholdPx = int16_t((tft.width() * 30) / 100);
       if (swipeCommitThresholdPx < TOUCH_SWIPE_THRESHOLD_PX)
         swipeCommitThresholdPx = TOUCH_SWIPE_THRESHOLD_PX;
+      waitDisplayTransfer();
       tft.setRotation(liveData->settings.displayRotation);
       if (touchSwipeGestureActive)
       {
@@ -444,6 +463,46 @@ bool BoardM5stackCore2::getTouch(int16_t &x, int16_t &y)
   return true;
 }
 
+/**
+ * Input task: M5.update() at a fixed rate
+ */
+void BoardM5stackCore2::sampleInput()
+{
+  M5.update();
+  const bool pressed = M5.Touch.ispressed() && M5.Touch.points > 0 && M5.Touch.point[0].valid();
+  publishTouchSample(pressed, M5.Touch.point[0].x, M5.Touch.point[0].y);
+}
+
+/**
+ * FT6336U touch interrupt (G39, low while touched) wakes sentry light sleep
+ */
+bool BoardM5stackCore2::enableTouchWake()
+{
+  gpio_wakeup_enable(GPIO_NUM_39, GPIO_INTR_LOW_LEVEL);
+  return esp_sleep_enable_gpio_wakeup() == ESP_OK;
+}
+
+/**
+ * Touch/button event from M5.update(), queued with its sample time
+ */
+void BoardM5stackCore2::queueDisplayEvent(Event &e)
+{
+  Core2InputEvent input;
+  input.event = e;
+  input.timeUs = esp_timer_get_time();
+  if (inputQueue == nullptr || core2Board == nullptr || core2Board->inputTaskHandle == nullptr)
+  {
+    // No input task yet, M5.update() runs in boardLoop()
+    eventTimeMs = millis();
+    eventDisplay(e);
+    return;
+  }
+  if (xQueueSend(inputQueue, &input, 0) != pdTRUE)
+  {
+    core2Board->inputQueueDrops++;
+  }
+}
+
 /**
  * Touch screen handler
  */
@@ -520,7 +579,7 @@ void BoardM5stackCore2::eventDisplay(Event &e)
         touchPressed = true;
       }
     }
-    lastTouchTime = millis();
+    lastTouchTime = eventTimeMs;
   }
 
   //  Not take button as touch event only background events
@@ -564,8 +623,8 @@ void BoardM5stackCore2::eventDisplay(Event &e)
       validTap = false;
       touchPressed = true;
     }
-    else if (millis() - lastTouchTime > M5.background.tapTime &&
-             millis() - lastTouchProcessedTime > M5.background.longPressTime)
+    else if (int32_t(eventTimeMs - lastTouchTime) > int32_t(M5.background.tapTime) &&
+             int32_t(eventTimeMs - lastTouchProcessedTime) > int32_t(M5.background.longPressTime))
     {
       if (lastTouchY >= 240)
       {
@@ -642,7 +701,27 @@ void BoardM5stackCore2::enterSleepMode(int secs)
  */
 void BoardM5stackCore2::boardLoop()
 {
-  M5.update();
+  if (inputTaskHandle == nullptr)
+  {
+    M5.update();
+  }
+  else
+  {
+    Core2InputEvent input;
+    Core2InputEvent next;
+    while (xQueueReceive(inputQueue, &input, 0) == pdTRUE)
+    {
+      markInputConsumed(input.timeUs);
+      // Only the newest of consecutive moves matters (swipe preview redraw)
+      if ((input.event.type == E_MOVE || input.event.type == E_DRAGGED) &&
+          xQueuePeek(inputQueue, &next, 0) == pdTRUE && next.event.type == input.event.type)
+      {
+        continue;
+      }
+      eventTimeMs = uint32_t(input.timeUs / 1000);
+      eventDisplay(input.event);
+    }
+  }
   Board320_240::boardLoop();
 
   M5.IMU.getGyroData(&gyroX, &gyroY, &gyroZ);
@@ -683,10 +762,14 @@ bool BoardM5stackCore2::skipAdapterScan()
 {
   bool pressed = false;
 
+  waitDisplayTransfer();
   M5.Lcd.clear(RED);
   for (uint16_t i = 0; i < 2000 * 10; i++)
   {
-    M5.update();
+    if (inputTaskHandle == nullptr)
+      M5.update();
+    else
+      delay(1);
     if (M5.BtnA.isPressed() == true || M5.BtnB.isPressed() == true || M5.BtnC.isPressed() == true ||
         btnAPressed || btnBPressed || btnCPressed)
     {
@@ -23,6 +23,9 @@ public:
   bool getTouch(int16_t &x, int16_t &y) override;
   void enterSleepMode(int secs) override;
   bool skipAdapterScan() override;
+  void sampleInput() override;
+  bool enableTouchWake() override;
+  static void queueDisplayEvent(Event &e);
   static void eventDisplay(Event &e);
   void setTime(String timestamp) override;
   void ntpSync() override;
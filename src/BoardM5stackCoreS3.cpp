@@ -4,6 +4,7 @@
 #include "Board320_240.h"
 #include "BoardM5stackCoreS3.h"
 #include <time.h>
+#include <esp_timer.h>
 // #include "I2C_MPU6886.h"
 
 // Touch screen
@@ -33,6 +34,16 @@ float gyroX = 0.0F;
 float gyroY = 0.0F;
 float gyroZ = 0.0F;
 
+// Touch details sampled on the input task, handled in boardLoop()
+struct S3InputEvent
+{
+  m5::touch_detail_t detail;
+  int64_t timeUs;
+};
+static QueueHandle_t inputQueue = nullptr;
+static m5::touch_state_t lastSampledTouchState = m5::touch_state_t::none;
+static m5::touch_detail_t lastHandledTouch;
+
 /**
  * Init board
  */
@@ -85,6 +96,12 @@ void BoardM5stackCoreS3::afterSetup()
   M5.background.repeatInterval = 250;
   M5.background.addHandler(eventDisplay, events);
   M5.Buttons.addHandler(eventDisplay, events);*/
+
+  inputQueue = xQueueCreate(32, sizeof(S3InputEvent));
+  if (inputQueue != nullptr)
+  {
+    startInputTask();
+  }
 }
 
 /**
@@ -181,6 +198,7 @@ bool BoardM5stackCoreS3::isButtonPressed(int button)
       int16_t swipeCommitThresholdPx = int16_t((tft.width() * 30) / 100);
       if (swipeCommitThresholdPx < TOUCH_SWIPE_THRESHOLD_PX)
         swipeCommitThresholdPx = TOUCH_SWIPE_THRESHOLD_PX;
+      waitDisplayTransfer();
       tft.setRotation(liveData->settings.displayRotation);
       if (touchSwipeGestureActive)
       {
@@ -440,14 +458,99 @@ void BoardM5stackCoreS3::enterSleepMode(int secs)
 
 static m5::touch_state_t prev_state;
 
+/**
+ * Input task: M5.update() at a fixed rate, touch details are queued with timestamp
+ */
+void BoardM5stackCoreS3::sampleInput()
+{
+  if (!takeInputBus(kInputSamplePeriodMs))
+  {
+    return; // IMU/RTC access in progress, sample next period
+  }
+  M5.update();
+  const m5::touch_detail_t detail = CoreS3.Touch.getDetail();
+  giveInputBus();
+  publishTouchSample(detail.isPressed(), detail.x, detail.y);
+  if (detail.state == m5::touch_state_t::none && lastSampledTouchState == m5::touch_state_t::none)
+  {
+    return;
+  }
+  lastSampledTouchState = detail.state;
+
+  S3InputEvent input;
+  input.detail = detail;
+  input.timeUs = esp_timer_get_time();
+  if (xQueueSend(inputQueue, &input, 0) != pdTRUE)
+  {
+    inputQueueDrops++;
+  }
+}
+
 /**
  * Board loop
  */
 void BoardM5stackCoreS3::boardLoop()
 {
-  M5.update();
+  if (inputTaskHandle == nullptr)
+  {
+    // Input task not running (boot), sample here
+    M5.update();
+    handleTouchDetail(CoreS3.Touch.getDetail());
+  }
+  else
+  {
+    S3InputEvent input;
+    bool received = false;
+    S3InputEvent next;
+    while (xQueueReceive(inputQueue, &input, 0) == pdTRUE)
+    {
+      markInputConsumed(input.timeUs);
+      lastHandledTouch = input.detail;
+      received = true;
+      // Coalesce held/moving samples, edges (begin/end) are always handled
+      if ((input.detail.state & 3) == 1 && xQueuePeek(inputQueue, &next, 0) == pdTRUE && (next.detail.state & 3) == 1)
+      {
+        continue;
+      }
+      handleTouchDetail(input.detail);
+    }
+    if (!received)
+    {
+      // Touch is sampled on the input task; replay the held state without its one-shot edge
+      const uint8_t state = lastHandledTouch.state;
+      if ((state & 3) == 2) // *_end
+        lastHandledTouch.state = m5::touch_state_t::none;
+      else if ((state & 3) == 3) // *_begin
+        lastHandledTouch.state = static_cast<m5::touch_state_t>(state & ~2);
+      handleTouchDetail(lastHandledTouch);
+    }
+  }
+
+  Board320_240::boardLoop();
+
+  // Same I2C bus as the touch controller sampled on the input task
+  if (takeInputBus(kInputSamplePeriodMs))
+  {
+    CoreS3.Imu.getGyroData(&gyroX, &gyroY, &gyroZ);
+    CoreS3.Imu.getAccelData(&accX, &accY, &accZ);
+    giveInputBus();
+  }
+
+  if (gyroX != 0.0 || gyroY != 0.0 || gyroZ != 0.0 || accX != 0.0 || accY != 0.0 || accZ != 0.0)
+  {
+    liveData->params.gyroSensorMotion = false;
+    if (abs(gyroX) > 15.0 || abs(gyroY) > 15.0 || abs(gyroZ) > 15.0)
+    {
+      liveData->params.gyroSensorMotion = true;
+    }
+  }
+}
 
-  auto t = CoreS3.Touch.getDetail();
+/**
+ * Touch gesture handling (main loop task)
+ */
+void BoardM5stackCoreS3::handleTouchDetail(const m5::touch_detail_t &t)
+{
   if (isMessageDialogVisible())
   {
     const bool dismissRequested = t.wasClicked() || btnAPressed || btnBPressed || btnCPressed;
@@ -469,20 +572,6 @@ void BoardM5stackCoreS3::boardLoop()
       dismissMessageDialog();
     }
 
-    Board320_240::boardLoop();
-
-    CoreS3.Imu.getGyroData(&gyroX, &gyroY, &gyroZ);
-    CoreS3.Imu.getAccelData(&accX, &accY, &accZ);
-
-    if (gyroX != 0.0 || gyroY != 0.0 || gyroZ != 0.0 || accX != 0.0 || accY != 0.0 || accZ != 0.0)
-    {
-      liveData->params.gyroSensorMotion = false;
-      if (abs(gyroX) > 15.0 || abs(gyroY) > 15.0 || abs(gyroZ) > 15.0)
-      {
-        liveData->params.gyroSensorMotion = true;
-      }
-    }
-
     return;
   }
 
@@ -502,20 +591,6 @@ void BoardM5stackCoreS3::boardLoop()
     btnBPressed = false;
     btnCPressed = false;
 
-    Board320_240::boardLoop();
-
-    CoreS3.Imu.getGyroData(&gyroX, &gyroY, &gyroZ);
-    CoreS3.Imu.getAccelData(&accX, &accY, &accZ);
-
-    if (gyroX != 0.0 || gyroY != 0.0 || gyroZ != 0.0 || accX != 0.0 || accY != 0.0 || accZ != 0.0)
-    {
-      liveData->params.gyroSensorMotion = false;
-      if (abs(gyroX) > 15.0 || abs(gyroY) > 15.0 || abs(gyroZ) > 15.0)
-      {
-        liveData->params.gyroSensorMotion = true;
-      }
-    }
-
     return;
   }
 
@@ -636,20 +711,6 @@ void BoardM5stackCoreS3::boardLoop()
         "___", "drag", "drag_end", "drag_begin"};
     syslog->println(state_name[t.state]);
   }
-
-  Board320_240::boardLoop();
-
-  CoreS3.Imu.getGyroData(&gyroX, &gyroY, &gyroZ);
-  CoreS3.Imu.getAccelData(&accX, &accY, &accZ);
-
-  if (gyroX != 0.0 || gyroY != 0.0 || gyroZ != 0.0 || accX != 0.0 || accY != 0.0 || accZ != 0.0)
-  {
-    liveData->params.gyroSensorMotion = false;
-    if (abs(gyroX) > 15.0 || abs(gyroY) > 15.0 || abs(gyroZ) > 15.0)
-    {
-      liveData->params.gyroSensorMotion = true;
-    }
-  }
 }
 
 /**
@@ -667,10 +728,14 @@ bool BoardM5stackCoreS3::skipAdapterScan()
 {
   bool pressed = false;
 
+  waitDisplayTransfer();
   M5.Lcd.clear(RED);
   for (uint16_t i = 0; i < 2000 * 10; i++)
   {
-    M5.update();
+    if (inputTaskHandle == nullptr)
+      M5.update();
+    else
+      delay(1);
     if (M5.BtnA.isPressed() == true || M5.BtnB.isPressed() == true || M5.BtnC.isPressed() == true ||
         btnAPressed || btnBPressed || btnCPressed)
     {
@@ -697,7 +762,9 @@ void BoardM5stackCoreS3::setTime(String timestamp)
   tm.tm_min = timestamp.substring(14, 16).toInt();
   tm.tm_sec = timestamp.substring(17, 19).toInt();
   time_t t = mktime(&tm);
+  takeInputBus(portMAX_DELAY);
   CoreS3.Rtc.setDateTime(gmtime(&t));
+  giveInputBus();
 
   BoardInterface::setTime(timestamp);
 }
@@ -22,6 +22,8 @@ public:
   bool getTouch(int16_t &x, int16_t &y) override;
   void enterSleepMode(int secs) override;
   bool skipAdapterScan() override;
+  void sampleInput() override;
+  void handleTouchDetail(const m5::touch_detail_t &t);
   //  static void eventDisplay(Event &e);
   void setTime(String timestamp) override;
   void ntpSync() override;
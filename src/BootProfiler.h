@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * Boot timeline.
+ *
+ * mark() closes the current sequential stage and opens the next one,
+ * begin()/end() record a stage running concurrently on another task
+ * (end() is then called from that task). Times are ms since reset.
+ */
+class BootProfiler
+{
+public:
+  static constexpr uint8_t kMaxStages = 16;
+  static constexpr uint8_t kNoStage = 0xFF;
+
+  struct Stage
+  {
+    const char *name;
+    uint32_t startMs;
+    uint32_t endMs; // 0 = still running
+    bool concurrent;
+  };
+
+  void mark(const char *name)
+  {
+    end(current);
+    current = begin(name, false);
+  }
+
+  uint8_t begin(const char *name, bool concurrent = true)
+  {
+    if (count >= kMaxStages)
+    {
+      return kNoStage;
+    }
+    stages[count].name = name;
+    stages[count].startMs = millis();
+    stages[count].endMs = 0;
+    stages[count].concurrent = concurrent;
+    return count++;
+  }
+
+  void end(uint8_t index)
+  {
+    if (index < count && stages[index].endMs == 0)
+    {
+      const uint32_t nowMs = millis();
+      stages[index].endMs = (nowMs > stages[index].startMs) ? nowMs : stages[index].startMs + 1;
+    }
+  }
+
+  // Setup finished (concurrent stages may still be running)
+  void finish()
+  {
+    end(current);
+    current = kNoStage;
+    setupDoneMs = millis();
+  }
+
+  // First response from the car (CAN frame / OBD2 adapter answer)
+  void firstResponse()
+  {
+    if (firstResponseMs == 0)
+    {
+      firstResponseMs = millis();
+    }
+  }
+
+  uint8_t stageCount() const { return count; }
+  const Stage &stage(uint8_t index) const { return stages[index]; }
+  uint32_t setupMs() const { return setupDoneMs; }
+  uint32_t firstResponseAtMs() const { return firstResponseMs; }
+
+private:
+  Stage stages[kMaxStages] = {};
+  volatile uint8_t count = 0;
+  uint8_t current = kNoStage;
+  uint32_t setupDoneMs = 0;
+  volatile uint32_t firstResponseMs = 0;
+};
@@ -0,0 +1,151 @@
+/**
+ * MCP2515 acceptance filters, see CanAcceptance.h.
+ */
+#include "CanAcceptance.h"
+
+/**
+ * IDs are kept sorted, duplicates ignored
+ */
+bool CanAcceptance::addResponseId(uint32_t id)
+{
+  uint8_t pos = 0;
+  while (pos < count && ids[pos] < id)
+    pos++;
+  if (pos < count && ids[pos] == id)
+    return true;
+  if (count >= kMaxIds)
+    return false;
+  for (uint8_t i = count; i > pos; i--)
+    ids[i] = ids[i - 1];
+  ids[pos] = id;
+  count++;
+  return true;
+}
+
+static uint8_t bitCount(uint16_t value)
+{
+  uint8_t bits = 0;
+  for (; value; value &= value - 1)
+    bits++;
+  return bits;
+}
+
+/**
+ * Acceptance masks/filters covering every registered ID.
+ *
+ * Up to 6 IDs get exact filters. Above that IDs are greedily merged into 6
+ * groups (each group keeps the bits its members share), then the 2 + 4 split
+ * over the two RX buffer masks with the fewest accepted IDs is chosen.
+ */
+bool CanAcceptance::filterPlan(CanFilterPlan &plan) const
+{
+  if (count == 0)
+  {
+    return false;
+  }
+  uint16_t base[kMaxIds];
+  uint16_t common[kMaxIds]; // bits equal across the group
+  uint8_t groups = 0;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (ids[i] > 0x7FF)
+    {
+      return false; // extended IDs: leave acceptance open
+    }
+    base[groups] = ids[i];
+    common[groups] = 0x7FF;
+    groups++;
+  }
+
+  while (groups > 6)
+  {
+    uint8_t bestA = 0, bestB = 1;
+    int8_t bestBits = -1;
+    for (uint8_t a = 0; a < groups; a++)
+    {
+      for (uint8_t b = a + 1; b < groups; b++)
+      {
+        const uint16_t merged = common[a] & common[b] & ~(base[a] ^ base[b]) & 0x7FF;
+        const int8_t bits = bitCount(merged);
+        if (bits > bestBits)
+        {
+          bestBits = bits;
+          bestA = a;
+          bestB = b;
+        }
+      }
+    }
+    common[bestA] = common[bestA] & common[bestB] & ~(base[bestA] ^ base[bestB]) & 0x7FF;
+    base[bestB] = base[groups - 1];
+    common[bestB] = common[groups - 1];
+    groups--;
+  }
+
+  // Pick the 2 groups sharing RXB0, the rest share RXB1
+  uint32_t bestCost = 0xFFFFFFFF;
+  uint8_t bestFirst = 0, bestSecond = (groups > 1) ? 1 : 0;
+  for (uint8_t a = 0; a < groups; a++)
+  {
+    for (uint8_t b = a; b < groups; b++)
+    {
+      if (b == a && groups > 1)
+        continue;
+      uint16_t mask0 = common[a] & common[b];
+      uint16_t mask1 = 0x7FF;
+      uint8_t rest = 0;
+      for (uint8_t i = 0; i < groups; i++)
+      {
+        if (i != a && i != b)
+        {
+          mask1 &= common[i];
+          rest++;
+        }
+      }
+      const uint32_t cost = ((a == b ? 1 : 2) << (11 - bitCount(mask0))) + (rest ? (uint32_t(rest) << (11 - bitCount(mask1))) : 0);
+      if (cost < bestCost)
+      {
+        bestCost = cost;
+        bestFirst = a;
+        bestSecond = b;
+      }
+    }
+  }
+
+  plan.mask[0] = common[bestFirst] & common[bestSecond];
+  plan.mask[1] = 0x7FF;
+  plan.filter[0] = base[bestFirst];
+  plan.filter[1] = base[bestSecond];
+  uint8_t slot = 2;
+  for (uint8_t i = 0; i < groups; i++)
+  {
+    if (i != bestFirst && i != bestSecond)
+    {
+      plan.mask[1] &= common[i];
+      plan.filter[slot++] = base[i];
+    }
+  }
+  if (slot == 2)
+  {
+    plan.filter[slot++] = base[bestFirst]; // RXB1 mirrors RXB0
+    plan.mask[1] = plan.mask[0];
+  }
+  while (slot < 6)
+  {
+    plan.filter[slot] = plan.filter[slot - 1];
+    slot++;
+  }
+
+  plan.acceptedIds = 0;
+  for (uint16_t id = 0; id <= 0x7FF; id++)
+  {
+    bool accepted = false;
+    for (uint8_t f = 0; f < 6 && !accepted; f++)
+    {
+      const uint16_t mask = plan.mask[(f < 2) ? 0 : 1];
+      accepted = ((id ^ plan.filter[f]) & mask) == 0;
+    }
+    if (accepted)
+      plan.acceptedIds++;
+  }
+  return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * MCP2515 acceptance filters computed from the CAN IDs a car needs (direct CAN).
+ *
+ * A car registers the diagnostic response IDs it polls
+ * (CarInterface::registerCanAcceptance()). CommObd2Can programs the masks and
+ * filters from that set, so on a car whose OBD port is the live broadcast CAN
+ * the two RX buffers only see replies. Without registered IDs acceptance stays
+ * open.
+ */
+
+// MCP2515 acceptance setup: RXB0 = mask[0] with filter[0..1], RXB1 = mask[1] with filter[2..5]
+struct CanFilterPlan
+{
+  uint16_t mask[2];
+  uint16_t filter[6];
+  uint16_t acceptedIds; // 11-bit IDs passing the plan (registered + collateral)
+};
+
+class CanAcceptance
+{
+public:
+  static constexpr uint8_t kMaxIds = 32;
+
+  void clear() { count = 0; }
+  bool addResponseId(uint32_t id);
+  uint8_t idCount() const { return count; }
+  bool filterPlan(CanFilterPlan &plan) const; // false with extended IDs or an empty set
+
+private:
+  uint32_t ids[kMaxIds]; // sorted
+  uint8_t count = 0;
+};
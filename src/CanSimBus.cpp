@@ -0,0 +1,496 @@
+/**
+ * Software MCP2515 stand-in with a scripted ECU simulator, see CanSimBus.h.
+ */
+#include "CanSimBus.h"
+
+#if defined(EVDASH_CAN_SIM) || defined(EVDASH_BLE_SIM)
+
+#include <Arduino.h>
+#include <mcp_can.h>
+#include <string.h>
+
+static constexpr uint16_t kDefaultLatencyMs = 15;
+static constexpr uint16_t kDefaultJitterMs = 10;
+static constexpr uint16_t kPendingExtraMs = 60; // real answer follows a 7F xx 78 after this
+static constexpr uint8_t kPadByte = 0xAA;
+
+const char *const kCanSimDefaultScript =
+    "# Ioniq 6 AWD 77 demo responses (CarHyundaiEgmp::loadTestData)\n"
+    "PROFILE 7E4 20 10 2 5\n"
+    "PROFILE 7A0 25 15 10 0\n"
+    "PROFILE 7B3 15 5 2 0\n"
+    "NOISE 541 10\n"
+    "NOISE 5A0 100\n"
+    "ATSH770 22BC03 62BC03FDFE20620A600400AAAA\n"
+    "ATSH770 22BC06 62BC06B400006D00000080AAAA\n"
+    "ATSH7D1 220104 620104FFFEFFFC0000000001BD00000000000600277FFF00F0F0F0F0D5FC000011D0FF4AF5FFFB00000000FDFFFAAAAA\n"
+    "ATSH7A0 22C00B 62C00BFFFFFFF80000000002000000000200000000020000000002FFFFFFFFFFFFFFFFFFAAAAAAAAAA\n"
+    "ATSH7B3 220100 6201007F9427C8FF77575100E88F01EEFFFF0FFFB4FFFFFFFFDDFFFF4C7DC4D100FFFF01FFFFFFAAAA\n"
+    "ATSH7C6 22B002 62B002E0000000FFB601FDB8000000AAAAAAAAAA\n"
+    "ATSH7E5 22E011 62E011FFFFFFF801010000006E3A750CEF1BB638F6826051224B006108010101000A000033000700000000000000000000AAAAAAAAAAAA\n"
+    "ATSH7E4 220101 620101EFFBE7EF6E000000000000591BD007050505050505002BB952B99100008D00051D8D00050DFC0003D282000391F20168C7B30002C9000000000665\n"
+    "ATSH7E4 220105 6201051FFB740F012C01012C0605050505050661146162000050120003B61D424C006D0000000000000005050505AAAA\n"
+    "ATSH7E4 220106 62010617F811000D000C000000000000000000000000000500EA000000000000000000000000AAAAAA\n";
+
+static int8_t simHexValue(char ch)
+{
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  return -1;
+}
+
+static bool simIsHex(const char *text, uint16_t length)
+{
+  for (uint16_t i = 0; i < length; i++)
+  {
+    if (simHexValue(text[i]) < 0)
+      return false;
+  }
+  return length > 0 && length % 2 == 0;
+}
+
+static uint8_t simHexByte(const char *text)
+{
+  return uint8_t((simHexValue(text[0]) << 4) | simHexValue(text[1]));
+}
+
+// Next whitespace separated token on the current line
+static const char *simToken(const char *&cursor, uint16_t &length)
+{
+  while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')
+    cursor++;
+  const char *start = cursor;
+  while (*cursor != '\0' && *cursor != '\n' && *cursor != ' ' && *cursor != '\t' && *cursor != '\r')
+    cursor++;
+  length = cursor - start;
+  return start;
+}
+
+static uint32_t simNumber(const char *text, uint16_t length, uint8_t base)
+{
+  uint32_t value = 0;
+  for (uint16_t i = 0; i < length; i++)
+  {
+    const int8_t digit = simHexValue(text[i]);
+    if (digit < 0 || digit >= base)
+      break;
+    value = value * base + digit;
+  }
+  return value;
+}
+
+CanSimBus::CanSimBus(uint32_t seed)
+    : random(seed != 0 ? seed : 1)
+{
+}
+
+uint8_t CanSimBus::begin(uint8_t idMode, uint8_t speed, uint8_t clock)
+{
+  (void)idMode;
+  (void)speed;
+  (void)clock;
+  rxCount = 0;
+  messageLength = 0;
+  messageFlowing = false;
+  sleeping = false;
+  return CAN_OK;
+}
+
+uint8_t CanSimBus::setMode(uint8_t mode)
+{
+  sleeping = (mode == MCP_SLEEP);
+  if (sleeping)
+  {
+    rxCount = 0;
+    messageLength = 0;
+    messageFlowing = false;
+  }
+  return MCP2515_OK;
+}
+
+uint8_t CanSimBus::init_Mask(uint8_t num, uint8_t ext, uint32_t data)
+{
+  (void)ext;
+  if (num < 2)
+    masks[num] = (data >> 16) & 0x7FF; // standard id is written as id << 16
+  return MCP2515_OK;
+}
+
+uint8_t CanSimBus::init_Filt(uint8_t num, uint8_t ext, uint32_t data)
+{
+  (void)ext;
+  if (num < 6)
+    filters[num] = (data >> 16) & 0x7FF;
+  return MCP2515_OK;
+}
+
+/**
+ * Tester -> ECU. Requests are answered from the script, flow control frames
+ * release the consecutive frames of the response in flight.
+ */
+uint8_t CanSimBus::sendMsgBuf(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf)
+{
+  if (sleeping || ext != 0 || len == 0)
+    return CAN_FAILTX;
+
+  const uint8_t frameType = buf[0] >> 4;
+  if (frameType == 3)
+  {
+    if (messageLength != 0 && messageOffset < messageLength && id + 8 == messageId)
+    {
+      messageFlowing = true;
+      messageBlockLeft = buf[1];
+      messageGapMs = (buf[2] <= 0x7F) ? buf[2] : 1; // 0xF1..0xF9 = 100..900 us
+      messageNextMs = millis() + messageGapMs;
+    }
+    return CAN_OK;
+  }
+  if (frameType == 0)
+  {
+    const uint8_t length = buf[0] & 0x0F;
+    if (length > 0 && length < len)
+    {
+      counters.requests++;
+      answer(uint16_t(id), buf + 1, length);
+    }
+  }
+  return CAN_OK;
+}
+
+/**
+ * ECU -> tester. Pops the oldest frame whose time has come.
+ */
+uint8_t CanSimBus::readMsgBuf(unsigned long *id, uint8_t *len, uint8_t *buf)
+{
+  const uint32_t nowMs = millis();
+  generateNoise(nowMs);
+  pumpConsecutive(nowMs);
+  uint8_t best = kRxQueue;
+  for (uint8_t i = 0; i < rxCount; i++)
+  {
+    if (int32_t(nowMs - rxQueue[i].dueMs) < 0)
+      continue;
+    if (best == kRxQueue || int32_t(rxQueue[i].dueMs - rxQueue[best].dueMs) < 0 ||
+        (rxQueue[i].dueMs == rxQueue[best].dueMs && int32_t(rxQueue[i].order - rxQueue[best].order) < 0))
+      best = i;
+  }
+  if (best == kRxQueue)
+  {
+    *id = 0;
+    *len = 0;
+    return CAN_NOMSG;
+  }
+  *id = rxQueue[best].id;
+  *len = 8;
+  memcpy(buf, rxQueue[best].data, 8);
+  rxQueue[best] = rxQueue[--rxCount];
+  return CAN_OK;
+}
+
+uint8_t CanSimBus::checkReceive()
+{
+  const uint32_t nowMs = millis();
+  generateNoise(nowMs);
+  pumpConsecutive(nowMs);
+  for (uint8_t i = 0; i < rxCount; i++)
+  {
+    if (int32_t(nowMs - rxQueue[i].dueMs) >= 0)
+      return CAN_MSGAVAIL;
+  }
+  return CAN_NOMSG;
+}
+
+/**
+ * Parses PROFILE / NOISE / ATSHxxx lines. Response hex is referenced, so the
+ * script must outlive the bus (string literal or a buffer kept by the caller).
+ */
+uint16_t CanSimBus::loadScript(const char *script)
+{
+  uint16_t accepted = 0;
+  const char *cursor = script;
+  while (*cursor != '\0')
+  {
+    uint16_t length;
+    const char *word = simToken(cursor, length);
+    if (length >= 7 && strncmp(word, "ATSH", 4) == 0)
+    {
+      const uint16_t requestId = simNumber(word + 4, length - 4, 16);
+      uint16_t requestLength;
+      const char *request = simToken(cursor, requestLength);
+      uint16_t responseLength;
+      const char *response = simToken(cursor, responseLength);
+      accepted += addResponse(requestId, request, requestLength, response, responseLength) ? 1 : 0;
+    }
+    else if (length == 7 && strncmp(word, "PROFILE", 7) == 0)
+    {
+      uint16_t values[5];
+      for (uint8_t i = 0; i < 5; i++)
+      {
+        uint16_t valueLength;
+        const char *value = simToken(cursor, valueLength);
+        values[i] = simNumber(value, valueLength, (i == 0) ? 16 : 10);
+      }
+      accepted += setProfile(values[0], values[1], values[2], values[3], values[4]) ? 1 : 0;
+    }
+    else if (length == 5 && strncmp(word, "NOISE", 5) == 0)
+    {
+      uint16_t idLength;
+      const char *id = simToken(cursor, idLength);
+      uint16_t periodLength;
+      const char *period = simToken(cursor, periodLength);
+      accepted += addNoise(simNumber(id, idLength, 16), simNumber(period, periodLength, 10)) ? 1 : 0;
+    }
+    // Skip the rest of the line (comments, unknown keywords)
+    while (*cursor != '\0' && *cursor != '\n')
+      cursor++;
+    if (*cursor == '\n')
+      cursor++;
+  }
+  return accepted;
+}
+
+bool CanSimBus::addResponse(uint16_t requestId, const char *request, const char *response)
+{
+  return addResponse(requestId, request, strlen(request), response, strlen(response));
+}
+
+bool CanSimBus::addResponse(uint16_t requestId, const char *request, uint16_t requestLength, const char *response, uint16_t responseLength)
+{
+  if (requestLength > 12 || !simIsHex(request, requestLength) || !simIsHex(response, responseLength) ||
+      responseLength / 2 > kMaxMessage || responseCount >= kMaxResponses)
+  {
+    return false;
+  }
+  Response &entry = responses[responseCount++];
+  entry.requestId = requestId;
+  entry.requestLength = requestLength / 2;
+  for (uint8_t i = 0; i < entry.requestLength; i++)
+    entry.request[i] = simHexByte(request + i * 2);
+  entry.hex = response;
+  entry.hexLength = responseLength;
+  return true;
+}
+
+bool CanSimBus::setProfile(uint16_t requestId, uint16_t latencyMs, uint16_t jitterMs, uint8_t lossPerc, uint8_t pendingPerc)
+{
+  Ecu *ecu = nullptr;
+  for (uint8_t i = 0; i < ecuCount; i++)
+  {
+    if (ecus[i].requestId == requestId)
+      ecu = &ecus[i];
+  }
+  if (ecu == nullptr)
+  {
+    if (ecuCount >= kMaxEcus)
+      return false;
+    ecu = &ecus[ecuCount++];
+  }
+  ecu->requestId = requestId;
+  ecu->latencyMs = latencyMs;
+  ecu->jitterMs = jitterMs;
+  ecu->lossPerc = lossPerc;
+  ecu->pendingPerc = pendingPerc;
+  return true;
+}
+
+bool CanSimBus::addNoise(uint16_t id, uint16_t periodMs)
+{
+  if (noiseCount >= kMaxNoise || periodMs == 0)
+    return false;
+  noise[noiseCount++] = {id, periodMs, 0, 0};
+  return true;
+}
+
+uint32_t CanSimBus::nextRandom()
+{
+  random ^= random << 13;
+  random ^= random >> 17;
+  random ^= random << 5;
+  return random;
+}
+
+const CanSimBus::Ecu &CanSimBus::ecuFor(uint16_t requestId) const
+{
+  static const Ecu kDefaultEcu = {0, kDefaultLatencyMs, kDefaultJitterMs, 0, 0};
+  for (uint8_t i = 0; i < ecuCount; i++)
+  {
+    if (ecus[i].requestId == requestId)
+      return ecus[i];
+  }
+  return kDefaultEcu;
+}
+
+const CanSimBus::Response *CanSimBus::findResponse(uint16_t requestId, const uint8_t *request, uint8_t length) const
+{
+  for (uint8_t i = 0; i < responseCount; i++)
+  {
+    const Response &entry = responses[i];
+    if (entry.requestId == requestId && entry.requestLength == length && memcmp(entry.request, request, length) == 0)
+      return &entry;
+  }
+  return nullptr;
+}
+
+/**
+ * Schedules the ECU answer: loss, 7F xx 78 pending, latency and jitter
+ * are drawn from the ECU profile.
+ */
+void CanSimBus::answer(uint16_t requestId, const uint8_t *request, uint8_t length)
+{
+  const Ecu &ecu = ecuFor(requestId);
+  const uint16_t responseId = requestId + 8;
+  uint32_t dueMs = millis() + ecu.latencyMs + (ecu.jitterMs != 0 ? nextRandom() % (ecu.jitterMs + 1) : 0);
+
+  if (ecu.lossPerc != 0 && nextRandom() % 100 < ecu.lossPerc)
+  {
+    counters.lost++;
+    return;
+  }
+
+  const Response *response = findResponse(requestId, request, length);
+  if (response == nullptr)
+  {
+    const uint8_t negative[3] = {0x7F, request[0], 0x31};
+    counters.negative++;
+    queueMessage(responseId, dueMs, negative, sizeof(negative));
+    return;
+  }
+
+  if (ecu.pendingPerc != 0 && nextRandom() % 100 < ecu.pendingPerc)
+  {
+    const uint8_t pending[3] = {0x7F, request[0], 0x78};
+    counters.pending++;
+    queueSingle(responseId, dueMs, pending, sizeof(pending));
+    dueMs += kPendingExtraMs;
+  }
+
+  uint8_t data[kMaxMessage];
+  const uint16_t dataLength = response->hexLength / 2;
+  for (uint16_t i = 0; i < dataLength; i++)
+    data[i] = simHexByte(response->hex + i * 2);
+  queueMessage(responseId, dueMs, data, dataLength);
+}
+
+void CanSimBus::queueSingle(uint16_t id, uint32_t dueMs, const uint8_t *data, uint8_t length)
+{
+  uint8_t frame[8];
+  memset(frame, kPadByte, sizeof(frame));
+  frame[0] = length;
+  memcpy(frame + 1, data, length);
+  queueFrame(dueMs, id, frame, 8);
+}
+
+/**
+ * Single frame, or first frame with the rest kept until flow control arrives
+ */
+void CanSimBus::queueMessage(uint16_t id, uint32_t dueMs, const uint8_t *data, uint16_t length)
+{
+  if (length <= 7)
+  {
+    queueSingle(id, dueMs, data, length);
+    counters.responses++;
+    return;
+  }
+  uint8_t frame[8];
+  memset(frame, kPadByte, sizeof(frame));
+  memcpy(message, data, length);
+  messageLength = length;
+  messageOffset = 6;
+  messageId = id;
+  messageSeq = 1;
+  messageFlowing = false;
+  frame[0] = uint8_t(0x10 | (length >> 8));
+  frame[1] = uint8_t(length & 0xFF);
+  memcpy(frame + 2, data, 6);
+  queueFrame(dueMs, id, frame, 8);
+}
+
+/**
+ * Releases consecutive frames whose time has come, STmin apart, until the
+ * block size is used up (0 = all) and the next flow control is awaited.
+ */
+void CanSimBus::pumpConsecutive(uint32_t nowMs)
+{
+  while (messageFlowing && int32_t(nowMs - messageNextMs) >= 0 && rxCount < kRxQueue)
+  {
+    uint8_t frame[8];
+    memset(frame, kPadByte, sizeof(frame));
+    frame[0] = uint8_t(0x20 | (messageSeq & 0x0F));
+    const uint16_t chunk = (messageLength - messageOffset < 7) ? messageLength - messageOffset : 7;
+    memcpy(frame + 1, message + messageOffset, chunk);
+    queueFrame(messageNextMs, messageId, frame, 8);
+    messageOffset += chunk;
+    messageSeq++;
+    messageNextMs += messageGapMs;
+    if (messageOffset >= messageLength)
+    {
+      messageLength = 0;
+      messageFlowing = false;
+      counters.responses++;
+    }
+    else if (messageBlockLeft != 0 && --messageBlockLeft == 0)
+    {
+      messageFlowing = false;
+    }
+  }
+}
+
+void CanSimBus::queueFrame(uint32_t dueMs, uint16_t id, const uint8_t *data, uint8_t length)
+{
+  if (!accepted(id))
+  {
+    counters.filtered++;
+    return;
+  }
+  if (rxCount >= kRxQueue)
+  {
+    counters.overruns++;
+    return;
+  }
+  Frame &frame = rxQueue[rxCount++];
+  frame.dueMs = dueMs;
+  frame.order = rxOrder++;
+  frame.id = id;
+  memcpy(frame.data, data, length);
+}
+
+void CanSimBus::generateNoise(uint32_t nowMs)
+{
+  if (sleeping)
+    return;
+  for (uint8_t i = 0; i < noiseCount; i++)
+  {
+    Noise &entry = noise[i];
+    if (int32_t(nowMs - entry.nextMs) < 0)
+      continue;
+    // A late reader sees one frame per id, like the two MCP2515 RX buffers overwriting
+    entry.nextMs = nowMs + entry.periodMs;
+    uint8_t frame[8];
+    frame[0] = entry.counter++;
+    for (uint8_t j = 1; j < 8; j++)
+      frame[j] = uint8_t(nextRandom());
+    counters.noiseFrames++;
+    queueFrame(nowMs, entry.id, frame, 8);
+  }
+}
+
+/**
+ * MCP2515 acceptance: RXB0 = mask 0 with filters 0-1, RXB1 = mask 1 with filters 2-5
+ */
+bool CanSimBus::accepted(uint16_t id) const
+{
+  if ((id & masks[0]) == (filters[0] & masks[0]) || (id & masks[0]) == (filters[1] & masks[0]))
+    return true;
+  for (uint8_t i = 2; i < 6; i++)
+  {
+    if ((id & masks[1]) == (filters[i] & masks[1]))
+      return true;
+  }
+  return false;
+}
+
+#endif // EVDASH_CAN_SIM || EVDASH_BLE_SIM
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Software MCP2515 stand-in with a scripted UDS/ISO-TP ECU simulator.
+ *
+ * Builds with -DEVDASH_CAN_SIM put this class behind CommObd2Can instead of
+ * MCP_CAN (same calls: begin, setMode, init_Mask/Filt, sendMsgBuf,
+ * readMsgBuf, checkReceive), so the real command queue, ISO-TP reassembly
+ * and car parsers run on any ESP32 without a CAN board or a car. Elm327Sim
+ * (EVDASH_BLE_SIM) uses it as the bus behind its emulated adapter.
+ *
+ * Responses come from a text script, one per line, using the same strings
+ * as the cars' loadTestData():
+ *
+ *   ATSH7E4 220101 620101EFFBE7EF...        recorded response (ECU answers on id + 8)
+ *   PROFILE 7E4 20 10 2 5                   latency ms, jitter ms, loss %, 7F xx 78 pending %
+ *   NOISE 541 10                            broadcast frame id every n ms
+ *
+ * Faults come from a seeded xorshift generator, so a given script and seed
+ * produce the same loss/pending pattern on every run. Unknown requests are
+ * answered with 7F xx 31. Masks/filters are applied to delivered frames like
+ * the MCP2515 does. Cars using an additional starting character are not
+ * simulated.
+ */
+class CanSimBus
+{
+public:
+  static constexpr uint8_t kMaxResponses = 48;
+  static constexpr uint8_t kMaxEcus = 12;
+  static constexpr uint8_t kMaxNoise = 6;
+  static constexpr uint8_t kRxQueue = 32;
+  static constexpr uint16_t kMaxMessage = 512;
+
+  struct Stats
+  {
+    uint32_t requests;
+    uint32_t responses; // last frame of a response delivered
+    uint32_t lost;      // requests left unanswered on purpose
+    uint32_t pending;   // 7F xx 78 sent in front of a response
+    uint32_t negative;  // unknown request, 7F xx 31
+    uint32_t noiseFrames;
+    uint32_t filtered; // dropped by masks/filters
+    uint32_t overruns; // rx queue full
+  };
+
+  explicit CanSimBus(uint32_t seed = 0x45564441);
+
+  // MCP_CAN subset used by CommObd2Can
+  uint8_t begin(uint8_t idMode, uint8_t speed, uint8_t clock);
+  uint8_t setMode(uint8_t mode);
+  uint8_t init_Mask(uint8_t num, uint8_t ext, uint32_t data);
+  uint8_t init_Filt(uint8_t num, uint8_t ext, uint32_t data);
+  uint8_t sendMsgBuf(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf);
+  uint8_t readMsgBuf(unsigned long *id, uint8_t *len, uint8_t *buf);
+  uint8_t checkReceive();
+
+  // Simulator setup
+  uint16_t loadScript(const char *script); // number of accepted lines
+  bool addResponse(uint16_t requestId, const char *request, const char *response); // strings must outlive the bus
+  bool setProfile(uint16_t requestId, uint16_t latencyMs, uint16_t jitterMs, uint8_t lossPerc, uint8_t pendingPerc);
+  bool addNoise(uint16_t id, uint16_t periodMs);
+  const Stats &stats() const { return counters; }
+
+private:
+  struct Response
+  {
+    uint16_t requestId;
+    uint8_t requestLength;
+    uint8_t request[6];
+    const char *hex; // points into the script, not copied
+    uint16_t hexLength;
+  };
+
+  struct Ecu
+  {
+    uint16_t requestId;
+    uint16_t latencyMs;
+    uint16_t jitterMs;
+    uint8_t lossPerc;
+    uint8_t pendingPerc;
+  };
+
+  struct Noise
+  {
+    uint16_t id;
+    uint16_t periodMs;
+    uint32_t nextMs;
+    uint8_t counter;
+  };
+
+  struct Frame
+  {
+    uint32_t dueMs;
+    uint32_t order; // keeps frames due at the same ms in send order
+    uint16_t id;
+    uint8_t data[8];
+  };
+
+  Response responses[kMaxResponses] = {};
+  uint8_t responseCount = 0;
+  Ecu ecus[kMaxEcus] = {};
+  uint8_t ecuCount = 0;
+  Noise noise[kMaxNoise] = {};
+  uint8_t noiseCount = 0;
+  Frame rxQueue[kRxQueue] = {};
+  uint8_t rxCount = 0;
+  uint32_t rxOrder = 0;
+  uint32_t masks[2] = {0, 0};
+  uint32_t filters[6] = {0, 0, 0, 0, 0, 0};
+  bool sleeping = false;
+  uint32_t random;
+  Stats counters = {};
+
+  // Multi-frame response waiting for / following a flow control frame
+  uint8_t message[kMaxMessage];
+  uint16_t messageLength = 0;
+  uint16_t messageOffset = 0;
+  uint16_t messageId = 0;
+  uint8_t messageSeq = 0;
+  bool messageFlowing = false; // flow control received, consecutive frames due
+  uint8_t messageBlockLeft = 0;
+  uint8_t messageGapMs = 0;
+  uint32_t messageNextMs = 0;
+
+  bool addResponse(uint16_t requestId, const char *request, uint16_t requestLength, const char *response, uint16_t responseLength);
+  uint32_t nextRandom();
+  const Ecu &ecuFor(uint16_t requestId) const;
+  const Response *findResponse(uint16_t requestId, const uint8_t *request, uint8_t length) const;
+  void answer(uint16_t requestId, const uint8_t *request, uint8_t length);
+  void queueSingle(uint16_t id, uint32_t dueMs, const uint8_t *data, uint8_t length);
+  void queueMessage(uint16_t id, uint32_t dueMs, const uint8_t *data, uint16_t length);
+  void pumpConsecutive(uint32_t nowMs);
+  void queueFrame(uint32_t dueMs, uint16_t id, const uint8_t *data, uint8_t length);
+  void generateNoise(uint32_t nowMs);
+  bool accepted(uint16_t id) const;
+};
+
+extern const char *const kCanSimDefaultScript; // E-GMP responses from loadTestData()
@@ -259,10 +259,7 @@ void CarBmwI3::parseRowMerged()
         // update charging graph data if car is charging
         if (liveData->params.speedKmh < 10 && liveData->params.batPowerKw >= 1 && liveData->params.socPerc > 0 && liveData->params.socPerc <= 100)
         {
-          if (liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)] < 0 || liveData->params.batPowerKw < liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)])
-            liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)] = liveData->params.batPowerKw;
-          if (liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)] < 0 || liveData->params.batPowerKw > liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)])
-            liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)] = liveData->params.batPowerKw;
+          liveData->chargingGraph.recordPower(liveData->params.socPerc, liveData->params.batPowerKw);
         }
       }
     }
@@ -286,7 +283,7 @@ void CarBmwI3::parseRowMerged()
         // update charging graph data if car is charging
         if (liveData->params.speedKmh < 10 && liveData->params.batPowerKw >= 1 && liveData->params.socPerc > 0 && liveData->params.socPerc <= 100)
         {
-          liveData->params.chargingGraphWaterCoolantTempC[int(liveData->params.socPerc)] = liveData->params.coolingWaterTempC;
+          liveData->chargingGraph.set(ChargingGraph::COOLANT_C, liveData->params.socPerc, liveData->params.coolingWaterTempC);
         }
       }
     }
@@ -394,9 +391,9 @@ void CarBmwI3::parseRowMerged()
         // update charging graph data if car is charging
         if (liveData->params.speedKmh < 10 && liveData->params.batPowerKw >= 1 && liveData->params.socPerc > 0 && liveData->params.socPerc <= 100)
         {
-          liveData->params.chargingGraphBatMinTempC[int(liveData->params.socPerc)] = liveData->params.batMinC;
-          liveData->params.chargingGraphBatMaxTempC[int(liveData->params.socPerc)] = liveData->params.batMaxC;
-          // liveData->params.chargingGraphHeaterTempC[int(liveData->params.socPerc)] = liveData->params.batHeaterC;
+          liveData->chargingGraph.set(ChargingGraph::BAT_MIN_C, liveData->params.socPerc, liveData->params.batMinC);
+          liveData->chargingGraph.set(ChargingGraph::BAT_MAX_C, liveData->params.socPerc, liveData->params.batMaxC);
+          // liveData->chargingGraph.set(ChargingGraph::HEATER_C, liveData->params.socPerc, liveData->params.batHeaterC);
         }
       }
     }
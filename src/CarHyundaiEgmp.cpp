@@ -6,6 +6,7 @@
 #include "LiveData.h"
 #include "CarHyundaiEgmp.h"
 #include "CommInterface.h"
+#include "CarSignalsEgmp.h"
 #include <vector>
 
 #define commandQueueLoopFromHyundaiEgmp 8
@@ -432,6 +433,8 @@ void CarHyundaiEgmp::parseRowMerged()
   if (!hasResponse())
     return;
 
+  decodeCarSignals(liveData, kEgmpSignals, kEgmpSignalCount);
+
   // IGPM
   if (liveData->currentAtshRequest.equals("ATSH770"))
   {
@@ -497,33 +500,11 @@ void CarHyundaiEgmp::parseRowMerged()
     }
   }
 
-  // TPMS 7A0
-  if (liveData->currentAtshRequest.equals("ATSH7A0"))
-  {
-    if (liveData->commandRequest.equals("22C00B") && hasPrefixAndLength("62C00B", 48))
-    {
-      liveData->params.tireFrontLeftPressureBar = liveData->hexToDecFromResponse(14, 16, 2, false) / 72.51886900361;  // === OK Valid *0.2 / 14.503773800722
-      liveData->params.tireFrontRightPressureBar = liveData->hexToDecFromResponse(24, 26, 2, false) / 72.51886900361; // === OK Valid *0.2 / 14.503773800722
-      liveData->params.tireRearLeftPressureBar = liveData->hexToDecFromResponse(34, 36, 2, false) / 72.51886900361;   // === OK Valid *0.2 / 14.503773800722
-      liveData->params.tireRearRightPressureBar = liveData->hexToDecFromResponse(44, 46, 2, false) / 72.51886900361;  // === OK Valid *0.2 / 14.503773800722
-      liveData->params.tireFrontLeftTempC = liveData->hexToDecFromResponse(16, 18, 2, false) - 50;                    // === OK Valid
-      liveData->params.tireFrontRightTempC = liveData->hexToDecFromResponse(26, 28, 2, false) - 50;                   // === OK Valid
-      liveData->params.tireRearLeftTempC = liveData->hexToDecFromResponse(36, 38, 2, false) - 50;                     // === OK Valid
-      liveData->params.tireRearRightTempC = liveData->hexToDecFromResponse(46, 48, 2, false) - 50;                    // === OK Valid
-    }
-  }
-
   // Aircon 7B3
   if (liveData->currentAtshRequest.equals("ATSH7B3"))
   {
     if (liveData->commandRequest.equals("220100") && hasPrefixAndLength("620100", 20))
     {
-      const float indoor = (liveData->hexToDecFromResponse(16, 18, 1, false) / 2) - 40;
-      const float outdoor = (liveData->hexToDecFromResponse(18, 20, 1, false) / 2) - 40;
-      if (inRangeF(indoor, -30, 80))
-        liveData->params.indoorTemperature = indoor;
-      if (inRangeF(outdoor, -30, 80))
-        liveData->params.outdoorTemperature = outdoor;
       // liveData->params.evaporatorTempC = (liveData->hexToDecFromResponse(20, 22, 1, false) / 2) - 40;
     }
     if (liveData->commandRequest.equals("220102") && hasPrefixAndLength("620102", 18) && liveData->responseRowMerged.substring(12, 14) == "00")
@@ -533,17 +514,6 @@ void CarHyundaiEgmp::parseRowMerged()
     }
   }
 
-  // Cluster module 7C6
-  if (liveData->currentAtshRequest.equals("ATSH7C6"))
-  {
-    if (liveData->commandRequest.equals("22B002") && hasPrefixAndLength("62B002", 24))
-    {
-      const float odo = liveData->decFromResponse(18, 24);
-      if (inRangeF(odo, 0, 2000000))
-        liveData->params.odoKm = odo;
-    }
-  }
-
   // VMCU 7E2
   if (liveData->currentAtshRequest.equals("ATSH7E2"))
   {
@@ -570,20 +540,6 @@ void CarHyundaiEgmp::parseRowMerged()
     }
   }*/
 
-  // ICCU 7E5
-  if (liveData->currentAtshRequest.equals("ATSH7E5"))
-  {
-    if (liveData->commandRequest.equals("22E011") && hasPrefixAndLength("62E011", 48))
-    {
-      const float auxCurrent = -liveData->hexToDecFromResponse(30, 34, 2, true) / 1000.0;
-      const float auxPerc = liveData->hexToDecFromResponse(46, 48, 1, false);
-      if (inRangeF(auxCurrent, -200, 200))
-        liveData->params.auxCurrentAmp = auxCurrent;
-      if (inRangeF(auxPerc, 0, 100))
-        liveData->params.auxPerc = auxPerc;
-    }
-  }
-
   // VIN from UDS DID F190 (any ECU)
   if (liveData->commandRequest.equals("22F190") && liveData->params.carVin[0] == 0)
   {
@@ -648,32 +604,6 @@ void CarHyundaiEgmp::parseRowMerged()
     {
       liveData->params.operationTimeSec = liveData->hexToDecFromResponse(98, 106, 4, false);
 
-      const float cChargeAh = liveData->decFromResponse(66, 74) / 10.0;
-      const float cDischargeAh = liveData->decFromResponse(74, 82) / 10.0;
-      const float cecKWh = liveData->decFromResponse(82, 90) / 10.0;
-      const float cedKWh = liveData->decFromResponse(90, 98) / 10.0;
-      const float availChargeKw = liveData->decFromResponse(16, 20) / 100.0;
-      const float availDischargeKw = liveData->decFromResponse(20, 24) / 100.0;
-      if (inRangeF(cChargeAh, 0, 2000000))
-        liveData->params.cumulativeChargeCurrentAh = cChargeAh;
-      if (inRangeF(cDischargeAh, 0, 2000000))
-        liveData->params.cumulativeDischargeCurrentAh = cDischargeAh;
-      if (inRangeF(cecKWh, 0, 2000000))
-        liveData->params.cumulativeEnergyChargedKWh = cecKWh;
-      if (inRangeF(cedKWh, 0, 2000000))
-        liveData->params.cumulativeEnergyDischargedKWh = cedKWh;
-      if (inRangeF(availChargeKw, 0, 600))
-        liveData->params.availableChargePower = availChargeKw;
-      if (inRangeF(availDischargeKw, 0, 600))
-        liveData->params.availableDischargePower = availDischargeKw;
-
-      const float fanStatus = liveData->hexToDecFromResponse(60, 62, 1, false);
-      const float fanFeedback = liveData->hexToDecFromResponse(62, 64, 1, false);
-      if (inRangeF(fanStatus, 0, 255))
-        liveData->params.batFanStatus = fanStatus;
-      if (inRangeF(fanFeedback, 0, 255))
-        liveData->params.batFanFeedbackHz = fanFeedback;
-
       const float decodedBatPowerAmp = -liveData->hexToDecFromResponse(26, 30, 2, true) / 10.0;
       const float decodedBatVoltage = liveData->hexToDecFromResponse(30, 34, 2, false) / 10.0;
       if (inRangeF(decodedBatPowerAmp, -2000, 2000) && inRangeF(decodedBatVoltage, 250, 900))
@@ -757,13 +687,6 @@ void CarHyundaiEgmp::parseRowMerged()
           liveData->params.batModuleTempC[4] = t4;
       }
 
-      const float motor1Rpm = liveData->hexToDecFromResponse(112, 116, 2, false);
-      const float motor2Rpm = liveData->hexToDecFromResponse(116, 120, 2, false);
-      if (inRangeF(motor1Rpm, 0, 30000))
-        liveData->params.motor1Rpm = motor1Rpm;
-      if (inRangeF(motor2Rpm, 0, 30000))
-        liveData->params.motor2Rpm = motor2Rpm;
-
       const float decodedBatMax = liveData->hexToDecFromResponse(34, 36, 1, true);
       const float decodedBatMin = liveData->hexToDecFromResponse(36, 38, 1, true);
       if (inRangeF(decodedBatMax, -30, 80))
@@ -792,19 +715,9 @@ void CarHyundaiEgmp::parseRowMerged()
         liveData->params.batTempC = liveData->params.batMinC;
       }
 
-      const float batInlet = liveData->hexToDecFromResponse(50, 52, 1, true);
-      if (inRangeF(batInlet, -30, 80))
-        liveData->params.batInletC = batInlet;
       if (liveData->params.speedKmh < 10 && liveData->params.batPowerKw >= 1 && liveData->params.socPerc > 0 && liveData->params.socPerc <= 100)
       {
-        if (liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)] < 0 || liveData->params.batPowerKw < liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)])
-          liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)] = liveData->params.batPowerKw;
-        if (liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)] < 0 || liveData->params.batPowerKw > liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)])
-          liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)] = liveData->params.batPowerKw;
-        liveData->params.chargingGraphBatMinTempC[int(liveData->params.socPerc)] = liveData->params.batMinC;
-        liveData->params.chargingGraphBatMaxTempC[int(liveData->params.socPerc)] = liveData->params.batMaxC;
-        liveData->params.chargingGraphHeaterTempC[int(liveData->params.socPerc)] = liveData->params.batHeaterC;
-        liveData->params.chargingGraphWaterCoolantTempC[int(liveData->params.socPerc)] = liveData->params.coolingWaterTempC;
+        liveData->chargingGraph.record(liveData->params.socPerc, liveData->params.batPowerKw, liveData->params.batMinC, liveData->params.batMaxC, liveData->params.batHeaterC, liveData->params.coolingWaterTempC);
       }
 
       // Charging ON, AC/DC
@@ -856,6 +769,7 @@ void CarHyundaiEgmp::parseRowMerged()
           continue;
         liveData->params.cellVoltage[destOffset + i] = tmpVoltages[i];
       }
+      liveData->cellStats.updateBlock(liveData->params.cellVoltage, destOffset, 32);
     };
 
     // BMS 7e4
@@ -1470,12 +1384,8 @@ void CarHyundaiEgmp::loadTestData()
   // Charging graph
   for (int i = 0; i <= 100; i++)
   {
-    liveData->params.chargingGraphBatMinTempC[i] = i / 7;
-    liveData->params.chargingGraphBatMaxTempC[i] = (i / 7) + (i / 20);
-    liveData->params.chargingGraphHeaterTempC[i] = 30;
-    liveData->params.chargingGraphWaterCoolantTempC[i] = 12;
-    liveData->params.chargingGraphMinKw[i] = (i * 1.3);
-    liveData->params.chargingGraphMaxKw[i] = (i * 2.3);
+    liveData->chargingGraph.record(i, i * 1.3, i / 7, (i / 7) + (i / 20), 30, 12);
+    liveData->chargingGraph.recordPower(i, i * 2.3);
   }*/
 }
 
@@ -262,13 +262,10 @@ void CarHyundaiIoniq::parseRowMerged()
       liveData->params.batInletC = liveData->hexToDecFromResponse(48, 50, 1, true);
       if (liveData->params.speedKmh < 10 && liveData->params.batPowerKw >= 1 && liveData->params.socPerc > 0 && liveData->params.socPerc <= 100)
       {
-        if (liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)] == -100 || liveData->params.batPowerKw < liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)])
-          liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)] = liveData->params.batPowerKw;
-        if (liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)] == -100 || liveData->params.batPowerKw > liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)])
-          liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)] = liveData->params.batPowerKw;
-        liveData->params.chargingGraphBatMinTempC[int(liveData->params.socPerc)] = liveData->params.batMinC;
-        liveData->params.chargingGraphBatMaxTempC[int(liveData->params.socPerc)] = liveData->params.batMaxC;
-        liveData->params.chargingGraphHeaterTempC[int(liveData->params.socPerc)] = liveData->params.batHeaterC;
+        liveData->chargingGraph.recordPower(liveData->params.socPerc, liveData->params.batPowerKw);
+        liveData->chargingGraph.set(ChargingGraph::BAT_MIN_C, liveData->params.socPerc, liveData->params.batMinC);
+        liveData->chargingGraph.set(ChargingGraph::BAT_MAX_C, liveData->params.socPerc, liveData->params.batMaxC);
+        liveData->chargingGraph.set(ChargingGraph::HEATER_C, liveData->params.socPerc, liveData->params.batHeaterC);
       }
     }
     // BMS 7e4
@@ -278,6 +275,7 @@ void CarHyundaiIoniq::parseRowMerged()
       {
         liveData->params.cellVoltage[i] = liveData->hexToDecFromResponse(12 + (i * 2), 12 + (i * 2) + 2, 1, false) / 50;
       }
+      liveData->cellStats.updateBlock(liveData->params.cellVoltage, 0, 32);
     }
     // BMS 7e4
     if (liveData->commandRequest.equals("2103"))
@@ -286,6 +284,7 @@ void CarHyundaiIoniq::parseRowMerged()
       {
         liveData->params.cellVoltage[32 + i] = liveData->hexToDecFromResponse(12 + (i * 2), 12 + (i * 2) + 2, 1, false) / 50;
       }
+      liveData->cellStats.updateBlock(liveData->params.cellVoltage, 32, 32);
     }
     // BMS 7e4
     if (liveData->commandRequest.equals("2104"))
@@ -294,6 +293,7 @@ void CarHyundaiIoniq::parseRowMerged()
       {
         liveData->params.cellVoltage[64 + i] = liveData->hexToDecFromResponse(12 + (i * 2), 12 + (i * 2) + 2, 1, false) / 50;
       }
+      liveData->cellStats.updateBlock(liveData->params.cellVoltage, 64, 32);
     }
     // BMS 7e4
     if (liveData->commandRequest.equals("2105"))
@@ -341,6 +341,7 @@ void CarHyundaiIoniq::parseRowMerged()
       { // ai/aj position
         liveData->params.cellVoltage[96 - 30 + i] = -1;
       }
+      liveData->cellStats.updateBlock(liveData->params.cellVoltage, 96, 2);
     }
     // BMS 7e4
     // IONIQ FAILED
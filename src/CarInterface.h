@@ -1,6 +1,7 @@
 #pragma once
 
 #include "LiveData.h"
+#include "CanAcceptance.h"
 
 class CommInterface; // Forward declaration
 
@@ -18,6 +19,7 @@ public:
   virtual bool commandAllowed() { return true; }
   virtual void parseRowMerged();
   virtual void loadTestData();
+  virtual void registerCanAcceptance(CanAcceptance &) {} // direct CAN: response IDs for the MCP2515 filters
   //
   virtual void testHandler(const String &cmd);
 };
@@ -327,14 +327,7 @@ void CarKiaEniro::parseRowMerged()
       liveData->params.batInletC = liveData->hexToDecFromResponse(50, 52, 1, true);
       if (liveData->params.speedKmh < 10 && liveData->params.batPowerKw >= 1 && liveData->params.socPerc > 0 && liveData->params.socPerc <= 100)
       {
-        if (liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)] < 0 || liveData->params.batPowerKw < liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)])
-          liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)] = liveData->params.batPowerKw;
-        if (liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)] < 0 || liveData->params.batPowerKw > liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)])
-          liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)] = liveData->params.batPowerKw;
-        liveData->params.chargingGraphBatMinTempC[int(liveData->params.socPerc)] = liveData->params.batMinC;
-        liveData->params.chargingGraphBatMaxTempC[int(liveData->params.socPerc)] = liveData->params.batMaxC;
-        liveData->params.chargingGraphHeaterTempC[int(liveData->params.socPerc)] = liveData->params.batHeaterC;
-        liveData->params.chargingGraphWaterCoolantTempC[int(liveData->params.socPerc)] = liveData->params.coolingWaterTempC;
+        liveData->chargingGraph.record(liveData->params.socPerc, liveData->params.batPowerKw, liveData->params.batMinC, liveData->params.batMaxC, liveData->params.batHeaterC, liveData->params.coolingWaterTempC);
       }
     }
     // BMS 7e4
@@ -344,6 +337,7 @@ void CarKiaEniro::parseRowMerged()
       {
         liveData->params.cellVoltage[i] = liveData->hexToDecFromResponse(14 + (i * 2), 14 + (i * 2) + 2, 1, false) / 50;
       }
+      liveData->cellStats.updateBlock(liveData->params.cellVoltage, 0, 32);
     }
     // BMS 7e4
     if (liveData->commandRequest.equals("220103"))
@@ -352,6 +346,7 @@ void CarKiaEniro::parseRowMerged()
       {
         liveData->params.cellVoltage[32 + i] = liveData->hexToDecFromResponse(14 + (i * 2), 14 + (i * 2) + 2, 1, false) / 50;
       }
+      liveData->cellStats.updateBlock(liveData->params.cellVoltage, 32, 32);
     }
     // BMS 7e4
     if (liveData->commandRequest.equals("220104"))
@@ -360,6 +355,7 @@ void CarKiaEniro::parseRowMerged()
       {
         liveData->params.cellVoltage[64 + i] = liveData->hexToDecFromResponse(14 + (i * 2), 14 + (i * 2) + 2, 1, false) / 50;
       }
+      liveData->cellStats.updateBlock(liveData->params.cellVoltage, 64, 32);
     }
     // BMS 7e4
     if (liveData->commandRequest.equals("220105"))
@@ -391,6 +387,7 @@ void CarKiaEniro::parseRowMerged()
       { // ai/aj position
         liveData->params.cellVoltage[96 - 30 + i] = liveData->hexToDecFromResponse(14 + (i * 2), 14 + (i * 2) + 2, 1, false) / 50;
       }
+      liveData->cellStats.updateBlock(liveData->params.cellVoltage, 96, 2);
 
       // Charging ON, AC/DC
       liveData->params.getValidResponse = true;
@@ -54,43 +54,19 @@ namespace
 
   void updateCellMinMax(LiveData *liveData)
   {
-    bool found = false;
-    float minV = 9;
-    float maxV = 0;
-    float sumV = 0;
-    uint8_t minNo = 255;
-    uint8_t maxNo = 255;
-    uint8_t validCount = 0;
-
-    for (uint8_t i = 0; i < kPsaCellCount; i++)
-    {
-      const float value = liveData->params.cellVoltage[i];
-      if (!inRange(value, 2.5, 4.4))
-        continue;
-      sumV += value;
-      validCount++;
-      if (!found || value < minV)
-      {
-        minV = value;
-        minNo = i + 1;
-      }
-      if (!found || value > maxV)
-      {
-        maxV = value;
-        maxNo = i + 1;
-      }
-      found = true;
-    }
-
-    if (!found)
+    // D440 only stores 2.5-4.4 V values, shared stats cover exactly those cells
+    CellStats &stats = liveData->cellStats;
+    stats.updateBlock(liveData->params.cellVoltage, 0, kPsaCellCount);
+    if (stats.validCount() == 0)
       return;
 
+    const float sumV = stats.sumMv() / 1000.0;
     liveData->params.cellCount = kPsaCellCount;
-    liveData->params.batCellMinV = minV;
-    liveData->params.batCellMaxV = maxV;
-    liveData->params.batCellMinVNo = minNo;
-    liveData->params.batCellMaxVNo = maxNo;
-    if (validCount >= kPsaCellCount - 4 && inRange(sumV, 200, 470))
+    liveData->params.batCellMinV = stats.minMv() / 1000.0;
+    liveData->params.batCellMaxV = stats.maxMv() / 1000.0;
+    liveData->params.batCellMinVNo = stats.minCellNo();
+    liveData->params.batCellMaxVNo = stats.maxCellNo();
+    if (stats.validCount() >= kPsaCellCount - 4 && inRange(sumV, 200, 470))
       liveData->params.batVoltage = sumV;
   }
 
@@ -125,13 +101,9 @@ namespace
     if (liveData->params.speedKmh >= 10 || liveData->params.batPowerKw < 1 || !inRange(liveData->params.socPerc, 0, 100))
       return;
 
-    const uint8_t socIndex = static_cast<uint8_t>(liveData->params.socPerc);
-    if (liveData->params.chargingGraphMinKw[socIndex] < 0 || liveData->params.batPowerKw < liveData->params.chargingGraphMinKw[socIndex])
-      liveData->params.chargingGraphMinKw[socIndex] = liveData->params.batPowerKw;
-    if (liveData->params.chargingGraphMaxKw[socIndex] < 0 || liveData->params.batPowerKw > liveData->params.chargingGraphMaxKw[socIndex])
-      liveData->params.chargingGraphMaxKw[socIndex] = liveData->params.batPowerKw;
-    liveData->params.chargingGraphBatMinTempC[socIndex] = liveData->params.batMinC;
-    liveData->params.chargingGraphBatMaxTempC[socIndex] = liveData->params.batMaxC;
+    liveData->chargingGraph.recordPower(liveData->params.socPerc, liveData->params.batPowerKw);
+    liveData->chargingGraph.set(ChargingGraph::BAT_MIN_C, liveData->params.socPerc, liveData->params.batMinC);
+    liveData->chargingGraph.set(ChargingGraph::BAT_MAX_C, liveData->params.socPerc, liveData->params.batMaxC);
   }
 
   void applyIgnitionState(LiveData *liveData)
@@ -177,6 +149,22 @@ namespace
   }
 } // namespace
 
+/**
+   registerCanAcceptance
+*/
+void CarPeugeotE208::registerCanAcceptance(CanAcceptance &acceptance)
+{
+  // PSA e-CMP: the OBD port is the live high-speed CAN with hundreds of broadcast
+  // frames/s. With the masks open the MCP2515's two RX buffers overflow with
+  // broadcast and the diagnostic reply is dropped before the firmware reads it
+  // (a plugged-in ELM327 works here because ATCRA programs the same hardware filter).
+  // Accept only the e-208 response IDs (4 IDs = exact filters).
+  acceptance.addResponseId(0x7E8); // VIN (mode 09)
+  acceptance.addResponseId(0x58F); // charger / DC-DC
+  acceptance.addResponseId(0x682); // VCU
+  acceptance.addResponseId(0x694); // BMS / TBMU, carries the bulk + multiframe
+}
+
 /**
    activateCommandQueue
 */
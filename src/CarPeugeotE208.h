@@ -11,4 +11,5 @@ public:
   bool commandAllowed() override;
   void parseRowMerged() override;
   void loadTestData() override;
+  void registerCanAcceptance(CanAcceptance &acceptance) override;
 };
@@ -138,6 +138,7 @@ void CarRenaultZoe::updateZoeCells(uint16_t offset, uint16_t count)
       liveData->params.cellVoltage[offset + i] = voltage;
   }
   liveData->params.cellCount = 96;
+  liveData->cellStats.updateBlock(liveData->params.cellVoltage, offset, count);
   updateZoeCellMinMax();
 }
 
@@ -146,39 +147,15 @@ void CarRenaultZoe::updateZoeCells(uint16_t offset, uint16_t count)
 */
 void CarRenaultZoe::updateZoeCellMinMax()
 {
-  float minV = 9;
-  float maxV = 0;
-  uint8_t minNo = 255;
-  uint8_t maxNo = 255;
-  const uint16_t count = liveData->params.cellCount > 0 ? liveData->params.cellCount : 96;
-
-  for (uint16_t i = 0; i < count && i < 200; i++)
-  {
-    const float voltage = liveData->params.cellVoltage[i];
-    if (!inRange(voltage, 2.5, 4.5))
-      continue;
-    if (voltage < minV)
-    {
-      minV = voltage;
-      minNo = i + 1;
-    }
-    if (voltage > maxV)
-    {
-      maxV = voltage;
-      maxNo = i + 1;
-    }
-  }
+  // Only 2.5-4.5 V values are stored, so the shared stats match the cell filter
+  CellStats &stats = liveData->cellStats;
+  if (stats.validCount() == 0)
+    return;
 
-  if (minNo != 255)
-  {
-    liveData->params.batCellMinV = minV;
-    liveData->params.batCellMinVNo = minNo;
-  }
-  if (maxNo != 255)
-  {
-    liveData->params.batCellMaxV = maxV;
-    liveData->params.batCellMaxVNo = maxNo;
-  }
+  liveData->params.batCellMinV = stats.minMv() / 1000.0;
+  liveData->params.batCellMinVNo = stats.minCellNo();
+  liveData->params.batCellMaxV = stats.maxMv() / 1000.0;
+  liveData->params.batCellMaxVNo = stats.maxCellNo();
 }
 
 /**
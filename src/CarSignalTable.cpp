@@ -0,0 +1,128 @@
+/**
+ * Declarative UDS signal tables, see CarSignalTable.h.
+ */
+#include "CarSignalTable.h"
+#ifndef EVDASH_HOST_TEST
+#include "LiveData.h"
+#endif // EVDASH_HOST_TEST
+
+static int8_t hexValue(char ch)
+{
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  return -1;
+}
+
+// Big endian bytes from hex text, false on a non-hex character
+static bool readHexBytes(const char *hex, uint8_t bytes, uint32_t &value)
+{
+  value = 0;
+  for (uint8_t i = 0; i < bytes * 2; i++)
+  {
+    const int8_t nibble = hexValue(hex[i]);
+    if (nibble < 0)
+      return false;
+    value = (value << 4) | uint8_t(nibble);
+  }
+  return true;
+}
+
+/**
+ * Positive response check: response starts with the request bytes, service id + 0x40
+ */
+static bool isPositiveResponse(uint32_t request, const char *hex, uint16_t hexLength)
+{
+  uint8_t requestBytes = 1;
+  while (requestBytes < 4 && (request >> (8 * requestBytes)) != 0)
+    requestBytes++;
+  if (hexLength < requestBytes * 2)
+    return false;
+  uint32_t header;
+  if (!readHexBytes(hex, requestBytes, header))
+    return false;
+  const uint32_t serviceShift = 8 * (requestBytes - 1);
+  return header == request + (uint32_t(0x40) << serviceShift);
+}
+
+uint8_t decodeSignalRows(const CarSignal *table, uint16_t count, uint16_t ecu, uint32_t request,
+                         const char *hex, uint16_t hexLength, PARAMS_STRUC &params)
+{
+  // Rows are sorted, find the first one of (ecu, request)
+  uint16_t low = 0;
+  uint16_t high = count;
+  while (low < high)
+  {
+    const uint16_t mid = (low + high) / 2;
+    if (table[mid].ecu < ecu || (table[mid].ecu == ecu && table[mid].request < request))
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  if (low >= count || table[low].ecu != ecu || table[low].request != request)
+    return 0;
+  if (hexLength % 2 != 0 || !isPositiveResponse(request, hex, hexLength))
+    return 0;
+
+  const uint16_t responseBytes = hexLength / 2;
+  uint8_t written = 0;
+  for (uint16_t i = low; i < count && table[i].ecu == ecu && table[i].request == request; i++)
+  {
+    const CarSignal &row = table[i];
+    if (responseBytes < row.minLength || row.byteOffset + row.length > responseBytes)
+      continue;
+    uint32_t raw;
+    if (!readHexBytes(hex + row.byteOffset * 2, row.length, raw))
+      continue;
+    float value;
+    if (row.isSigned && row.length < 4 && (raw & (1UL << (row.length * 8 - 1))))
+      value = float(int32_t(raw) - int32_t(1UL << (row.length * 8)));
+    else if (row.isSigned && row.length == 4)
+      value = float(int32_t(raw));
+    else
+      value = float(raw);
+    value = value * row.scale + row.offset;
+    if (value < row.minValue || value > row.maxValue)
+      continue;
+    params.*(row.target) = value;
+    written++;
+  }
+  return written;
+}
+
+// LiveData glue, not part of the host tests (test/Makefile)
+#ifndef EVDASH_HOST_TEST
+// Hex text of up to 8 digits as number (ATSH header, request), skips spaces
+static bool parseHexNumber(const char *text, uint32_t &value)
+{
+  value = 0;
+  uint8_t digits = 0;
+  for (; *text != '\0'; text++)
+  {
+    if (*text == ' ')
+      continue;
+    const int8_t nibble = hexValue(*text);
+    if (nibble < 0 || ++digits > 8)
+      return false;
+    value = (value << 4) | uint8_t(nibble);
+  }
+  return digits > 0;
+}
+
+uint8_t decodeCarSignals(LiveData *liveData, const CarSignal *table, uint16_t count)
+{
+  const String &header = liveData->currentAtshRequest;
+  uint32_t ecu;
+  uint32_t request;
+  if (!header.startsWith("ATSH") || !parseHexNumber(header.c_str() + 4, ecu) ||
+      !parseHexNumber(liveData->commandRequest.c_str(), request))
+  {
+    return 0;
+  }
+  return decodeSignalRows(table, count, uint16_t(ecu), request, liveData->responseRowMerged.c_str(),
+                          liveData->responseRowMerged.length(), liveData->params);
+}
+#endif // EVDASH_HOST_TEST
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include "LiveDataParams.h"
+
+class LiveData;
+
+/**
+ * Declarative UDS signal tables.
+ *
+ * A car describes plain "bytes * scale + offset -> param" values as constexpr
+ * rows instead of hand written hexToDecFromResponse() calls:
+ *
+ *   {0x7A0, 0x22C00B, 24, 7, 1, false, 1 / 72.51886900361, 0, &PARAMS_STRUC::tireFrontLeftPressureBar, 0, 10},
+ *
+ * decodeCarSignals() matches rows against the current ATSH header and
+ * request, checks the positive response header (request + 0x40) and
+ * minimum length once per DID, then runs one generic loop over the matching
+ * rows. Values outside [minValue, maxValue] keep the previous param value.
+ * Rows must be sorted by (ecu, request). Anything with extra logic (bit
+ * flags, derived values, settings) stays hand written in parseRowMerged().
+ */
+struct CarSignal
+{
+  uint16_t ecu;        // ATSH header
+  uint32_t request;    // UDS request as number, e.g. 0x220101
+  uint8_t minLength;   // response bytes required for the whole DID
+  uint8_t byteOffset;  // from response start (0x62 = byte 0)
+  uint8_t length;      // bytes, big endian, 1..4
+  bool isSigned;
+  float scale;
+  float offset;
+  float PARAMS_STRUC::*target;
+  float minValue;
+  float maxValue;
+};
+
+static constexpr float kSignalNoMin = -1.0e9f;
+static constexpr float kSignalNoMax = 1.0e9f;
+
+// Core decoder (no String use, host testable, see test/)
+uint8_t decodeSignalRows(const CarSignal *table, uint16_t count, uint16_t ecu, uint32_t request,
+                         const char *hex, uint16_t hexLength, PARAMS_STRUC &params);
+
+// Decodes liveData->responseRowMerged for the current header/request, returns params written
+uint8_t decodeCarSignals(LiveData *liveData, const CarSignal *table, uint16_t count);
+
+template <uint16_t N>
+uint8_t decodeCarSignals(LiveData *liveData, const CarSignal (&table)[N])
+{
+  return decodeCarSignals(liveData, table, N);
+}
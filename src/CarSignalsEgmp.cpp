@@ -0,0 +1,41 @@
+/**
+ * E-GMP signal table, see CarSignalsEgmp.h.
+ */
+#include "CarSignalsEgmp.h"
+
+/**
+ * Plain scaled values, decoded by decodeCarSignals(). Sorted by ECU, request.
+ */
+static constexpr float kTpmsBar = 1 / 72.51886900361; // *0.2 / 14.503773800722
+const CarSignal kEgmpSignals[] = {
+    // TPMS 7A0
+    {0x7A0, 0x22C00B, 24, 7, 1, false, kTpmsBar, 0, &PARAMS_STRUC::tireFrontLeftPressureBar, kSignalNoMin, kSignalNoMax},
+    {0x7A0, 0x22C00B, 24, 8, 1, false, 1, -50, &PARAMS_STRUC::tireFrontLeftTempC, kSignalNoMin, kSignalNoMax},
+    {0x7A0, 0x22C00B, 24, 12, 1, false, kTpmsBar, 0, &PARAMS_STRUC::tireFrontRightPressureBar, kSignalNoMin, kSignalNoMax},
+    {0x7A0, 0x22C00B, 24, 13, 1, false, 1, -50, &PARAMS_STRUC::tireFrontRightTempC, kSignalNoMin, kSignalNoMax},
+    {0x7A0, 0x22C00B, 24, 17, 1, false, kTpmsBar, 0, &PARAMS_STRUC::tireRearLeftPressureBar, kSignalNoMin, kSignalNoMax},
+    {0x7A0, 0x22C00B, 24, 18, 1, false, 1, -50, &PARAMS_STRUC::tireRearLeftTempC, kSignalNoMin, kSignalNoMax},
+    {0x7A0, 0x22C00B, 24, 22, 1, false, kTpmsBar, 0, &PARAMS_STRUC::tireRearRightPressureBar, kSignalNoMin, kSignalNoMax},
+    {0x7A0, 0x22C00B, 24, 23, 1, false, 1, -50, &PARAMS_STRUC::tireRearRightTempC, kSignalNoMin, kSignalNoMax},
+    // Aircon 7B3
+    {0x7B3, 0x220100, 10, 8, 1, false, 0.5, -40, &PARAMS_STRUC::indoorTemperature, -30, 80},
+    {0x7B3, 0x220100, 10, 9, 1, false, 0.5, -40, &PARAMS_STRUC::outdoorTemperature, -30, 80},
+    // Cluster module 7C6
+    {0x7C6, 0x22B002, 12, 9, 3, false, 1, 0, &PARAMS_STRUC::odoKm, 0, 2000000},
+    // BMS 7E4
+    {0x7E4, 0x220101, 60, 8, 2, false, 0.01, 0, &PARAMS_STRUC::availableChargePower, 0, 600},
+    {0x7E4, 0x220101, 60, 10, 2, false, 0.01, 0, &PARAMS_STRUC::availableDischargePower, 0, 600},
+    {0x7E4, 0x220101, 60, 25, 1, true, 1, 0, &PARAMS_STRUC::batInletC, -30, 80},
+    {0x7E4, 0x220101, 60, 30, 1, false, 1, 0, &PARAMS_STRUC::batFanStatus, 0, 255},
+    {0x7E4, 0x220101, 60, 31, 1, false, 1, 0, &PARAMS_STRUC::batFanFeedbackHz, 0, 255},
+    {0x7E4, 0x220101, 60, 33, 4, false, 0.1, 0, &PARAMS_STRUC::cumulativeChargeCurrentAh, 0, 2000000},
+    {0x7E4, 0x220101, 60, 37, 4, false, 0.1, 0, &PARAMS_STRUC::cumulativeDischargeCurrentAh, 0, 2000000},
+    {0x7E4, 0x220101, 60, 41, 4, false, 0.1, 0, &PARAMS_STRUC::cumulativeEnergyChargedKWh, 0, 2000000},
+    {0x7E4, 0x220101, 60, 45, 4, false, 0.1, 0, &PARAMS_STRUC::cumulativeEnergyDischargedKWh, 0, 2000000},
+    {0x7E4, 0x220101, 60, 56, 2, false, 1, 0, &PARAMS_STRUC::motor1Rpm, 0, 30000},
+    {0x7E4, 0x220101, 60, 58, 2, false, 1, 0, &PARAMS_STRUC::motor2Rpm, 0, 30000},
+    // ICCU 7E5
+    {0x7E5, 0x22E011, 24, 15, 2, true, -0.001, 0, &PARAMS_STRUC::auxCurrentAmp, -200, 200},
+    {0x7E5, 0x22E011, 24, 23, 1, false, 1, 0, &PARAMS_STRUC::auxPerc, 0, 100},
+};
+const uint16_t kEgmpSignalCount = sizeof(kEgmpSignals) / sizeof(kEgmpSignals[0]);
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "CarSignalTable.h"
+
+/**
+ * E-GMP signal table shared by CarHyundaiEgmp and CarKiaEV9 (same ECUs and DIDs).
+ */
+extern const CarSignal kEgmpSignals[];
+extern const uint16_t kEgmpSignalCount;
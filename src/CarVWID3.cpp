@@ -567,6 +567,7 @@ void CarVWID3::parseRowMerged()
     {
       tempByte = liveData->hexToDec(liveData->commandRequest.substring(4, 6).c_str(), 1, false);
       liveData->params.cellVoltage[tempByte - 64] = liveData->hexToDecFromResponse(6, 10, 2, false) / 1000 + 1; // Cell voltage, cell 1
+      liveData->cellStats.updateBlock(liveData->params.cellVoltage, tempByte - 64, 1);
     }
 
     // HV Battery total accumulated charge and total accumulated discharge, MF answer
@@ -577,14 +578,7 @@ void CarVWID3::parseRowMerged()
 
       if (liveData->params.speedKmh < 10 && liveData->params.batPowerKw >= 1 && liveData->params.socPerc > 0 && liveData->params.socPerc <= 100)
       {
-        if (liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)] < 0 || liveData->params.batPowerKw < liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)])
-          liveData->params.chargingGraphMinKw[int(liveData->params.socPerc)] = liveData->params.batPowerKw;
-        if (liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)] < 0 || liveData->params.batPowerKw > liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)])
-          liveData->params.chargingGraphMaxKw[int(liveData->params.socPerc)] = liveData->params.batPowerKw;
-        liveData->params.chargingGraphBatMinTempC[int(liveData->params.socPerc)] = liveData->params.batMinC;
-        liveData->params.chargingGraphBatMaxTempC[int(liveData->params.socPerc)] = liveData->params.batMaxC;
-        liveData->params.chargingGraphHeaterTempC[int(liveData->params.socPerc)] = liveData->params.batHeaterC;
-        liveData->params.chargingGraphWaterCoolantTempC[int(liveData->params.socPerc)] = liveData->params.coolingWaterTempC;
+        liveData->chargingGraph.record(liveData->params.socPerc, liveData->params.batPowerKw, liveData->params.batMinC, liveData->params.batMaxC, liveData->params.batHeaterC, liveData->params.coolingWaterTempC);
       }
     }
   }
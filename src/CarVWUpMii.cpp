@@ -34,35 +34,15 @@ static void addDid(std::vector<String> &queue, uint16_t did)
 
 static void updateCellMinMax(LiveData *liveData)
 {
-  bool found = false;
-  float minV = 9;
-  float maxV = 0;
-  uint8_t minNo = 255;
-  uint8_t maxNo = 255;
-  for (uint8_t i = 0; i < 84; i++)
-  {
-    const float value = liveData->params.cellVoltage[i];
-    if (!inRange(value, 2.5, 4.4))
-      continue;
-    if (!found || value < minV)
-    {
-      minV = value;
-      minNo = i + 1;
-    }
-    if (!found || value > maxV)
-    {
-      maxV = value;
-      maxNo = i + 1;
-    }
-    found = true;
-  }
-  if (!found)
+  // Only 2.5-4.4 V values are stored, shared stats cover exactly those cells
+  CellStats &stats = liveData->cellStats;
+  if (stats.validCount() == 0)
     return;
   liveData->params.cellCount = 84;
-  liveData->params.batCellMinV = minV;
-  liveData->params.batCellMaxV = maxV;
-  liveData->params.batCellMinVNo = minNo;
-  liveData->params.batCellMaxVNo = maxNo;
+  liveData->params.batCellMinV = stats.minMv() / 1000.0;
+  liveData->params.batCellMaxV = stats.maxMv() / 1000.0;
+  liveData->params.batCellMinVNo = stats.minCellNo();
+  liveData->params.batCellMaxVNo = stats.maxCellNo();
 }
 
 static void updateModuleTempMinMax(LiveData *liveData)
@@ -242,13 +222,9 @@ void CarVWUpMii::parseRowMerged()
         liveData->params.batPowerKwh100 = liveData->params.batPowerKw / liveData->params.speedKmh * 100.0;
       if (liveData->params.speedKmh < 10 && liveData->params.batPowerKw >= 1 && inRange(liveData->params.socPerc, 0, 100))
       {
-        const uint8_t socIndex = static_cast<uint8_t>(liveData->params.socPerc);
-        if (liveData->params.chargingGraphMinKw[socIndex] < 0 || liveData->params.batPowerKw < liveData->params.chargingGraphMinKw[socIndex])
-          liveData->params.chargingGraphMinKw[socIndex] = liveData->params.batPowerKw;
-        if (liveData->params.chargingGraphMaxKw[socIndex] < 0 || liveData->params.batPowerKw > liveData->params.chargingGraphMaxKw[socIndex])
-          liveData->params.chargingGraphMaxKw[socIndex] = liveData->params.batPowerKw;
-        liveData->params.chargingGraphBatMinTempC[socIndex] = liveData->params.batMinC;
-        liveData->params.chargingGraphBatMaxTempC[socIndex] = liveData->params.batMaxC;
+        liveData->chargingGraph.recordPower(liveData->params.socPerc, liveData->params.batPowerKw);
+        liveData->chargingGraph.set(ChargingGraph::BAT_MIN_C, liveData->params.socPerc, liveData->params.batMinC);
+        liveData->chargingGraph.set(ChargingGraph::BAT_MAX_C, liveData->params.socPerc, liveData->params.batMaxC);
       }
     }
     return;
@@ -355,6 +331,7 @@ void CarVWUpMii::parseRowMerged()
     if (cellIndex < 84 && inRange(voltage, 2.5, 4.4))
     {
       liveData->params.cellVoltage[cellIndex] = voltage;
+      liveData->cellStats.updateBlock(liveData->params.cellVoltage, cellIndex, 1);
       updateCellMinMax(liveData);
     }
     return;
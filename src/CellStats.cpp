@@ -0,0 +1,229 @@
+/**
+ * Shared battery cell statistics, see CellStats.h.
+ */
+#include "CellStats.h"
+#include <math.h>
+#include <string.h>
+
+void CellStats::clear()
+{
+  memset(mv, 0, sizeof(mv));
+  memset(bins, 0, sizeof(bins));
+  memset(moduleDelta, 0, sizeof(moduleDelta));
+  cellsValid = 0;
+  sum = 0;
+  sumSq = 0;
+  minValue = maxValue = 0;
+  minIndex = maxIndex = 0;
+  extremesDirty = false;
+  moduleDirty = 0;
+  changeCounter++;
+}
+
+/**
+ * Cells per module for per-module deltas (0 = off)
+ */
+void CellStats::setModuleSize(uint8_t cellsPerModule)
+{
+  moduleSize = cellsPerModule;
+  moduleDirty = 0xFFFFFFFF;
+}
+
+uint8_t CellStats::binIndex(uint16_t value)
+{
+  if (value <= kHistogramMinMv)
+    return 0;
+  const uint16_t bin = (value - kHistogramMinMv) / kHistogramBinMv;
+  return (bin >= kHistogramBins) ? (kHistogramBins - 1) : bin;
+}
+
+/**
+ * Sync cells [first, first + count) from params.cellVoltage[] (values <= 0 = unknown)
+ */
+void CellStats::updateBlock(const float *voltages, uint16_t first, uint16_t count)
+{
+  for (uint16_t i = first; i < first + count && i < kMaxCells; i++)
+  {
+    const float value = voltages[i];
+    uint16_t millivolts = 0;
+    if (value > 0 && value < 65.0f)
+    {
+      millivolts = uint16_t(value * 1000.0f + 0.5f);
+    }
+    if (millivolts != mv[i])
+    {
+      setCell(i, millivolts);
+    }
+  }
+}
+
+void CellStats::setCell(uint16_t index, uint16_t value)
+{
+  const uint16_t old = mv[index];
+  if (old != 0)
+  {
+    cellsValid--;
+    sum -= old;
+    sumSq -= uint32_t(old) * old;
+    bins[binIndex(old)]--;
+  }
+  if (value != 0)
+  {
+    cellsValid++;
+    sum += value;
+    sumSq += uint32_t(value) * value;
+    bins[binIndex(value)]++;
+  }
+  mv[index] = value;
+  changeCounter++;
+  if (moduleSize != 0 && index / moduleSize < kMaxModules)
+  {
+    moduleDirty |= (1UL << (index / moduleSize));
+  }
+
+  // Extremes: only a change of the extreme cell itself needs a rescan
+  if (extremesDirty)
+    return;
+  if ((old != 0 && (index == minIndex || index == maxIndex)) || cellsValid == 0)
+  {
+    extremesDirty = true;
+    return;
+  }
+  if (value == 0)
+    return;
+  if (cellsValid == 1 || value < minValue || (value == minValue && index < minIndex))
+  {
+    minValue = value;
+    minIndex = index;
+  }
+  if (cellsValid == 1 || value > maxValue || (value == maxValue && index < maxIndex))
+  {
+    maxValue = value;
+    maxIndex = index;
+  }
+}
+
+/**
+ * Full min/max scan over the packed array. Value pass is branch free (unknown 0
+ * wraps to 0xFFFF for min), index pass only looks for the first match.
+ */
+void CellStats::refreshExtremes()
+{
+  extremesDirty = false;
+  if (cellsValid == 0)
+  {
+    minValue = maxValue = 0;
+    minIndex = maxIndex = 0;
+    return;
+  }
+
+  uint16_t biasedMin = 0xFFFF;
+  uint16_t maxFound = 0;
+  for (uint16_t i = 0; i < kMaxCells; i += 4)
+  {
+    const uint16_t b0 = mv[i] - 1, b1 = mv[i + 1] - 1, b2 = mv[i + 2] - 1, b3 = mv[i + 3] - 1;
+    const uint16_t lo01 = (b0 < b1) ? b0 : b1;
+    const uint16_t lo23 = (b2 < b3) ? b2 : b3;
+    const uint16_t lo = (lo01 < lo23) ? lo01 : lo23;
+    biasedMin = (lo < biasedMin) ? lo : biasedMin;
+    const uint16_t hi01 = (mv[i] > mv[i + 1]) ? mv[i] : mv[i + 1];
+    const uint16_t hi23 = (mv[i + 2] > mv[i + 3]) ? mv[i + 2] : mv[i + 3];
+    const uint16_t hi = (hi01 > hi23) ? hi01 : hi23;
+    maxFound = (hi > maxFound) ? hi : maxFound;
+  }
+  minValue = biasedMin + 1;
+  maxValue = maxFound;
+
+  minIndex = maxIndex = kMaxCells;
+  for (uint16_t i = 0; i < kMaxCells && (minIndex == kMaxCells || maxIndex == kMaxCells); i++)
+  {
+    if (minIndex == kMaxCells && mv[i] == minValue)
+      minIndex = i;
+    if (maxIndex == kMaxCells && mv[i] == maxValue)
+      maxIndex = i;
+  }
+}
+
+uint16_t CellStats::minMv()
+{
+  if (extremesDirty)
+    refreshExtremes();
+  return minValue;
+}
+
+uint16_t CellStats::maxMv()
+{
+  if (extremesDirty)
+    refreshExtremes();
+  return maxValue;
+}
+
+uint8_t CellStats::minCellNo()
+{
+  if (extremesDirty)
+    refreshExtremes();
+  return cellsValid ? minIndex + 1 : 0;
+}
+
+uint8_t CellStats::maxCellNo()
+{
+  if (extremesDirty)
+    refreshExtremes();
+  return cellsValid ? maxIndex + 1 : 0;
+}
+
+float CellStats::stddevMv() const
+{
+  if (cellsValid < 2)
+    return 0;
+  const double mean = double(sum) / cellsValid;
+  const double variance = double(sumSq) / cellsValid - (mean * mean);
+  return (variance > 0) ? sqrt(variance) : 0;
+}
+
+uint8_t CellStats::moduleCount() const
+{
+  if (moduleSize == 0)
+    return 0;
+  uint16_t last = kMaxCells;
+  while (last > 0 && mv[last - 1] == 0)
+    last--;
+  const uint16_t modules = (last + moduleSize - 1) / moduleSize;
+  return (modules > kMaxModules) ? kMaxModules : modules;
+}
+
+/**
+ * Max - min of known cells in module (0 if fewer than 2 known cells)
+ */
+uint16_t CellStats::moduleDeltaMv(uint8_t module)
+{
+  if (moduleSize == 0 || module >= kMaxModules)
+    return 0;
+  if (moduleDirty & (1UL << module))
+  {
+    uint16_t lo = 0xFFFF;
+    uint16_t hi = 0;
+    for (uint16_t i = module * moduleSize; i < (module + 1) * moduleSize && i < kMaxCells; i++)
+    {
+      if (mv[i] == 0)
+        continue;
+      lo = (mv[i] < lo) ? mv[i] : lo;
+      hi = (mv[i] > hi) ? mv[i] : hi;
+    }
+    moduleDelta[module] = (hi > lo) ? (hi - lo) : 0;
+    moduleDirty &= ~(1UL << module);
+  }
+  return moduleDelta[module];
+}
+
+uint16_t CellStats::maxModuleDeltaMv()
+{
+  uint16_t result = 0;
+  const uint8_t modules = moduleCount();
+  for (uint8_t m = 0; m < modules; m++)
+  {
+    const uint16_t delta = moduleDeltaMv(m);
+    result = (delta > result) ? delta : result;
+  }
+  return result;
+}
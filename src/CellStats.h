@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * Shared battery cell statistics.
+ *
+ * Car decoders keep writing params.cellVoltage[] and call updateBlock() for the
+ * range they just parsed. Cells are mirrored as packed uint16 millivolts
+ * (0 = unknown) and sum, sum of squares, histogram and min/max are updated per
+ * changed cell, so screens and uploads read ready values instead of rescanning
+ * the float array. A full min/max scan only runs when the current extreme cell
+ * itself changes.
+ */
+class CellStats
+{
+public:
+  static constexpr uint16_t kMaxCells = 200;
+  static constexpr uint8_t kMaxModules = 32;
+  static constexpr uint16_t kHistogramMinMv = 2500;
+  static constexpr uint8_t kHistogramBinMv = 10;
+  static constexpr uint8_t kHistogramBins = 200; // 2.5 .. 4.5 V
+
+  void clear();
+  void setModuleSize(uint8_t cellsPerModule);
+  void updateBlock(const float *voltages, uint16_t first, uint16_t count);
+
+  uint16_t validCount() const { return cellsValid; }
+  uint16_t minMv();
+  uint16_t maxMv();
+  uint8_t minCellNo(); // 1-based, 0 = none
+  uint8_t maxCellNo();
+  uint32_t sumMv() const { return sum; }
+  float avgV() const { return cellsValid ? (sum / float(cellsValid)) / 1000.0f : 0; }
+  float stddevMv() const;
+  uint8_t moduleCount() const;
+  uint16_t moduleDeltaMv(uint8_t module);
+  uint16_t maxModuleDeltaMv();
+  const uint8_t *histogram() const { return bins; }
+  const uint16_t *millivolts() const { return mv; }
+  uint32_t version() const { return changeCounter; } // bumps on every cell change
+
+private:
+  uint16_t mv[kMaxCells] = {};
+  uint16_t cellsValid = 0;
+  uint32_t sum = 0;
+  uint64_t sumSq = 0;
+  uint8_t bins[kHistogramBins] = {};
+  uint32_t changeCounter = 0;
+  // Extremes
+  bool extremesDirty = false;
+  uint16_t minValue = 0;
+  uint16_t maxValue = 0;
+  uint16_t minIndex = 0;
+  uint16_t maxIndex = 0;
+  // Modules
+  uint8_t moduleSize = 8;
+  uint32_t moduleDirty = 0; // bit per module
+  uint16_t moduleDelta[kMaxModules] = {};
+
+  static uint8_t binIndex(uint16_t value);
+  void setCell(uint16_t index, uint16_t value);
+  void refreshExtremes();
+};
@@ -0,0 +1,57 @@
+/**
+ * Charging graph, see ChargingGraph.h.
+ */
+#include "ChargingGraph.h"
+#include <string.h>
+
+void ChargingGraph::clear()
+{
+  memset(values, 0, sizeof(values));
+  memset(validBits, 0, sizeof(validBits));
+}
+
+int ChargingGraph::pointIndex(float socPerc)
+{
+  const int point = int(socPerc);
+  return (point >= 0 && point < kPoints) ? point : -1;
+}
+
+int16_t ChargingGraph::pack(float value)
+{
+  const float scaled = value * kScale + (value >= 0 ? 0.5f : -0.5f);
+  if (scaled >= 32767.0f)
+    return 32767;
+  if (scaled <= -32768.0f)
+    return -32768;
+  return int16_t(scaled);
+}
+
+void ChargingGraph::set(Series series, float socPerc, float value)
+{
+  const int point = pointIndex(socPerc);
+  if (point < 0)
+    return;
+  values[series][point] = pack(value);
+  validBits[series][point >> 5] |= (1UL << (point & 31));
+}
+
+void ChargingGraph::recordPower(float socPerc, float powerKw)
+{
+  const int point = pointIndex(socPerc);
+  if (point < 0)
+    return;
+  const int16_t packed = pack(powerKw);
+  if (!valid(MIN_KW, point) || packed < values[MIN_KW][point])
+    set(MIN_KW, socPerc, powerKw);
+  if (!valid(MAX_KW, point) || packed > values[MAX_KW][point])
+    set(MAX_KW, socPerc, powerKw);
+}
+
+void ChargingGraph::record(float socPerc, float powerKw, float batMinC, float batMaxC, float heaterC, float coolantC)
+{
+  recordPower(socPerc, powerKw);
+  set(BAT_MIN_C, socPerc, batMinC);
+  set(BAT_MAX_C, socPerc, batMaxC);
+  set(HEATER_C, socPerc, heaterC);
+  set(COOLANT_C, socPerc, coolantC);
+}
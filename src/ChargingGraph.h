@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Charging graph (power and temperatures per SoC %).
+ *
+ * Points are packed int16 in 0.1 units (kW / °C) with one validity bit per
+ * point instead of the old -1/-100 float sentinels, 1.3 kB instead of 2.4 kB.
+ * Decoders call record() while charging, the charging screen reads value().
+ */
+class ChargingGraph
+{
+public:
+  static constexpr uint8_t kPoints = 101; // 0..100 %
+  static constexpr float kScale = 10.0f;  // 0.1 kW / 0.1 °C
+
+  enum Series : uint8_t
+  {
+    MIN_KW = 0,
+    MAX_KW,
+    BAT_MIN_C,
+    BAT_MAX_C,
+    HEATER_C,
+    COOLANT_C,
+    SERIES_COUNT
+  };
+
+  void clear();
+  void recordPower(float socPerc, float powerKw); // widens min/max kW of the SoC point
+  void record(float socPerc, float powerKw, float batMinC, float batMaxC, float heaterC, float coolantC);
+  void set(Series series, float socPerc, float value);
+
+  bool valid(Series series, uint8_t point) const
+  {
+    return point < kPoints && (validBits[series][point >> 5] & (1UL << (point & 31))) != 0;
+  }
+  float value(Series series, uint8_t point) const { return values[series][point] / kScale; }
+
+private:
+  int16_t values[SERIES_COUNT][kPoints];
+  uint32_t validBits[SERIES_COUNT][(kPoints + 31) / 32];
+
+  static int pointIndex(float socPerc);
+  static int16_t pack(float value);
+};
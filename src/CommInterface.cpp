@@ -14,6 +14,7 @@
  * receivePID() receives and handles a PID response.
  */
 #include "CommInterface.h"
+#include "ElmResponseMerger.h"
 #include "BoardInterface.h"
 // #include "CarInterface.h"
 #include "LiveData.h"
@@ -151,8 +152,42 @@ bool CommInterface::doNextQueueCommand()
     return false;
   }
 
-  // Send AT command to obd
+  // Command held back by the previous call while its ATSH was sent
+  if (pendingCommand != "")
+  {
+    liveData->commandRequest = pendingCommand;
+    liveData->commandStartChar = pendingStartChar;
+    pendingCommand = "";
+  }
+  else if (!nextAllowedCommand())
+  {
+    return true; // header switch sent, the held back command follows
+  }
+
+  // Adapter already has this header / receive filter
+  if (adapterCommandRedundant(liveData->commandRequest))
+  {
+    syslog->infoNolf(DEBUG_COMM, ">>> Redundant ");
+    syslog->info(DEBUG_COMM, liveData->commandRequest);
+    liveData->canSendNextAtCommand = true;
+    return true;
+  }
+
+  executeQueueCommand();
+  return true;
+}
+
+/**
+ * Moves the queue to the next command allowed by the car and loads it into
+ * commandRequest. ATSH in the loop part is held back until a command of its
+ * ECU is allowed, so headers of fully skipped ECUs are never sent. Returns
+ * false when the header switch was sent instead; the command follows on the
+ * next call.
+ */
+bool CommInterface::nextAllowedCommand()
+{
   bool commandAllowed = false;
+  uint16_t scanned = 0;
   do
   {
     liveData->commandRequest = liveData->commandQueue[liveData->commandQueueIndex].request;
@@ -173,6 +208,7 @@ bool CommInterface::doNextQueueCommand()
     // Contribute data flags
     if (liveData->commandQueueIndex == liveData->commandQueueLoopFrom)
     {
+      adapterInitDone = true;
       if (liveData->params.contributeStatus == CONTRIBUTE_COLLECTING)
       {
         syslog->println("contributeStatus ... ready to send");
@@ -189,7 +225,9 @@ bool CommInterface::doNextQueueCommand()
 
     // Queue optimizer
     commandAllowed = board->carCommandAllowed();
+    const bool loopCommand = (liveData->commandQueueIndex >= liveData->commandQueueLoopFrom);
     liveData->commandQueueIndex++;
+    scanned++;
 
     if (liveData->commandQueueIndex >= liveData->commandQueueCount)
     {
@@ -208,17 +246,88 @@ bool CommInterface::doNextQueueCommand()
       syslog->infoNolf(DEBUG_COMM, ">>> Command skipped ");
       syslog->info(DEBUG_COMM, liveData->commandRequest);
     }
+    else if (loopCommand && liveData->commandRequest.startsWith("ATSH"))
+    {
+      // Sent only if a command of this ECU follows, a whole queue loop without one sends it anyway
+      atshAllowed++;
+      deferredAtsh = liveData->commandRequest;
+      commandAllowed = (scanned > liveData->commandQueueCount);
+    }
 
   } while (!commandAllowed);
 
-  // Execute command
+  // Switch header before the first allowed command of its ECU
+  const String atsh = deferredAtsh;
+  deferredAtsh = "";
+  if (atsh != "" && liveData->commandRequest != atsh && !adapterCommandRedundant(atsh))
+  {
+    pendingCommand = liveData->commandRequest;
+    pendingStartChar = liveData->commandStartChar;
+    liveData->commandRequest = atsh;
+    liveData->commandStartChar = 0;
+    executeQueueCommand();
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Sends commandRequest to the adapter
+ */
+void CommInterface::executeQueueCommand()
+{
+  if (liveData->commandRequest.startsWith("ATSH"))
+    atshSent++;
   syslog->infoNolf(DEBUG_COMM, ">>> ");
   syslog->info(DEBUG_COMM, liveData->commandRequest);
   liveData->responseRowMerged = "";
   liveData->vResponseRowMerged.clear();
   executeCommand(liveData->commandRequest);
+}
 
-  return true;
+/**
+ * Tracks ATSH/ATCRA sent to the adapter. Returns true when the command would
+ * set what the adapter already has. Reset commands clear the tracked state.
+ */
+bool CommInterface::adapterCommandRedundant(const String &cmd)
+{
+  String normalized = cmd;
+  normalized.replace(" ", "");
+  normalized.toUpperCase();
+  if (normalized == "ATZ" || normalized == "ATWS" || normalized == "ATD")
+  {
+    adapterAtsh = "";
+    adapterAtcra = "";
+    return false;
+  }
+  String *tracked = nullptr;
+  if (normalized.startsWith("ATSH"))
+    tracked = &adapterAtsh;
+  else if (normalized.startsWith("ATCRA"))
+    tracked = &adapterAtcra;
+  if (tracked == nullptr)
+  {
+    return false;
+  }
+  if (*tracked == normalized)
+  {
+    return true;
+  }
+  *tracked = normalized;
+  return false;
+}
+
+/**
+ * Adapter was reset or replaced, next connect runs the full init queue
+ */
+void CommInterface::invalidateAdapterState()
+{
+  adapterAtsh = "";
+  adapterAtcra = "";
+  adapterInitDone = false;
+  deferredAtsh = "";
+  pendingCommand = "";
 }
 
 /**
@@ -228,20 +337,18 @@ bool CommInterface::doNextQueueCommand()
  */
 bool CommInterface::parseResponse()
 {
+  const int8_t offset = ElmResponseMerger::payloadOffset(liveData->responseRow.c_str(), liveData->responseRow.length());
+
   // 1 frame data
-  if (liveData->responseRow.length() < 2 || (liveData->responseRow.length() >= 2 && liveData->responseRow.charAt(1) != ':'))
+  if (offset != 2)
   {
     syslog->info(DEBUG_COMM, liveData->responseRow);
   }
 
   // Merge frames 0:xxxx 1:yyyy 2:zzzz to single response xxxxyyyyzzzz string
-  if (liveData->responseRow.length() >= 2 && liveData->responseRow.charAt(1) == ':')
-  {
-    liveData->responseRowMerged += liveData->responseRow.substring(2);
-  }
-  else if (liveData->responseRow.length() >= 4)
+  if (offset >= 0)
   {
-    liveData->responseRowMerged += liveData->responseRow;
+    liveData->responseRowMerged += liveData->responseRow.substring(offset);
   }
 
   return true;
@@ -307,6 +414,12 @@ void CommInterface::parseRowMerged()
   }
 
   liveData->params.lastCanbusResponseTime = liveData->params.currentTime;
+  if (board->bootProfiler.firstResponseAtMs() == 0)
+  {
+    board->bootProfiler.firstResponse();
+    syslog->print("Boot: first response at ms ");
+    syslog->println(board->bootProfiler.firstResponseAtMs());
+  }
 
   // Normalize merged response before car-specific parsing:
   // - keep text error/status responses intact
@@ -21,6 +21,20 @@ protected:
   uint32_t canComparerRecordQueueLoop; // Request to record specified params.queueLoopCounter
   String canComparerData[4] = {"", "", "", ""};
   bool suspendedDevice = false;
+  // Adapter state as last set by the queue, lets it skip redundant ATSH/ATCRA
+  String adapterAtsh = "";
+  String adapterAtcra = "";
+  bool adapterInitDone = false; // init commands (queue before commandQueueLoopFrom) were served
+  // Header switch resolved lazily: ATSH waits until a command of its ECU is allowed
+  String deferredAtsh = "";
+  String pendingCommand = ""; // allowed command held back while its ATSH is sent
+  char pendingStartChar = 0;
+  uint32_t atshAllowed = 0; // ATSH allowed by the car, each was sent before
+  uint32_t atshSent = 0;
+  bool adapterCommandRedundant(const String &cmd);
+  void invalidateAdapterState();
+  bool nextAllowedCommand();
+  void executeQueueCommand();
 
 public:
   void initComm(LiveData *pLiveData, BoardInterface *pBoard);
@@ -47,4 +61,5 @@ public:
   bool isSuspended();
   virtual void suspendDevice() = 0;
   virtual void resumeDevice() = 0;
+  virtual int8_t armWakeOnActivity() { return -1; } // before deep sleep, wake GPIO or -1
 };
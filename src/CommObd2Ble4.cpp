@@ -15,6 +15,10 @@ namespace
   // adapter), canSendNextAtCommand never goes true again and the whole OBD queue
   // hangs until reboot. Re-arm the queue if no '>' arrives within this window.
   constexpr uint32_t kBleCmdTimeoutMs = 4000;
+  // First retry after losing a working link. Later retries use the backoff below.
+  constexpr uint32_t kBleFastRetryMs = 500;
+  // Adapter settings (ATE0, protocol, ...) are trusted this long after its last prompt
+  constexpr uint32_t kAdapterStateValidMs = 30 * 60 * 1000;
 
   // BLE connect/disconnect events are signalled from the BLE callback task and the
   // user-facing message is rendered later from the loop task (TFT/sprite work must
@@ -205,35 +209,31 @@ class MySecurity : public BLESecurityCallbacks
 static void notifyCallback(BLERemoteCharacteristic *pBLERemoteCharacteristic, uint8_t *pData, size_t length, bool isNotify)
 {
 
-  char ch;
-
-  // Parse multiframes to single response. responseRow deliberately persists across
-  // notifications: an ELM327 line split over two BLE packets is completed by the
-  // next packet instead of being dropped (frozen 620101/power values, issue #107).
-  // It is cleared in executeCommand() before each new command.
+  // Parse multiframes to single response. The unfinished row deliberately persists
+  // across notifications: an ELM327 line split over two BLE packets is completed by
+  // the next packet instead of being dropped (frozen 620101/power values, issue #107).
+  // It is dropped in executeCommand() before each new command.
   for (size_t i = 0; i < length; i++)
   {
-    ch = pData[i];
-    if (ch == '\r' || ch == '\n' || ch == '\0')
-    {
-      if (liveDataObj->responseRow != "")
-        commObj->parseResponse();
-      liveDataObj->responseRow = "";
-    }
-    else
+    switch (commObj->elmRows.feed(char(pData[i])))
     {
-      liveDataObj->responseRow += ch;
-      if (liveDataObj->responseRow == ">")
+    case ElmResponseMerger::ELM_ROW:
+      liveDataObj->responseRow = commObj->elmRows.row();
+      commObj->parseResponse();
+      break;
+    case ElmResponseMerger::ELM_PROMPT:
+      commObj->promptReceived();
+      if (liveDataObj->responseRowMerged != "")
       {
-        if (liveDataObj->responseRowMerged != "")
-        {
-          syslog->infoNolf(DEBUG_COMM, "merged: ");
-          syslog->info(DEBUG_COMM, liveDataObj->responseRowMerged);
-          commObj->parseRowMerged();
-        }
-        liveDataObj->responseRowMerged = "";
-        liveDataObj->canSendNextAtCommand = true;
+        syslog->infoNolf(DEBUG_COMM, "merged: ");
+        syslog->info(DEBUG_COMM, liveDataObj->responseRowMerged);
+        commObj->parseRowMerged();
       }
+      liveDataObj->responseRowMerged = "";
+      liveDataObj->canSendNextAtCommand = true;
+      break;
+    default:
+      break;
     }
   }
 }
@@ -249,6 +249,15 @@ void CommObd2Ble4::connectDevice()
   boardObj = board;
 
   syslog->println("BLE4 connectDevice");
+#ifdef EVDASH_BLE_SIM
+  syslog->print("ELM327 simulator, script lines: ");
+  syslog->println(elmSim.loadScript(kCanSimDefaultScript));
+  liveData->commConnected = true;
+  liveData->obd2ready = false;
+  connectStatus = "Connected (sim)";
+  doNextQueueCommand();
+  return;
+#endif
   connectFailCount = 0;
   nextConnectRetryMs = 0;
   liveData->commConnected = false;
@@ -288,6 +297,10 @@ void CommObd2Ble4::disconnectDevice()
 {
 
   syslog->println("COMM disconnectDevice");
+#ifdef EVDASH_BLE_SIM
+  liveData->commConnected = false;
+  return;
+#endif
 #ifdef EVDASH_USE_NIMBLE
   BLEDevice::deinit(false);
 #else
@@ -422,10 +435,106 @@ bool CommObd2Ble4::connectToServer(BLEAddress pAddress)
   syslog->println("Successfully connected to BLE device.");
   board->displayMessage("> Successfully connected", pAddress.toString().c_str());
 
-  // Discover all services. NimBLE returns a vector, Bluedroid a map.
+  // GATT handles: cached map from the last session first, full discovery otherwise
   liveData->pRemoteCharacteristic = nullptr;
   liveData->pRemoteCharacteristicWrite = nullptr;
+  const String address = pAddress.toString().c_str();
+  if (gattCacheAddress == address && attachCharacteristics(gattCacheService, gattCacheTx, gattCacheRx))
+  {
+    syslog->println("GATT characteristics attached from cache.");
+  }
+  else
+  {
+    if (!discoverCharacteristics())
+    {
+      return false;
+    }
+    if (liveData->pRemoteCharacteristic != nullptr && liveData->pRemoteCharacteristicWrite != nullptr)
+    {
+      gattCacheAddress = address;
+      gattCacheService = liveData->pRemoteCharacteristic->getRemoteService()->getUUID().toString().c_str();
+      gattCacheTx = liveData->pRemoteCharacteristic->getUUID().toString().c_str();
+      gattCacheRx = liveData->pRemoteCharacteristicWrite->getUUID().toString().c_str();
+    }
+  }
+
+  // Check if Tx and Rx characteristics were found
+  if (liveData->pRemoteCharacteristic == nullptr || liveData->pRemoteCharacteristicWrite == nullptr)
+  {
+    syslog->println("Failed to detect Tx/Rx characteristics.");
+    liveData->pClient->disconnect();
+    return false;
+  }
+
+  syslog->println("Successfully detected service and characteristics.");
 
+  // Enable indications on the Tx characteristic (CCCD = {0x02,0x00}).
+#ifdef EVDASH_USE_NIMBLE
+  // NimBLE writes the CCCD itself: subscribe(false,...) = indications, matching the
+  // old {0x02,0x00} write + registerForNotify(cb, false). Fall back to notifications.
+  if (liveData->pRemoteCharacteristic->canIndicate())
+  {
+    liveData->pRemoteCharacteristic->subscribe(false, notifyCallback, true);
+    delay(200);
+  }
+  else if (liveData->pRemoteCharacteristic->canNotify())
+  {
+    liveData->pRemoteCharacteristic->subscribe(true, notifyCallback, true);
+    delay(200);
+  }
+#else
+  if (liveData->pRemoteCharacteristic->canNotify())
+  {
+    const uint8_t indicationOn[] = {0x2, 0x0};
+    BLERemoteDescriptor *notifyDescriptor = liveData->pRemoteCharacteristic->getDescriptor(BLEUUID((uint16_t)0x2902));
+    if (notifyDescriptor != nullptr)
+    {
+      notifyDescriptor->writeValue((uint8_t *)indicationOn, 2, true);
+    }
+    else
+    {
+      syslog->println("Notify descriptor 0x2902 not found. Registering callback only.");
+    }
+    liveData->pRemoteCharacteristic->registerForNotify(notifyCallback, false);
+    delay(200);
+  }
+#endif
+
+  syslog->println("BLE device is ready for communication.");
+  return true;
+}
+
+/**
+ * Looks up the Tx/Rx characteristics by UUID, without walking all services
+ */
+bool CommObd2Ble4::attachCharacteristics(const String &service, const String &tx, const String &rx)
+{
+  if (service.length() < 4 || tx.length() < 4 || rx.length() < 4)
+  {
+    return false;
+  }
+  BLERemoteService *pRemoteService = liveData->pClient->getService(BLEUUID(service.c_str()));
+  if (pRemoteService == nullptr)
+  {
+    return false;
+  }
+  BLERemoteCharacteristic *pTx = pRemoteService->getCharacteristic(BLEUUID(tx.c_str()));
+  BLERemoteCharacteristic *pRx = pRemoteService->getCharacteristic(BLEUUID(rx.c_str()));
+  if (pTx == nullptr || pRx == nullptr || !pTx->canNotify() || !pRx->canWrite())
+  {
+    return false;
+  }
+  liveData->pRemoteCharacteristic = pTx;
+  liveData->pRemoteCharacteristicWrite = pRx;
+  return true;
+}
+
+/**
+ * Full service discovery, first notify / write characteristic wins.
+ * NimBLE returns a vector, Bluedroid a map.
+ */
+bool CommObd2Ble4::discoverCharacteristics()
+{
 #ifdef EVDASH_USE_NIMBLE
   std::vector<BLERemoteService *> *services = liveData->pClient->getServices(true);
   if (services == nullptr || services->empty())
@@ -500,49 +609,7 @@ bool CommObd2Ble4::connectToServer(BLEAddress pAddress)
   }
 #endif
 
-  // Check if Tx and Rx characteristics were found
-  if (liveData->pRemoteCharacteristic == nullptr || liveData->pRemoteCharacteristicWrite == nullptr)
-  {
-    syslog->println("Failed to detect Tx/Rx characteristics.");
-    liveData->pClient->disconnect();
-    return false;
-  }
 
-  syslog->println("Successfully detected service and characteristics.");
-
-  // Enable indications on the Tx characteristic (CCCD = {0x02,0x00}).
-#ifdef EVDASH_USE_NIMBLE
-  // NimBLE writes the CCCD itself: subscribe(false,...) = indications, matching the
-  // old {0x02,0x00} write + registerForNotify(cb, false). Fall back to notifications.
-  if (liveData->pRemoteCharacteristic->canIndicate())
-  {
-    liveData->pRemoteCharacteristic->subscribe(false, notifyCallback, true);
-    delay(200);
-  }
-  else if (liveData->pRemoteCharacteristic->canNotify())
-  {
-    liveData->pRemoteCharacteristic->subscribe(true, notifyCallback, true);
-    delay(200);
-  }
-#else
-  if (liveData->pRemoteCharacteristic->canNotify())
-  {
-    const uint8_t indicationOn[] = {0x2, 0x0};
-    BLERemoteDescriptor *notifyDescriptor = liveData->pRemoteCharacteristic->getDescriptor(BLEUUID((uint16_t)0x2902));
-    if (notifyDescriptor != nullptr)
-    {
-      notifyDescriptor->writeValue((uint8_t *)indicationOn, 2, true);
-    }
-    else
-    {
-      syslog->println("Notify descriptor 0x2902 not found. Registering callback only.");
-    }
-    liveData->pRemoteCharacteristic->registerForNotify(notifyCallback, false);
-    delay(200);
-  }
-#endif
-
-  syslog->println("BLE device is ready for communication.");
   return true;
 }
 
@@ -570,12 +637,16 @@ void CommObd2Ble4::mainLoop()
       lastBleCmdSentMs != 0 && (uint32_t)(millis() - lastBleCmdSentMs) > kBleCmdTimeoutMs)
   {
     syslog->println("BLE queue stall: no '>' prompt, re-arming command queue.");
-    liveData->responseRow = "";
+    elmRows.reset();
     liveData->responseRowMerged = "";
     liveData->canSendNextAtCommand = true;
     lastBleCmdSentMs = millis();
   }
 
+#ifdef EVDASH_BLE_SIM
+  simLoop();
+#endif
+
   // Connect BLE device
   if (liveData->obd2ready == true && hasConfiguredBleMac(liveData->settings.obdMacAddress))
   {
@@ -603,11 +674,7 @@ void CommObd2Ble4::mainLoop()
           syslog->println("We are now connected to the BLE device.");
           connectStatus = "Connected";
 
-          // Print message
-          board->displayMessage(" > Processing init AT cmds", "");
-
-          // Serve first command (ATZ)
-          doNextQueueCommand();
+          startCommandQueue();
         }
         else
         {
@@ -615,7 +682,7 @@ void CommObd2Ble4::mainLoop()
           syslog->println("We have failed to connect to the server; scheduling retry.");
           if (connectFailCount < 0xFF)
             connectFailCount++;
-          const uint32_t retryDelayMs = calcConnectRetryDelayMs(connectFailCount);
+          const uint32_t retryDelayMs = (adapterInitDone && connectFailCount == 1) ? kBleFastRetryMs : calcConnectRetryDelayMs(connectFailCount);
           nextConnectRetryMs = nowMs + retryDelayMs;
           connectStatus = String("Retry in ") + String(retryDelayMs / 1000) + "s";
         }
@@ -633,6 +700,57 @@ void CommObd2Ble4::mainLoop()
   }
 }
 
+/**
+ * Starts the queue after a connect. An adapter initialized in the last
+ * kAdapterStateValidMs keeps its settings, so the init commands (ATZ ...)
+ * are skipped; the first answer is checked for an adapter reset.
+ */
+void CommObd2Ble4::startCommandQueue()
+{
+  // Header/filter may have been lost with the link, send them again
+  adapterAtsh = "";
+  adapterAtcra = "";
+  deferredAtsh = "";
+  pendingCommand = "";
+  if (adapterInitDone && lastPromptMs != 0 && millis() - lastPromptMs < kAdapterStateValidMs)
+  {
+    syslog->println("Fast resume, adapter init skipped.");
+    liveData->commandQueueIndex = liveData->commandQueueLoopFrom;
+    verifyAdapterState = true;
+  }
+  else
+  {
+    board->displayMessage(" > Processing init AT cmds", "");
+    invalidateAdapterState();
+    liveData->commandQueueIndex = 0;
+    verifyAdapterState = false;
+  }
+  doNextQueueCommand();
+}
+
+/**
+ * ELM '>' prompt, called from notifyCallback before the merged response is parsed.
+ * An echoed command or the ELM banner after a fast resume means the adapter
+ * lost power meanwhile, so the queue restarts with the init commands.
+ */
+void CommObd2Ble4::promptReceived()
+{
+  lastPromptMs = millis();
+  if (!verifyAdapterState)
+  {
+    return;
+  }
+  verifyAdapterState = false;
+  String sent = liveData->commandRequest;
+  sent.replace(" ", "");
+  if (liveData->responseRowMerged.startsWith(sent) || liveData->responseRowMerged.indexOf("ELM") >= 0)
+  {
+    syslog->println("Adapter was reset, running full init.");
+    invalidateAdapterState();
+    liveData->commandQueueIndex = 0;
+  }
+}
+
 /**
  * Send command
  */
@@ -645,14 +763,77 @@ void CommObd2Ble4::executeCommand(String cmd)
   if (liveData->commConnected && liveData->pRemoteCharacteristicWrite != nullptr)
   {
     // Drop any unfinished line fragment from the previous response so it cannot
-    // prepend itself to this command's response (responseRow persists across
-    // BLE notifications, see notifyCallback).
-    liveData->responseRow = "";
+    // prepend itself to this command's response (rows persist across BLE
+    // notifications, see notifyCallback).
+    elmRows.reset();
     liveData->pRemoteCharacteristicWrite->writeValue(tmpStr.c_str(), tmpStr.length());
     lastBleCmdSentMs = millis(); // arm the queue-stall watchdog
   }
+#ifdef EVDASH_BLE_SIM
+  else if (liveData->commConnected)
+  {
+    elmRows.reset();
+    elmSim.write(tmpStr.c_str(), tmpStr.length());
+    lastBleCmdSentMs = millis();
+  }
+#endif
 }
 
+#ifdef EVDASH_BLE_SIM
+/**
+ * Runs the adapter emulator and hands its notifications to the real
+ * notifyCallback(). Every kSimReportMs the log shows PIDs/s, round trip
+ * and notification counters.
+ */
+void CommObd2Ble4::simLoop()
+{
+  const uint32_t nowMs = millis();
+  elmSim.loop(nowMs);
+  uint8_t notification[64];
+  uint8_t length;
+  while ((length = elmSim.read(notification, sizeof(notification), nowMs)) != 0)
+  {
+    notifyCallback(nullptr, notification, length, true);
+  }
+
+  if (simReportMs == 0)
+  {
+    simReportMs = nowMs;
+    return;
+  }
+  const uint32_t elapsedMs = nowMs - simReportMs;
+  if (elapsedMs < kSimReportMs)
+  {
+    return;
+  }
+  const Elm327Sim::Stats &stats = elmSim.stats();
+  const uint32_t answered = stats.answered - simReportStats.answered;
+  const uint32_t commands = stats.commands - simReportStats.commands;
+  const uint32_t loops = liveData->params.queueLoopCounter - simReportLoops;
+  char line[160];
+  snprintf(line, sizeof(line), "SIM ELM %lu.%lu PID/s, queue loop %lu ms, rtt avg %lu max %lu ms, no data %lu, notify %lu (%lu B), searching %lu",
+           (unsigned long)(answered * 1000 / elapsedMs), (unsigned long)((answered * 10000 / elapsedMs) % 10),
+           (unsigned long)(loops ? elapsedMs / loops : 0),
+           (unsigned long)(commands ? (stats.roundTripSumMs - simReportStats.roundTripSumMs) / commands : 0),
+           (unsigned long)stats.roundTripMaxMs, (unsigned long)(stats.noData - simReportStats.noData),
+           (unsigned long)(stats.notifications - simReportStats.notifications),
+           (unsigned long)(stats.bytes - simReportStats.bytes), (unsigned long)stats.searching);
+  syslog->println(line);
+  // ATSH allowed by the car (all sent before lazy header switching) vs. sent
+  snprintf(line, sizeof(line), "SIM ELM ATSH per loop %lu.%02lu (was %lu.%02lu)",
+           (unsigned long)(loops ? (atshSent - simReportAtshSent) / loops : 0),
+           (unsigned long)(loops ? (atshSent - simReportAtshSent) * 100 / loops % 100 : 0),
+           (unsigned long)(loops ? (atshAllowed - simReportAtshAllowed) / loops : 0),
+           (unsigned long)(loops ? (atshAllowed - simReportAtshAllowed) * 100 / loops % 100 : 0));
+  syslog->println(line);
+  simReportMs = nowMs;
+  simReportStats = stats;
+  simReportLoops = liveData->params.queueLoopCounter;
+  simReportAtshAllowed = atshAllowed;
+  simReportAtshSent = atshSent;
+}
+#endif
+
 /**
  * Suspends the CAN device by setting it to sleep mode.
  * Stops communication and minimizes power consumption.
@@ -3,6 +3,10 @@
 #include "ble_compat.h"
 #include "LiveData.h"
 #include "CommInterface.h"
+#include "ElmResponseMerger.h"
+#ifdef EVDASH_BLE_SIM
+#include "Elm327Sim.h"
+#endif
 
 class CommObd2Ble4 : public CommInterface
 {
@@ -12,8 +16,30 @@ protected:
   uint32_t nextConnectRetryMs = 0;
   uint8_t connectFailCount = 0;
   uint32_t lastBleCmdSentMs = 0; // for the queue-stall watchdog (lost ELM '>' prompt)
+  // Fast reconnect: GATT handle map and adapter init state of the last session
+  String gattCacheAddress = "";
+  String gattCacheService = "";
+  String gattCacheTx = "";
+  String gattCacheRx = "";
+  uint32_t lastPromptMs = 0;
+  bool verifyAdapterState = false; // first answer after a fast resume checks for an adapter reset
+#ifdef EVDASH_BLE_SIM
+  Elm327Sim elmSim; // adapter emulator instead of a BLE dongle
+  uint32_t simReportMs = 0;
+  Elm327Sim::Stats simReportStats = {};
+  uint32_t simReportLoops = 0;
+  uint32_t simReportAtshAllowed = 0;
+  uint32_t simReportAtshSent = 0;
+  static constexpr uint32_t kSimReportMs = 10000;
+  void simLoop();
+#endif
+
+  bool attachCharacteristics(const String &service, const String &tx, const String &rx);
+  bool discoverCharacteristics();
+  void startCommandQueue();
 
 public:
+  ElmResponseMerger elmRows; // ELM output split into rows, fed by notifyCallback()
   void connectDevice() override;
   void disconnectDevice() override;
   void scanDevices() override;
@@ -21,6 +47,7 @@ public:
   void executeCommand(String cmd) override;
   void startBleScan();
   bool connectToServer(BLEAddress pAddress);
+  void promptReceived();
   void suspendDevice() override;
   void resumeDevice() override;
 };
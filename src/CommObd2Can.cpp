@@ -2,6 +2,7 @@
 #include "BoardInterface.h"
 #include "LiveData.h"
 #include <mcp_can.h>
+#include <SPI.h>
 
 // #include <string.h>
 
@@ -21,6 +22,26 @@ static inline uint8_t hexPairToByte(const char *p)
   return static_cast<uint8_t>((hexNibble(p[0]) << 4) | hexNibble(p[1]));
 }
 
+#ifndef EVDASH_CAN_SIM
+// MCP2515 registers used before sleep (MCP_CAN keeps its register access private)
+static const uint8_t kMcpBitModify = 0x05;
+static const uint8_t kMcpCanInte = 0x2B;
+static const uint8_t kMcpCanIntf = 0x2C;
+static const uint8_t kMcpRxIe = 0x03; // RX0IE | RX1IE
+
+static void mcp2515BitModify(uint8_t csPin, uint8_t address, uint8_t mask, uint8_t data)
+{
+  SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));
+  digitalWrite(csPin, LOW);
+  SPI.transfer(kMcpBitModify);
+  SPI.transfer(address);
+  SPI.transfer(mask);
+  SPI.transfer(data);
+  digitalWrite(csPin, HIGH);
+  SPI.endTransaction();
+}
+#endif // EVDASH_CAN_SIM
+
 /**
  * Connects to the CAN bus adapter.
  * Initializes the MCP2515 CAN controller, configures the bitrate, masks,
@@ -33,8 +54,17 @@ void CommObd2Can::connectDevice()
   syslog->println("CAN connectDevice");
   connectStatus = "Connecting...";
 
+#ifdef EVDASH_CAN_SIM
+  CAN.reset(new CanSimBus());
+  if (CAN != nullptr)
+  {
+    syslog->print("CAN simulator, script lines: ");
+    syslog->println(CAN->loadScript(kCanSimDefaultScript));
+  }
+#else
   // CAN = new MCP_CAN(pinCanCs); // todo: remove if smart pointer is ok
   CAN.reset(new MCP_CAN(&SPI, pinCanCs)); // smart pointer so it's automatically cleaned when out of context and also free to re-init
+#endif
   sentCanData = false;
   if (CAN == nullptr)
   {
@@ -63,33 +93,7 @@ void CommObd2Can::connectDevice()
     return;
   }
 
-  if (liveData->settings.carType == CAR_BMW_I3_2014)
-  {
-    // initialise mask and filter to allow only receipt of 0x7xx CAN IDs
-    CAN->init_Mask(0, 0, 0x07000000); // Init first mask...
-    CAN->init_Mask(1, 0, 0x07000000); // Init second mask...
-    for (uint8_t i = 0; i < 6; ++i)
-    {
-      CAN->init_Filt(i, 0, 0x06000000); // Init filters
-    }
-  }
-  else if (liveData->settings.carType == CAR_PEUGEOT_E208)
-  {
-    // PSA e-CMP: the OBD port is the live high-speed CAN with hundreds of broadcast
-    // frames/s. With the masks open the MCP2515's two RX buffers overflow with
-    // broadcast and the diagnostic reply is dropped before the firmware reads it
-    // (a plugged-in ELM327 works here because ATCRA programs the same hardware filter).
-    // Accept only the e-208 response IDs. For this library a standard 11-bit id is
-    // written as (id << 16); mask 0x07FF0000 is an exact 11-bit match (see mcp2515_write_mf).
-    CAN->init_Mask(0, 0, 0x07FF0000); // RXB0 exact match
-    CAN->init_Mask(1, 0, 0x07FF0000); // RXB1 exact match
-    CAN->init_Filt(0, 0, 0x07E80000); // 0x7E8 VIN (mode 09)
-    CAN->init_Filt(1, 0, 0x058F0000); // 0x58F charger / DC-DC
-    CAN->init_Filt(2, 0, 0x06820000); // 0x682 VCU
-    CAN->init_Filt(3, 0, 0x06940000); // 0x694 BMS / TBMU
-    CAN->init_Filt(4, 0, 0x06940000); // 0x694 (dup, BMS carries the bulk + multiframe)
-    CAN->init_Filt(5, 0, 0x06940000); // 0x694 (dup)
-  }
+  setupAcceptanceFilters();
 
   if (MCP2515_OK != CAN->setMode(MCP_NORMAL))
   { // Set operation mode to normal so the MCP2515 sends acks to received data.
@@ -111,6 +115,97 @@ void CommObd2Can::connectDevice()
   syslog->println("init_can() done");
 }
 
+/**
+ * Programs the MCP2515 masks/filters.
+ *
+ * Masks default to accept-all. Cars that register response IDs
+ * (CarInterface::registerCanAcceptance()) get acceptance computed from that
+ * ID set, so a busy broadcast bus cannot overflow the two RX buffers with
+ * frames nobody reads.
+ */
+void CommObd2Can::setupAcceptanceFilters()
+{
+  acceptance.clear();
+  board->registerCanAcceptance(acceptance);
+
+  if (liveData->settings.carType == CAR_BMW_I3_2014)
+  {
+    // initialise mask and filter to allow only receipt of 0x7xx CAN IDs
+    CAN->init_Mask(0, 0, 0x07000000); // Init first mask...
+    CAN->init_Mask(1, 0, 0x07000000); // Init second mask...
+    for (uint8_t i = 0; i < 6; ++i)
+    {
+      CAN->init_Filt(i, 0, 0x06000000); // Init filters
+    }
+    return;
+  }
+
+  CanFilterPlan plan;
+  if (!acceptance.filterPlan(plan))
+  {
+    return;
+  }
+  // For this library a standard 11-bit id is written as (id << 16); mask 0x07FF0000 is an exact match
+  CAN->init_Mask(0, 0, uint32_t(plan.mask[0]) << 16);
+  CAN->init_Mask(1, 0, uint32_t(plan.mask[1]) << 16);
+  for (uint8_t i = 0; i < 6; i++)
+  {
+    CAN->init_Filt(i, 0, uint32_t(plan.filter[i]) << 16);
+  }
+  syslog->print("CAN acceptance: ");
+  syslog->print(plan.acceptedIds);
+  syslog->print(" ids for ");
+  syslog->print(acceptance.idCount());
+  syslog->println(" registered");
+}
+
+/**
+ * MCP2515 pulls /INT low while a frame waits in an RX buffer
+ */
+bool CommObd2Can::frameAvailable()
+{
+#ifdef EVDASH_CAN_SIM
+  return CAN->checkReceive() == CAN_MSGAVAIL;
+#else
+  return !digitalRead(pinCanInt);
+#endif
+}
+
+#ifdef EVDASH_CAN_SIM
+/**
+ * Throughput of the comm pipeline against the simulator, printed every kSimReportMs
+ */
+void CommObd2Can::simReport()
+{
+  const uint32_t nowMs = millis();
+  if (simReportMs == 0)
+  {
+    simReportMs = nowMs;
+    return;
+  }
+  const uint32_t elapsedMs = nowMs - simReportMs;
+  if (elapsedMs < kSimReportMs || !CAN)
+  {
+    return;
+  }
+  const CanSimBus::Stats &stats = CAN->stats();
+  const uint32_t responses = stats.responses - simReportResponses;
+  const uint32_t timeouts = timeoutsComm - simReportTimeouts;
+  const uint32_t loops = liveData->params.queueLoopCounter - simReportLoops;
+  char line[160];
+  snprintf(line, sizeof(line), "SIM %lu.%lu PID/s, queue loop %lu ms, timeouts %lu/%lu, pending %lu lost %lu neg %lu noise %lu filt %lu ovr %lu",
+           (unsigned long)(responses * 1000 / elapsedMs), (unsigned long)((responses * 10000 / elapsedMs) % 10),
+           (unsigned long)(loops ? elapsedMs / loops : 0), (unsigned long)timeouts, (unsigned long)(responses + timeouts),
+           (unsigned long)stats.pending, (unsigned long)stats.lost, (unsigned long)stats.negative,
+           (unsigned long)stats.noiseFrames, (unsigned long)stats.filtered, (unsigned long)stats.overruns);
+  syslog->println(line);
+  simReportMs = nowMs;
+  simReportResponses = stats.responses;
+  simReportTimeouts = timeoutsComm;
+  simReportLoops = liveData->params.queueLoopCounter;
+}
+#endif
+
 /**
  * Disconnects the CAN device by setting commConnected to false and connectStatus to "Disconnected".
  * Also prints a message to syslog.
@@ -176,6 +271,9 @@ void CommObd2Can::mainLoop()
   }
 
   CommInterface::mainLoop();
+#ifdef EVDASH_CAN_SIM
+  simReport();
+#endif
 
   // Prevent errors without connected module
   if (!liveData->commConnected)
@@ -210,6 +308,7 @@ void CommObd2Can::mainLoop()
       if (lastDataSent != 0 && (unsigned long)(millis() - lastDataSent) > liveData->rxTimeoutMs)
       {
         syslog->info(DEBUG_COMM, "CAN execution timeout (multiframe message).");
+        timeoutsComm++;
         connectStatus = "Timeout (multiframe)";
         sentCanData = false;
         break;
@@ -225,6 +324,7 @@ void CommObd2Can::mainLoop()
   if (lastDataSent != 0 && (unsigned long)(millis() - lastDataSent) > liveData->rxTimeoutMs)
   {
     syslog->info(DEBUG_COMM, "CAN execution timeout. Continue with next command.");
+    timeoutsComm++;
     connectStatus = "CAN timeout";
     sentCanData = false;
     liveData->canSendNextAtCommand = true;
@@ -457,7 +557,7 @@ void CommObd2Can::sendFlowControlFrame()
 uint8_t CommObd2Can::receivePID()
 {
   const uint8_t rxBuffOffset = liveData->bAdditionalStartingChar ? 1 : 0;
-  if (!digitalRead(pinCanInt) && sentCanData == true) // If CAN0_INT pin is low, read receive buffer
+  if (frameAvailable() && sentCanData == true) // If CAN0_INT pin is low, read receive buffer
   {
     syslog->infoNolf(DEBUG_COMM, " CAN READ ");
     CAN->readMsgBuf(&rxId, &rxLen, rxBuf); // Read data: len = data length, buf = data byte(s)
@@ -584,25 +684,30 @@ void printHexBuffer(uint8_t *pData, const uint16_t length, const bool bAddNewLin
 }
 
 /**
- * Converts a byte buffer to a hexadecimal string representation.
- *
- * Takes a byte buffer and length, iterates through each byte,
- * converts it to a two-character hexadecimal string, and appends to
- * the output string parameter.
+ * Appends a byte buffer as uppercase hex to a string.
  *
- * @param out_targetString String to append hexadecimal representation to.
- * @param in_pBuffer Pointer to byte buffer to convert.
- * @param in_length Length of the byte buffer.
+ * Encodes through a small stack chunk, so a long response costs a few
+ * String appends instead of one sprintf and append per byte.
  */
-static void buffer2string(String &out_targetString, uint8_t *in_pBuffer, const uint16_t in_length)
+static void buffer2string(String &out_targetString, const uint8_t *in_pBuffer, const uint16_t in_length)
 {
-  char str[8] = {0};
+  static const char kHexDigits[] = "0123456789ABCDEF";
+  char chunk[129];
+  uint8_t pos = 0;
 
   for (uint16_t i = 0; i < in_length; i++)
   {
-    sprintf(str, "%.2X", in_pBuffer[i]);
-    out_targetString += str;
+    chunk[pos++] = kHexDigits[in_pBuffer[i] >> 4];
+    chunk[pos++] = kHexDigits[in_pBuffer[i] & 0x0F];
+    if (pos == sizeof(chunk) - 1)
+    {
+      chunk[pos] = '\0';
+      out_targetString += chunk;
+      pos = 0;
+    }
   }
+  chunk[pos] = '\0';
+  out_targetString += chunk;
 }
 
 /**
@@ -630,11 +735,10 @@ CommObd2Can::enFrame_t CommObd2Can::getFrameType(const uint8_t firstByte)
 /**
  * Processes a CAN frame on the byte level according to ISO 15765-2.
  *
- * Determines the frame type based on the first byte. For single frames,
- * processes the payload directly. For first frames, stores the payload
- * and expects consecutive frames to follow. For consecutive frames,
- * stores the payload and keeps track of remaining bytes. When all bytes
- * received, merges the payloads into a single buffer.
+ * Determines the frame type based on the first byte and hands the payload
+ * to the ISO-TP reassembler, which copies consecutive frames straight to
+ * their offset by sequence number. Once all frames arrived the message is
+ * published as hex string and byte vector.
  *
  * Returns true if frame processed successfully, false on error.
  */
@@ -643,81 +747,39 @@ bool CommObd2Can::processFrameBytes()
   const uint8_t rxBuffOffset = liveData->bAdditionalStartingChar ? 1 : 0;
   uint8_t *pDataStart = rxBuf + rxBuffOffset; // set pointer to data start based on specific offset of car
   const auto frameType = getFrameType(*pDataStart);
+  if (rxLen <= rxBuffOffset)
+  {
+    return false;
+  }
   const uint8_t frameLenght = rxLen - rxBuffOffset;
+  IsoTpReassembler::Result result;
 
   switch (frameType)
   {
   case enFrame_t::single: // Single frame
   {
-    struct SingleFrame_t
-    {
-      uint8_t size : 4;
-      uint8_t frameType : 4;
-      uint8_t pData[];
-    };
-
-    SingleFrame_t *pSingleFrame = (SingleFrame_t *)pDataStart;
-    mergedData.assign(pSingleFrame->pData, pSingleFrame->pData + pSingleFrame->size);
-
-    rxRemaining = 0;
-
-    // syslog->print("----Processing SingleFrame payload: "); printHexBuffer(pSingleFrame->pData, pSingleFrame->size, true);
-
-    // single frame - process directly
-    buffer2string(liveData->responseRowMerged, mergedData.data(), mergedData.size());
-    liveData->vResponseRowMerged.assign(mergedData.begin(), mergedData.end());
-    processMergedResponse();
-
-    return true;
+    uint8_t size = pDataStart[0] & 0x0F;
+    if (size > frameLenght - 1)
+      size = frameLenght - 1;
+    result = isoTp.single(pDataStart + 1, size);
   }
   break;
 
   case enFrame_t::first: // First frame
   {
-    struct FirstFrame_t
-    {
-      uint8_t sizeMSB : 4;
-      uint8_t frameType : 4;
-      uint8_t sizeLSB : 8;
-      uint8_t pData[];
-
-      uint16_t lengthOfFullPacket() { return (256 * sizeMSB) + sizeLSB; }
-    };
-
-    FirstFrame_t *pFirstFrame = (FirstFrame_t *)pDataStart;
-
-    rxRemaining = pFirstFrame->lengthOfFullPacket(); // length of complete data
-    requestFramesCount = 0;                          // ISO-TP block size 0 = request all remaining frames
-
-    mergedData.clear();
-    dataRows.clear();
-
-    const uint8_t framePayloadSize = frameLenght - sizeof(FirstFrame_t); // remove one byte of header
-    dataRows[0].assign(pFirstFrame->pData, pFirstFrame->pData + framePayloadSize);
-    rxRemaining -= framePayloadSize;
-
-    // syslog->print("----Processing FirstFrame payload: "); printHexBuffer(pFirstFrame->pData, framePayloadSize, true);
+    const uint16_t lengthOfFullPacket = ((pDataStart[0] & 0x0F) << 8) | pDataStart[1];
+    requestFramesCount = 0; // ISO-TP block size 0 = request all remaining frames
+    result = isoTp.first(lengthOfFullPacket, pDataStart + 2, (frameLenght > 2) ? frameLenght - 2 : 0);
   }
   break;
 
   case enFrame_t::consecutive: // Consecutive frame
   {
-    struct ConsecutiveFrame_t
+    result = isoTp.consecutive(pDataStart[0] & 0x0F, pDataStart + 1, frameLenght - 1);
+    if (result == IsoTpReassembler::ISOTP_DUPLICATE || result == IsoTpReassembler::ISOTP_OUT_OF_WINDOW)
     {
-      uint8_t index : 4;
-      uint8_t frameType : 4;
-      uint8_t pData[];
-    };
-
-    // const uint8_t structSize = sizeof(ConsecutiveFrame_t);
-    // syslog->print("[debug] sizeof(ConsecutiveFrame_t) is expected to be 1 and it's "); syslog->println(structSize);
-
-    ConsecutiveFrame_t *pConseqFrame = (ConsecutiveFrame_t *)pDataStart;
-    const uint8_t framePayloadSize = frameLenght - sizeof(ConsecutiveFrame_t); // remove one byte of header
-    dataRows[pConseqFrame->index].assign(pConseqFrame->pData, pConseqFrame->pData + framePayloadSize);
-    rxRemaining -= framePayloadSize;
-
-    // syslog->print("----Processing ConsecFrame payload: "); printHexBuffer(pConseqFrame->pData, framePayloadSize, true);
+      syslog->info(DEBUG_COMM, (result == IsoTpReassembler::ISOTP_DUPLICATE) ? "ISO-TP duplicate frame ignored" : "ISO-TP frame out of window ignored");
+    }
   }
   break;
 
@@ -729,26 +791,24 @@ bool CommObd2Can::processFrameBytes()
     break;
   } // \switch (frameType)
 
-  // Merge data if all data was received
-  if (rxRemaining <= 0)
+  rxRemaining = isoTp.remaining();
+  if (result == IsoTpReassembler::ISOTP_COMPLETE)
   {
-    // multiple frames and no data remaining - merge everything to single packet
-    for (int i = 0; i < dataRows.size(); i++)
-    {
-      // syslog->print("------merging packet index ");
-      // syslog->print(i);
-      // syslog->print(" with length ");
-      // syslog->println(dataRows[i].size());
-
-      mergedData.insert(mergedData.end(), dataRows[i].begin(), dataRows[i].end());
-    }
+    publishIsoTpMessage();
+  }
 
-  buffer2string(liveData->responseRowMerged, mergedData.data(), mergedData.size()); // output for string parsing
-  liveData->vResponseRowMerged.assign(mergedData.begin(), mergedData.end());        // output for binary parsing
-  processMergedResponse();
+  return true;
 }
 
-  return true;
+/**
+ * Outputs the reassembled message for string (hex) and binary parsing
+ */
+void CommObd2Can::publishIsoTpMessage()
+{
+  buffer2string(liveData->responseRowMerged, isoTp.data(), isoTp.length());
+  liveData->vResponseRowMerged.assign(isoTp.data(), isoTp.data() + isoTp.length()); // keeps capacity, no reallocation after the first long response
+  isoTp.reset();
+  processMergedResponse();
 }
 
 /**
@@ -933,3 +993,31 @@ void CommObd2Can::resumeDevice()
     connectStatus = "Not initialized";
   }
 }
+
+/**
+ * Before deep sleep: MCP2515 sleeps with the wake-up interrupt enabled, so
+ * CAN bus activity pulls INT low and wakes the ESP32 (ext0). The next boot
+ * resets the controller in connectDevice().
+ */
+int8_t CommObd2Can::armWakeOnActivity()
+{
+#ifdef EVDASH_CAN_SIM
+  return -1;
+#else
+  if (!CAN || pinCanInt == 0)
+  {
+    return -1;
+  }
+  // INT must only follow the wake-up flag: mask RX interrupts and clear pending flags,
+  // otherwise a frame still in an RX buffer keeps INT low and ext0 fires at once
+  mcp2515BitModify(pinCanCs, kMcpCanInte, kMcpRxIe, 0);
+  CAN->setSleepWakeup(1);
+  mcp2515BitModify(pinCanCs, kMcpCanIntf, 0xFF, 0);
+  if (CAN->setMode(MCP_SLEEP) != MCP2515_OK)
+  {
+    syslog->println("Error: CAN wake on activity not armed.");
+    return -1;
+  }
+  return pinCanInt;
+#endif
+}
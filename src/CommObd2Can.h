@@ -2,11 +2,14 @@
 
 #include "LiveData.h"
 #include "CommInterface.h"
+#include "IsoTpReassembler.h"
+#include "CanAcceptance.h"
 #include <mcp_can.h>
+#ifdef EVDASH_CAN_SIM
+#include "CanSimBus.h"
+#endif
 
 #include <memory>
-#include <vector>
-#include <unordered_map>
 
 class CommObd2Can : public CommInterface
 {
@@ -19,7 +22,16 @@ protected:
   const uint8_t pinCanInt = 0;
   const uint8_t pinCanCs = 0;
 #endif
+#ifdef EVDASH_CAN_SIM
+  std::unique_ptr<CanSimBus> CAN; // software bus + ECU simulator, no MCP2515 needed
+  uint32_t simReportMs = 0;
+  uint32_t simReportResponses = 0;
+  uint32_t simReportTimeouts = 0;
+  uint32_t simReportLoops = 0;
+  static constexpr uint32_t kSimReportMs = 10000;
+#else
   std::unique_ptr<MCP_CAN> CAN;
+#endif
   long unsigned int rxId;
   unsigned char rxLen = 0;
   uint8_t rxBuf[32];
@@ -30,8 +42,9 @@ protected:
   uint32_t lastPid;
   unsigned long lastDataSent = 0;
   long errorsComm = 0;
-  std::vector<uint8_t> mergedData;
-  std::unordered_map<uint16_t, std::vector<uint8_t>> dataRows;
+  uint32_t timeoutsComm = 0; // requests given up (single or multiframe)
+  IsoTpReassembler isoTp;
+  CanAcceptance acceptance; // response IDs registered by the car
   bool bResponseProcessed = false;
   static constexpr uint32_t kCanReconnectGraceMs = 20000;
   uint32_t canReconnectAllowedAtMs = 0;
@@ -59,6 +72,13 @@ private:
   bool processFrameBytes();
   bool processFrame();
   void processMergedResponse();
+  void publishIsoTpMessage();
+  void setupAcceptanceFilters();
+  bool frameAvailable();
+#ifdef EVDASH_CAN_SIM
+  void simReport();
+#endif
   void suspendDevice() override;
   void resumeDevice() override;
+  int8_t armWakeOnActivity() override;
 };
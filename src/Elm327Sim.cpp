@@ -0,0 +1,358 @@
+/**
+ * ELM327 adapter emulator, see Elm327Sim.h.
+ */
+#include "Elm327Sim.h"
+
+#ifdef EVDASH_BLE_SIM
+
+#include <Arduino.h>
+#include <mcp_can.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *const kElmBanner = "ELM327 v1.5";
+
+static int8_t elmHexValue(char ch)
+{
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  return -1;
+}
+
+static uint32_t elmHexNumber(const char *text)
+{
+  uint32_t value = 0;
+  for (; elmHexValue(*text) >= 0; text++)
+    value = (value << 4) | elmHexValue(*text);
+  return value;
+}
+
+Elm327Sim::Elm327Sim(uint32_t seed)
+    : bus(seed), random(seed != 0 ? seed : 1)
+{
+  bus.begin(0, 0, 0);
+}
+
+/**
+ * Characteristic write: command text up to '\r', spaces dropped like the ELM does
+ */
+void Elm327Sim::write(const char *data, uint16_t length)
+{
+  for (uint16_t i = 0; i < length; i++)
+  {
+    const char ch = data[i];
+    if (ch == '\r')
+    {
+      command[commandLength] = '\0';
+      commandReady = true;
+      commandStartMs = millis();
+      counters.commands++;
+      return;
+    }
+    if (ch != ' ' && ch != '\n' && commandLength < kCommandSize - 1)
+    {
+      command[commandLength++] = (ch >= 'a' && ch <= 'z') ? ch - 'a' + 'A' : ch;
+    }
+  }
+}
+
+void Elm327Sim::loop(uint32_t nowMs)
+{
+  if (waiting)
+  {
+    pollBus(nowMs);
+  }
+  else if (commandReady)
+  {
+    runCommand(nowMs);
+  }
+}
+
+/**
+ * Next notification payload: at most mtuPayload bytes (less when splitPerc
+ * hits), kGapMs after the previous one.
+ */
+uint8_t Elm327Sim::read(uint8_t *notification, uint8_t maxLength, uint32_t nowMs)
+{
+  if (outputHead == outputTail || int32_t(nowMs - nextNotifyMs) < 0)
+  {
+    return 0;
+  }
+  uint16_t length = outputTail - outputHead;
+  if (length > mtuPayload)
+    length = mtuPayload;
+  if (length > maxLength)
+    length = maxLength;
+  if (splitPerc != 0 && length > 1 && nextRandom() % 100 < splitPerc)
+    length = 1 + nextRandom() % (length - 1);
+
+  memcpy(notification, output + outputHead, length);
+  outputHead += length;
+  if (outputHead == outputTail)
+  {
+    outputHead = outputTail = 0;
+  }
+  if (promptQueued && memchr(notification, '>', length) != nullptr)
+  {
+    promptQueued = false;
+    const uint32_t roundTripMs = nowMs - commandStartMs;
+    counters.roundTripSumMs += roundTripMs;
+    if (roundTripMs > counters.roundTripMaxMs)
+      counters.roundTripMaxMs = roundTripMs;
+  }
+  counters.notifications++;
+  counters.bytes += length;
+  nextNotifyMs = nowMs + kGapMs;
+  return length;
+}
+
+uint32_t Elm327Sim::nextRandom()
+{
+  random ^= random << 13;
+  random ^= random >> 17;
+  random ^= random << 5;
+  return random;
+}
+
+void Elm327Sim::runCommand(uint32_t nowMs)
+{
+  commandReady = false;
+  const char *text = command;
+  commandLength = 0;
+  if (echo)
+  {
+    put(text);
+    put("\r");
+  }
+
+  if (strncmp(text, "AT", 2) == 0)
+  {
+    runAtCommand(text + 2);
+    finish();
+    return;
+  }
+
+  // OBD/UDS request as hex, single frame only
+  uint8_t frame[8];
+  memset(frame, 0, sizeof(frame));
+  const uint8_t length = strlen(text) / 2;
+  if (length == 0 || length > 7)
+  {
+    put("?\r");
+    finish();
+    return;
+  }
+  for (uint8_t i = 0; i < length; i++)
+  {
+    if (elmHexValue(text[i * 2]) < 0 || elmHexValue(text[i * 2 + 1]) < 0)
+    {
+      put("?\r");
+      finish();
+      return;
+    }
+    frame[1 + i] = uint8_t((elmHexValue(text[i * 2]) << 4) | elmHexValue(text[i * 2 + 1]));
+  }
+  frame[0] = length;
+  counters.requests++;
+  if (searchPending)
+  {
+    searchPending = false;
+    counters.searching++;
+    put("SEARCHING...\r");
+  }
+  bus.sendMsgBuf(header, 0, 8, frame);
+  waiting = true;
+  lastFrameMs = nowMs;
+  expectedLength = 0;
+  receivedLength = 0;
+  rowNo = 0;
+}
+
+void Elm327Sim::runAtCommand(const char *at)
+{
+  if (strcmp(at, "Z") == 0 || strcmp(at, "WS") == 0)
+  {
+    echo = true;
+    spaces = true;
+    headers = false;
+    searchPending = true;
+    timeoutMs = 200;
+    put("\r\r");
+    put(kElmBanner);
+    put("\r");
+    return;
+  }
+  if (strcmp(at, "I") == 0)
+  {
+    put(kElmBanner);
+    put("\r");
+    return;
+  }
+  if (strcmp(at, "DP") == 0)
+  {
+    put("ISO 15765-4 (CAN 11/500)\r");
+    return;
+  }
+  if ((at[0] == 'E' || at[0] == 'S' || at[0] == 'H') && (at[1] == '0' || at[1] == '1') && at[2] == '\0')
+  {
+    const bool on = (at[1] == '1');
+    if (at[0] == 'E')
+      echo = on;
+    else if (at[0] == 'S')
+      spaces = on;
+    else
+      headers = on;
+  }
+  else if (strncmp(at, "SH", 2) == 0)
+  {
+    header = elmHexNumber(at + 2) & 0x7FF;
+  }
+  else if (strncmp(at, "ST", 2) == 0)
+  {
+    const uint32_t value = elmHexNumber(at + 2);
+    timeoutMs = (value == 0) ? 200 : value * 4;
+  }
+  else if (strncmp(at, "SP", 2) == 0)
+  {
+    searchPending = true;
+  }
+  put("OK\r");
+}
+
+/**
+ * Collects the answer from the simulated bus, sends flow control and prints
+ * ELM rows. Pending (7F xx 78) is printed and restarts the timeout.
+ */
+void Elm327Sim::pollBus(uint32_t nowMs)
+{
+  while (bus.checkReceive() == CAN_MSGAVAIL)
+  {
+    unsigned long id;
+    uint8_t length;
+    uint8_t frame[8];
+    bus.readMsgBuf(&id, &length, frame);
+    if (id != uint32_t(header) + 8)
+    {
+      continue; // automatic receive filter
+    }
+    lastFrameMs = nowMs;
+    if (headers)
+    {
+      char idText[5];
+      snprintf(idText, sizeof(idText), spaces ? "%03lX " : "%03lX", id);
+      put(idText);
+    }
+
+    const uint8_t frameType = frame[0] >> 4;
+    if (frameType == 0)
+    {
+      const uint8_t size = (frame[0] & 0x0F) <= 7 ? (frame[0] & 0x0F) : 7;
+      putHex(headers ? frame : frame + 1, headers ? 8 : size);
+      put("\r");
+      if (size == 3 && frame[1] == 0x7F && frame[3] == 0x78)
+      {
+        continue; // response pending, keep waiting
+      }
+      counters.answered++;
+      waiting = false;
+      finish();
+      return;
+    }
+    if (frameType == 1)
+    {
+      expectedLength = ((frame[0] & 0x0F) << 8) | frame[1];
+      receivedLength = 6;
+      rowNo = 1;
+      const uint8_t flowControl[8] = {0x30, 0x00, 0x00, 0, 0, 0, 0, 0};
+      bus.sendMsgBuf(header, 0, 8, const_cast<uint8_t *>(flowControl));
+      if (!headers)
+      {
+        char lengthText[5];
+        snprintf(lengthText, sizeof(lengthText), "%03X", expectedLength);
+        put(lengthText);
+        put("\r");
+        put(spaces ? "0: " : "0:");
+      }
+      putHex(headers ? frame : frame + 2, headers ? 8 : 6);
+      put("\r");
+    }
+    else if (frameType == 2 && expectedLength != 0)
+    {
+      const uint16_t remaining = expectedLength - receivedLength;
+      const uint8_t size = (remaining < 7) ? remaining : 7;
+      if (!headers)
+      {
+        char rowText[4];
+        snprintf(rowText, sizeof(rowText), spaces ? "%X: " : "%X:", rowNo & 0x0F);
+        put(rowText);
+      }
+      putHex(headers ? frame : frame + 1, headers ? 8 : size);
+      put("\r");
+      receivedLength += size;
+      rowNo++;
+      if (receivedLength >= expectedLength)
+      {
+        counters.answered++;
+        waiting = false;
+        finish();
+        return;
+      }
+    }
+  }
+
+  if (nowMs - lastFrameMs > timeoutMs)
+  {
+    waiting = false;
+    if (receivedLength == 0)
+    {
+      counters.noData++;
+      put("NO DATA\r");
+    }
+    finish();
+  }
+}
+
+void Elm327Sim::finish()
+{
+  put("\r>");
+  promptQueued = true;
+}
+
+void Elm327Sim::put(const char *text)
+{
+  const uint16_t length = strlen(text);
+  if (outputTail + length > kOutputSize && outputHead > 0)
+  {
+    memmove(output, output + outputHead, outputTail - outputHead);
+    outputTail -= outputHead;
+    outputHead = 0;
+  }
+  if (outputTail + length > kOutputSize)
+  {
+    return; // reader stalled, drop like a full adapter buffer
+  }
+  memcpy(output + outputTail, text, length);
+  outputTail += length;
+}
+
+void Elm327Sim::putHex(const uint8_t *data, uint8_t length)
+{
+  static const char kHexDigits[] = "0123456789ABCDEF";
+  char text[8 * 3 + 1];
+  uint8_t pos = 0;
+  for (uint8_t i = 0; i < length; i++)
+  {
+    text[pos++] = kHexDigits[data[i] >> 4];
+    text[pos++] = kHexDigits[data[i] & 0x0F];
+    if (spaces)
+      text[pos++] = ' ';
+  }
+  text[pos] = '\0';
+  put(text);
+}
+
+#endif // EVDASH_BLE_SIM
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stdint.h>
+#include "CanSimBus.h"
+
+/**
+ * ELM327 adapter emulator behind a BLE characteristic stand-in.
+ *
+ * Builds with -DEVDASH_BLE_SIM connect CommObd2Ble4 to this class instead of
+ * a BLE dongle: executeCommand() writes the command text here and the
+ * emulator's output is fed to the real notifyCallback() in chunks of at most
+ * mtuPayload bytes, kGapMs apart, so lines and the '>' prompt get split
+ * across notifications the way real adapters do.
+ *
+ * AT commands used by the cars are answered (ATZ banner, E/S/H/L/ST/SH, the
+ * rest with OK). OBD/UDS requests go over a CanSimBus with the same script,
+ * so ECU latency, loss, 7F xx 78 pending and multi-frame answers come from
+ * there; the emulator sends flow control and formats the reply as ELM text
+ * (single line or "03E" + "0:" "1:" rows). Echo stays on until ATE0, the
+ * first request after ATZ prints SEARCHING..., unanswered requests print
+ * NO DATA after the ATST timeout, splitPerc cuts extra notifications in the
+ * middle of a line.
+ */
+class Elm327Sim
+{
+public:
+  static constexpr uint16_t kOutputSize = 1536;
+  static constexpr uint8_t kCommandSize = 32;
+  static constexpr uint8_t kDefaultMtuPayload = 20; // MTU 23 - ATT header
+  static constexpr uint8_t kGapMs = 8;               // between notifications
+
+  struct Stats
+  {
+    uint32_t commands;
+    uint32_t requests;  // non-AT commands
+    uint32_t answered;  // requests with data
+    uint32_t noData;
+    uint32_t searching;
+    uint32_t notifications;
+    uint32_t bytes;
+    uint32_t roundTripSumMs; // command written -> '>' notified
+    uint32_t roundTripMaxMs;
+  };
+
+  explicit Elm327Sim(uint32_t seed = 0x454C4D33);
+
+  uint16_t loadScript(const char *script) { return bus.loadScript(script); }
+  void setMtuPayload(uint8_t payload) { mtuPayload = (payload > 0) ? payload : 1; }
+  void setSplitPerc(uint8_t perc) { splitPerc = perc; }
+
+  void write(const char *data, uint16_t length); // characteristic write
+  void loop(uint32_t nowMs);
+  uint8_t read(uint8_t *notification, uint8_t maxLength, uint32_t nowMs); // next notification, 0 = none yet
+  const Stats &stats() const { return counters; }
+  const CanSimBus::Stats &busStats() const { return bus.stats(); }
+
+private:
+  CanSimBus bus;
+  Stats counters = {};
+  uint32_t random;
+  uint8_t mtuPayload = kDefaultMtuPayload;
+  uint8_t splitPerc = 0;
+
+  // Adapter state
+  bool echo = true;
+  bool spaces = true;
+  bool headers = false;
+  bool searchPending = true; // protocol not yet detected since ATZ
+  uint16_t header = 0x7DF;
+  uint16_t timeoutMs = 200; // ATST x 4 ms
+
+  char command[kCommandSize];
+  uint8_t commandLength = 0;
+  uint32_t commandStartMs = 0;
+  bool commandReady = false;
+
+  // Request in flight on the simulated bus
+  bool waiting = false;
+  uint32_t lastFrameMs = 0;
+  uint16_t expectedLength = 0;
+  uint16_t receivedLength = 0;
+  uint8_t rowNo = 0;
+
+  char output[kOutputSize];
+  uint16_t outputHead = 0;
+  uint16_t outputTail = 0;
+  uint32_t nextNotifyMs = 0;
+  bool promptQueued = false;
+
+  uint32_t nextRandom();
+  void runCommand(uint32_t nowMs);
+  void runAtCommand(const char *at);
+  void pollBus(uint32_t nowMs);
+  void finish(); // appends the prompt
+  void put(const char *text);
+  void putHex(const uint8_t *data, uint8_t length);
+};
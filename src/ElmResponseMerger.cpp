@@ -0,0 +1,58 @@
+/**
+ * ELM327 row splitter and merge rule, see ElmResponseMerger.h.
+ */
+#include "ElmResponseMerger.h"
+
+ElmResponseMerger::Event ElmResponseMerger::feed(char ch)
+{
+  if (completed)
+  {
+    reset();
+  }
+
+  if (ch == '\r' || ch == '\n' || ch == '\0')
+  {
+    if (length == 0)
+    {
+      return ELM_NONE;
+    }
+    completed = true;
+    return ELM_ROW;
+  }
+
+  if (ch == '>' && length == 0)
+  {
+    return ELM_PROMPT;
+  }
+
+  if (length >= kMaxRow)
+  {
+    if (!overflowed)
+    {
+      overflowed = true; // counted once per row, rest of the row ignored
+      overflowCount++;
+    }
+    return ELM_NONE;
+  }
+  rowText[length++] = ch;
+  rowText[length] = '\0';
+  return ELM_NONE;
+}
+
+void ElmResponseMerger::reset()
+{
+  length = 0;
+  completed = false;
+  overflowed = false;
+  rowText[0] = '\0';
+}
+
+int8_t ElmResponseMerger::payloadOffset(const char *row, uint16_t rowLength)
+{
+  // Merge frames 0:xxxx 1:yyyy 2:zzzz to single response xxxxyyyyzzzz string
+  if (rowLength >= 2 && row[1] == ':')
+  {
+    return 2;
+  }
+  return (rowLength >= 4) ? 0 : -1;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Splits ELM327 output into rows and decides what each row adds to the
+ * merged response.
+ *
+ * Bytes arrive in BLE notifications that may cut a row anywhere, so the
+ * unfinished row is kept until '\r', '\n' or '\0' completes it (issue #107)
+ * and is dropped by reset() when the next command is sent. A '>' at the
+ * start of a row is the prompt: the adapter is ready for the next command.
+ *
+ * Multi-frame rows "0:xxxx" "1:yyyy" are merged without the row number,
+ * other rows of 4+ chars are appended whole, shorter ones (byte count "03E",
+ * "OK") are skipped. No Arduino dependency.
+ */
+class ElmResponseMerger
+{
+public:
+  static constexpr uint8_t kMaxRow = 128;
+
+  enum Event : uint8_t
+  {
+    ELM_NONE = 0,
+    ELM_ROW,   // row() holds a completed row
+    ELM_PROMPT // '>' received
+  };
+
+  Event feed(char ch);
+  void reset(); // new command: unfinished row dropped
+  const char *row() const { return rowText; }
+  uint8_t rowLength() const { return length; }
+  uint32_t overflows() const { return overflowCount; } // rows cut at kMaxRow
+
+  // Offset of the part of a row that belongs to the merged response, -1 = none
+  static int8_t payloadOffset(const char *row, uint16_t rowLength);
+
+private:
+  char rowText[kMaxRow + 1] = {};
+  uint8_t length = 0;
+  bool completed = false; // rowText holds the last completed row, next char starts a new one
+  bool overflowed = false;
+  uint32_t overflowCount = 0;
+};
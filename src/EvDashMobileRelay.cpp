@@ -1,10 +1,49 @@
 #include "EvDashMobileRelay.h"
 #include <ArduinoJson.h>
 #include <math.h>
+#include <esp_heap_caps.h>
 #include "BoardInterface.h"
 #include "CarModelUtils.h"
 #include "config.h"
 #include "LogSerial.h"
+#include "MemStats.h"
+
+// v3 encoding helpers
+static size_t putVarint(uint8_t *out, uint32_t value)
+{
+  size_t n = 0;
+  while (value >= 0x80)
+  {
+    out[n++] = uint8_t(value) | 0x80;
+    value >>= 7;
+  }
+  out[n++] = uint8_t(value);
+  return n;
+}
+
+static size_t putSvarint(uint8_t *out, int32_t value)
+{
+  return putVarint(out, (uint32_t(value) << 1) ^ uint32_t(value >> 31));
+}
+
+// History channels as relay field names / decimals (HistoryChannel order)
+static const char *const kHistoryFieldNames[HISTORY_CHANNEL_COUNT] = {"powKw", "spd", "soc", "batV", "cMinV", "cMaxV", "batMinC", "batMaxC", "outC"};
+static const uint8_t kHistoryFieldDecimals[HISTORY_CHANNEL_COUNT] = {1, 1, 1, 1, 3, 3, 1, 1, 1};
+
+static int32_t fixedPoint(float value, uint8_t decimals)
+{
+  static const float kScale[] = {1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f, 100000.0f};
+  if (!isfinite(value))
+  {
+    return INT32_MIN;
+  }
+  const float scaled = roundf(value * kScale[decimals]);
+  if (scaled >= 2147483520.0f || scaled <= -2147483520.0f)
+  {
+    return INT32_MIN;
+  }
+  return int32_t(scaled);
+}
 
 void EvDashMobileRelay::begin(LiveData *pLiveData, BoardInterface *pBoard)
 {
@@ -14,6 +53,28 @@ void EvDashMobileRelay::begin(LiveData *pLiveData, BoardInterface *pBoard)
   {
     syslog->setMirrorCallback(EvDashMobileRelay::serialMirrorThunk, this);
   }
+  if (txQueue == nullptr)
+  {
+    txQueueSize = kTxQueueBytes;
+    txQueue = static_cast<uint8_t *>(heap_caps_malloc(txQueueSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (txQueue == nullptr)
+    {
+      txQueueSize = kTxQueueBytesInternal;
+      txQueue = static_cast<uint8_t *>(heap_caps_malloc(txQueueSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    }
+    if (txQueue == nullptr)
+    {
+      txQueueSize = 0;
+    }
+  }
+  if (commandQueue == nullptr)
+  {
+    commandQueue = xQueueCreate(kCommandQueueLength, sizeof(RelayCommand));
+    if (commandQueue == nullptr && syslog != nullptr)
+    {
+      syslog->println("Mobile relay: command queue allocation failed");
+    }
+  }
   if (liveData != nullptr && liveData->settings.relayForMobileEnabled == 1)
   {
     startServer();
@@ -39,6 +100,9 @@ void EvDashMobileRelay::loop()
   {
     startServer();
   }
+  handleConnectionEvents();
+  handleQueuedCommands();
+  pumpTx();
   const uint32_t nowMs = millis();
   if (serialCaptureEnabled && serialMirrorBuffer.length() > 0 && nowMs - lastSerialMirrorMs > 800)
   {
@@ -61,26 +125,243 @@ void EvDashMobileRelay::loop()
   {
     return;
   }
-  if (nowMs - lastSnapshotMs > 500)
+  bool streamSent = false;
+  for (uint8_t i = 0; i < RELAY_STREAM_COUNT; i++)
   {
-    sendSnapshot();
-    lastSnapshotMs = nowMs;
+    StreamSchedule &stream = streams[i];
+    if (stream.intervalMs == 0 || nowMs - stream.lastMs < stream.intervalMs)
+    {
+      continue;
+    }
+    if (txBacklogged())
+    {
+      // Previous notifications not drained yet; nothing is queued, the stream goes out
+      // with fresh values once the link catches up
+      stream.skipped++;
+      continue;
+    }
+    stream.lastMs = nowMs;
+    sendStream(i);
+    streamSent = true;
   }
-  if (nowMs - lastCellsMs > 3000)
+  // Backfill only uses loops without live traffic
+  if (historyJob.active() && !streamSent && !txBacklogged())
   {
-    sendCells();
-    lastCellsMs = nowMs;
+    sendHistoryChunk();
   }
-  if (nowMs - lastTempsMs > 3000)
+}
+
+/**
+ * Backfill request: history of channels in channelMask from since until now
+ */
+void EvDashMobileRelay::startHistoryJob(time_t since, uint16_t channelMask)
+{
+  if (!historyJob.start(liveData->history, since, liveData->params.currentTime, channelMask))
   {
-    sendTemps();
-    lastTempsMs = nowMs;
+    notifyJson("{\"type\":\"historyEnd\",\"ver\":2,\"available\":false}");
+  }
+}
+
+/**
+ * Next chunk of the backfill (one channel, up to RelayHistoryJob::kChunkPoints buckets)
+ */
+void EvDashMobileRelay::sendHistoryChunk()
+{
+  RelayHistoryJob::Chunk chunk;
+  if (!historyJob.next(liveData->history, chunk))
+  {
+    notifyJson("{\"type\":\"historyEnd\",\"ver\":2,\"available\":true,\"to\":" + String(uint32_t(historyJob.to())) + "}");
+    return;
   }
-  if (nowMs - lastRawMs > 2500)
+  if (chunk.count == 0)
   {
+    return;
+  }
+
+  const uint8_t channel = chunk.channel;
+  const uint16_t period = chunk.periodSec;
+  const size_t count = chunk.count;
+  const HistoryPoint *points = chunk.points;
+  const uint8_t decimals = kHistoryFieldDecimals[channel];
+  if (binaryProtocol)
+  {
+    size_t n = 0;
+    txBuffer[n++] = channel;
+    txBuffer[n++] = period & 0xFF;
+    txBuffer[n++] = period >> 8;
+    const uint32_t start = uint32_t(points[0].time);
+    for (uint8_t b = 0; b < 4; b++)
+    {
+      txBuffer[n++] = uint8_t(start >> (8 * b));
+    }
+    txBuffer[n++] = uint8_t(count);
+    time_t previous = points[0].time;
+    for (size_t i = 0; i < count; i++)
+    {
+      n += putVarint(txBuffer + n, uint32_t((points[i].time - previous) / period));
+      n += putSvarint(txBuffer + n, fixedPoint(points[i].avg, decimals));
+      n += putSvarint(txBuffer + n, fixedPoint(points[i].min, decimals));
+      n += putSvarint(txBuffer + n, fixedPoint(points[i].max, decimals));
+      previous = points[i].time;
+    }
+    notifyFrame(RELAY_MSG_HISTORY, txBuffer, n);
+    return;
+  }
+
+  // v2: [time, avg, min, max] per bucket
+  String json = "{\"type\":\"history\",\"ver\":2,\"field\":\"" + String(kHistoryFieldNames[channel]) +
+                "\",\"period\":" + String(period) + ",\"pts\":[";
+  for (size_t i = 0; i < count; i++)
+  {
+    if (i > 0)
+    {
+      json += ",";
+    }
+    json += "[" + String(uint32_t(points[i].time)) + "," + jsonNumber(points[i].avg, decimals) + "," +
+            jsonNumber(points[i].min, decimals) + "," + jsonNumber(points[i].max, decimals) + "]";
+  }
+  json += "]}";
+  notifyJson(json);
+}
+
+void EvDashMobileRelay::sendStream(uint8_t stream)
+{
+  switch (stream)
+  {
+  case RELAY_STREAM_SNAPSHOT:
+    sendSnapshot();
+    break;
+  case RELAY_STREAM_CELLS:
+    sendCells();
+    break;
+  case RELAY_STREAM_TEMPS:
+    sendTemps();
+    break;
+  case RELAY_STREAM_RAW:
     sendRawFrames();
-    lastRawMs = nowMs;
+    break;
+  }
+}
+
+/**
+ * Default cadences (no subscription)
+ */
+void EvDashMobileRelay::resetStreams()
+{
+  for (uint8_t i = 0; i < RELAY_STREAM_COUNT; i++)
+  {
+    streams[i].intervalMs = streams[i].defaultMs;
+    streams[i].lastMs = 0;
+    streams[i].skipped = 0;
+  }
+  txBacklogBytes = 0;
+}
+
+/**
+ * Account bytes handed to the BLE stack
+ */
+void EvDashMobileRelay::noteNotified(size_t bytes)
+{
+  txBacklogged();
+  txBacklogBytes += bytes + 3; // ATT header
+}
+
+/**
+ * Estimated bytes still in the BLE stack (drained at kTxDrainBytesPerSec)
+ */
+uint32_t EvDashMobileRelay::drainTxBacklog()
+{
+  const uint32_t nowMs = millis();
+  const uint32_t drained = (nowMs - txBacklogUpdatedMs) * kTxDrainBytesPerSec / 1000U;
+  if (drained > 0)
+  {
+    txBacklogBytes = (drained >= txBacklogBytes) ? 0 : (txBacklogBytes - drained);
+    txBacklogUpdatedMs = nowMs;
+  }
+  return txBacklogBytes;
+}
+
+/**
+ * True while the BLE stack and our own fragment queue hold more than the limit
+ */
+bool EvDashMobileRelay::txBacklogged()
+{
+  return drainTxBacklog() + (txTail - txHead) > kTxBacklogLimitBytes;
+}
+
+/**
+ * Room for bytes at the end of the fragment queue (sent fragments are compacted away)
+ */
+bool EvDashMobileRelay::reserveTx(size_t bytes)
+{
+  if (txQueueSize - txTail < bytes && txHead > 0)
+  {
+    memmove(txQueue, txQueue + txHead, txTail - txHead);
+    txTail -= txHead;
+    txHead = 0;
+  }
+  if (txQueueSize - txTail < bytes)
+  {
+    txDropped++;
+    return false;
+  }
+  return true;
+}
+
+void EvDashMobileRelay::queueFragment(const uint8_t *header, size_t headerLength, const uint8_t *data, size_t length)
+{
+  const size_t total = headerLength + length;
+  txQueue[txTail++] = uint8_t(total);
+  txQueue[txTail++] = uint8_t(total >> 8);
+  if (headerLength > 0)
+  {
+    memcpy(txQueue + txTail, header, headerLength);
+    txTail += headerLength;
   }
+  memcpy(txQueue + txTail, data, length);
+  txTail += length;
+}
+
+/**
+ * Send queued fragments: kTxFragmentGapMs after the previous pass, then more
+ * in the same pass only while the BLE stack estimate stays under the limit.
+ * Never waits, so the main loop is not held by a long message.
+ */
+void EvDashMobileRelay::pumpTx()
+{
+  if (txHead == txTail)
+  {
+    return;
+  }
+  if (!connected || notifyCharacteristic == nullptr)
+  {
+    txHead = 0;
+    txTail = 0;
+    return;
+  }
+  const uint32_t nowMs = millis();
+  if (nowMs - lastFragmentMs < kTxFragmentGapMs)
+  {
+    return;
+  }
+  for (uint8_t sent = 0; sent < kTxFragmentsPerLoop && txHead < txTail; sent++)
+  {
+    if (sent > 0 && drainTxBacklog() > kTxBacklogLimitBytes)
+    {
+      break;
+    }
+    const size_t length = txQueue[txHead] | (size_t(txQueue[txHead + 1]) << 8);
+    notifyCharacteristic->setValue(txQueue + txHead + 2, length);
+    notifyCharacteristic->notify();
+    noteNotified(length);
+    txHead += 2 + length;
+  }
+  if (txHead == txTail)
+  {
+    txHead = 0;
+    txTail = 0;
+  }
+  lastFragmentMs = nowMs;
 }
 
 String EvDashMobileRelay::startPairing()
@@ -191,34 +472,23 @@ void EvDashMobileRelay::onConnect(BLEServer *server)
 {
   (void)server;
   connected = true;
-  if (syslog != nullptr)
-  {
-    syslog->println("Mobile relay connected");
-  }
-  sendHello();
-  flushSerialPendingLines(8);
+  connectPending = true;
 }
 
 void EvDashMobileRelay::onDisconnect(BLEServer *server)
 {
   (void)server;
   connected = false;
-  if (!serialCaptureEnabled)
-  {
-    serialMirrorBuffer = "";
-    serialPendingLines = "";
-    serialPendingOverflow = false;
-  }
-  if (syslog != nullptr)
-  {
-    syslog->println("Mobile relay disconnected");
-  }
+  disconnectPending = true;
   if (!netUploadPaused)
   {
     BLEDevice::startAdvertising();
   }
 }
 
+/**
+ * BLE host task: split into lines and queue them for loop()
+ */
 void EvDashMobileRelay::onWrite(BLECharacteristic *characteristic)
 {
 #ifdef EVDASH_USE_NIMBLE
@@ -235,20 +505,81 @@ void EvDashMobileRelay::onWrite(BLECharacteristic *characteristic)
     const char ch = value[i];
     if (ch == '\n')
     {
-      handleCommand(rxBuffer);
-      rxBuffer = "";
+      rxCommand.line[rxLength] = '\0';
+      if (commandQueue == nullptr || xQueueSend(commandQueue, &rxCommand, 0) != pdTRUE)
+      {
+        commandsDropped++;
+      }
+      rxLength = 0;
     }
     else if (ch != '\r')
     {
-      rxBuffer += ch;
-      if (rxBuffer.length() > 512)
+      rxCommand.line[rxLength++] = ch;
+      if (rxLength > kCommandMaxBytes)
       {
-        rxBuffer = "";
+        rxLength = 0;
       }
     }
   }
 }
 
+/**
+ * Connect / disconnect flagged by the BLE callbacks
+ */
+void EvDashMobileRelay::handleConnectionEvents()
+{
+  if (disconnectPending)
+  {
+    disconnectPending = false;
+    setBinaryProtocol(false, 0);
+    resetStreams();
+    historyJob.cancel();
+    txHead = 0;
+    txTail = 0;
+    if (!serialCaptureEnabled)
+    {
+      serialMirrorBuffer = "";
+      serialPendingLines = "";
+      serialPendingOverflow = false;
+    }
+    if (syslog != nullptr)
+    {
+      syslog->println("Mobile relay disconnected");
+    }
+  }
+  if (connectPending)
+  {
+    connectPending = false;
+    if (syslog != nullptr)
+    {
+      syslog->println("Mobile relay connected");
+    }
+    sendHello();
+    flushSerialPendingLines(8);
+  }
+}
+
+void EvDashMobileRelay::handleQueuedCommands()
+{
+  if (commandsDropped != 0)
+  {
+    syslog->print("Mobile relay: commands dropped ");
+    syslog->println(commandsDropped);
+    commandsDropped = 0;
+  }
+  if (txDropped != 0)
+  {
+    syslog->print("Mobile relay: TX queue full, messages dropped ");
+    syslog->println(txDropped);
+    txDropped = 0;
+  }
+  RelayCommand command;
+  while (commandQueue != nullptr && xQueueReceive(commandQueue, &command, 0) == pdTRUE)
+  {
+    handleCommand(String(command.line));
+  }
+}
+
 void EvDashMobileRelay::startServer()
 {
   if (started)
@@ -338,8 +669,67 @@ void EvDashMobileRelay::handleCommand(const String &jsonLine)
     notifyJson("{\"type\":\"pairRequired\",\"ver\":2}");
     return;
   }
+  if (type == "subscribe")
+  {
+    // {"type":"subscribe","streams":{"snapshot":100,"cells":0}} intervals in ms, 0 = off, unlisted unchanged
+    JsonObject requested = doc["streams"];
+    String json = "{\"type\":\"subscribed\",\"ver\":2";
+    for (uint8_t i = 0; i < RELAY_STREAM_COUNT; i++)
+    {
+      StreamSchedule &stream = streams[i];
+      if (!requested.isNull() && requested.containsKey(stream.name))
+      {
+        const int32_t intervalMs = requested[stream.name] | -1;
+        if (intervalMs >= 0)
+        {
+          stream.intervalMs = (intervalMs == 0) ? 0 : constrain(intervalMs, int32_t(stream.minMs), int32_t(60000));
+          stream.lastMs = 0;
+        }
+      }
+      json += ",\"" + String(stream.name) + "\":" + String(stream.intervalMs);
+    }
+    json += "}";
+    notifyJson(json);
+    return;
+  }
+  if (type == "history")
+  {
+    // {"type":"history","since":T,"fields":["powKw","soc"]} (no fields = all)
+    uint16_t mask = 0;
+    JsonArray fields = doc["fields"];
+    for (uint8_t ch = 0; ch < HISTORY_CHANNEL_COUNT; ch++)
+    {
+      bool wanted = fields.isNull();
+      for (JsonVariant field : fields)
+      {
+        wanted = wanted || (strcmp(field | "", kHistoryFieldNames[ch]) == 0);
+      }
+      if (wanted)
+      {
+        mask |= (1U << ch);
+      }
+    }
+    const uint32_t since = doc["since"] | 0UL;
+    startHistoryJob(time_t(since), mask);
+    return;
+  }
+  if (type == "ack")
+  {
+    handleSnapshotAck(doc["seq"] | -1);
+    return;
+  }
   if (type == "hello" || type == "ping" || type == "requestFullSnapshot")
   {
+    const uint8_t proto = doc["proto"] | 0;
+    if (type == "hello" && proto >= 2)
+    {
+      // Answered in the current framing, switch afterwards
+      const uint16_t mtu = doc["mtu"] | 0;
+      notifyJson("{\"type\":\"protocol\",\"ver\":" + String(proto >= 3 ? 3 : 2) + "}");
+      setBinaryProtocol(proto >= 3, mtu);
+    }
+    ackedSnapshotValid = false;
+    cellsSent = false;
     sendHello();
     sendSnapshot();
     sendCells();
@@ -362,6 +752,10 @@ void EvDashMobileRelay::handleCommand(const String &jsonLine)
   {
     forgetPairing();
   }
+  else if (type == "memory")
+  {
+    sendMemoryStats();
+  }
 }
 
 void EvDashMobileRelay::handlePairStart(const String &mobileId, const String &code)
@@ -414,14 +808,23 @@ void EvDashMobileRelay::notifyLine(const String &line)
   {
     return;
   }
+  if (binaryProtocol)
+  {
+    notifyFrame(RELAY_MSG_JSON_LINE, reinterpret_cast<const uint8_t *>(line.c_str()), line.length());
+    return;
+  }
   String payload = line + "\n";
   const size_t chunkSize = 160;
+  const size_t chunks = (payload.length() + chunkSize - 1) / chunkSize;
+  if (!reserveTx(payload.length() + 2 * chunks))
+  {
+    return;
+  }
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(payload.c_str());
   for (size_t pos = 0; pos < payload.length(); pos += chunkSize)
   {
-    String chunk = payload.substring(pos, pos + chunkSize);
-    notifyCharacteristic->setValue(reinterpret_cast<uint8_t *>(const_cast<char *>(chunk.c_str())), chunk.length());
-    notifyCharacteristic->notify();
-    delay(3);
+    const size_t chunk = (payload.length() - pos > chunkSize) ? chunkSize : (payload.length() - pos);
+    queueFragment(nullptr, 0, data + pos, chunk);
   }
 }
 
@@ -430,17 +833,113 @@ void EvDashMobileRelay::notifyJson(const String &json)
   notifyLine(json);
 }
 
+/**
+ * Queue one v3 message, split into MTU sized fragments
+ */
+void EvDashMobileRelay::notifyFrame(uint8_t type, const uint8_t *payload, size_t length)
+{
+  if (!connected || notifyCharacteristic == nullptr)
+  {
+    return;
+  }
+  if (length > kRelayMaxMessageBytes)
+  {
+    syslog->print("Relay: message type ");
+    syslog->print(type);
+    syslog->print(" too long, dropped bytes ");
+    syslog->println(length);
+    return;
+  }
+  const size_t fragments = (length == 0) ? 1 : (length + fragmentPayload - 1) / fragmentPayload;
+  if (!reserveTx(length + fragments * (2 + kRelayFrameHeaderSize)))
+  {
+    return;
+  }
+  uint8_t header[kRelayFrameHeaderSize];
+  const uint8_t seq = frameSeq++;
+  size_t pos = 0;
+  uint8_t index = 0;
+  do
+  {
+    const size_t chunk = (length - pos > fragmentPayload) ? fragmentPayload : (length - pos);
+    header[0] = kRelayFrameMagic;
+    header[1] = type;
+    header[2] = seq;
+    header[3] = (index & kRelayFragmentIndexMask) | ((pos + chunk >= length) ? kRelayFragmentLast : 0);
+    queueFragment(header, kRelayFrameHeaderSize, payload + pos, chunk);
+    pos += chunk;
+    index++;
+  } while (pos < length);
+}
+
+/**
+ * Switch framing (v3 binary / v2 JSON). mtu = ATT MTU reported by the app, 0 = unknown.
+ */
+void EvDashMobileRelay::setBinaryProtocol(bool enabled, uint16_t mtu)
+{
+  binaryProtocol = enabled;
+  fragmentPayload = kDefaultFragmentPayload;
+  if (mtu >= 23)
+  {
+    const uint16_t payload = ((mtu > 515) ? 515 : mtu) - 3 - kRelayFrameHeaderSize;
+    fragmentPayload = payload;
+  }
+  ackedSnapshotValid = false;
+  cellsSent = false;
+  for (uint8_t i = 0; i < kSnapshotHistory; i++)
+  {
+    sentSnapshotValid[i] = false;
+  }
+  if (enabled && syslog != nullptr)
+  {
+    syslog->print("Mobile relay protocol v3, fragment ");
+    syslog->println(fragmentPayload);
+  }
+}
+
+/**
+ * App applied snapshot seq; it becomes the base for next deltas
+ */
+void EvDashMobileRelay::handleSnapshotAck(int16_t seq)
+{
+  if (seq < 0 || seq > 255)
+  {
+    return;
+  }
+  const uint8_t slot = seq % kSnapshotHistory;
+  if (!sentSnapshotValid[slot] || sentSnapshotSeq[slot] != seq)
+  {
+    return;
+  }
+  if (ackedSnapshotValid && uint8_t(seq - ackedSnapshotSeq) > 127)
+  {
+    // Older than current base (late ack)
+    return;
+  }
+  memcpy(ackedSnapshot, sentSnapshots[slot], sizeof(ackedSnapshot));
+  ackedSnapshotSeq = seq;
+  ackedSnapshotValid = true;
+}
+
 void EvDashMobileRelay::sendHello()
 {
   if (liveData == nullptr)
   {
     return;
   }
-  String json = "{\"type\":\"hello\",\"ver\":2,\"relayId\":\"" + relayId() +
+  String json = "{\"type\":\"hello\",\"ver\":2,\"protos\":[2,3],\"relayId\":\"" + relayId() +
                 "\",\"fw\":\"" + String(APP_VERSION) +
                 "\",\"vehicleId\":\"" + vehicleId() +
                 "\",\"paired\":" + jsonBool(paired()) +
-                ",\"pairing\":" + jsonBool(pairingOpen()) + "}";
+                ",\"pairing\":" + jsonBool(pairingOpen());
+  if (binaryProtocol)
+  {
+    // Text fields are not part of v3 snapshots
+    json += ",\"carType\":" + String(liveData->settings.carType);
+    json += ",\"comm\":\"" + commType() + "\"";
+    json += ",\"vin\":\"" + escapeJson(String(liveData->params.carVin)) + "\"";
+  }
+  json += "}";
   notifyJson(json);
 }
 
@@ -459,6 +958,11 @@ void EvDashMobileRelay::sendContributePayload()
 
 void EvDashMobileRelay::sendSnapshot()
 {
+  if (binaryProtocol)
+  {
+    sendSnapshotBinary();
+    return;
+  }
   PARAMS_STRUC &p = liveData->params;
   String json = "{\"type\":\"snapshot\",\"ver\":2";
   json += ",\"ts\":" + String(static_cast<uint32_t>(p.currentTime));
@@ -548,6 +1052,11 @@ void EvDashMobileRelay::sendSnapshot()
 
 void EvDashMobileRelay::sendCells()
 {
+  if (binaryProtocol)
+  {
+    sendCellsBinary();
+    return;
+  }
   PARAMS_STRUC &p = liveData->params;
   const uint16_t count = (p.cellCount > 0 && p.cellCount <= 192) ? p.cellCount : 192;
   String json = "{\"type\":\"cells\",\"ver\":2,\"cells\":[";
@@ -570,8 +1079,35 @@ void EvDashMobileRelay::sendCells()
   notifyJson(json);
 }
 
+/**
+ * Memory budget: heap totals and per subsystem [current, peak, allocs/s]
+ */
+void EvDashMobileRelay::sendMemoryStats()
+{
+  String json = "{\"type\":\"memory\",\"ver\":2";
+  json += ",\"heapInt\":" + String(heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+  json += ",\"heapIntLargest\":" + String(heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+  json += ",\"psram\":" + String(ESP.getFreePsram());
+  json += ",\"loopAllocsMax\":" + String(memLoopAllocsMax());
+  json += ",\"budgetOverruns\":" + String(memLoopBudgetOverruns());
+  json += ",\"tags\":{";
+  for (uint8_t i = 0; i < MEM_TAG_COUNT; i++)
+  {
+    const MemTagStats stats = memTagStats(MemTag(i));
+    json += (i == 0 ? "\"" : ",\"") + String(memTagName(MemTag(i))) + "\":[" + String(stats.currentBytes) + "," +
+            String(stats.peakBytes) + "," + String(stats.allocsPerSec) + "]";
+  }
+  json += "}}";
+  notifyJson(json);
+}
+
 void EvDashMobileRelay::sendTemps()
 {
+  if (binaryProtocol)
+  {
+    sendTempsBinary();
+    return;
+  }
   PARAMS_STRUC &p = liveData->params;
   const uint16_t count = (p.batModuleTempCount > 0 && p.batModuleTempCount <= 25) ? p.batModuleTempCount : 25;
   String json = "{\"type\":\"temps\",\"ver\":2,\"modules\":[";
@@ -594,21 +1130,177 @@ void EvDashMobileRelay::sendTemps()
   notifyJson(json);
 }
 
+/**
+ * Snapshot values as fixed point (kRelayNullValue = null), same content as the v2 snapshot
+ */
+void EvDashMobileRelay::collectSnapshotFields(int32_t *values) const
+{
+  const PARAMS_STRUC &p = liveData->params;
+  const LIVE_HOT_STRUC hot = liveData->hot; // hot fields come pre-packed, invalid ones as null
+  values[RELAY_FIELD_TS] = int32_t(p.currentTime);
+  values[RELAY_FIELD_SPD] = (hot.valid & HOT_VALID_SPEED) ? hot.speedKmh10 : kRelayNullValue;
+  values[RELAY_FIELD_GPS_SPD] = fixedPoint(p.speedKmhGPS, 1);
+  values[RELAY_FIELD_SOC] = (hot.valid & HOT_VALID_SOC) ? hot.socPerc10 : kRelayNullValue;
+  values[RELAY_FIELD_SOC_BMS] = fixedPoint(p.socPercBms, 1);
+  values[RELAY_FIELD_SOH] = fixedPoint(p.sohPerc, 1);
+  values[RELAY_FIELD_POW_KW] = (hot.valid & HOT_VALID_POWER) ? hot.batPowerKw100 : kRelayNullValue;
+  values[RELAY_FIELD_POW_KWH100] = fixedPoint(p.batPowerKwh100, 2);
+  values[RELAY_FIELD_BAT_V] = (hot.valid & HOT_VALID_VOLTAGE) ? hot.batVoltage10 : kRelayNullValue;
+  values[RELAY_FIELD_BAT_A] = (hot.valid & HOT_VALID_CURRENT) ? hot.batCurrentA10 : kRelayNullValue;
+  values[RELAY_FIELD_AUX_V] = fixedPoint(p.auxVoltage, 1);
+  values[RELAY_FIELD_AUX_PCT] = fixedPoint(p.auxPerc, 0);
+  values[RELAY_FIELD_ODO_KM] = fixedPoint(p.odoKm, 1);
+  values[RELAY_FIELD_AVG_SPD] = fixedPoint(p.avgSpeedKmh, 1);
+  values[RELAY_FIELD_TRIP_KM] = (p.odoKm >= 0.0f && p.odoKmStart >= 0.0f) ? fixedPoint(p.odoKm - p.odoKmStart, 1) : kRelayNullValue;
+  values[RELAY_FIELD_IN_C] = (p.indoorTemperature > -99.0f) ? fixedPoint(p.indoorTemperature, 1) : kRelayNullValue;
+  values[RELAY_FIELD_OUT_C] = (p.outdoorTemperature > -99.0f) ? fixedPoint(p.outdoorTemperature, 1) : kRelayNullValue;
+  values[RELAY_FIELD_FLAGS] = ((hot.flags & HOT_FLAG_CHARGING) ? (1 << 0) : 0) |
+                              ((hot.flags & HOT_FLAG_AC) ? (1 << 1) : 0) |
+                              ((hot.flags & HOT_FLAG_DC) ? (1 << 2) : 0) |
+                              (p.leftFrontDoorOpen ? (1 << 3) : 0) |
+                              (p.rightFrontDoorOpen ? (1 << 4) : 0) |
+                              (p.leftRearDoorOpen ? (1 << 5) : 0) |
+                              (p.rightRearDoorOpen ? (1 << 6) : 0) |
+                              (p.hoodDoorOpen ? (1 << 7) : 0) |
+                              (p.trunkDoorOpen ? (1 << 8) : 0) |
+                              ((p.headLights || p.dayLights || p.autoLights) ? (1 << 9) : 0) |
+                              (p.brakeLights ? (1 << 10) : 0);
+  values[RELAY_FIELD_DRIVE] = (hot.flags & HOT_FLAG_FORWARD) ? 1 : ((hot.flags & HOT_FLAG_REVERSE) ? 2 : ((hot.flags & HOT_FLAG_PARK) ? 3 : 0));
+  values[RELAY_FIELD_BAT_MIN_C] = (hot.valid & HOT_VALID_BAT_MIN_C) ? fixedPoint(hot.batMinC10 / 10.0f, 0) : kRelayNullValue;
+  values[RELAY_FIELD_BAT_MAX_C] = (hot.valid & HOT_VALID_BAT_MAX_C) ? fixedPoint(hot.batMaxC10 / 10.0f, 0) : kRelayNullValue;
+  values[RELAY_FIELD_BAT_INLET_C] = fixedPoint(p.batInletC, 0);
+  values[RELAY_FIELD_BAT_HEATER_C] = fixedPoint(p.batHeaterC, 0);
+  values[RELAY_FIELD_COOLANT_C] = fixedPoint(p.coolingWaterTempC, 0);
+  values[RELAY_FIELD_CELL_MIN_V] = (hot.valid & HOT_VALID_CELL_MIN) ? hot.cellMinMv : kRelayNullValue;
+  values[RELAY_FIELD_CELL_MAX_V] = (hot.valid & HOT_VALID_CELL_MAX) ? hot.cellMaxMv : kRelayNullValue;
+  values[RELAY_FIELD_CELL_MIN_NO] = (hot.valid & HOT_VALID_CELL_MIN) ? hot.cellMinNo : kRelayNullValue;
+  values[RELAY_FIELD_CELL_MAX_NO] = (hot.valid & HOT_VALID_CELL_MAX) ? hot.cellMaxNo : kRelayNullValue;
+  values[RELAY_FIELD_CHARGED_KWH] = (p.cumulativeEnergyChargedKWh >= 0.0f && p.cumulativeEnergyChargedKWhStart >= 0.0f) ? fixedPoint(p.cumulativeEnergyChargedKWh - p.cumulativeEnergyChargedKWhStart, 2) : kRelayNullValue;
+  values[RELAY_FIELD_DISCHARGED_KWH] = (p.cumulativeEnergyDischargedKWh >= 0.0f && p.cumulativeEnergyDischargedKWhStart >= 0.0f) ? fixedPoint(p.cumulativeEnergyDischargedKWh - p.cumulativeEnergyDischargedKWhStart, 2) : kRelayNullValue;
+  values[RELAY_FIELD_AVAIL_KWH] = fixedPoint(p.batteryTotalAvailableKWh, 1);
+  values[RELAY_FIELD_BAT_KWH] = fixedPoint(p.batEnergyContent, 1);
+  values[RELAY_FIELD_BAT_MAX_KWH] = fixedPoint(p.batMaxEnergyContent, 1);
+  values[RELAY_FIELD_BMS_MODE] = p.batteryManagementMode;
+  values[RELAY_FIELD_FRONT_RPM] = fixedPoint(p.motor1Rpm, 0);
+  values[RELAY_FIELD_REAR_RPM] = fixedPoint(p.motor2Rpm, 0);
+  values[RELAY_FIELD_FL_TIRE_KPA] = (p.tireFrontLeftPressureBar > 0.05f) ? fixedPoint(p.tireFrontLeftPressureBar * 100.0f, 0) : kRelayNullValue;
+  values[RELAY_FIELD_FR_TIRE_KPA] = (p.tireFrontRightPressureBar > 0.05f) ? fixedPoint(p.tireFrontRightPressureBar * 100.0f, 0) : kRelayNullValue;
+  values[RELAY_FIELD_RL_TIRE_KPA] = (p.tireRearLeftPressureBar > 0.05f) ? fixedPoint(p.tireRearLeftPressureBar * 100.0f, 0) : kRelayNullValue;
+  values[RELAY_FIELD_RR_TIRE_KPA] = (p.tireRearRightPressureBar > 0.05f) ? fixedPoint(p.tireRearRightPressureBar * 100.0f, 0) : kRelayNullValue;
+  values[RELAY_FIELD_FL_TIRE_C] = (p.tireFrontLeftTempC > -50.0f) ? fixedPoint(p.tireFrontLeftTempC, 0) : kRelayNullValue;
+  values[RELAY_FIELD_FR_TIRE_C] = (p.tireFrontRightTempC > -50.0f) ? fixedPoint(p.tireFrontRightTempC, 0) : kRelayNullValue;
+  values[RELAY_FIELD_RL_TIRE_C] = (p.tireRearLeftTempC > -50.0f) ? fixedPoint(p.tireRearLeftTempC, 0) : kRelayNullValue;
+  values[RELAY_FIELD_RR_TIRE_C] = (p.tireRearRightTempC > -50.0f) ? fixedPoint(p.tireRearRightTempC, 0) : kRelayNullValue;
+  values[RELAY_FIELD_LAT] = fixedPoint(p.gpsLat, 5);
+  values[RELAY_FIELD_LON] = fixedPoint(p.gpsLon, 5);
+  values[RELAY_FIELD_ALT] = fixedPoint(p.gpsAlt, 0);
+  values[RELAY_FIELD_SAT] = p.gpsSat;
+  values[RELAY_FIELD_HDG] = fixedPoint(p.gpsHeadingDeg, 1);
+}
+
+/**
+ * v3 snapshot: fields that differ from the last acked snapshot, full until the app acks
+ */
+void EvDashMobileRelay::sendSnapshotBinary()
+{
+  const uint8_t seq = snapshotSeq++;
+  const uint8_t slot = seq % kSnapshotHistory;
+  int32_t *values = sentSnapshots[slot];
+  collectSnapshotFields(values);
+  sentSnapshotSeq[slot] = seq;
+  sentSnapshotValid[slot] = true;
+
+  const bool delta = ackedSnapshotValid;
+  size_t n = 0;
+  txBuffer[n++] = seq;
+  if (delta)
+  {
+    txBuffer[n++] = ackedSnapshotSeq;
+  }
+  const size_t countPos = n++;
+  uint8_t count = 0;
+  for (uint8_t id = 0; id < RELAY_FIELD_COUNT; id++)
+  {
+    if (delta && values[id] == ackedSnapshot[id])
+    {
+      continue;
+    }
+    if (values[id] == kRelayNullValue)
+    {
+      txBuffer[n++] = id | kRelayFieldNull;
+    }
+    else
+    {
+      txBuffer[n++] = id;
+      n += putSvarint(txBuffer + n, values[id]);
+    }
+    count++;
+  }
+  txBuffer[countPos] = count;
+  notifyFrame(delta ? RELAY_MSG_SNAPSHOT_DELTA : RELAY_MSG_SNAPSHOT_FULL, txBuffer, n);
+}
+
+/**
+ * v3 cells: packed mV from the shared cell stats, neighbour differences as zigzag varints.
+ * Skipped while no cell changed since the last sent frame.
+ */
+void EvDashMobileRelay::sendCellsBinary()
+{
+  CellStats &stats = liveData->cellStats;
+  if (cellsSent && stats.version() == cellsVersionSent)
+  {
+    return;
+  }
+  const uint16_t *mv = stats.millivolts();
+  uint16_t count = liveData->params.cellCount;
+  if (count == 0 || count > CellStats::kMaxCells)
+  {
+    count = CellStats::kMaxCells;
+    while (count > 0 && mv[count - 1] == 0)
+    {
+      count--;
+    }
+  }
+
+  size_t n = 0;
+  txBuffer[n++] = count & 0xFF;
+  txBuffer[n++] = count >> 8;
+  int32_t previous = 0;
+  for (uint16_t i = 0; i < count; i++)
+  {
+    n += putSvarint(txBuffer + n, int32_t(mv[i]) - previous);
+    previous = mv[i];
+  }
+  notifyFrame(RELAY_MSG_CELLS, txBuffer, n);
+  cellsVersionSent = stats.version();
+  cellsSent = true;
+}
+
+void EvDashMobileRelay::sendTempsBinary()
+{
+  PARAMS_STRUC &p = liveData->params;
+  const uint8_t count = (p.batModuleTempCount > 0 && p.batModuleTempCount <= 25) ? p.batModuleTempCount : 25;
+  size_t n = 0;
+  txBuffer[n++] = count;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    const float value = p.batModuleTempC[i];
+    txBuffer[n++] = (!isfinite(value) || value < -30.0f || value > 80.0f) ? uint8_t(int8_t(-128)) : uint8_t(int8_t(lroundf(value)));
+  }
+  notifyFrame(RELAY_MSG_TEMPS, txBuffer, n);
+}
+
 void EvDashMobileRelay::sendRawFrames()
 {
-  if (liveData->contributeRawFrameCount == 0)
+  if (liveData->contributeRawFrames.count() == 0)
   {
     return;
   }
   String json = "{\"type\":\"raw\",\"ver\":2,\"frames\":{";
   uint8_t added = 0;
-  for (uint8_t i = 0; i < liveData->contributeRawFrameCount && added < 8; i++)
+  for (uint8_t i = 0; i < liveData->contributeRawFrames.count() && added < 8; i++)
   {
-    LiveData::ContributeRawFrame &raw = liveData->contributeRawFrames[i];
-    if (raw.key[0] == '\0' || raw.value[0] == '\0')
-    {
-      continue;
-    }
+    const RawFrameTable::Frame raw = liveData->contributeRawFrames.frame(i);
     if (added > 0)
     {
       json += ",";
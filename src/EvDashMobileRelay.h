@@ -1,8 +1,13 @@
 #pragma once
 
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 #include "ble_compat.h"
 #include "LiveData.h"
+#include "EvDashRelayProtocol.h"
+#include "LiveDataHistory.h"
+#include "RelayHistoryJob.h"
 
 class BoardInterface;
 
@@ -11,12 +16,19 @@ class BoardInterface;
  *
  * M5Stack keeps talking to the car. The phone app connects here and receives
  * snapshots, cells, module temperatures, and recent raw frames.
+ * JSON lines (v2) by default, binary delta frames (v3) when the app asks for
+ * them, see EvDashRelayProtocol.h.
+ *
+ * BLE callbacks run on the BLE host task: they only queue commands and flag
+ * connection changes. Everything else, including the notifications, runs in
+ * loop() on the main loop task.
  */
 class EvDashMobileRelay : public BLEServerCallbacks, public BLECharacteristicCallbacks
 {
 public:
   void begin(LiveData *pLiveData, BoardInterface *pBoard);
   void loop();
+  void pumpTx();
   String startPairing();
   void forgetPairing();
   void pauseForNetUpload();
@@ -36,39 +48,126 @@ private:
   BLECharacteristic *notifyCharacteristic = nullptr;
   BLECharacteristic *writeCharacteristic = nullptr;
   bool started = false;
-  bool connected = false;
+  volatile bool connected = false;
+  volatile bool connectPending = false;
+  volatile bool disconnectPending = false;
   bool netUploadPaused = false;
   bool advertisingUuidAdded = false;
   char currentPairingCode[7] = "";
   uint32_t pairingExpiresAtMs = 0;
   uint32_t lastHelloMs = 0;
-  uint32_t lastSnapshotMs = 0;
-  uint32_t lastCellsMs = 0;
-  uint32_t lastTempsMs = 0;
-  uint32_t lastRawMs = 0;
+  // Streams the app can subscribe to with its own interval (0 = off)
+  enum RelayStream : uint8_t
+  {
+    RELAY_STREAM_SNAPSHOT = 0,
+    RELAY_STREAM_CELLS,
+    RELAY_STREAM_TEMPS,
+    RELAY_STREAM_RAW,
+    RELAY_STREAM_COUNT
+  };
+  struct StreamSchedule
+  {
+    const char *name;
+    uint16_t defaultMs;
+    uint16_t minMs;
+    uint16_t intervalMs;
+    uint32_t lastMs;
+    uint32_t skipped; // cycles skipped by backpressure
+  };
+  StreamSchedule streams[RELAY_STREAM_COUNT] = {
+      {"snapshot", 500, 100, 500, 0, 0},
+      {"cells", 3000, 500, 3000, 0, 0},
+      {"temps", 3000, 500, 3000, 0, 0},
+      {"raw", 2500, 500, 2500, 0, 0},
+  };
+  // Backpressure: estimated bytes still queued in the BLE stack
+  static constexpr uint16_t kTxDrainBytesPerSec = 6000;
+  static constexpr uint16_t kTxBacklogLimitBytes = 512;
+  uint32_t txBacklogBytes = 0;
+  uint32_t txBacklogUpdatedMs = 0;
+  // Outgoing fragments ([len lo][len hi][bytes] each), sent from loop() at the send cursor.
+  // PSRAM holds a contribute payload in one piece; internal RAM fallback is smaller.
+  static constexpr size_t kTxQueueBytes = 16384;
+  static constexpr size_t kTxQueueBytesInternal = 4096;
+  static constexpr uint8_t kTxFragmentGapMs = 3;
+  static constexpr uint8_t kTxFragmentsPerLoop = 4;
+  uint8_t *txQueue = nullptr;
+  size_t txQueueSize = 0;
+  size_t txHead = 0; // send cursor
+  size_t txTail = 0;
+  uint32_t lastFragmentMs = 0;
+  uint32_t txDropped = 0;
+  // Command lines from onWrite(), handled in loop()
+  static constexpr uint8_t kCommandQueueLength = 4;
+  static constexpr size_t kCommandMaxBytes = 512;
+  struct RelayCommand
+  {
+    char line[kCommandMaxBytes + 1];
+  };
+  QueueHandle_t commandQueue = nullptr;
+  RelayCommand rxCommand = {}; // line being received, BLE host task only
+  size_t rxLength = 0;
+  volatile uint16_t commandsDropped = 0;
+  // History backfill, sent in chunks when no live stream is due
+  RelayHistoryJob historyJob;
   uint32_t lastSerialMirrorMs = 0;
   bool serialCaptureEnabled = false;
-  String rxBuffer = "";
   String serialMirrorBuffer = "";
   String serialPendingLines = "";
   bool serialPendingOverflow = false;
   static constexpr size_t kSerialPendingMaxBytes = 8192;
   static constexpr uint8_t kSerialFlushLinesPerLoop = 4;
+  // Binary protocol v3
+  static constexpr int32_t kRelayNullValue = INT32_MIN;
+  static constexpr uint8_t kSnapshotHistory = 4; // sent snapshots kept as delta base candidates
+  static constexpr uint16_t kDefaultFragmentPayload = 160;
+  bool binaryProtocol = false;
+  uint16_t fragmentPayload = kDefaultFragmentPayload;
+  uint8_t frameSeq = 0;
+  uint8_t snapshotSeq = 0;
+  int32_t sentSnapshots[kSnapshotHistory][RELAY_FIELD_COUNT];
+  uint8_t sentSnapshotSeq[kSnapshotHistory] = {};
+  bool sentSnapshotValid[kSnapshotHistory] = {};
+  int32_t ackedSnapshot[RELAY_FIELD_COUNT];
+  uint8_t ackedSnapshotSeq = 0;
+  bool ackedSnapshotValid = false;
+  uint32_t cellsVersionSent = 0;
+  bool cellsSent = false;
+  uint8_t txBuffer[1024];
 
   void startServer();
   void stopServer();
+  void handleConnectionEvents();
+  void handleQueuedCommands();
   void handleCommand(const String &jsonLine);
   void handlePairStart(const String &mobileId, const String &code);
   void handleSerialCaptureStart();
   void handleSerialCaptureStop();
   void notifyLine(const String &line);
   void notifyJson(const String &json);
+  void noteNotified(size_t bytes);
+  uint32_t drainTxBacklog();
+  bool txBacklogged();
+  bool reserveTx(size_t bytes);
+  void queueFragment(const uint8_t *header, size_t headerLength, const uint8_t *data, size_t length);
+  void resetStreams();
+  void sendStream(uint8_t stream);
+  void startHistoryJob(time_t since, uint16_t channelMask);
+  void sendHistoryChunk();
+  void notifyFrame(uint8_t type, const uint8_t *payload, size_t length);
+  void setBinaryProtocol(bool enabled, uint16_t mtu);
+  void handleSnapshotAck(int16_t seq);
+  void collectSnapshotFields(int32_t *values) const;
+  void sendSnapshotBinary();
+  void sendCellsBinary();
+  void sendTempsBinary();
   void sendHello();
   void sendContributePayload();
   void sendSnapshot();
   void sendCells();
   void sendTemps();
   void sendRawFrames();
+  void sendMemoryStats();
   void sendSerialLine(const String &line);
   void queueSerialLine(const String &line);
   void flushSerialPendingLines(uint8_t maxLines);
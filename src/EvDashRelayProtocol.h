@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * evDash mobile relay binary protocol (v3).
+ *
+ * v2 (default) sends JSON lines. The app switches to v3 by sending
+ *   {"type":"hello","token":"...","proto":3,"mtu":<negotiated ATT MTU>}
+ * The relay answers {"type":"protocol","ver":3,...} as a v2 JSON line; from then
+ * on every notification is a v3 fragment until disconnect:
+ *
+ *   [0xE3][msgType][msgSeq][frag] payload...
+ *   frag: bit 7 = last fragment, bits 0-6 = fragment index modulo 128
+ *
+ * Fragments of one message share msgSeq and are sent in order. Payload per
+ * fragment is MTU - 3 (ATT) - 4 (header) bytes. The index wraps 127 -> 0 on
+ * long messages (over ~2 kB at MTU 23), so the app appends fragments in arrival
+ * order until the last one and uses the index only to detect a gap. Messages
+ * over kRelayMaxMessageBytes are not sent.
+ *
+ * Messages (multi byte integers little endian, varint = unsigned LEB128,
+ * svarint = zigzag varint):
+ *   JSON_LINE       one v2 JSON line without '\n' (hello, raw, serial, pair ...)
+ *   SNAPSHOT_FULL   [seq][count] count x field
+ *   SNAPSHOT_DELTA  [seq][baseSeq][count] count x field, only fields that differ
+ *                   from snapshot baseSeq; fields not listed keep baseSeq values
+ *   CELLS           [count u16][count x svarint] mV, first cell absolute, next ones
+ *                   as difference to the previous cell (0 = unknown cell)
+ *   TEMPS           [count] count x int8 C (-128 = unknown)
+ *   HISTORY         [channel][periodSec u16][startTime u32][count] count x point,
+ *                   point: [varint periods since previous point (first: since
+ *                   startTime)] svarint avg, min, max (fixed point, channel decimals)
+ *   field: [id] svarint value (fixed point, see decimals) or [id | 0x80] = null
+ *
+ * The app acks applied snapshots with {"type":"ack","token":"...","seq":N}.
+ * Deltas are always relative to the newest acked snapshot, so a lost
+ * notification only costs the fields of that message; without acks the relay
+ * keeps sending full snapshots.
+ */
+
+static constexpr uint8_t kRelayFrameMagic = 0xE3;
+static constexpr uint8_t kRelayFrameHeaderSize = 4;
+static constexpr uint8_t kRelayFragmentLast = 0x80;
+static constexpr uint8_t kRelayFragmentIndexMask = 0x7F;
+static constexpr uint32_t kRelayMaxMessageBytes = 32768;
+static constexpr uint8_t kRelayFieldNull = 0x80;
+
+enum RelayMessageType : uint8_t
+{
+  RELAY_MSG_JSON_LINE = 1,
+  RELAY_MSG_SNAPSHOT_FULL = 2,
+  RELAY_MSG_SNAPSHOT_DELTA = 3,
+  RELAY_MSG_CELLS = 4,
+  RELAY_MSG_TEMPS = 5,
+  RELAY_MSG_HISTORY = 6,
+};
+
+// Snapshot field IDs (never renumber, append only). Comment = v2 JSON key, decimals.
+enum RelayFieldId : uint8_t
+{
+  RELAY_FIELD_TS = 0,             // ts, 0
+  RELAY_FIELD_SPD,                // spd, 1
+  RELAY_FIELD_GPS_SPD,            // gpsSpd, 1
+  RELAY_FIELD_SOC,                // soc, 1
+  RELAY_FIELD_SOC_BMS,            // socBms, 1
+  RELAY_FIELD_SOH,                // soh, 1
+  RELAY_FIELD_POW_KW,             // powKw, 2
+  RELAY_FIELD_POW_KWH100,         // powKwh100, 2
+  RELAY_FIELD_BAT_V,              // batV, 1
+  RELAY_FIELD_BAT_A,              // batA, 1
+  RELAY_FIELD_AUX_V,              // auxV, 1
+  RELAY_FIELD_AUX_PCT,            // auxPct, 0
+  RELAY_FIELD_ODO_KM,             // odoKm, 1
+  RELAY_FIELD_AVG_SPD,            // avgSpd, 1
+  RELAY_FIELD_TRIP_KM,            // tripKm, 1
+  RELAY_FIELD_IN_C,               // inC, 1
+  RELAY_FIELD_OUT_C,              // outC, 1
+  RELAY_FIELD_FLAGS,              // bit 0 chg, 1 chgAc, 2 chgDc, 3 flDoor, 4 frDoor, 5 rlDoor, 6 rrDoor, 7 hood, 8 trunk, 9 headlights, 10 brakeLights
+  RELAY_FIELD_DRIVE,              // drive: 0 "-", 1 "D", 2 "R", 3 "P/N"
+  RELAY_FIELD_BAT_MIN_C,          // batMinC, 0
+  RELAY_FIELD_BAT_MAX_C,          // batMaxC, 0
+  RELAY_FIELD_BAT_INLET_C,        // batInletC, 0
+  RELAY_FIELD_BAT_HEATER_C,       // batHeaterC, 0
+  RELAY_FIELD_COOLANT_C,          // coolantC, 0
+  RELAY_FIELD_CELL_MIN_V,         // cMinV, 3
+  RELAY_FIELD_CELL_MAX_V,         // cMaxV, 3
+  RELAY_FIELD_CELL_MIN_NO,        // cMinNo, 0
+  RELAY_FIELD_CELL_MAX_NO,        // cMaxNo, 0
+  RELAY_FIELD_CHARGED_KWH,        // chargedKwh, 2
+  RELAY_FIELD_DISCHARGED_KWH,     // dischargedKwh, 2
+  RELAY_FIELD_AVAIL_KWH,          // availKwh, 1
+  RELAY_FIELD_BAT_KWH,            // batKwh, 1
+  RELAY_FIELD_BAT_MAX_KWH,        // batMaxKwh, 1
+  RELAY_FIELD_BMS_MODE,           // bms as LiveData battery management mode number, 0
+  RELAY_FIELD_FRONT_RPM,          // frontRpm, 0
+  RELAY_FIELD_REAR_RPM,           // rearRpm, 0
+  RELAY_FIELD_FL_TIRE_KPA,        // flTireKpa, 0
+  RELAY_FIELD_FR_TIRE_KPA,        // frTireKpa, 0
+  RELAY_FIELD_RL_TIRE_KPA,        // rlTireKpa, 0
+  RELAY_FIELD_RR_TIRE_KPA,        // rrTireKpa, 0
+  RELAY_FIELD_FL_TIRE_C,          // flTireC, 0
+  RELAY_FIELD_FR_TIRE_C,          // frTireC, 0
+  RELAY_FIELD_RL_TIRE_C,          // rlTireC, 0
+  RELAY_FIELD_RR_TIRE_C,          // rrTireC, 0
+  RELAY_FIELD_LAT,                // lat, 5
+  RELAY_FIELD_LON,                // lon, 5
+  RELAY_FIELD_ALT,                // alt, 0
+  RELAY_FIELD_SAT,                // sat, 0
+  RELAY_FIELD_HDG,                // hdg, 1
+  RELAY_FIELD_COUNT
+};
@@ -0,0 +1,194 @@
+/**
+ * Binary GNSS navigation parser, see GpsBinaryParser.h.
+ */
+#include "GpsBinaryParser.h"
+#include <string.h>
+
+static uint16_t readU2(const uint8_t *p)
+{
+  return uint16_t(p[0]) | (uint16_t(p[1]) << 8);
+}
+
+static uint32_t readU4(const uint8_t *p)
+{
+  return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+static float readR4(const uint8_t *p)
+{
+  const uint32_t bits = readU4(p);
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static double readR8(const uint8_t *p)
+{
+  const uint64_t bits = uint64_t(readU4(p)) | (uint64_t(readU4(p + 4)) << 32);
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void GpsBinaryParser::ubxChecksum(const uint8_t *data, uint16_t length, uint8_t &ckA, uint8_t &ckB)
+{
+  ckA = 0;
+  ckB = 0;
+  for (uint16_t i = 0; i < length; i++)
+  {
+    ckA += data[i];
+    ckB += ckA;
+  }
+}
+
+bool GpsBinaryParser::encode(uint8_t byte)
+{
+  switch (state)
+  {
+  case SYNC1:
+    if (byte == 0xB5 || byte == 0xBA)
+    {
+      casic = (byte == 0xBA);
+      state = SYNC2;
+    }
+    return false;
+  case SYNC2:
+    if ((!casic && byte == 0x62) || (casic && byte == 0xCE))
+    {
+      headerPos = 0;
+      state = HEADER;
+    }
+    else
+    {
+      state = (byte == 0xB5 || byte == 0xBA) ? SYNC2 : SYNC1;
+      casic = (byte == 0xBA);
+    }
+    return false;
+  case HEADER:
+    header[headerPos++] = byte;
+    if (headerPos < 4)
+    {
+      return false;
+    }
+    // UBX: class id lenL lenH, CASIC: lenL lenH class id
+    msgClass = casic ? header[2] : header[0];
+    msgId = casic ? header[3] : header[1];
+    length = casic ? readU2(header) : readU2(header + 2);
+    if (length > kMaxPayload)
+    {
+      // Not a frame we decode (or garbage), resync
+      state = SYNC1;
+      return false;
+    }
+    payloadPos = 0;
+    checksumPos = 0;
+    state = (length == 0) ? CHECKSUM : PAYLOAD;
+    return false;
+  case PAYLOAD:
+    payload[payloadPos++] = byte;
+    if (payloadPos >= length)
+    {
+      state = CHECKSUM;
+    }
+    return false;
+  case CHECKSUM:
+    checksum[checksumPos++] = byte;
+    if (checksumPos < (casic ? 4 : 2))
+    {
+      return false;
+    }
+    state = SYNC1;
+    return finishFrame();
+  }
+  state = SYNC1;
+  return false;
+}
+
+bool GpsBinaryParser::finishFrame()
+{
+  if (casic)
+  {
+    // Sum of little endian words: header word (len | class << 16 | id << 24) + payload words
+    uint32_t sum = readU4(header);
+    for (uint16_t i = 0; i + 3 < length; i += 4)
+    {
+      sum += readU4(payload + i);
+    }
+    if (sum != readU4(checksum))
+    {
+      badChecksums++;
+      return false;
+    }
+  }
+  else
+  {
+    uint8_t ckA, ckB;
+    ubxChecksum(header, 4, ckA, ckB);
+    for (uint16_t i = 0; i < length; i++)
+    {
+      ckA += payload[i];
+      ckB += ckA;
+    }
+    if (ckA != checksum[0] || ckB != checksum[1])
+    {
+      badChecksums++;
+      return false;
+    }
+  }
+
+  frames++;
+  if (msgClass != 0x01)
+  {
+    return false;
+  }
+  if (!casic && msgId == 0x07 && length == 92)
+  {
+    return decodeUbxNavPvt();
+  }
+  if (casic && msgId == 0x03 && length == 80)
+  {
+    return decodeCasicNavPv();
+  }
+  return false;
+}
+
+bool GpsBinaryParser::decodeUbxNavPvt()
+{
+  const uint8_t *p = payload;
+  const uint8_t valid = p[11];
+  const uint8_t fixType = p[20];
+  const bool fixOk = (p[21] & 0x01) != 0 && fixType >= 2 && fixType <= 4;
+
+  navData.dateTimeValid = (valid & 0x03) == 0x03;
+  navData.year = readU2(p + 4);
+  navData.month = p[6];
+  navData.day = p[7];
+  navData.hour = p[8];
+  navData.minute = p[9];
+  navData.second = p[10];
+  navData.sat = p[23];
+  navData.positionValid = fixOk;
+  navData.lon = int32_t(readU4(p + 24)) * 1e-7;
+  navData.lat = int32_t(readU4(p + 28)) * 1e-7;
+  navData.altM = int32_t(readU4(p + 36)) / 1000.0f;
+  navData.speedValid = fixOk;
+  navData.speedKmh = int32_t(readU4(p + 60)) * 0.0036f; // mm/s
+  navData.courseDeg = int32_t(readU4(p + 64)) * 1e-5f;
+  return true;
+}
+
+bool GpsBinaryParser::decodeCasicNavPv()
+{
+  const uint8_t *p = payload;
+  // posValid/velValid: 6 = 2D, 7 = 3D, 8 = GNSS + DR
+  navData.positionValid = p[4] >= 6 && p[4] <= 8;
+  navData.speedValid = p[5] >= 6 && p[5] <= 8;
+  navData.sat = p[7];
+  navData.lon = readR8(p + 16);
+  navData.lat = readR8(p + 24);
+  navData.altM = readR4(p + 32);
+  navData.speedKmh = readR4(p + 64) * 3.6f; // speed2D m/s
+  navData.courseDeg = readR4(p + 68);
+  navData.dateTimeValid = false;
+  return true;
+}
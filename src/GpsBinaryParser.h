@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Byte-wise parser for binary GNSS navigation messages:
+ *   u-blox UBX NAV-PVT (B5 62, class 0x01 id 0x07, 92 B payload, Fletcher-8 checksum)
+ *   CASIC NAV-PV       (BA CE, class 0x01 id 0x03, 80 B payload, 32-bit word sum)
+ * Other frames are checked and skipped. No Arduino dependencies.
+ */
+class GpsBinaryParser
+{
+public:
+  struct Nav
+  {
+    bool positionValid;
+    double lat;
+    double lon;
+    float altM; // above mean sea level
+    uint8_t sat;
+    bool speedValid;
+    float speedKmh;
+    float courseDeg;
+    bool dateTimeValid; // CASIC NAV-PV carries no date/time
+    uint16_t year;
+    uint8_t month, day, hour, minute, second;
+  };
+
+  bool encode(uint8_t byte); // true when a navigation message was just completed
+  const Nav &nav() const { return navData; }
+  uint32_t frameCount() const { return frames; }
+  uint32_t checksumErrors() const { return badChecksums; }
+
+  // UBX Fletcher-8 over class, id, length and payload
+  static void ubxChecksum(const uint8_t *data, uint16_t length, uint8_t &ckA, uint8_t &ckB);
+
+private:
+  static constexpr uint16_t kMaxPayload = 96;
+  enum State : uint8_t
+  {
+    SYNC1,
+    SYNC2,
+    HEADER,
+    PAYLOAD,
+    CHECKSUM
+  };
+  State state = SYNC1;
+  bool casic = false;
+  uint8_t header[4] = {};
+  uint8_t headerPos = 0;
+  uint8_t msgClass = 0;
+  uint8_t msgId = 0;
+  uint16_t length = 0;
+  uint16_t payloadPos = 0;
+  uint8_t payload[kMaxPayload] = {};
+  uint8_t checksum[4] = {};
+  uint8_t checksumPos = 0;
+  Nav navData = {};
+  uint32_t frames = 0;
+  uint32_t badChecksums = 0;
+
+  bool finishFrame();
+  bool decodeUbxNavPvt();
+  bool decodeCasicNavPv();
+};
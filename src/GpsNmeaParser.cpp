@@ -0,0 +1,261 @@
+/**
+ * NMEA GGA/RMC parser, see GpsNmeaParser.h.
+ */
+#include "GpsNmeaParser.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int8_t hexValue(char ch)
+{
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  return -1;
+}
+
+static bool twoDigits(const char *p, uint8_t &value)
+{
+  if (p[0] < '0' || p[0] > '9' || p[1] < '0' || p[1] > '9')
+    return false;
+  value = uint8_t((p[0] - '0') * 10 + (p[1] - '0'));
+  return true;
+}
+
+// ddmm.mmmm / dddmm.mmmm to degrees
+static double nmeaDegrees(const char *field)
+{
+  const double value = strtod(field, nullptr);
+  const int degrees = int(value / 100);
+  return degrees + (value - degrees * 100) / 60.0;
+}
+
+bool GpsNmeaParser::encode(char ch, int64_t arrivalUs)
+{
+  if (ch == '$')
+  {
+    inSentence = true;
+    length = 0;
+    return false;
+  }
+  if (!inSentence)
+  {
+    return false;
+  }
+  if (ch == '\r' || ch == '\n')
+  {
+    inSentence = false;
+    sentence[length] = '\0';
+    return finishSentence(arrivalUs);
+  }
+  if (length >= kMaxSentence)
+  {
+    inSentence = false; // overlong, wait for the next '$'
+    return false;
+  }
+  sentence[length++] = ch;
+  return false;
+}
+
+/**
+ * hhmmss[.ss] to 1/100 s, -1 when empty or malformed
+ */
+int32_t GpsNmeaParser::parseTime(const char *field)
+{
+  uint8_t hour, minute, second;
+  if (!twoDigits(field, hour) || !twoDigits(field + 2, minute) || !twoDigits(field + 4, second))
+  {
+    return -1;
+  }
+  int32_t hundredths = 0;
+  if (field[6] == '.')
+  {
+    int32_t scale = 10;
+    for (const char *p = field + 7; *p >= '0' && *p <= '9' && scale > 0; p++, scale /= 10)
+    {
+      hundredths += (*p - '0') * scale;
+    }
+  }
+  return ((int32_t(hour) * 60 + minute) * 60 + second) * 100 + hundredths;
+}
+
+void GpsNmeaParser::applyTime(const char *field)
+{
+  uint8_t hour, minute, second;
+  if (twoDigits(field, hour) && twoDigits(field + 2, minute) && twoDigits(field + 4, second))
+  {
+    state.hour = hour;
+    state.minute = minute;
+    state.second = second;
+    timeSeen = true;
+  }
+}
+
+bool GpsNmeaParser::applyLocation(const char *lat, const char *ns, const char *lon, const char *ew)
+{
+  if (*lat == '\0' || *lon == '\0')
+  {
+    return false;
+  }
+  state.lat = nmeaDegrees(lat) * ((*ns == 'S') ? -1 : 1);
+  state.lon = nmeaDegrees(lon) * ((*ew == 'W') ? -1 : 1);
+  state.locationValid = true;
+  return true;
+}
+
+void GpsNmeaParser::emit(int64_t arrivalUs)
+{
+  epochFix = state;
+  epochFix.arrivalUs = arrivalUs;
+  epochPending = false;
+  epochGga = false;
+  epochRmc = false;
+  fixes++;
+}
+
+/**
+ * Verify checksum, split fields and apply GGA/RMC
+ */
+bool GpsNmeaParser::finishSentence(int64_t arrivalUs)
+{
+  char *star = strchr(sentence, '*');
+  if (star == nullptr || hexValue(star[1]) < 0 || hexValue(star[2]) < 0)
+  {
+    badChecksums++;
+    return false;
+  }
+  uint8_t checksum = 0;
+  for (const char *p = sentence; p < star; p++)
+  {
+    checksum ^= uint8_t(*p);
+  }
+  if (checksum != uint8_t((hexValue(star[1]) << 4) | hexValue(star[2])))
+  {
+    badChecksums++;
+    return false;
+  }
+  *star = '\0';
+  sentences++;
+
+  const char *fields[kMaxFields];
+  uint8_t count = 0;
+  fields[count++] = sentence;
+  for (char *p = sentence; *p != '\0' && count < kMaxFields; p++)
+  {
+    if (*p == ',')
+    {
+      *p = '\0';
+      fields[count++] = p + 1;
+    }
+  }
+
+  const bool gga = (strlen(fields[0]) == 5 && strcmp(fields[0] + 2, "GGA") == 0 && count >= 10);
+  const bool rmc = (strlen(fields[0]) == 5 && strcmp(fields[0] + 2, "RMC") == 0 && count >= 10);
+  if (!gga && !rmc)
+  {
+    return false;
+  }
+
+  // A sentence of the next epoch closes the pending one
+  bool completed = false;
+  const int32_t time = parseTime(fields[1]);
+  if (epochPending && time != epochTime)
+  {
+    emit(lastSentenceUs);
+    completed = true;
+  }
+
+  if (gga)
+  {
+    // $GPGGA,time,lat,N,lon,E,quality,sats,hdop,alt,M,...
+    applyTime(fields[1]);
+    if (atoi(fields[6]) > 0 && applyLocation(fields[2], fields[3], fields[4], fields[5]) && *fields[9] != '\0')
+    {
+      state.altM = float(strtod(fields[9], nullptr));
+    }
+    if (*fields[7] != '\0')
+    {
+      state.satValid = true;
+      state.sat = uint8_t(atoi(fields[7]));
+    }
+    epochGga = true;
+  }
+  else
+  {
+    // $GPRMC,time,status,lat,N,lon,E,knots,course,ddmmyy,...
+    applyTime(fields[1]);
+    uint8_t day, month, year;
+    if (twoDigits(fields[9], day) && twoDigits(fields[9] + 2, month) && twoDigits(fields[9] + 4, year))
+    {
+      state.day = day;
+      state.month = month;
+      state.year = 2000 + year;
+      dateSeen = true;
+    }
+    if (*fields[2] == 'A')
+    {
+      applyLocation(fields[3], fields[4], fields[5], fields[6]);
+      if (*fields[7] != '\0')
+      {
+        state.speedValid = true;
+        state.speedKmh = float(strtod(fields[7], nullptr) * 1.852);
+      }
+      if (*fields[8] != '\0')
+      {
+        state.courseValid = true;
+        state.courseDeg = float(strtod(fields[8], nullptr));
+      }
+    }
+    epochRmc = true;
+  }
+  state.dateTimeValid = dateSeen && timeSeen;
+
+  epochTime = time;
+  epochPending = true;
+  lastSentenceUs = arrivalUs;
+  if (epochGga && epochRmc)
+  {
+    emit(arrivalUs);
+    completed = true;
+  }
+  return completed;
+}
+
+GpsFix GpsNmeaParser::binaryFix(const GpsBinaryParser::Nav &nav, int64_t arrivalUs) const
+{
+  GpsFix fix = {};
+  fix.arrivalUs = arrivalUs;
+  fix.locationValid = nav.positionValid;
+  fix.lat = nav.lat;
+  fix.lon = nav.lon;
+  fix.altM = nav.altM;
+  fix.satValid = true;
+  fix.sat = nav.sat;
+  fix.speedValid = nav.speedValid;
+  fix.speedKmh = nav.speedKmh;
+  fix.courseValid = nav.speedValid;
+  fix.courseDeg = nav.courseDeg;
+  fix.dateTimeValid = nav.dateTimeValid;
+  if (fix.dateTimeValid)
+  {
+    fix.year = nav.year;
+    fix.month = nav.month;
+    fix.day = nav.day;
+    fix.hour = nav.hour;
+    fix.minute = nav.minute;
+    fix.second = nav.second;
+  }
+  else if (dateSeen && timeSeen)
+  {
+    fix.dateTimeValid = true;
+    fix.year = state.year;
+    fix.month = state.month;
+    fix.day = state.day;
+    fix.hour = state.hour;
+    fix.minute = state.minute;
+    fix.second = state.second;
+  }
+  return fix;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include "GpsBinaryParser.h"
+
+/**
+ * One GPS epoch as applied by the main loop (Board320_240::syncGPS)
+ */
+struct GpsFix
+{
+  int64_t arrivalUs; // esp_timer time the completing sentence was read from UART
+  bool locationValid;
+  double lat;
+  double lon;
+  float altM;
+  bool satValid;
+  uint8_t sat;
+  bool speedValid;
+  float speedKmh;
+  bool courseValid;
+  float courseDeg;
+  bool dateTimeValid;
+  uint16_t year;
+  uint8_t month, day, hour, minute, second;
+};
+
+/**
+ * Char-wise NMEA parser for GGA and RMC (any talker, checksum required).
+ *
+ * Values stick like in TinyGPS++: RMC with status A updates location, speed
+ * and course, GGA with fix quality > 0 updates location and altitude, both
+ * update the time. A fix is emitted once per epoch, when GGA and RMC of the
+ * same UTC time were both seen, or when a sentence of the next epoch arrives
+ * first (modules with only one of the two enabled). The fix carries the
+ * arrival time of the sentence that completed it. No Arduino dependencies.
+ */
+class GpsNmeaParser
+{
+public:
+  bool encode(char ch, int64_t arrivalUs); // true when an epoch was just completed
+  const GpsFix &fix() const { return epochFix; }
+  const GpsFix &current() const { return state; }
+  // Fix from a binary NAV message, date/time taken from NMEA when the message has none (CASIC)
+  GpsFix binaryFix(const GpsBinaryParser::Nav &nav, int64_t arrivalUs) const;
+  uint32_t sentenceCount() const { return sentences; }
+  uint32_t checksumErrors() const { return badChecksums; }
+  uint32_t fixCount() const { return fixes; }
+
+  static constexpr uint8_t kMaxSentence = 96;
+
+private:
+  static constexpr uint8_t kMaxFields = 20;
+  char sentence[kMaxSentence + 1] = {};
+  uint8_t length = 0;
+  bool inSentence = false;
+  GpsFix state = {};
+  GpsFix epochFix = {};
+  bool dateSeen = false;
+  bool timeSeen = false;
+  bool epochPending = false;
+  bool epochGga = false;
+  bool epochRmc = false;
+  int32_t epochTime = -1; // UTC time of the pending epoch in 1/100 s, -1 = sentence had no time
+  int64_t lastSentenceUs = 0;
+  uint32_t sentences = 0;
+  uint32_t badChecksums = 0;
+  uint32_t fixes = 0;
+
+  bool finishSentence(int64_t arrivalUs);
+  void emit(int64_t arrivalUs);
+  void applyTime(const char *field);
+  bool applyLocation(const char *lat, const char *ns, const char *lon, const char *ew);
+  static int32_t parseTime(const char *field);
+};
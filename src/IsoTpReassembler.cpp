@@ -0,0 +1,105 @@
+/**
+ * ISO-TP receive side, see IsoTpReassembler.h.
+ */
+#include "IsoTpReassembler.h"
+#include <string.h>
+
+void IsoTpReassembler::reset()
+{
+  active = false;
+  totalLength = 0;
+  receivedBytes = 0;
+  expectedFrames = 0;
+  receivedFrames = 0;
+}
+
+IsoTpReassembler::Result IsoTpReassembler::single(const uint8_t *data, uint8_t length)
+{
+  reset();
+  memcpy(buffer, data, length);
+  totalLength = receivedBytes = length;
+  expectedFrames = receivedFrames = 1;
+  active = true;
+  return ISOTP_COMPLETE;
+}
+
+IsoTpReassembler::Result IsoTpReassembler::first(uint16_t length, const uint8_t *data, uint8_t payload)
+{
+  reset();
+  if (length > kMaxLength)
+  {
+    length = kMaxLength;
+  }
+  if (payload > length)
+  {
+    payload = length;
+  }
+  memcpy(buffer, data, payload);
+  totalLength = length;
+  receivedBytes = payload;
+  firstPayload = payload;
+  const uint16_t consecutivePayload = firstPayload + 1;
+  expectedFrames = 1 + (length - payload + consecutivePayload - 1) / consecutivePayload;
+  if (expectedFrames > kMaxFrames)
+  {
+    expectedFrames = kMaxFrames;
+  }
+  memset(receivedBits, 0, ((expectedFrames + 31) / 32) * sizeof(receivedBits[0]));
+  markReceived(0);
+  receivedFrames = 1;
+  nextFrame = 1;
+  active = true;
+  return complete() ? ISOTP_COMPLETE : ISOTP_PENDING;
+}
+
+IsoTpReassembler::Result IsoTpReassembler::consecutive(uint8_t sequence, const uint8_t *data, uint8_t length)
+{
+  if (!active || expectedFrames <= 1)
+  {
+    return ISOTP_IDLE;
+  }
+
+  // Absolute frame number with (frame & 0x0F) == sequence closest to nextFrame
+  const int16_t delta = int16_t(((sequence - nextFrame) & 0x0F) ^ 0x08) - 0x08; // -8 .. 7
+  const int32_t frame = int32_t(nextFrame) + delta;
+  if (frame < 1 || frame >= expectedFrames)
+  {
+    return ISOTP_OUT_OF_WINDOW;
+  }
+  if (!markReceived(frame))
+  {
+    duplicateCount++;
+    return ISOTP_DUPLICATE;
+  }
+  if (delta > 0)
+  {
+    gapCount++;
+  }
+
+  const uint16_t consecutivePayload = firstPayload + 1;
+  const uint16_t offset = firstPayload + (frame - 1) * consecutivePayload;
+  uint16_t copy = (length < consecutivePayload) ? length : consecutivePayload;
+  if (offset + copy > totalLength)
+  {
+    copy = totalLength - offset; // padding of the last frame
+  }
+  memcpy(buffer + offset, data, copy);
+  receivedBytes += copy;
+  receivedFrames++;
+  if (frame >= nextFrame)
+  {
+    nextFrame = frame + 1;
+  }
+  return complete() ? ISOTP_COMPLETE : ISOTP_PENDING;
+}
+
+bool IsoTpReassembler::markReceived(uint16_t frame)
+{
+  const uint32_t bit = 1UL << (frame & 31);
+  if (receivedBits[frame >> 5] & bit)
+  {
+    return false;
+  }
+  receivedBits[frame >> 5] |= bit;
+  return true;
+}
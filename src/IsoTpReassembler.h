@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * ISO 15765-2 (ISO-TP) receive side without heap use.
+ *
+ * The first frame announces the length (max 4095), every consecutive frame
+ * is copied straight to its offset in a fixed buffer:
+ *   offset = firstPayload + (n - 1) * (firstPayload + 1)
+ * where n is the absolute frame number. The 4 bit sequence number wraps
+ * every 16 frames; n is the candidate closest to the next expected frame,
+ * so reordered frames within +-7 still land in the right slot. A bitmap of
+ * received frames detects duplicates and gaps, the message is complete when
+ * every frame arrived.
+ */
+class IsoTpReassembler
+{
+public:
+  static constexpr uint16_t kMaxLength = 4095;
+  static constexpr uint16_t kMaxFrames = 1 + (kMaxLength + 5) / 6; // worst case 6 byte consecutive payload
+
+  enum Result : uint8_t
+  {
+    ISOTP_PENDING = 0,
+    ISOTP_COMPLETE,
+    ISOTP_DUPLICATE,     // frame already received, ignored
+    ISOTP_OUT_OF_WINDOW, // sequence number too far from the expected frame, ignored
+    ISOTP_IDLE,          // consecutive frame without first frame
+  };
+
+  void reset();
+  Result single(const uint8_t *data, uint8_t length);
+  Result first(uint16_t totalLength, const uint8_t *data, uint8_t length);
+  Result consecutive(uint8_t sequence, const uint8_t *data, uint8_t length);
+
+  bool complete() const { return active && receivedFrames == expectedFrames; }
+  uint16_t remaining() const { return active ? (totalLength - receivedBytes) : 0; }
+  uint16_t missingFrames() const { return active ? (expectedFrames - receivedFrames) : 0; }
+  const uint8_t *data() const { return buffer; }
+  uint16_t length() const { return totalLength; }
+
+  // Counters since boot
+  uint32_t gaps() const { return gapCount; } // frames that skipped ahead of the expected one
+  uint32_t duplicates() const { return duplicateCount; }
+
+private:
+  uint8_t buffer[kMaxLength + 1];
+  uint32_t receivedBits[(kMaxFrames + 31) / 32];
+  bool active = false;
+  uint16_t totalLength = 0;
+  uint16_t receivedBytes = 0;
+  uint8_t firstPayload = 0;
+  uint16_t expectedFrames = 0; // including the first frame
+  uint16_t receivedFrames = 0;
+  uint16_t nextFrame = 0; // absolute number of the next expected consecutive frame
+  uint32_t gapCount = 0;
+  uint32_t duplicateCount = 0;
+
+  bool markReceived(uint16_t frame);
+};
@@ -5,6 +5,7 @@
  */
 #include "LiveData.h"
 #include "menu.h"
+#include "MemStats.h"
 #include <esp_heap_caps.h>
 #include <string.h>
 #include <stdlib.h>
@@ -73,17 +74,18 @@ void LiveData::initParams()
   params.stopCommandQueueTime = 0;
   params.gpsWakeCount = 0;
   params.gyroWakeCount = 0;
-  params.motionWakeLastTime = 0;
   params.motionWakeLocked = false;
   params.sentrySessionActive = false;
   params.parkedModeStartTime = 0;
   params.clearDrivingStatsOnNextDrive = false;
   // Car data
+  memset(&hot, 0, sizeof(hot));
   memset(params.carVin, 0, sizeof(params.carVin));
   params.carMode = CAR_MODE_NONE;
   params.sleepModeQueue = false;
   params.getValidResponse = false;
   params.wakeUpTime = 0;
+  params.sleepSnapshotWake = false;
   params.ignitionOn = false;
   params.lastIgnitionOnTime = 0;
   params.operationTimeSec = 0;
@@ -183,15 +185,8 @@ void LiveData::initParams()
     params.cellVoltage[i] = -1;
   }
   params.cellCount = 0;
-  for (int i = 0; i < 100; i++)
-  {
-    params.chargingGraphMinKw[i] = -1;
-    params.chargingGraphMaxKw[i] = -1;
-    params.chargingGraphBatMinTempC[i] = -100;
-    params.chargingGraphBatMaxTempC[i] = -100;
-    params.chargingGraphHeaterTempC[i] = -100;
-    params.chargingGraphWaterCoolantTempC[i] = -100;
-  }
+  cellStats.clear();
+  chargingGraph.clear();
   params.contributeStatus = CONTRIBUTE_NONE;
   clearContributeRawFrames();
 
@@ -218,6 +213,7 @@ void LiveData::initParams()
   }
   if (menuItems != nullptr)
   {
+    memTrackSet(MEM_TAG_MENU, sizeof(menuItemsSource));
     memcpy(menuItems, menuItemsSource, sizeof(menuItemsSource));
   }
   else
@@ -228,42 +224,13 @@ void LiveData::initParams()
 
 void LiveData::clearContributeRawFrames()
 {
-  contributeRawFrameCount = 0;
-  for (uint8_t i = 0; i < kContributeRawFrameMax; i++)
-  {
-    contributeRawFrames[i].key[0] = '\0';
-    contributeRawFrames[i].value[0] = '\0';
-    contributeRawFrames[i].latencyMs = 0;
-  }
+  contributeRawFrames.clear();
 }
 
 void LiveData::addContributeRawFrame(const String &key, const String &value, unsigned long latencyMs)
 {
-  if (key.length() == 0 || value.length() == 0)
-  {
-    return;
-  }
-
-  for (uint8_t i = 0; i < contributeRawFrameCount; i++)
-  {
-    if (strcmp(contributeRawFrames[i].key, key.c_str()) == 0)
-    {
-      value.toCharArray(contributeRawFrames[i].value, sizeof(contributeRawFrames[i].value));
-      contributeRawFrames[i].latencyMs = (latencyMs > 65535UL) ? 65535 : static_cast<uint16_t>(latencyMs);
-      return;
-    }
-  }
-
-  if (contributeRawFrameCount >= kContributeRawFrameMax)
-  {
-    return;
-  }
-
-  ContributeRawFrame &entry = contributeRawFrames[contributeRawFrameCount];
-  key.toCharArray(entry.key, sizeof(entry.key));
-  value.toCharArray(entry.value, sizeof(entry.value));
-  entry.latencyMs = (latencyMs > 65535UL) ? 65535 : static_cast<uint16_t>(latencyMs);
-  contributeRawFrameCount++;
+  contributeRawFrames.put(key.c_str(), key.length(), value.c_str(), value.length(),
+                          (latencyMs > 65535UL) ? 65535 : static_cast<uint16_t>(latencyMs));
 }
 
 /**
@@ -365,16 +332,101 @@ void LiveData::clearDrivingAndChargingStats(int newCarMode)
   params.cumulativeEnergyDischargedKWhStart = params.cumulativeEnergyDischargedKWh;
   params.cumulativeEnergyChargedKWhStart = params.cumulativeEnergyChargedKWh;
   params.odoKmStart = params.odoKm;
+  history.markSession(params.currentTime);
+
+  chargingGraph.clear();
+}
+
+/**
+ * Feed current params into the time-series store (unknown values as NAN)
+ */
+void LiveData::recordHistory()
+{
+  float values[HISTORY_CHANNEL_COUNT];
+  values[HISTORY_BAT_POWER_KW] = (params.batPowerKw == -1000) ? NAN : params.batPowerKw;
+  values[HISTORY_SPEED_KMH] = (params.speedKmh < 0) ? NAN : params.speedKmh;
+  values[HISTORY_SOC_PERC] = (params.socPerc == -1) ? NAN : params.socPerc;
+  values[HISTORY_BAT_VOLTAGE] = (params.batVoltage <= 0) ? NAN : params.batVoltage;
+  values[HISTORY_CELL_MIN_V] = (params.batCellMinV <= 0) ? NAN : params.batCellMinV;
+  values[HISTORY_CELL_MAX_V] = (params.batCellMaxV <= 0) ? NAN : params.batCellMaxV;
+  values[HISTORY_BAT_MIN_C] = (params.batMinC == -100) ? NAN : params.batMinC;
+  values[HISTORY_BAT_MAX_C] = (params.batMaxC == -100) ? NAN : params.batMaxC;
+  values[HISTORY_OUTDOOR_C] = (params.outdoorTemperature == -100) ? NAN : params.outdoorTemperature;
+  history.record(params.currentTime, values);
+}
+
+static int32_t hotFixed(float value, float scale, int32_t limit)
+{
+  const float scaled = value * scale + (value >= 0 ? 0.5f : -0.5f);
+  if (scaled >= limit)
+    return limit;
+  if (scaled <= -limit)
+    return -limit;
+  return int32_t(scaled);
+}
 
-  for (int i = 0; i <= 100; i++)
+/**
+ * Refresh the hot fixed point block from params (once per main loop)
+ */
+void LiveData::updateHot()
+{
+  LIVE_HOT_STRUC next;
+  memset(&next, 0, sizeof(next));
+  next.frame = hot.frame + 1;
+  if (params.speedKmh >= 0)
+  {
+    next.speedKmh10 = hotFixed(params.speedKmh, 10, INT16_MAX);
+    next.valid |= HOT_VALID_SPEED;
+  }
+  if (params.socPerc >= 0)
+  {
+    next.socPerc10 = hotFixed(params.socPerc, 10, INT16_MAX);
+    next.valid |= HOT_VALID_SOC;
+  }
+  if (params.batPowerKw != -1000)
   {
-    params.chargingGraphMinKw[i] = -1;
-    params.chargingGraphMaxKw[i] = -1;
-    params.chargingGraphBatMinTempC[i] = -100;
-    params.chargingGraphBatMaxTempC[i] = -100;
-    params.chargingGraphHeaterTempC[i] = -100;
-    params.chargingGraphWaterCoolantTempC[i] = -100;
+    next.batPowerKw100 = hotFixed(params.batPowerKw, 100, INT32_MAX / 2);
+    next.valid |= HOT_VALID_POWER;
   }
+  if (params.batVoltage > 0)
+  {
+    next.batVoltage10 = hotFixed(params.batVoltage, 10, INT16_MAX);
+    next.valid |= HOT_VALID_VOLTAGE;
+  }
+  if (params.batPowerAmp != -1000)
+  {
+    next.batCurrentA10 = hotFixed(params.batPowerAmp, 10, INT16_MAX);
+    next.valid |= HOT_VALID_CURRENT;
+  }
+  if (params.batCellMinV > 0)
+  {
+    next.cellMinMv = hotFixed(params.batCellMinV, 1000, UINT16_MAX);
+    next.cellMinNo = params.batCellMinVNo;
+    next.valid |= HOT_VALID_CELL_MIN;
+  }
+  if (params.batCellMaxV > 0)
+  {
+    next.cellMaxMv = hotFixed(params.batCellMaxV, 1000, UINT16_MAX);
+    next.cellMaxNo = params.batCellMaxVNo;
+    next.valid |= HOT_VALID_CELL_MAX;
+  }
+  if (params.batMinC != -100)
+  {
+    next.batMinC10 = hotFixed(params.batMinC, 10, INT16_MAX);
+    next.valid |= HOT_VALID_BAT_MIN_C;
+  }
+  if (params.batMaxC != -100)
+  {
+    next.batMaxC10 = hotFixed(params.batMaxC, 10, INT16_MAX);
+    next.valid |= HOT_VALID_BAT_MAX_C;
+  }
+  next.flags = (params.chargingOn ? HOT_FLAG_CHARGING : 0) |
+               (params.chargerACconnected ? HOT_FLAG_AC : 0) |
+               (params.chargerDCconnected ? HOT_FLAG_DC : 0) |
+               (params.forwardDriveMode ? HOT_FLAG_FORWARD : 0) |
+               (params.reverseDriveMode ? HOT_FLAG_REVERSE : 0) |
+               (params.parkModeOrNeutral ? HOT_FLAG_PARK : 0);
+  hot = next;
 }
 
 /**
@@ -389,14 +441,6 @@ void LiveData::prepareForStopCommandQueue()
   if (params.stopCommandQueueTime == 0)
   {
     params.stopCommandQueueTime = params.currentTime;
-    if (!params.sentrySessionActive)
-    {
-      params.sentrySessionActive = true;
-      params.gpsWakeCount = 0;
-      params.gyroWakeCount = 0;
-      params.motionWakeLocked = false;
-      params.motionWakeLastTime = params.currentTime;
-    }
   }
 }
 
@@ -8,6 +8,11 @@
 #include "ble_compat.h"
 #include "config.h"
 #include "LogSerial.h"
+#include "LiveDataHistory.h"
+#include "CellStats.h"
+#include "ChargingGraph.h"
+#include "RawFrameTable.h"
+#include "LiveDataParams.h"
 #include <vector>
 
 // SUPPORTED CARS
@@ -97,198 +102,54 @@
 #define CONTRIBUTE_COLLECTING 2
 #define CONTRIBUTE_READY_TO_SEND 3
 
-// Stored settings schema version. Bump only when SETTINGS_STRUC gets a persisted field.
-#define SETTINGS_VERSION_CURRENT 25
+// Legacy EEPROM blob schema version (import only). New persisted fields need no bump,
+// only a kSettingsFields entry (BoardInterface.cpp) and a default in loadSettings().
+#define SETTINGS_VERSION_CURRENT 26
 
 //
 #define MONTH_SEC 2678400
 
 extern LogSerial *syslog;
 
-// Structure with realtime values
-typedef struct
-{
-  // System
-  bool booting;
-  time_t currentTime;
-  time_t chargingStartTime;
-  uint32_t queueLoopCounter;
-  bool stopCommandQueue; // sleep mode/screen only & ina3221 voltmeter based
-  time_t lastCanbusResponseTime;
-  bool ntpTimeSet;
-  uint8_t contributeStatus; // 0 - none, 1 - ready to scan (waiting for loop begin), 2 - collecting data, 3 - ready to send
-  // Network
-  time_t lastRemoteApiSent;
-  time_t lastAbrpSent;
-  time_t lastContributeSent;
-  time_t lastSuccessNetSendTime;
-  bool netAvailable;
-  time_t netLastFailureTime;
-  time_t netFailureStartTime;
-  uint16_t netFailureCount;
-  bool isWifiBackupLive;
-  time_t wifiLastConnectedTime;
-  time_t wifiBackupUptime;
-  bool wifiApMode; // hotspot
-  // GPS
-  bool currTimeSyncWithGps;
-  bool gpsValid;
-  float gpsLat;
-  float gpsLon;
-  uint8_t gpsSat; // satellites count
-  int16_t gpsAlt;
-  float gpsHeadingDeg;
-  time_t gpsLastFixTime;
-  uint32_t gpsLastFixMs;
-  time_t setGpsTimeFromCar;
-  bool gyroSensorMotion;
-  // SD card
-  bool sdcardInit;
-  bool sdcardRecording;
-  char sdcardFilename[32];
-  char sdcardAbrpFilename[32];
-  uint32_t sdcardLastFlushMs;
-  // Display
-  uint8_t displayScreen;
-  uint8_t displayScreenAutoMode;
-  time_t lastButtonPushedTime;
-  int8_t lcdBrightnessCalc;
-  bool spriteInit;
-  // voltagemeter INA3221
-  time_t lastVoltageReadTime;
-  time_t lastVoltageOkTime;
-  time_t stopCommandQueueTime;
-  uint16_t gpsWakeCount;
-  uint16_t gyroWakeCount;
-  time_t motionWakeLastTime;
-  bool motionWakeLocked;
-  bool sentrySessionActive;
-  time_t parkedModeStartTime;
-  bool clearDrivingStatsOnNextDrive;
-  // Car params
-  char carVin[18];
-  uint8_t carMode;
-  time_t carModeChanged;
-  bool sleepModeQueue;
-  bool getValidResponse;
-  time_t wakeUpTime;
-  bool ignitionOn;
-  bool chargingOn;
-  bool chargerACconnected;
-  bool chargerDCconnected;
-  time_t lastIgnitionOnTime;
-  time_t lastChargingOnTime;
-  uint64_t operationTimeSec;
-  bool sdcardCanNotify;
-  time_t timeInForwardDriveMode;
-  bool forwardDriveMode;
-  bool reverseDriveMode;
-  bool parkModeOrNeutral;
-  bool headLights;
-  bool autoLights;
-  bool dayLights;
-  bool brakeLights;
-  bool trunkDoorOpen;
-  bool leftFrontDoorOpen;
-  bool rightFrontDoorOpen;
-  bool leftRearDoorOpen;
-  bool rightRearDoorOpen;
-  bool hoodDoorOpen;
-  float batteryTotalAvailableKWh;
-  float speedKmh;
-  float speedKmhGPS;
-  float avgSpeedKmh;
-  float motor1Rpm;
-  float motor2Rpm;
-  float odoKm;
-  float odoKmStart;
-  float socPercBms;
-  float socPerc;
-  float socPercPrevious;
-  float sohPerc;
-  float cumulativeEnergyChargedKWh;
-  float cumulativeEnergyChargedKWhStart;
-  float cumulativeEnergyDischargedKWh;
-  float cumulativeEnergyDischargedKWhStart;
-  float cumulativeChargeCurrentAh;    // CCC
-  float cumulativeDischargeCurrentAh; // CDC
-  float availableChargePower;         // max regen
-  float availableDischargePower;      // max power
-  float isolationResistanceKOhm;
-  float batEnergyContent;
-  float batMaxEnergyContent;
-  float batPowerAmp;
-  float batPowerKw;
-  float batPowerKwh100;
-  float batVoltage;
-  float batCellMinV;
-  float batCellMaxV;
-  uint8_t batCellMinVNo;
-  uint8_t batCellMaxVNo;
-  float batTempC;
-  float batHeaterC;
-  float batInletC;
-  float batFanStatus;
-  float batFanFeedbackHz;
-  float batMinC;
-  float batMaxC;
-  uint16_t batModuleTempCount;
-  float batModuleTempC[25];
-  float coolingWaterTempC;
-  float coolantTemp1C;
-  float coolantTemp2C;
-  float bmsUnknownTempA;
-  float bmsUnknownTempB;
-  float bmsUnknownTempC;
-  float bmsUnknownTempD;
-  float auxPerc;
-  float auxCurrentAmp;
-  float auxVoltage;
-  float auxTemperature;
-  int8_t batteryManagementMode;
-
-  // MCU
-  float inverterTempC;
-  float motorTempC;
-
-  // HVAC
-  float indoorTemperature;
-  float outdoorTemperature;
-  float evaporatorTempC;
-  float tireFrontLeftTempC;
-  float tireFrontLeftPressureBar;
-  float tireFrontRightTempC;
-  float tireFrontRightPressureBar;
-  float tireRearLeftTempC;
-  float tireRearLeftPressureBar;
-  float tireRearRightTempC;
-  float tireRearRightPressureBar;
-  uint16_t cellCount;
-  float cellVoltage[200]; // 1..192 has index 0..191
-
-  // Screen - charging graph
-  float chargingGraphMinKw[101];             // 0..100% .. Min power Kw
-  float chargingGraphMaxKw[101];             // 0..100% .. Max power Kw
-  float chargingGraphBatMinTempC[101];       // 0..100% .. Min bat.temp in.C
-  float chargingGraphBatMaxTempC[101];       // 0..100% .. Max bat.temp in.C
-  float chargingGraphHeaterTempC[101];       // 0..100% .. Heater temp in.C
-  float chargingGraphWaterCoolantTempC[101]; // 0..100% .. Heater temp in.C
+// Validity bits of LIVE_HOT_STRUC (replace the -1/-100/-1000 sentinels of params)
+#define HOT_VALID_SPEED (1 << 0)
+#define HOT_VALID_SOC (1 << 1)
+#define HOT_VALID_POWER (1 << 2)
+#define HOT_VALID_VOLTAGE (1 << 3)
+#define HOT_VALID_CURRENT (1 << 4)
+#define HOT_VALID_CELL_MIN (1 << 5)
+#define HOT_VALID_CELL_MAX (1 << 6)
+#define HOT_VALID_BAT_MIN_C (1 << 7)
+#define HOT_VALID_BAT_MAX_C (1 << 8)
 
-  // Screen - consumption info
-  float soc10ced[11];   // 0..10 (5%, 10%, 20%, 30%, 40%).. (never discharged soc% to 0)
-  float soc10cec[11];   // 0..10 (5%, 10%, 20%, 30%, 40%)..
-  float soc10odo[11];   // odo history
-  time_t soc10time[11]; // time for avg speed
+// Hot flags
+#define HOT_FLAG_CHARGING (1 << 0)
+#define HOT_FLAG_AC (1 << 1)
+#define HOT_FLAG_DC (1 << 2)
+#define HOT_FLAG_FORWARD (1 << 3)
+#define HOT_FLAG_REVERSE (1 << 4)
+#define HOT_FLAG_PARK (1 << 5)
 
-  // additional
-  /*
-    uint8_t bmsMainRelay;
-    uint8_t highVoltageCharging;
-    float inverterCapacitorVoltage;
-    float normalChargePort;
-    float rapidChargePort;
-    ;*/
-} PARAMS_STRUC;
+// Per-frame copy of the most read params in fixed point, one 32 byte cache line.
+// Written by LiveData::updateHot() once per main loop, readers copy it whole.
+typedef struct alignas(32)
+{
+  uint32_t frame;         // updateHot() counter
+  int32_t batPowerKw100;  // 0.01 kW
+  int16_t speedKmh10;     // 0.1 km/h
+  int16_t socPerc10;      // 0.1 %
+  int16_t batVoltage10;   // 0.1 V
+  int16_t batCurrentA10;  // 0.1 A
+  uint16_t cellMinMv;
+  uint16_t cellMaxMv;
+  int16_t batMinC10; // 0.1 °C
+  int16_t batMaxC10;
+  uint8_t cellMinNo;
+  uint8_t cellMaxNo;
+  uint16_t flags; // HOT_FLAG_*
+  uint16_t valid; // HOT_VALID_*
+} LIVE_HOT_STRUC;
+static_assert(sizeof(LIVE_HOT_STRUC) == 32, "hot block must stay one cache line");
 
 // Setting stored to flash
 typedef struct
@@ -422,6 +283,8 @@ typedef struct
   uint8_t relayForMobileEnabled; // 0 - off, 1 - BLE relay for iOS/Android app
   char relayToken[32];           // Shared token for paired mobile app
   char relayMobileId[40];        // Last paired mobile app id
+  // == settings version 26
+  uint8_t gpsBinaryNav; // 0 - NMEA, 1 - binary UBX NAV-PVT / CASIC NAV-PV (5-10 Hz)
   //
 } SETTINGS_STRUC;
 
@@ -456,15 +319,7 @@ public:
   String packetFilteredData = "";
   unsigned long lastCommandLatencyMs = 0;
   String contributeDataJson = "";
-  static constexpr uint8_t kContributeRawFrameMax = 96;
-  struct ContributeRawFrame
-  {
-    char key[24];
-    char value[192];
-    uint16_t latencyMs;
-  };
-  ContributeRawFrame contributeRawFrames[kContributeRawFrameMax];
-  uint8_t contributeRawFrameCount = 0;
+  RawFrameTable contributeRawFrames; // raw responses by "<ECU>_<DID>" (contribute, relay)
   // Menu
   bool menuVisible = false;
   uint8_t menuItemsCount;
@@ -501,7 +356,15 @@ public:
   // Params
   PARAMS_STRUC params; // Realtime sensor values
   // Settings
-  SETTINGS_STRUC settings, tmpSettings; // Settings stored into flash
+  SETTINGS_STRUC settings; // Settings stored into flash
+  // Time-series of selected params (PSRAM)
+  LiveDataHistory history;
+  // Cell statistics, decoders call cellStats.updateBlock() after writing params.cellVoltage[]
+  CellStats cellStats;
+  // Charging graph (cold, packed), decoders call chargingGraph.record() while charging
+  ChargingGraph chargingGraph;
+  // Hot fixed point snapshot of params
+  LIVE_HOT_STRUC hot;
 
   //
   void initParams();
@@ -517,4 +380,6 @@ public:
   void continueWithCommandQueue();
   void clearContributeRawFrames();
   void addContributeRawFrame(const String &key, const String &value, unsigned long latencyMs);
+  void recordHistory();
+  void updateHot();
 };
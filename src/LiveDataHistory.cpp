@@ -0,0 +1,254 @@
+/**
+ * Time-series store for live parameters, see LiveDataHistory.h.
+ */
+#include "LiveDataHistory.h"
+#include <math.h>
+#ifdef EVDASH_HOST_TEST
+#include <stdlib.h>
+#else
+#include "LogSerial.h"
+#include <esp_heap_caps.h>
+#endif // EVDASH_HOST_TEST
+
+// Fixed point scale per channel (kW 0.1, km/h 0.1, % 0.1, V 0.1, cell V 0.001, C 0.1)
+static const float kHistoryScale[HISTORY_CHANNEL_COUNT] = {10, 10, 10, 10, 1000, 1000, 10, 10, 10};
+
+// Host tests keep the rings on the heap
+#ifdef EVDASH_HOST_TEST
+#define psramFound() true
+#define heap_caps_malloc(bytes, caps) malloc(bytes)
+#define heap_caps_free(ptr) free(ptr)
+#define historyLog(msg)
+#else
+#define historyLog(msg) syslog->println(msg)
+#endif // EVDASH_HOST_TEST
+
+/**
+ * Allocate tier rings (PSRAM only, history is optional)
+ */
+bool LiveDataHistory::begin()
+{
+  if (ready)
+  {
+    return true;
+  }
+  if (!psramFound())
+  {
+    historyLog("History: no PSRAM, disabled");
+    return false;
+  }
+
+  bytesAllocated = 0;
+  for (uint8_t t = 0; t < HISTORY_TIER_COUNT; t++)
+  {
+    const size_t bytes = size_t(tiers[t].capacity) * HISTORY_CHANNEL_COUNT * sizeof(Bucket);
+    tiers[t].buckets = static_cast<Bucket *>(heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (tiers[t].buckets == nullptr)
+    {
+      historyLog("History: allocation failed, disabled");
+      for (uint8_t i = 0; i < t; i++)
+      {
+        heap_caps_free(tiers[i].buckets);
+        tiers[i].buckets = nullptr;
+      }
+      bytesAllocated = 0;
+      return false;
+    }
+    bytesAllocated += bytes;
+    tiers[t].head = 0;
+    tiers[t].count = 0;
+    resetAccumulator(tiers[t], 0);
+  }
+
+  ready = true;
+  historyLog("History: " + String(bytesAllocated / 1024) + " kB PSRAM");
+  return true;
+}
+
+int16_t LiveDataHistory::encode(uint8_t channel, float value)
+{
+  if (isnan(value))
+  {
+    return kInvalid;
+  }
+  const float scaled = roundf(value * kHistoryScale[channel]);
+  if (scaled > 32767.0f)
+    return 32767;
+  if (scaled < -32767.0f)
+    return -32767;
+  return int16_t(scaled);
+}
+
+float LiveDataHistory::decode(uint8_t channel, int16_t value)
+{
+  return value / kHistoryScale[channel];
+}
+
+void LiveDataHistory::resetAccumulator(Tier &tier, time_t start)
+{
+  tier.accStart = start;
+  for (uint8_t ch = 0; ch < HISTORY_CHANNEL_COUNT; ch++)
+  {
+    tier.accSum[ch] = 0;
+    tier.accCount[ch] = 0;
+    tier.accMin[ch] = INT16_MAX;
+    tier.accMax[ch] = -INT16_MAX;
+  }
+}
+
+/**
+ * Move bucket in progress into the ring. Skipped periods become invalid buckets.
+ */
+void LiveDataHistory::commitAccumulator(Tier &tier)
+{
+  uint32_t steps = 1;
+  if (tier.count > 0)
+  {
+    steps = (tier.accStart > tier.newest) ? uint32_t((tier.accStart - tier.newest) / tier.periodSec) : 0;
+  }
+  if (steps == 0 || steps >= tier.capacity)
+  {
+    // Clock jumped or gap longer than the whole ring
+    tier.count = 0;
+    steps = 1;
+  }
+
+  for (uint32_t s = 1; s < steps; s++)
+  {
+    tier.head = (tier.head + 1) % tier.capacity;
+    Bucket *row = tier.buckets + size_t(tier.head) * HISTORY_CHANNEL_COUNT;
+    for (uint8_t ch = 0; ch < HISTORY_CHANNEL_COUNT; ch++)
+    {
+      row[ch].min = row[ch].max = row[ch].avg = kInvalid;
+    }
+  }
+
+  tier.head = (tier.head + 1) % tier.capacity;
+  Bucket *row = tier.buckets + size_t(tier.head) * HISTORY_CHANNEL_COUNT;
+  for (uint8_t ch = 0; ch < HISTORY_CHANNEL_COUNT; ch++)
+  {
+    if (tier.accCount[ch] == 0)
+    {
+      row[ch].min = row[ch].max = row[ch].avg = kInvalid;
+      continue;
+    }
+    row[ch].min = tier.accMin[ch];
+    row[ch].max = tier.accMax[ch];
+    row[ch].avg = int16_t(tier.accSum[ch] / int32_t(tier.accCount[ch]));
+  }
+
+  tier.count = (tier.count + steps > tier.capacity) ? tier.capacity : (tier.count + steps);
+  tier.newest = tier.accStart;
+}
+
+/**
+ * Add one sample (NAN = value not available). At most one sample per second is kept.
+ */
+void LiveDataHistory::record(time_t now, const float values[HISTORY_CHANNEL_COUNT])
+{
+  if (!ready || now <= 0 || now == lastSampleTime)
+  {
+    return;
+  }
+  if (now < lastSampleTime)
+  {
+    // Time set backwards (GPS/NTP sync), old buckets can no longer be addressed
+    for (uint8_t t = 0; t < HISTORY_TIER_COUNT; t++)
+    {
+      tiers[t].count = 0;
+      resetAccumulator(tiers[t], 0);
+    }
+  }
+  lastSampleTime = now;
+
+  int16_t encoded[HISTORY_CHANNEL_COUNT];
+  for (uint8_t ch = 0; ch < HISTORY_CHANNEL_COUNT; ch++)
+  {
+    encoded[ch] = encode(ch, values[ch]);
+  }
+
+  for (uint8_t t = 0; t < HISTORY_TIER_COUNT; t++)
+  {
+    Tier &tier = tiers[t];
+    const time_t bucketStart = now - (now % tier.periodSec);
+    if (bucketStart != tier.accStart)
+    {
+      if (tier.accStart != 0)
+      {
+        commitAccumulator(tier);
+      }
+      resetAccumulator(tier, bucketStart);
+    }
+    for (uint8_t ch = 0; ch < HISTORY_CHANNEL_COUNT; ch++)
+    {
+      if (encoded[ch] == kInvalid)
+        continue;
+      tier.accSum[ch] += encoded[ch];
+      tier.accCount[ch]++;
+      if (encoded[ch] < tier.accMin[ch])
+        tier.accMin[ch] = encoded[ch];
+      if (encoded[ch] > tier.accMax[ch])
+        tier.accMax[ch] = encoded[ch];
+    }
+  }
+}
+
+/**
+ * Start time of the newest (possibly still open) bucket, 0 if empty
+ */
+time_t LiveDataHistory::newestTime(uint8_t tier) const
+{
+  if (!ready || tier >= HISTORY_TIER_COUNT)
+  {
+    return 0;
+  }
+  return (tiers[tier].accStart != 0) ? tiers[tier].accStart : (tiers[tier].count > 0 ? tiers[tier].newest : 0);
+}
+
+void LiveDataHistory::fillPoint(uint8_t channel, const Bucket &bucket, time_t time, HistoryPoint &point) const
+{
+  point.time = time;
+  point.avg = decode(channel, bucket.avg);
+  point.min = decode(channel, bucket.min);
+  point.max = decode(channel, bucket.max);
+}
+
+/**
+ * Copy valid buckets with start time in [from, to], oldest first.
+ * The bucket in progress is included as the last point. Returns point count.
+ */
+size_t LiveDataHistory::query(uint8_t channel, uint8_t tierIndex, time_t from, time_t to, HistoryPoint *out, size_t maxPoints) const
+{
+  if (!ready || channel >= HISTORY_CHANNEL_COUNT || tierIndex >= HISTORY_TIER_COUNT || out == nullptr || from > to)
+  {
+    return 0;
+  }
+
+  const Tier &tier = tiers[tierIndex];
+  size_t n = 0;
+  if (tier.count > 0 && to >= tier.newest - time_t(tier.count - 1) * tier.periodSec)
+  {
+    const time_t oldest = tier.newest - time_t(tier.count - 1) * tier.periodSec;
+    const uint32_t first = (from > oldest) ? uint32_t((from - oldest + tier.periodSec - 1) / tier.periodSec) : 0;
+    const uint32_t last = (to >= tier.newest) ? uint32_t(tier.count - 1) : uint32_t((to - oldest) / tier.periodSec);
+    for (uint32_t k = first; k <= last && n < maxPoints; k++)
+    {
+      const uint16_t index = (tier.head + tier.capacity - (tier.count - 1 - k)) % tier.capacity;
+      const Bucket &bucket = tier.buckets[size_t(index) * HISTORY_CHANNEL_COUNT + channel];
+      if (bucket.avg == kInvalid)
+        continue;
+      fillPoint(channel, bucket, oldest + time_t(k) * tier.periodSec, out[n++]);
+    }
+  }
+
+  if (n < maxPoints && tier.accStart != 0 && tier.accStart >= from && tier.accStart <= to && tier.accCount[channel] > 0)
+  {
+    Bucket partial;
+    partial.min = tier.accMin[channel];
+    partial.max = tier.accMax[channel];
+    partial.avg = int16_t(tier.accSum[channel] / int32_t(tier.accCount[channel]));
+    fillPoint(channel, partial, tier.accStart, out[n++]);
+  }
+
+  return n;
+}
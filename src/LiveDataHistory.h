@@ -0,0 +1,105 @@
+#pragma once
+
+#ifndef EVDASH_HOST_TEST
+#include <Arduino.h>
+#endif // EVDASH_HOST_TEST
+#include <stdint.h>
+#include <time.h>
+
+// History channels
+enum HistoryChannel : uint8_t
+{
+  HISTORY_BAT_POWER_KW = 0,
+  HISTORY_SPEED_KMH,
+  HISTORY_SOC_PERC,
+  HISTORY_BAT_VOLTAGE,
+  HISTORY_CELL_MIN_V,
+  HISTORY_CELL_MAX_V,
+  HISTORY_BAT_MIN_C,
+  HISTORY_BAT_MAX_C,
+  HISTORY_OUTDOOR_C,
+  HISTORY_CHANNEL_COUNT
+};
+
+// Resolution tiers (all fed from the same 1 s samples)
+enum HistoryTier : uint8_t
+{
+  HISTORY_TIER_1S = 0,
+  HISTORY_TIER_10S,
+  HISTORY_TIER_1MIN,
+  HISTORY_TIER_COUNT
+};
+
+struct HistoryPoint
+{
+  time_t time; // bucket start
+  float avg;
+  float min;
+  float max;
+};
+
+/**
+ * Time-series store for live parameters.
+ *
+ * Every tier is a ring of fixed-period buckets (min/max/avg as int16 fixed point)
+ * allocated in PSRAM:
+ *   1 s   x 900  = last 15 minutes
+ *   10 s  x 2160 = last 6 hours (trip / charge session)
+ *   1 min x 1440 = last 24 hours
+ * Buckets are addressed by time, so a query only touches the requested window.
+ * Missing samples (NAN) and time gaps are stored as invalid buckets.
+ */
+class LiveDataHistory
+{
+public:
+  bool begin();
+  bool isReady() const { return ready; }
+  void record(time_t now, const float values[HISTORY_CHANNEL_COUNT]);
+  void markSession(time_t now) { sessionStartTime = now; }
+  time_t sessionStart() const { return sessionStartTime; }
+  time_t newestTime(uint8_t tier) const;
+  uint16_t tierPeriodSec(uint8_t tier) const { return tier < HISTORY_TIER_COUNT ? tiers[tier].periodSec : 0; }
+  uint16_t tierCapacity(uint8_t tier) const { return tier < HISTORY_TIER_COUNT ? tiers[tier].capacity : 0; }
+  size_t query(uint8_t channel, uint8_t tier, time_t from, time_t to, HistoryPoint *out, size_t maxPoints) const;
+  size_t allocatedBytes() const { return bytesAllocated; }
+
+private:
+  static constexpr int16_t kInvalid = INT16_MIN;
+  struct Bucket
+  {
+    int16_t min;
+    int16_t max;
+    int16_t avg;
+  };
+  struct Tier
+  {
+    uint16_t periodSec;
+    uint16_t capacity;
+    Bucket *buckets; // capacity x HISTORY_CHANNEL_COUNT
+    uint16_t head;   // index of newest committed bucket
+    uint16_t count;
+    time_t newest; // start time of newest committed bucket
+    // Bucket in progress
+    time_t accStart;
+    int32_t accSum[HISTORY_CHANNEL_COUNT];
+    uint16_t accCount[HISTORY_CHANNEL_COUNT];
+    int16_t accMin[HISTORY_CHANNEL_COUNT];
+    int16_t accMax[HISTORY_CHANNEL_COUNT];
+  };
+
+  Tier tiers[HISTORY_TIER_COUNT] = {
+      {1, 900, nullptr, 0, 0, 0, 0, {}, {}, {}, {}},
+      {10, 2160, nullptr, 0, 0, 0, 0, {}, {}, {}, {}},
+      {60, 1440, nullptr, 0, 0, 0, 0, {}, {}, {}, {}},
+  };
+  bool ready = false;
+  size_t bytesAllocated = 0;
+  time_t lastSampleTime = 0;
+  time_t sessionStartTime = 0;
+
+  static int16_t encode(uint8_t channel, float value);
+  static float decode(uint8_t channel, int16_t value);
+  void resetAccumulator(Tier &tier, time_t start);
+  void commitAccumulator(Tier &tier);
+  void fillPoint(uint8_t channel, const Bucket &bucket, time_t time, HistoryPoint &point) const;
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+// Structure with realtime values (plain types only, no Arduino headers)
+typedef struct
+{
+  // System
+  bool booting;
+  time_t currentTime;
+  time_t chargingStartTime;
+  uint32_t queueLoopCounter;
+  bool stopCommandQueue; // sleep mode/screen only & ina3221 voltmeter based
+  time_t lastCanbusResponseTime;
+  bool ntpTimeSet;
+  uint8_t contributeStatus; // 0 - none, 1 - ready to scan (waiting for loop begin), 2 - collecting data, 3 - ready to send
+  // Network
+  time_t lastRemoteApiSent;
+  time_t lastAbrpSent;
+  time_t lastContributeSent;
+  time_t lastSuccessNetSendTime;
+  bool netAvailable;
+  time_t netLastFailureTime;
+  time_t netFailureStartTime;
+  uint16_t netFailureCount;
+  bool isWifiBackupLive;
+  time_t wifiLastConnectedTime;
+  time_t wifiBackupUptime;
+  bool wifiApMode; // hotspot
+  // GPS
+  bool currTimeSyncWithGps;
+  bool gpsValid;
+  float gpsLat;
+  float gpsLon;
+  uint8_t gpsSat; // satellites count
+  int16_t gpsAlt;
+  float gpsHeadingDeg;
+  time_t gpsLastFixTime;
+  uint32_t gpsLastFixMs;
+  time_t setGpsTimeFromCar;
+  bool gyroSensorMotion;
+  // SD card
+  bool sdcardInit;
+  bool sdcardRecording;
+  char sdcardFilename[32];
+  char sdcardAbrpFilename[32];
+  uint32_t sdcardLastFlushMs;
+  // Display
+  uint8_t displayScreen;
+  uint8_t displayScreenAutoMode;
+  time_t lastButtonPushedTime;
+  int8_t lcdBrightnessCalc;
+  bool spriteInit;
+  // voltagemeter INA3221
+  time_t lastVoltageReadTime;
+  time_t lastVoltageOkTime;
+  time_t stopCommandQueueTime;
+  uint16_t gpsWakeCount;
+  uint16_t gyroWakeCount;
+  bool motionWakeLocked;
+  bool sentrySessionActive;
+  time_t parkedModeStartTime;
+  bool clearDrivingStatsOnNextDrive;
+  // Car params
+  char carVin[18];
+  uint8_t carMode;
+  time_t carModeChanged;
+  bool sleepModeQueue;
+  bool getValidResponse;
+  time_t wakeUpTime;
+  bool sleepSnapshotWake; // booted from deep sleep wake, snapshot restored
+  bool ignitionOn;
+  bool chargingOn;
+  bool chargerACconnected;
+  bool chargerDCconnected;
+  time_t lastIgnitionOnTime;
+  time_t lastChargingOnTime;
+  uint64_t operationTimeSec;
+  bool sdcardCanNotify;
+  time_t timeInForwardDriveMode;
+  bool forwardDriveMode;
+  bool reverseDriveMode;
+  bool parkModeOrNeutral;
+  bool headLights;
+  bool autoLights;
+  bool dayLights;
+  bool brakeLights;
+  bool trunkDoorOpen;
+  bool leftFrontDoorOpen;
+  bool rightFrontDoorOpen;
+  bool leftRearDoorOpen;
+  bool rightRearDoorOpen;
+  bool hoodDoorOpen;
+  float batteryTotalAvailableKWh;
+  float speedKmh;
+  float speedKmhGPS;
+  float avgSpeedKmh;
+  float motor1Rpm;
+  float motor2Rpm;
+  float odoKm;
+  float odoKmStart;
+  float socPercBms;
+  float socPerc;
+  float socPercPrevious;
+  float sohPerc;
+  float cumulativeEnergyChargedKWh;
+  float cumulativeEnergyChargedKWhStart;
+  float cumulativeEnergyDischargedKWh;
+  float cumulativeEnergyDischargedKWhStart;
+  float cumulativeChargeCurrentAh;    // CCC
+  float cumulativeDischargeCurrentAh; // CDC
+  float availableChargePower;         // max regen
+  float availableDischargePower;      // max power
+  float isolationResistanceKOhm;
+  float batEnergyContent;
+  float batMaxEnergyContent;
+  float batPowerAmp;
+  float batPowerKw;
+  float batPowerKwh100;
+  float batVoltage;
+  float batCellMinV;
+  float batCellMaxV;
+  uint8_t batCellMinVNo;
+  uint8_t batCellMaxVNo;
+  float batTempC;
+  float batHeaterC;
+  float batInletC;
+  float batFanStatus;
+  float batFanFeedbackHz;
+  float batMinC;
+  float batMaxC;
+  uint16_t batModuleTempCount;
+  float batModuleTempC[25];
+  float coolingWaterTempC;
+  float coolantTemp1C;
+  float coolantTemp2C;
+  float bmsUnknownTempA;
+  float bmsUnknownTempB;
+  float bmsUnknownTempC;
+  float bmsUnknownTempD;
+  float auxPerc;
+  float auxCurrentAmp;
+  float auxVoltage;
+  float auxTemperature;
+  int8_t batteryManagementMode;
+
+  // MCU
+  float inverterTempC;
+  float motorTempC;
+
+  // HVAC
+  float indoorTemperature;
+  float outdoorTemperature;
+  float evaporatorTempC;
+  float tireFrontLeftTempC;
+  float tireFrontLeftPressureBar;
+  float tireFrontRightTempC;
+  float tireFrontRightPressureBar;
+  float tireRearLeftTempC;
+  float tireRearLeftPressureBar;
+  float tireRearRightTempC;
+  float tireRearRightPressureBar;
+  uint16_t cellCount;
+  float cellVoltage[200]; // 1..192 has index 0..191
+
+  // Screen - consumption info
+  float soc10ced[11];   // 0..10 (5%, 10%, 20%, 30%, 40%).. (never discharged soc% to 0)
+  float soc10cec[11];   // 0..10 (5%, 10%, 20%, 30%, 40%)..
+  float soc10odo[11];   // odo history
+  time_t soc10time[11]; // time for avg speed
+
+  // additional
+  /*
+    uint8_t bmsMainRelay;
+    uint8_t highVoltageCharging;
+    float inverterCapacitorVoltage;
+    float normalChargePort;
+    float rapidChargePort;
+    ;*/
+} PARAMS_STRUC;
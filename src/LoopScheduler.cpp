@@ -0,0 +1,121 @@
+/**
+ * Cooperative main loop scheduler, see LoopScheduler.h.
+ */
+#include "LoopScheduler.h"
+
+static const uint32_t kHistogramLimitsUs[LoopScheduler::kHistogramBins - 1] = {
+    1000, 2000, 5000, 10000, 20000, 50000, 100000};
+
+/**
+ * Tasks are kept sorted by priority, equal priorities in the order added
+ */
+bool LoopScheduler::addTask(const char *name, LoopTaskFn fn, void *context, uint8_t priority, uint16_t periodMs, uint16_t budgetMs, bool critical, bool noDefer)
+{
+  if (count >= kMaxTasks || fn == nullptr)
+  {
+    return false;
+  }
+  uint8_t pos = count;
+  while (pos > 0 && tasks[pos - 1].priority > priority)
+  {
+    tasks[pos] = tasks[pos - 1];
+    pos--;
+  }
+  tasks[pos] = {};
+  tasks[pos].name = name;
+  tasks[pos].fn = fn;
+  tasks[pos].context = context;
+  tasks[pos].priority = priority;
+  tasks[pos].periodMs = periodMs;
+  tasks[pos].budgetMs = budgetMs;
+  tasks[pos].critical = critical;
+  tasks[pos].noDefer = noDefer;
+  count++;
+  return true;
+}
+
+void LoopScheduler::run(uint32_t nowMs)
+{
+  const int64_t loopStartUs = clock();
+  bool otherTaskRan = false;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    Task &task = tasks[i];
+    if (!due(task, nowMs))
+    {
+      continue;
+    }
+    if (task.critical)
+    {
+      runTask(task, nowMs);
+      continue;
+    }
+    if (!task.noDefer && !task.deferredLast && uint32_t(clock() - loopStartUs) > kLoopBudgetUs)
+    {
+      task.deferred++; // stays due; runs next loop even if that one is over budget too
+      task.deferredLast = true;
+      continue;
+    }
+    task.deferredLast = false;
+    if (otherTaskRan)
+    {
+      runCritical(nowMs);
+    }
+    runTask(task, nowMs);
+    otherTaskRan = true;
+  }
+
+  loopUs = uint32_t(clock() - loopStartUs);
+  if (loopUs > loopMax)
+    loopMax = loopUs;
+  if (loopUs > kLoopBudgetUs)
+    loopOver++;
+  loopBins[histogramBin(loopUs)]++;
+}
+
+uint8_t LoopScheduler::histogramBin(uint32_t us)
+{
+  uint8_t bin = 0;
+  while (bin < kHistogramBins - 1 && us >= kHistogramLimitsUs[bin])
+  {
+    bin++;
+  }
+  return bin;
+}
+
+bool LoopScheduler::due(const Task &task, uint32_t nowMs) const
+{
+  return task.periodMs == 0 || !task.ran || (nowMs - task.lastRunMs) >= task.periodMs;
+}
+
+void LoopScheduler::runTask(Task &task, uint32_t nowMs)
+{
+  const int64_t startUs = clock();
+  task.fn(task.context);
+  const uint32_t us = uint32_t(clock() - startUs);
+
+  task.ran = true;
+  task.lastRunMs = nowMs;
+  task.runs++;
+  task.lastUs = us;
+  if (us > task.maxUs)
+    task.maxUs = us;
+  if (task.budgetMs != 0 && us > uint32_t(task.budgetMs) * 1000U)
+    task.overruns++;
+  task.histogram[histogramBin(us)]++;
+}
+
+/**
+ * Critical tasks again before the next non-critical one (period 0 only, the
+ * others are not due again within the same loop anyway)
+ */
+void LoopScheduler::runCritical(uint32_t nowMs)
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (tasks[i].critical && tasks[i].periodMs == 0)
+    {
+      runTask(tasks[i], nowMs);
+    }
+  }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+
+typedef void (*LoopTaskFn)(void *context);
+
+/**
+ * Cooperative main loop scheduler.
+ *
+ * Board320_240::mainLoop() runs its subsystems as tasks with a period
+ * (0 = every loop), a priority and a time budget. run() calls the due tasks
+ * in priority order. Critical tasks (CAN/BLE servicing) run first and again
+ * between the other tasks, so a slow upload or redraw holds them back by one
+ * task at most. Once a loop has used kLoopBudgetUs, the remaining
+ * non-critical tasks are deferred to the next loop instead of stretching
+ * this one (never twice in a row, so low priorities don't starve). Tasks
+ * added with noDefer (input, power) always run when due.
+ *
+ * Tasks are not preempted; one running longer than its budget is counted as
+ * an overrun. Durations per task and per loop go into log-scale histograms
+ * for the debug screen. The clock is passed in, so it runs on a host too.
+ */
+class LoopScheduler
+{
+public:
+  static constexpr uint8_t kMaxTasks = 10;
+  static constexpr uint8_t kHistogramBins = 8; // <1 <2 <5 <10 <20 <50 <100 >=100 ms
+  static constexpr uint32_t kLoopBudgetUs = 60000;
+
+  struct Task
+  {
+    const char *name;
+    LoopTaskFn fn;
+    void *context;
+    uint16_t periodMs;
+    uint16_t budgetMs;
+    uint8_t priority;  // lower runs first
+    bool critical;     // never deferred, also runs between the other tasks
+    bool noDefer;      // never deferred
+    bool ran;          // at least once
+    bool deferredLast; // deferred in the previous loop, not deferred again
+    uint32_t lastRunMs;
+    uint32_t runs;
+    uint32_t overruns;
+    uint32_t deferred;
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint32_t histogram[kHistogramBins];
+  };
+
+  explicit LoopScheduler(int64_t (*clockUs)()) : clock(clockUs) {}
+
+  bool addTask(const char *name, LoopTaskFn fn, void *context, uint8_t priority, uint16_t periodMs, uint16_t budgetMs, bool critical = false, bool noDefer = false);
+  void run(uint32_t nowMs);
+
+  uint8_t taskCount() const { return count; }
+  const Task &task(uint8_t index) const { return tasks[index]; }
+  const uint32_t *loopHistogram() const { return loopBins; }
+  uint32_t loopLastUs() const { return loopUs; }
+  uint32_t loopMaxUs() const { return loopMax; }
+  uint32_t loopOverruns() const { return loopOver; }
+  static uint8_t histogramBin(uint32_t us);
+
+private:
+  int64_t (*clock)();
+  Task tasks[kMaxTasks] = {};
+  uint8_t count = 0;
+  uint32_t loopBins[kHistogramBins] = {};
+  uint32_t loopUs = 0;
+  uint32_t loopMax = 0;
+  uint32_t loopOver = 0;
+
+  bool due(const Task &task, uint32_t nowMs) const;
+  void runTask(Task &task, uint32_t nowMs);
+  void runCritical(uint32_t nowMs);
+};
@@ -0,0 +1,182 @@
+/**
+ * Per-subsystem memory accounting, see MemStats.h.
+ */
+#include "MemStats.h"
+#include <stdlib.h>
+#include <string.h>
+#ifdef EVDASH_HOST_TEST
+// Host tests: plain heap, single threaded
+#define heap_caps_malloc(bytes, caps) ((void)(caps), malloc(bytes))
+#define heap_caps_realloc(ptr, bytes, caps) ((void)(caps), realloc(ptr, bytes))
+#define heap_caps_free(ptr) free(ptr)
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) (void)(mux)
+#define portEXIT_CRITICAL(mux) (void)(mux)
+#else
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#endif // EVDASH_HOST_TEST
+
+static constexpr size_t kTagHeaderSize = 8; // keeps 8 byte alignment of the returned block
+
+static const char *const kMemTagNames[MEM_TAG_COUNT] = {
+    "LIVEDATA", "HISTORY", "FRAMEBUF", "DMA", "GLYPHS", "MENU", "JSON", "UPLOAD", "TLS"};
+
+static portMUX_TYPE memStatsMux = portMUX_INITIALIZER_UNLOCKED;
+static MemTagStats memTags[MEM_TAG_COUNT] = {};
+static uint32_t memTagAllocsAtTick[MEM_TAG_COUNT] = {};
+static uint32_t memLastTickMs = 0;
+static uint32_t memAllocsTotal = 0;
+static uint32_t memLoopStartAllocs = 0;
+static uint16_t memLoopMax = 0;
+static uint32_t memLoopOverruns = 0;
+
+void memTrackAlloc(MemTag tag, size_t bytes)
+{
+  portENTER_CRITICAL(&memStatsMux);
+  MemTagStats &stats = memTags[tag];
+  stats.currentBytes += bytes;
+  if (stats.currentBytes > stats.peakBytes)
+  {
+    stats.peakBytes = stats.currentBytes;
+  }
+  stats.allocs++;
+  memAllocsTotal++;
+  portEXIT_CRITICAL(&memStatsMux);
+}
+
+void memTrackFree(MemTag tag, size_t bytes)
+{
+  portENTER_CRITICAL(&memStatsMux);
+  MemTagStats &stats = memTags[tag];
+  stats.currentBytes = (stats.currentBytes > bytes) ? stats.currentBytes - bytes : 0;
+  portEXIT_CRITICAL(&memStatsMux);
+}
+
+void memTrackSet(MemTag tag, size_t bytes)
+{
+  portENTER_CRITICAL(&memStatsMux);
+  MemTagStats &stats = memTags[tag];
+  if (bytes > stats.currentBytes)
+  {
+    stats.allocs++;
+    memAllocsTotal++;
+  }
+  stats.currentBytes = bytes;
+  if (stats.currentBytes > stats.peakBytes)
+  {
+    stats.peakBytes = stats.currentBytes;
+  }
+  portEXIT_CRITICAL(&memStatsMux);
+}
+
+void *memTaggedMalloc(MemTag tag, size_t bytes, uint32_t caps)
+{
+  uint8_t *block = static_cast<uint8_t *>(heap_caps_malloc(bytes + kTagHeaderSize, caps));
+  if (block == nullptr)
+  {
+    return nullptr;
+  }
+  const uint32_t size = bytes;
+  memcpy(block, &size, sizeof(size));
+  memTrackAlloc(tag, bytes);
+  return block + kTagHeaderSize;
+}
+
+void *memTaggedRealloc(MemTag tag, void *ptr, size_t bytes, uint32_t caps)
+{
+  if (ptr == nullptr)
+  {
+    return memTaggedMalloc(tag, bytes, caps);
+  }
+  uint8_t *block = static_cast<uint8_t *>(ptr) - kTagHeaderSize;
+  uint32_t oldSize;
+  memcpy(&oldSize, block, sizeof(oldSize));
+  uint8_t *newBlock = static_cast<uint8_t *>(heap_caps_realloc(block, bytes + kTagHeaderSize, caps));
+  if (newBlock == nullptr)
+  {
+    return nullptr; // old block untouched
+  }
+  const uint32_t size = bytes;
+  memcpy(newBlock, &size, sizeof(size));
+  memTrackFree(tag, oldSize);
+  memTrackAlloc(tag, bytes);
+  return newBlock + kTagHeaderSize;
+}
+
+void memTaggedFree(MemTag tag, void *ptr)
+{
+  if (ptr == nullptr)
+  {
+    return;
+  }
+  uint8_t *block = static_cast<uint8_t *>(ptr) - kTagHeaderSize;
+  uint32_t size;
+  memcpy(&size, block, sizeof(size));
+  memTrackFree(tag, size);
+  heap_caps_free(block);
+}
+
+void memTrackTick(uint32_t nowMs)
+{
+  const uint32_t elapsedMs = nowMs - memLastTickMs;
+  if (elapsedMs < 1000)
+  {
+    return;
+  }
+  portENTER_CRITICAL(&memStatsMux);
+  for (uint8_t i = 0; i < MEM_TAG_COUNT; i++)
+  {
+    const uint32_t allocs = memTags[i].allocs - memTagAllocsAtTick[i];
+    const uint32_t perSec = (allocs * 1000U) / elapsedMs;
+    memTags[i].allocsPerSec = uint16_t(perSec > 0xFFFF ? 0xFFFF : perSec);
+    memTagAllocsAtTick[i] = memTags[i].allocs;
+  }
+  portEXIT_CRITICAL(&memStatsMux);
+  memLastTickMs = nowMs;
+}
+
+const char *memTagName(MemTag tag)
+{
+  return (tag < MEM_TAG_COUNT) ? kMemTagNames[tag] : "?";
+}
+
+MemTagStats memTagStats(MemTag tag)
+{
+  portENTER_CRITICAL(&memStatsMux);
+  const MemTagStats stats = memTags[tag];
+  portEXIT_CRITICAL(&memStatsMux);
+  return stats;
+}
+
+void memLoopBegin()
+{
+  memLoopStartAllocs = memAllocsTotal;
+}
+
+void memLoopEnd()
+{
+  const uint32_t allocs = memAllocsTotal - memLoopStartAllocs;
+  if (allocs > memLoopMax)
+  {
+    memLoopMax = uint16_t(allocs > 0xFFFF ? 0xFFFF : allocs);
+  }
+  if (allocs > kMemLoopAllocBudget)
+  {
+    memLoopOverruns++;
+#ifdef EVDASH_MEM_BUDGET_STRICT
+    abort();
+#endif
+  }
+}
+
+uint16_t memLoopAllocsMax()
+{
+  return memLoopMax;
+}
+
+uint32_t memLoopBudgetOverruns()
+{
+  return memLoopOverruns;
+}
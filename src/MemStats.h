@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Per-subsystem memory accounting.
+ *
+ * Long lived buffers report their size with memTrackSet() (sprite, DMA, glyph
+ * atlas, history, LiveData). Short lived allocations go through
+ * memTaggedMalloc/Realloc/Free, which keep the block size in an 8 byte header
+ * so frees are counted without the caller knowing the size (JSON documents,
+ * mbedTLS). Counters: current and peak bytes, allocation count and rate.
+ *
+ * Loop budget: the main loop brackets itself with memLoopBegin()/memLoopEnd().
+ * Tagged allocations above kMemLoopAllocBudget in one loop are counted as
+ * overruns; builds with EVDASH_MEM_BUDGET_STRICT abort instead.
+ */
+enum MemTag : uint8_t
+{
+  MEM_TAG_LIVEDATA = 0,
+  MEM_TAG_HISTORY,
+  MEM_TAG_FRAMEBUFFER,
+  MEM_TAG_DMA,
+  MEM_TAG_GLYPHS,
+  MEM_TAG_MENU,
+  MEM_TAG_JSON,
+  MEM_TAG_UPLOAD,
+  MEM_TAG_TLS,
+  MEM_TAG_COUNT
+};
+
+struct MemTagStats
+{
+  uint32_t currentBytes;
+  uint32_t peakBytes;
+  uint32_t allocs;
+  uint16_t allocsPerSec;
+};
+
+static constexpr uint16_t kMemLoopAllocBudget = 16;
+
+void memTrackAlloc(MemTag tag, size_t bytes);
+void memTrackFree(MemTag tag, size_t bytes);
+void memTrackSet(MemTag tag, size_t bytes); // long lived buffer (re)sized
+void *memTaggedMalloc(MemTag tag, size_t bytes, uint32_t caps);
+void *memTaggedRealloc(MemTag tag, void *ptr, size_t bytes, uint32_t caps);
+void memTaggedFree(MemTag tag, void *ptr);
+
+void memTrackTick(uint32_t nowMs); // updates rates once per second
+const char *memTagName(MemTag tag);
+MemTagStats memTagStats(MemTag tag);
+
+void memLoopBegin();
+void memLoopEnd();
+uint16_t memLoopAllocsMax();
+uint32_t memLoopBudgetOverruns();
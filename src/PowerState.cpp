@@ -0,0 +1,255 @@
+/**
+ * Board power state machine, see PowerState.h.
+ */
+#include "PowerState.h"
+
+static const char *const kPowerStateNames[POWER_STATE_COUNT] = {"ACTIVE", "PARKED", "SENTRY", "DEEP_SLEEP"};
+
+/**
+ * Charging, or charged within the last few minutes (car may pause charging)
+ */
+bool PowerStateMachine::chargingActive(const Inputs &inputs)
+{
+  const bool recentlyCharging =
+      (inputs.lastChargingOnTime != 0 &&
+       inputs.now >= inputs.lastChargingOnTime &&
+       (inputs.now - inputs.lastChargingOnTime) <= (time_t)kChargingHoldSec);
+  return (inputs.charging || recentlyCharging);
+}
+
+void PowerStateMachine::resetSession(time_t now)
+{
+  gpsWakes = 0;
+  gyroWakes = 0;
+  motionLocked = false;
+  motionWakeLastTime = now;
+}
+
+/**
+ * One main loop pass: wake, autostop and deep sleep rules
+ */
+void PowerStateMachine::update(const Inputs &inputs, uint32_t nowMs, Result &result)
+{
+  result = Result();
+  time_t stopPendingSince = inputs.stopPendingSince;
+  bool queueStopped = inputs.queueStopped;
+
+  // Protect AUX battery in screen only mode
+  if (inputs.voltmeterRead && inputs.screenOnlySleep &&
+      inputs.auxVoltage > 5 && inputs.auxVoltage < inputs.voltmeterCutOff)
+  {
+    result.shutdown = POWER_SHUTDOWN_AUX_CUTOFF;
+    if (enter(POWER_DEEP_SLEEP, nowMs, result.transitions[0]))
+      result.transitionCount = 1;
+    return;
+  }
+
+  const bool charging = chargingActive(inputs);
+
+  // Reset sentry session when car becomes active
+  if ((inputs.ignitionOn || charging) && sessionActive)
+  {
+    sessionActive = false;
+    resetSession(0);
+  }
+
+  // Wake up from stopped command queue
+  //  - ignitions on and aux >= 11.5v
+  //  - ina3221 & voltage is >= 14V (DCDC is running)
+  //  - gps speed >= 5kmh & 4+ satellites (only when voltmeter is disabled)
+  //  - gyro motion (only when voltmeter is disabled)
+  if (!queueStopped)
+  {
+    gpsConfirm = 0;
+    gyroConfirm = 0;
+
+    // Charging started while autostop was preparing: cancel pending stop timer.
+    if (stopPendingSince != 0 && charging)
+    {
+      result.continueQueue = true;
+      stopPendingSince = 0;
+    }
+  }
+
+  if (queueStopped || stopPendingSince != 0)
+  {
+    if (motionWakeLastTime == 0)
+    {
+      motionWakeLastTime = inputs.now;
+    }
+    else if (inputs.now - motionWakeLastTime >= (time_t)kMotionWakeResetSec)
+    {
+      resetSession(inputs.now);
+    }
+  }
+
+  const bool gpsWakeRemaining = (gpsWakes < kMaxGpsWakePerSession);
+  const bool gyroWakeRemaining = (gyroWakes < kMaxGyroWakePerSession);
+  motionLocked = (!gpsWakeRemaining && !gyroWakeRemaining);
+  const bool motionWakeAllowed = !inputs.voltmeter && !motionLocked;
+  // 5 floor parking house, satelites 5 & gps speed = 274kmh :/
+  const bool gpsWakeCandidate =
+      motionWakeAllowed && gpsWakeRemaining &&
+      (inputs.gpsValid && inputs.gpsSpeedKmh >= 5 && inputs.gpsSat >= 4);
+  const bool gyroWakeCandidate = motionWakeAllowed && gyroWakeRemaining && inputs.gyroMotion;
+
+  if (queueStopped && gpsWakeCandidate)
+  {
+    if (gpsConfirm < kGpsWakeConfirmSamples)
+      gpsConfirm++;
+  }
+  else
+  {
+    gpsConfirm = 0;
+  }
+  if (queueStopped && gyroWakeCandidate)
+  {
+    if (gyroConfirm < kGyroWakeConfirmSamples)
+      gyroConfirm++;
+  }
+  else
+  {
+    gyroConfirm = 0;
+  }
+
+  result.gpsWake = queueStopped && (gpsConfirm >= kGpsWakeConfirmSamples);
+  result.gyroWake = queueStopped && (gyroConfirm >= kGyroWakeConfirmSamples);
+  if (queueStopped &&
+      ((inputs.ignitionOn && (inputs.auxVoltage <= 3 || inputs.auxVoltage >= 11.5f)) ||
+       charging ||
+       (inputs.voltmeter && inputs.auxVoltage > 14.0f) ||
+       result.gpsWake || result.gyroWake))
+  {
+    if (result.gpsWake || result.gyroWake)
+    {
+      if (result.gpsWake)
+        gpsWakes++;
+      if (result.gyroWake)
+        gyroWakes++;
+      motionWakeLastTime = inputs.now;
+      motionLocked = (gpsWakes >= kMaxGpsWakePerSession && gyroWakes >= kMaxGyroWakePerSession);
+    }
+    gpsConfirm = 0;
+    gyroConfirm = 0;
+    result.continueQueue = true;
+    result.resumeComm = true;
+    stopPendingSince = 0;
+    queueStopped = false;
+  }
+
+  // Stop command queue
+  //  - automatically turns off CAN scanning after 1-2 minutes of inactivity
+  //  - ignition is off
+  //  - AUX voltage is under 11.5V
+  const bool doorStateStale = (inputs.now - inputs.lastCanResponseTime > (time_t)kDoorStateStaleSec);
+  const bool doorsOk = (inputs.doorsClosed || doorStateStale);
+  const bool parkingLikely = (!inputs.ignitionOn && !charging && doorsOk);
+  const bool lowAuxVoltage = (!charging && inputs.auxVoltage > 3 && inputs.auxVoltage < 11.5f);
+  const bool autoStopByCanSignals = (parkingLikely || lowAuxVoltage);
+
+  // Fallback when CAN never yields a valid response (e.g. adapter/config issue):
+  // still allow Sentry autostop after a grace period so AUX battery is protected.
+  const bool canDataMissingTooLong =
+      (!inputs.validResponse && (inputs.now - inputs.wakeUpTime > (time_t)kNoCanGraceSec));
+  const bool dcDcLikelyRunning = (inputs.auxVoltage >= 13.8f);
+  const bool autoStopFallbackSafe = (parkingLikely && !dcDcLikelyRunning);
+
+  if (inputs.autoStop &&
+      ((inputs.validResponse && autoStopByCanSignals) ||
+       (canDataMissingTooLong && autoStopFallbackSafe)))
+  {
+    if (stopPendingSince == 0)
+    {
+      result.canFallback = !inputs.validResponse;
+      result.prepareStop = true;
+      stopPendingSince = inputs.now;
+      if (!sessionActive)
+      {
+        sessionActive = true;
+        resetSession(inputs.now);
+      }
+    }
+  }
+  if (!queueStopped && !charging &&
+      ((stopPendingSince != 0 && inputs.now - stopPendingSince > (time_t)kStopAfterSec) ||
+       (inputs.auxVoltage > 3 && inputs.auxVoltage < 11.0f)))
+  {
+    result.stopQueue = true;
+    queueStopped = true;
+  }
+
+  const PowerState next = queueStopped ? POWER_SENTRY : ((stopPendingSince != 0) ? POWER_PARKED : POWER_ACTIVE);
+  if (enter(next, nowMs, result.transitions[result.transitionCount]))
+    result.transitionCount++;
+
+  // Woken from deep sleep by CAN noise or a voltage spike and the car never answered: sleep again
+  if (inputs.snapshotWake && queueStopped && !inputs.validResponse)
+  {
+    result.shutdown = POWER_SHUTDOWN_NO_CAR;
+  }
+  // Long Sentry: deep sleep until CAN activity or AUX voltage shows the car is awake
+  else if (current == POWER_SENTRY && inputs.screenOnlySleep && inputs.sentryShutdownHrs != 0 &&
+           inputs.deepSleepWakeSource &&
+           timeInStateMs(nowMs) / 3600000UL >= inputs.sentryShutdownHrs)
+  {
+    result.shutdown = POWER_SHUTDOWN_SENTRY_TIMEOUT;
+  }
+  if (result.shutdown != POWER_SHUTDOWN_NONE &&
+      enter(POWER_DEEP_SLEEP, nowMs, result.transitions[result.transitionCount]))
+  {
+    result.transitionCount++;
+  }
+}
+
+bool PowerStateMachine::enter(PowerState next, uint32_t nowMs, Transition &transition)
+{
+  if (next == current)
+  {
+    return false;
+  }
+
+  transition.from = current;
+  transition.to = next;
+  transition.durationMs = nowMs - enteredMs;
+  transition.avgCurrentMa = (currentSamples != 0) ? int16_t(currentSumMa / currentSamples) : -1;
+
+  totals[current] += transition.durationMs;
+  current = next;
+  enteredMs = nowMs;
+  currentSumMa = 0;
+  currentSamples = 0;
+  transitionCount++;
+  return true;
+}
+
+void PowerStateMachine::sampleCurrent(float currentMa)
+{
+  if (currentSamples == 0xFFFF)
+  {
+    return;
+  }
+  currentSumMa += currentMa;
+  currentSamples++;
+}
+
+void PowerStateMachine::shiftTime(time_t offset)
+{
+  if (motionWakeLastTime != 0)
+  {
+    motionWakeLastTime += offset;
+  }
+}
+
+uint32_t PowerStateMachine::totalMs(PowerState state, uint32_t nowMs) const
+{
+  if (state >= POWER_STATE_COUNT)
+  {
+    return 0;
+  }
+  return totals[state] + ((state == current) ? nowMs - enteredMs : 0);
+}
+
+const char *PowerStateMachine::name(PowerState state)
+{
+  return (state < POWER_STATE_COUNT) ? kPowerStateNames[state] : "?";
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+enum PowerState : uint8_t
+{
+  POWER_ACTIVE = 0, // command queue running
+  POWER_PARKED,     // autostop timer running (prepareForStopCommandQueue)
+  POWER_SENTRY,     // queue stopped, comm suspended, waiting for wake
+  POWER_DEEP_SLEEP, // shutdownDevice(), AUX cut-off
+  POWER_STATE_COUNT
+};
+
+enum PowerShutdown : uint8_t
+{
+  POWER_SHUTDOWN_NONE = 0,
+  POWER_SHUTDOWN_AUX_CUTOFF,    // INA3221 under voltmeterCutOff in screen only sleep mode
+  POWER_SHUTDOWN_NO_CAR,        // woken from deep sleep, car never answered
+  POWER_SHUTDOWN_SENTRY_TIMEOUT // sleepModeShutdownHrs in Sentry
+};
+
+/**
+ * Board power state machine.
+ *
+ * Owns the rules that used to live inline in Board320_240::loopPower():
+ * when the command queue starts the autostop timer (CAN parking signals,
+ * low AUX, no CAN data fallback), when it stops, when it wakes from Sentry
+ * (ignition, charging, DC-DC voltage, confirmed GPS/gyro motion with a
+ * per-session limit) and when the board goes to deep sleep. update() gets
+ * one snapshot of voltage, motion and CAN inputs per main loop pass and
+ * returns what the board has to do; the board only applies the actions.
+ *
+ * Each state change is reported with the time spent and the average
+ * current (INA3221 samples) of the state being left.
+ *
+ * No Arduino dependency, so it can be driven from recorded traces on a host.
+ */
+class PowerStateMachine
+{
+public:
+  struct Inputs
+  {
+    time_t now;               // params.currentTime
+    float auxVoltage;         // <= 3 = unknown
+    bool voltmeterRead;       // auxVoltage is a fresh INA3221 sample
+    bool ignitionOn;
+    bool charging;            // chargingOn or AC/DC connector
+    time_t lastChargingOnTime;
+    bool gpsValid;
+    float gpsSpeedKmh;
+    uint8_t gpsSat;
+    bool gyroMotion;
+    bool validResponse;       // params.getValidResponse
+    time_t lastCanResponseTime;
+    time_t wakeUpTime;
+    bool doorsClosed;         // front doors and trunk
+    time_t stopPendingSince;  // params.stopCommandQueueTime, 0 = no autostop timer
+    bool queueStopped;        // params.stopCommandQueue (buttons may clear it)
+    bool snapshotWake;        // params.sleepSnapshotWake
+    // settings
+    bool autoStop;            // commandQueueAutoStop
+    bool voltmeter;           // voltmeterEnabled
+    float voltmeterCutOff;
+    bool screenOnlySleep;     // sleepModeLevel == SLEEP_MODE_SCREEN_ONLY
+    uint16_t sentryShutdownHrs;
+    bool deepSleepWakeSource; // CAN interrupt or voltmeter can wake the board
+  };
+
+  struct Transition
+  {
+    PowerState from;
+    PowerState to;
+    uint32_t durationMs;  // time spent in "from"
+    int16_t avgCurrentMa; // -1 = no current samples (voltmeter disabled)
+  };
+
+  struct Result
+  {
+    bool continueQueue; // LiveData::continueWithCommandQueue()
+    bool resumeComm;    // woken from Sentry, resume the adapter
+    bool prepareStop;   // LiveData::prepareForStopCommandQueue()
+    bool stopQueue;     // stop the queue and suspend the adapter
+    bool gpsWake;
+    bool gyroWake;
+    bool canFallback;   // autostop prepared without any valid CAN response
+    PowerShutdown shutdown;
+    uint8_t transitionCount;
+    Transition transitions[2];
+  };
+
+  static const uint32_t kStopAfterSec = 60;
+  static const uint32_t kChargingHoldSec = 180;
+  static const uint32_t kNoCanGraceSec = 180;
+  static const uint32_t kDoorStateStaleSec = 15;
+  static const uint32_t kMotionWakeResetSec = 900;
+  static const uint8_t kGpsWakeConfirmSamples = 2;
+  static const uint8_t kGyroWakeConfirmSamples = 3;
+  static const uint16_t kMaxGpsWakePerSession = 1;
+  static const uint16_t kMaxGyroWakePerSession = 5;
+
+  void update(const Inputs &inputs, uint32_t nowMs, Result &result);
+  void sampleCurrent(float currentMa);
+  void shiftTime(time_t offset); // wall clock set from GPS/NTP
+  PowerState state() const { return current; }
+  uint32_t timeInStateMs(uint32_t nowMs) const { return nowMs - enteredMs; }
+  uint32_t totalMs(PowerState state, uint32_t nowMs) const;
+  uint16_t transitions() const { return transitionCount; }
+  uint16_t gpsWakeCount() const { return gpsWakes; }
+  uint16_t gyroWakeCount() const { return gyroWakes; }
+  bool motionWakeLocked() const { return motionLocked; }
+  bool sentrySessionActive() const { return sessionActive; }
+  static bool chargingActive(const Inputs &inputs);
+  static const char *name(PowerState state);
+
+private:
+  bool enter(PowerState next, uint32_t nowMs, Transition &transition);
+  void resetSession(time_t now);
+
+  PowerState current = POWER_ACTIVE;
+  uint32_t enteredMs = 0;
+  uint32_t totals[POWER_STATE_COUNT] = {};
+  float currentSumMa = 0;
+  uint16_t currentSamples = 0;
+  uint16_t transitionCount = 0;
+  // Sentry session: motion wakes are limited per session and re-armed after kMotionWakeResetSec
+  bool sessionActive = false;
+  bool motionLocked = false;
+  uint16_t gpsWakes = 0;
+  uint16_t gyroWakes = 0;
+  time_t motionWakeLastTime = 0;
+  uint8_t gpsConfirm = 0;
+  uint8_t gyroConfirm = 0;
+};
@@ -0,0 +1,165 @@
+/**
+ * Raw response table, see RawFrameTable.h.
+ */
+#include "RawFrameTable.h"
+#include <string.h>
+
+void RawFrameTable::clear()
+{
+  memset(slots, 0, sizeof(slots));
+  frameCount = 0;
+  arenaTop = 0;
+  dropCount = 0;
+  probeMax = 0;
+}
+
+uint32_t RawFrameTable::hashKey(const char *key, uint16_t keyLength)
+{
+  uint32_t hash = 2166136261UL;
+  for (uint16_t i = 0; i < keyLength; i++)
+  {
+    hash ^= uint8_t(key[i]);
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+/**
+ * Insert or update frame, false when it was dropped (table or arena full)
+ */
+bool RawFrameTable::put(const char *key, uint16_t keyLength, const char *value, uint16_t valueLength, uint16_t latencyMs)
+{
+  if (keyLength == 0 || keyLength > 255 || valueLength == 0)
+  {
+    return false;
+  }
+  if (valueLength > kArenaSize)
+  {
+    dropCount++;
+    return false;
+  }
+
+  const uint32_t hash = hashKey(key, keyLength);
+  uint16_t slot = hash & (kSlots - 1);
+  uint8_t probes = 0;
+  while (slots[slot] != 0)
+  {
+    Entry &entry = entries[slots[slot] - 1];
+    if (entry.hash == hash && entry.keyLength == keyLength && memcmp(arena + entry.offset, key, keyLength) == 0)
+    {
+      const uint16_t size = keyLength + valueLength + 2;
+      if (size > entry.capacity)
+      {
+        // Key is copied with the block, the old block becomes garbage for compact()
+        const uint16_t oldOffset = entry.offset;
+        char keyCopy[256];
+        memcpy(keyCopy, arena + oldOffset, keyLength);
+        if (!allocate(entry, size))
+        {
+          dropCount++;
+          return false;
+        }
+        memcpy(arena + entry.offset, keyCopy, keyLength);
+        arena[entry.offset + keyLength] = '\0';
+      }
+      memcpy(arena + entry.offset + keyLength + 1, value, valueLength);
+      arena[entry.offset + keyLength + 1 + valueLength] = '\0';
+      entry.valueLength = valueLength;
+      entry.latencyMs = latencyMs;
+      return true;
+    }
+    slot = (slot + 1) & (kSlots - 1);
+    probes++;
+  }
+
+  if (frameCount >= kMaxFrames)
+  {
+    dropCount++;
+    return false;
+  }
+  Entry &entry = entries[frameCount];
+  entry.hash = hash;
+  entry.keyLength = keyLength;
+  if (!allocate(entry, keyLength + valueLength + 2))
+  {
+    dropCount++;
+    return false;
+  }
+  memcpy(arena + entry.offset, key, keyLength);
+  arena[entry.offset + keyLength] = '\0';
+  memcpy(arena + entry.offset + keyLength + 1, value, valueLength);
+  arena[entry.offset + keyLength + 1 + valueLength] = '\0';
+  entry.valueLength = valueLength;
+  entry.latencyMs = latencyMs;
+  slots[slot] = ++frameCount;
+  if (probes > probeMax)
+  {
+    probeMax = probes;
+  }
+  return true;
+}
+
+RawFrameTable::Frame RawFrameTable::frame(uint8_t index) const
+{
+  const Entry &entry = entries[index];
+  Frame out;
+  out.key = arena + entry.offset;
+  out.value = arena + entry.offset + entry.keyLength + 1;
+  out.valueLength = entry.valueLength;
+  out.latencyMs = entry.latencyMs;
+  return out;
+}
+
+/**
+ * New arena block for entry (rounded up to 16 bytes so small growth stays in place)
+ */
+bool RawFrameTable::allocate(Entry &entry, uint16_t size)
+{
+  const uint32_t rounded = (uint32_t(size) + 15) & ~uint32_t(15);
+  if (arenaTop + rounded > kArenaSize)
+  {
+    compact();
+    if (arenaTop + rounded > kArenaSize)
+    {
+      return false;
+    }
+  }
+  entry.offset = arenaTop;
+  entry.capacity = rounded;
+  arenaTop += rounded;
+  return true;
+}
+
+/**
+ * Slide live blocks down in arena order, dropping blocks left behind by moved values
+ */
+void RawFrameTable::compact()
+{
+  uint8_t order[kMaxFrames];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < frameCount; i++)
+  {
+    uint8_t pos = n++;
+    while (pos > 0 && entries[order[pos - 1]].offset > entries[i].offset)
+    {
+      order[pos] = order[pos - 1];
+      pos--;
+    }
+    order[pos] = i;
+  }
+
+  uint16_t top = 0;
+  for (uint8_t i = 0; i < n; i++)
+  {
+    Entry &entry = entries[order[i]];
+    const uint16_t used = (entry.keyLength + entry.valueLength + 2 + 15) & ~15;
+    if (entry.offset != top)
+    {
+      memmove(arena + top, arena + entry.offset, entry.keyLength + entry.valueLength + 2);
+    }
+    entry.offset = top;
+    entry.capacity = used;
+    top += used;
+  }
+  arenaTop = top;
+}
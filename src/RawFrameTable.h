@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Raw response table for contribute uploads and the mobile relay.
+ *
+ * Keyed by "<ECU>_<DID>" (ATSH header + request). Lookup is an open
+ * addressing hash (FNV-1a, linear probing) over kSlots one byte slots, so an
+ * update is O(1) instead of a strcmp scan. Key and value live in one block of
+ * a bump arena: a value that still fits its block is rewritten in place, a
+ * longer one moves to a new block and the arena is compacted when it runs
+ * out. Values are never truncated; a frame that does not fit even after
+ * compaction is dropped and counted.
+ *
+ * Frames keep insertion order for iteration (frame(0..count()-1)).
+ * clear() only resets counters and the 512 byte slot index.
+ */
+class RawFrameTable
+{
+public:
+  static constexpr uint8_t kMaxFrames = 200;
+  static constexpr uint16_t kSlots = 512; // power of two, load stays under 40 %
+  static constexpr uint16_t kArenaSize = 16384;
+
+  struct Frame
+  {
+    const char *key;
+    const char *value;
+    uint16_t valueLength;
+    uint16_t latencyMs;
+  };
+
+  void clear();
+  bool put(const char *key, uint16_t keyLength, const char *value, uint16_t valueLength, uint16_t latencyMs);
+
+  uint8_t count() const { return frameCount; }
+  Frame frame(uint8_t index) const;
+  uint16_t arenaUsed() const { return arenaTop; }
+  uint16_t drops() const { return dropCount; }
+  uint8_t maxProbe() const { return probeMax; } // longest probe sequence since clear()
+
+private:
+  struct Entry
+  {
+    uint32_t hash;
+    uint16_t offset;   // block in arena: key \0 value \0
+    uint16_t capacity; // block size
+    uint16_t valueLength;
+    uint16_t latencyMs;
+    uint8_t keyLength;
+  };
+
+  Entry entries[kMaxFrames];
+  uint8_t slots[kSlots] = {}; // entry index + 1, 0 = empty
+  char arena[kArenaSize];
+  uint8_t frameCount = 0;
+  uint16_t arenaTop = 0;
+  uint16_t dropCount = 0;
+  uint8_t probeMax = 0;
+
+  static uint32_t hashKey(const char *key, uint16_t keyLength);
+  bool allocate(Entry &entry, uint16_t size);
+  void compact();
+};
@@ -0,0 +1,65 @@
+/**
+ * History backfill for the mobile relay, see RelayHistoryJob.h.
+ */
+#include "RelayHistoryJob.h"
+
+/**
+ * Backfill request: history of channels in channelMask from since until now.
+ * Uses the finest tier that still covers since.
+ */
+bool RelayHistoryJob::start(const LiveDataHistory &history, time_t since, time_t now, uint16_t channelMask)
+{
+  running = false;
+  if (!history.isReady() || channelMask == 0)
+  {
+    return false;
+  }
+  tierIndex = HISTORY_TIER_1MIN;
+  for (uint8_t t = 0; t < HISTORY_TIER_COUNT; t++)
+  {
+    const time_t newest = history.newestTime(t);
+    const time_t span = time_t(history.tierCapacity(t)) * history.tierPeriodSec(t);
+    if (newest != 0 && since >= newest - span)
+    {
+      tierIndex = t;
+      break;
+    }
+  }
+  mask = channelMask;
+  channel = 0;
+  from = since;
+  cursor = since;
+  until = now;
+  running = true;
+  return true;
+}
+
+/**
+ * Next chunk of the backfill (one channel, up to kChunkPoints buckets)
+ */
+bool RelayHistoryJob::next(const LiveDataHistory &history, Chunk &chunk)
+{
+  while (channel < HISTORY_CHANNEL_COUNT && (mask & (1U << channel)) == 0)
+  {
+    channel++;
+  }
+  if (!running || channel >= HISTORY_CHANNEL_COUNT)
+  {
+    running = false;
+    return false;
+  }
+
+  chunk.channel = channel;
+  chunk.periodSec = history.tierPeriodSec(tierIndex);
+  chunk.count = history.query(channel, tierIndex, cursor, until, chunk.points, kChunkPoints);
+  if (chunk.count < kChunkPoints)
+  {
+    channel++;
+    cursor = from;
+  }
+  else
+  {
+    cursor = chunk.points[chunk.count - 1].time + chunk.periodSec;
+  }
+  return true;
+}
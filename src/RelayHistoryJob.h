@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "LiveDataHistory.h"
+
+/**
+ * History backfill for the mobile relay.
+ *
+ * The app asks for channels since a time; the job walks them one channel at
+ * a time in chunks of kChunkPoints buckets from the finest tier that still
+ * covers the start. EvDashMobileRelay sends one chunk per loop without live
+ * traffic and cancels the job on disconnect; the app asks again after it
+ * reconnects. No Arduino dependency, so it is tested on a host.
+ */
+class RelayHistoryJob
+{
+public:
+  static constexpr uint8_t kChunkPoints = 24;
+
+  struct Chunk
+  {
+    uint8_t channel;
+    uint16_t periodSec;
+    size_t count;
+    HistoryPoint points[kChunkPoints];
+  };
+
+  bool start(const LiveDataHistory &history, time_t since, time_t now, uint16_t channelMask); // false = no history
+  bool next(const LiveDataHistory &history, Chunk &chunk); // false = finished, count 0 = nothing in this channel
+  void cancel() { running = false; }
+  bool active() const { return running; }
+  uint8_t tier() const { return tierIndex; }
+  time_t to() const { return until; }
+
+private:
+  bool running = false;
+  uint16_t mask = 0;
+  uint8_t channel = 0;
+  uint8_t tierIndex = 0;
+  time_t from = 0;
+  time_t cursor = 0;
+  time_t until = 0;
+};
@@ -0,0 +1,303 @@
+/**
+ * Key/value settings store, see SettingsStore.h.
+ */
+#include "SettingsStore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include <esp_system.h>
+#include <nvs.h>
+
+static const char *kNamespace = "evdash_cfg";
+static nvs_handle_t nvsHandle = 0;
+
+// esp_restart() runs shutdown handlers, so a pending commit survives "save and restart" menu actions
+static SettingsStore *shutdownStore = nullptr;
+static void settingsStoreShutdown()
+{
+  if (shutdownStore != nullptr)
+  {
+    shutdownStore->commit();
+  }
+}
+#else
+#include <map>
+#include <string>
+#include <vector>
+
+// Host builds: records kept in memory and rewritten to a file on commit
+static const char *kHostFile = "evdash_settings.bin";
+static std::map<std::string, std::vector<uint8_t>> hostRecords;
+#endif
+
+static const char *kSchemaKey = "schema";
+
+static void fieldKey(char *key, size_t keySize, uint16_t id)
+{
+  snprintf(key, keySize, "f%u", id);
+}
+
+/**
+ * Attach struct and field table, open storage
+ */
+bool SettingsStore::begin(void *settings, uint16_t settingsSize, const SettingsField *fields, uint16_t count)
+{
+  live = static_cast<uint8_t *>(settings);
+  structSize = settingsSize;
+  fieldTable = fields;
+  fieldCount = count;
+  if (committed == nullptr)
+  {
+    committed = static_cast<uint8_t *>(malloc(structSize));
+    if (committed == nullptr)
+    {
+      return false;
+    }
+  }
+  memcpy(committed, live, structSize);
+  opened = backendOpen();
+#ifdef ESP_PLATFORM
+  if (opened && shutdownStore == nullptr)
+  {
+    shutdownStore = this;
+    esp_register_shutdown_handler(settingsStoreShutdown);
+  }
+#endif
+  return opened;
+}
+
+/**
+ * Overlay stored fields onto the defaults already in the struct
+ */
+bool SettingsStore::load()
+{
+  loaded = 0;
+  if (!opened)
+  {
+    return false;
+  }
+
+  uint8_t schema = 0;
+  size_t length = sizeof(schema);
+  if (!backendRead(kSchemaKey, &schema, length) || length != sizeof(schema) || schema == 0)
+  {
+    return false;
+  }
+
+  uint8_t buffer[kMaxFieldSize];
+  char key[8];
+  for (uint16_t i = 0; i < fieldCount; i++)
+  {
+    const SettingsField &field = fieldTable[i];
+    fieldKey(key, sizeof(key), field.id);
+    length = sizeof(buffer);
+    if (!backendRead(key, buffer, length))
+    {
+      continue; // new field, keeps default
+    }
+    uint8_t *dst = live + field.offset;
+    if (field.text)
+    {
+      const size_t copy = (length < field.size) ? length : field.size;
+      memcpy(dst, buffer, copy);
+      dst[field.size - 1] = '\0';
+      if (copy < field.size)
+      {
+        dst[copy] = '\0';
+      }
+    }
+    else if (length == field.size)
+    {
+      memcpy(dst, buffer, length);
+    }
+    else
+    {
+      continue; // type changed, keeps default
+    }
+    loaded++;
+  }
+
+  memcpy(committed, live, structSize);
+  dirty = false;
+  return true;
+}
+
+/**
+ * Settings changed, commit after they stay unchanged for kCommitDelayMs
+ */
+void SettingsStore::requestCommit(uint32_t nowMs)
+{
+  dirty = true;
+  dirtySinceMs = nowMs;
+}
+
+void SettingsStore::loop(uint32_t nowMs)
+{
+  if (dirty && nowMs - dirtySinceMs >= kCommitDelayMs)
+  {
+    commit();
+  }
+}
+
+/**
+ * Write changed fields (all fields with all = true) and commit once
+ */
+uint16_t SettingsStore::commit(bool all)
+{
+  dirty = false;
+  if (!opened || erased)
+  {
+    return 0;
+  }
+
+  uint16_t written = 0;
+  char key[8];
+  for (uint16_t i = 0; i < fieldCount; i++)
+  {
+    const SettingsField &field = fieldTable[i];
+    const uint8_t *src = live + field.offset;
+    if (!all && memcmp(src, committed + field.offset, field.size) == 0)
+    {
+      continue;
+    }
+    size_t length = field.size;
+    if (field.text)
+    {
+      length = strnlen(reinterpret_cast<const char *>(src), field.size - 1) + 1;
+    }
+    fieldKey(key, sizeof(key), field.id);
+    if (backendWrite(key, src, length))
+    {
+      memcpy(committed + field.offset, src, field.size);
+      written++;
+    }
+  }
+  if (all)
+  {
+    const uint8_t schema = kSchema;
+    backendWrite(kSchemaKey, &schema, sizeof(schema));
+  }
+  if (written > 0 || all)
+  {
+    backendCommit();
+  }
+  writes += written;
+  return written;
+}
+
+/**
+ * Factory reset. Store stays closed until next boot.
+ */
+bool SettingsStore::erase()
+{
+  erased = true;
+  dirty = false;
+  return opened && backendErase() && backendCommit();
+}
+
+#ifdef ESP_PLATFORM
+
+bool SettingsStore::backendOpen()
+{
+  return nvsHandle != 0 || nvs_open(kNamespace, NVS_READWRITE, &nvsHandle) == ESP_OK;
+}
+
+bool SettingsStore::backendRead(const char *key, void *data, size_t &length)
+{
+  return nvs_get_blob(nvsHandle, key, data, &length) == ESP_OK;
+}
+
+bool SettingsStore::backendWrite(const char *key, const void *data, size_t length)
+{
+  return nvs_set_blob(nvsHandle, key, data, length) == ESP_OK;
+}
+
+bool SettingsStore::backendCommit()
+{
+  return nvs_commit(nvsHandle) == ESP_OK;
+}
+
+bool SettingsStore::backendErase()
+{
+  return nvs_erase_all(nvsHandle) == ESP_OK;
+}
+
+#else
+
+// File format: repeated [key length u8][key][data length u16 LE][data]
+bool SettingsStore::backendOpen()
+{
+  hostRecords.clear();
+  FILE *file = fopen(kHostFile, "rb");
+  if (file == nullptr)
+  {
+    return true; // empty store
+  }
+  uint8_t keyLength;
+  while (fread(&keyLength, 1, 1, file) == 1)
+  {
+    char key[256];
+    uint8_t lengthBytes[2];
+    if (fread(key, 1, keyLength, file) != keyLength || fread(lengthBytes, 1, 2, file) != 2)
+    {
+      break;
+    }
+    std::vector<uint8_t> data(lengthBytes[0] | (lengthBytes[1] << 8));
+    if (!data.empty() && fread(data.data(), 1, data.size(), file) != data.size())
+    {
+      break;
+    }
+    hostRecords[std::string(key, keyLength)] = data;
+  }
+  fclose(file);
+  return true;
+}
+
+bool SettingsStore::backendRead(const char *key, void *data, size_t &length)
+{
+  auto it = hostRecords.find(key);
+  if (it == hostRecords.end() || it->second.size() > length)
+  {
+    return false;
+  }
+  length = it->second.size();
+  memcpy(data, it->second.data(), length);
+  return true;
+}
+
+bool SettingsStore::backendWrite(const char *key, const void *data, size_t length)
+{
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  hostRecords[key] = std::vector<uint8_t>(bytes, bytes + length);
+  return true;
+}
+
+bool SettingsStore::backendCommit()
+{
+  FILE *file = fopen(kHostFile, "wb");
+  if (file == nullptr)
+  {
+    return false;
+  }
+  for (const auto &record : hostRecords)
+  {
+    const uint8_t keyLength = uint8_t(record.first.size());
+    const uint8_t lengthBytes[2] = {uint8_t(record.second.size() & 0xFF), uint8_t(record.second.size() >> 8)};
+    fwrite(&keyLength, 1, 1, file);
+    fwrite(record.first.data(), 1, keyLength, file);
+    fwrite(lengthBytes, 1, 2, file);
+    fwrite(record.second.data(), 1, record.second.size(), file);
+  }
+  fclose(file);
+  return true;
+}
+
+bool SettingsStore::backendErase()
+{
+  hostRecords.clear();
+  return true;
+}
+
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Key/value settings store.
+ *
+ * Every persisted field of a settings struct is one record keyed by a stable
+ * field ID (NVS blob "f<id>" on device, a small record file on host builds).
+ * saveSettings() only marks the store dirty; the commit runs once the settings
+ * stayed unchanged for kCommitDelayMs and writes just the fields that differ
+ * from the last committed copy, in one NVS commit.
+ *
+ * Schema changes need no version ladder: a new field gets a new ID and keeps
+ * its default until first written, a removed field's ID is never reused, a
+ * resized text field is truncated/extended on load, a numeric field whose size
+ * changed keeps its default.
+ */
+struct SettingsField
+{
+  uint16_t id; // stable, append only, never reuse
+  uint16_t offset;
+  uint16_t size;
+  bool text; // NUL terminated char array, stored without the unused tail
+};
+
+#define SETTINGS_FIELD(structType, fieldId, member, isText) \
+  {fieldId, uint16_t(offsetof(structType, member)), uint16_t(sizeof(((structType *)nullptr)->member)), isText}
+
+class SettingsStore
+{
+public:
+  static constexpr uint32_t kCommitDelayMs = 2000;
+  static constexpr uint16_t kMaxFieldSize = 128;
+  static constexpr uint8_t kSchema = 1;
+
+  bool begin(void *settings, uint16_t settingsSize, const SettingsField *fields, uint16_t fieldCount);
+  bool load(); // false when the store holds no settings yet (first boot / legacy import)
+  void requestCommit(uint32_t nowMs);
+  void loop(uint32_t nowMs);
+  uint16_t commit(bool all = false); // number of fields written
+  bool erase();
+  bool isDirty() const { return dirty; }
+  uint16_t loadedFields() const { return loaded; }
+  uint32_t fieldWrites() const { return writes; }
+
+private:
+  uint8_t *live = nullptr;
+  uint8_t *committed = nullptr; // copy of what the backend holds
+  uint16_t structSize = 0;
+  const SettingsField *fieldTable = nullptr;
+  uint16_t fieldCount = 0;
+  bool opened = false;
+  bool dirty = false;
+  bool erased = false; // factory reset in progress, nothing may be written again
+  uint32_t dirtySinceMs = 0;
+  uint16_t loaded = 0;
+  uint32_t writes = 0;
+
+  // Storage backend
+  bool backendOpen();
+  bool backendRead(const char *key, void *data, size_t &length);
+  bool backendWrite(const char *key, const void *data, size_t length);
+  bool backendCommit();
+  bool backendErase();
+};
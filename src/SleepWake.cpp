@@ -0,0 +1,148 @@
+/**
+ * Deep sleep wake on car activity, see SleepWake.h.
+ */
+#include "SleepWake.h"
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include <time.h>
+#include "SDL_Arduino_INA3221.h"
+#include "LiveData.h"
+
+namespace
+{
+  constexpr uint32_t kSnapshotMagic = 0x45565344; // "EVSD"
+  constexpr uint16_t kSnapshotVersion = 1;
+
+  struct SleepSnapshot
+  {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t timerChecks; // timer wakes that went back to sleep
+    time_t sleepStartTime;
+    int8_t canIntPin;     // -1 = no CAN wake
+    uint16_t intervalSec; // 0 = no timer wake
+    float wakeVoltage;
+    // Last values for the first screen after wake
+    float socPerc;
+    float socPercBms;
+    float sohPerc;
+    float odoKm;
+    float cumulativeEnergyChargedKWh;
+    float cumulativeEnergyDischargedKWh;
+    float batTempC;
+    float batMinC;
+    float batMaxC;
+    float auxVoltage;
+    uint32_t queueLoopCounter;
+  };
+
+  RTC_DATA_ATTR SleepSnapshot snapshot;
+
+  void enableWakeSources()
+  {
+    if (snapshot.canIntPin >= 0)
+    {
+      esp_sleep_enable_ext0_wakeup(gpio_num_t(snapshot.canIntPin), 0); // MCP2515 INT is active low
+    }
+    if (snapshot.intervalSec != 0)
+    {
+      esp_sleep_enable_timer_wakeup(uint64_t(snapshot.intervalSec) * 1000000ULL);
+    }
+  }
+} // namespace
+
+/**
+ * Stores the snapshot and arms the wake sources; shutdownDevice() starts the deep sleep
+ */
+bool sleepWakeArm(const LiveData *liveData, int8_t canIntPin)
+{
+  const SETTINGS_STRUC &settings = liveData->settings;
+  snapshot.magic = kSnapshotMagic;
+  snapshot.version = kSnapshotVersion;
+  snapshot.timerChecks = 0;
+  snapshot.sleepStartTime = time(nullptr);
+  snapshot.canIntPin = canIntPin;
+  snapshot.intervalSec = (settings.voltmeterEnabled == 1 && settings.sleepModeIntervalSec != 0) ? settings.sleepModeIntervalSec : 0;
+  snapshot.wakeVoltage = settings.voltmeterWakeUp;
+  snapshot.socPerc = liveData->params.socPerc;
+  snapshot.socPercBms = liveData->params.socPercBms;
+  snapshot.sohPerc = liveData->params.sohPerc;
+  snapshot.odoKm = liveData->params.odoKm;
+  snapshot.cumulativeEnergyChargedKWh = liveData->params.cumulativeEnergyChargedKWh;
+  snapshot.cumulativeEnergyDischargedKWh = liveData->params.cumulativeEnergyDischargedKWh;
+  snapshot.batTempC = liveData->params.batTempC;
+  snapshot.batMinC = liveData->params.batMinC;
+  snapshot.batMaxC = liveData->params.batMaxC;
+  snapshot.auxVoltage = liveData->params.auxVoltage;
+  snapshot.queueLoopCounter = liveData->params.queueLoopCounter;
+
+  if (snapshot.canIntPin < 0 && snapshot.intervalSec == 0)
+  {
+    snapshot.magic = 0;
+    return false;
+  }
+  enableWakeSources();
+  return true;
+}
+
+/**
+ * First call in setup(). Timer wake with AUX voltage under voltmeterWakeUp
+ * (car still asleep) goes back to deep sleep and does not return.
+ */
+void sleepWakeEarlyCheck()
+{
+  if (snapshot.magic != kSnapshotMagic || snapshot.version != kSnapshotVersion ||
+      esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER)
+  {
+    return;
+  }
+  SDL_Arduino_INA3221 ina3221;
+  ina3221.begin();
+  const float auxVoltage = ina3221.getBusVoltage_V(1);
+  if (auxVoltage >= snapshot.wakeVoltage)
+  {
+    snapshot.auxVoltage = auxVoltage;
+    return;
+  }
+  if (snapshot.timerChecks < 0xFFFF)
+    snapshot.timerChecks++;
+  enableWakeSources();
+  esp_deep_sleep_start();
+}
+
+/**
+ * After a deep sleep wake, fills params with the values from before the sleep
+ */
+bool sleepSnapshotRestore(LiveData *liveData)
+{
+  const esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+  if (snapshot.magic != kSnapshotMagic || snapshot.version != kSnapshotVersion ||
+      (cause != ESP_SLEEP_WAKEUP_EXT0 && cause != ESP_SLEEP_WAKEUP_TIMER))
+  {
+    snapshot.magic = 0;
+    return false;
+  }
+  snapshot.magic = 0; // one restore per sleep
+
+  liveData->params.socPerc = snapshot.socPerc;
+  liveData->params.socPercBms = snapshot.socPercBms;
+  liveData->params.sohPerc = snapshot.sohPerc;
+  liveData->params.odoKm = snapshot.odoKm;
+  liveData->params.cumulativeEnergyChargedKWh = snapshot.cumulativeEnergyChargedKWh;
+  liveData->params.cumulativeEnergyDischargedKWh = snapshot.cumulativeEnergyDischargedKWh;
+  liveData->params.batTempC = snapshot.batTempC;
+  liveData->params.batMinC = snapshot.batMinC;
+  liveData->params.batMaxC = snapshot.batMaxC;
+  liveData->params.auxVoltage = snapshot.auxVoltage;
+  liveData->params.queueLoopCounter = snapshot.queueLoopCounter;
+
+  const time_t now = time(nullptr);
+  syslog->print("Deep sleep wake by ");
+  syslog->print(cause == ESP_SLEEP_WAKEUP_EXT0 ? "CAN activity" : "AUX voltage");
+  syslog->print(" after ");
+  syslog->print((unsigned long)(now >= snapshot.sleepStartTime ? now - snapshot.sleepStartTime : 0));
+  syslog->print(" s, timer checks: ");
+  syslog->println(snapshot.timerChecks);
+  liveData->params.sleepSnapshotWake = true;
+  return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+class LiveData;
+
+/**
+ * Deep sleep with wake on car activity.
+ *
+ * shutdownDevice() keeps a compact snapshot of the last values in RTC memory
+ * and arms the wake sources: CAN bus activity through the MCP2515 wake-up
+ * interrupt (ext0 on the CAN INT pin) and, with the INA3221 voltmeter
+ * enabled, a timer every sleepModeIntervalSec. sleepWakeEarlyCheck() runs
+ * first in setup(): a timer wake reads the AUX voltage and goes straight back
+ * to sleep below voltmeterWakeUp, before LiveData, display, WiFi or BLE
+ * exist. A CAN wake or a charging/DC-DC voltage continues the normal boot and
+ * sleepSnapshotRestore() shows the last values until the car answers. If the
+ * command queue stops again without a valid response, loopPower() goes back
+ * to deep sleep right away.
+ */
+bool sleepWakeArm(const LiveData *liveData, int8_t canIntPin); // false = no wake source, sleeps until reset
+void sleepWakeEarlyCheck();
+bool sleepSnapshotRestore(LiveData *liveData); // false = cold boot or no snapshot
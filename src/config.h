@@ -260,12 +260,13 @@ typedef enum
   MENU_GPS_PORT,
   MENU_GPS_SPEED,
   MENU_CAR_SPEED_TYPE,
+  MENU_GPS_BINARY_NAV,
 
   // menu sleep
   MENU_SLEEP_TOP = 3110,
   MENU_SLEEP_MODE_MODE,
   // 202408 removed: MENU_SLEEP_MODE_WAKEINTERVAL,
-  // 202408 removed: MENU_SLEEP_MODE_SHUTDOWNHRS,
+  MENU_SLEEP_MODE_SHUTDOWNHRS,
 
   // menu voltmeter
   MENU_VOLTMETER_TOP = 3150,
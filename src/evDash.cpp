@@ -45,6 +45,8 @@
 
 #include "LogSerial.h"
 #include "LiveData.h"
+#include "MemStats.h"
+#include "SleepWake.h"
 #include "CarInterface.h"
 #include "CarKiaEniro.h"
 #include "CarHyundaiIoniq.h"
@@ -77,15 +79,19 @@ static void *evdashTlsCalloc(size_t count, size_t size)
   void *ptr = nullptr;
   if (bytes >= 1024 && psramFound())
   {
-    ptr = heap_caps_calloc(count, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    ptr = memTaggedMalloc(MEM_TAG_TLS, bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
   }
   if (ptr == nullptr)
   {
-    ptr = heap_caps_calloc(count, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ptr = memTaggedMalloc(MEM_TAG_TLS, bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
   }
   if (ptr == nullptr)
   {
-    ptr = calloc(count, size);
+    ptr = memTaggedMalloc(MEM_TAG_TLS, bytes, MALLOC_CAP_DEFAULT);
+  }
+  if (ptr != nullptr)
+  {
+    memset(ptr, 0, bytes);
   }
   return ptr;
 }
@@ -95,7 +101,7 @@ static void *evdashTlsCalloc(size_t count, size_t size)
  */
 static void evdashTlsFree(void *ptr)
 {
-  free(ptr);
+  memTaggedFree(MEM_TAG_TLS, ptr);
 }
 
 /**
@@ -104,22 +110,38 @@ static void evdashTlsFree(void *ptr)
  */
 void setup(void)
 {
+  // Deep sleep timer wake while the car sleeps: back to sleep before anything starts
+  sleepWakeEarlyCheck();
+
   // Init settings/params
   bool liveDataAllocatedInPsram = false;
-  void *liveDataMem = heap_caps_malloc(sizeof(LiveData), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  // Aligned for the cache line sized hot block (LiveData::hot)
+  void *liveDataMem = heap_caps_aligned_alloc(alignof(LiveData), sizeof(LiveData), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
   if (liveDataMem != nullptr)
   {
-    liveData = new (liveDataMem) LiveData();
     liveDataAllocatedInPsram = true;
   }
   else
   {
-    liveData = new LiveData();
+    liveDataMem = heap_caps_aligned_alloc(alignof(LiveData), sizeof(LiveData), MALLOC_CAP_8BIT);
+  }
+  if (liveDataMem == nullptr)
+  {
+    // Nothing works without LiveData and syslog does not exist yet
+    Serial.begin(115200);
+    Serial.printf("LiveData allocation failed (%u B), restarting\n", unsigned(sizeof(LiveData)));
+    Serial.flush();
+    delay(1000);
+    ESP.restart();
   }
+  liveData = new (liveDataMem) LiveData();
+  memTrackSet(MEM_TAG_LIVEDATA, sizeof(LiveData));
   liveData->initParams();
 
   // Serial console
   syslog = new LogSerial();
+  liveData->history.begin();
+  memTrackSet(MEM_TAG_HISTORY, liveData->history.allocatedBytes());
   if (psramFound())
   {
     int tlsAllocRc = mbedtls_platform_set_calloc_free(evdashTlsCalloc, evdashTlsFree);
@@ -136,6 +158,7 @@ void setup(void)
 #endif // BOARD_M5STACK_CORES3
 
   board->setLiveData(liveData);
+  board->bootProfiler.mark("settings");
   board->loadSettings();
 
 #if CONFIG_BT_ENABLED
@@ -161,6 +184,7 @@ void setup(void)
   }
 #endif
 
+  board->bootProfiler.mark("board");
   board->initBoard();
 
   // Turn on serial console
@@ -177,9 +201,11 @@ void setup(void)
                   String(ESP.getFreePsram()));
 
   syslog->println("\nBooting device...");
+  sleepSnapshotRestore(liveData);
   // board->resetSettings();
 
   // Init selected car interface
+  board->bootProfiler.mark("car");
   switch (liveData->settings.carType)
   {
   case CAR_KIA_ENIRO_2020_39:
@@ -249,9 +275,13 @@ void setup(void)
 
   // Finish board setup
   board->afterSetup();
+  board->bootProfiler.mark("relay");
   mobileRelay = new EvDashMobileRelay();
   mobileRelay->begin(liveData, board);
+  board->bootProfiler.mark("frame");
   board->redrawScreen();
+  board->bootProfiler.finish();
+  board->printBootTimeline();
 
   // End
   syslog->println("Device setup completed");
@@ -293,6 +323,7 @@ void setup(void)
   syslog->println("obd2ip=x     ... set ip for obd2 wifi adapter");
   syslog->println("obd2port=x     ... set port for obd2 wifi adapter");
   syslog->println("time   ... print current time");
+  syslog->println("boot   ... print boot timeline");
   syslog->println("ntpSync   ... sync Time with pool.ntp.org");
   syslog->println("setTime=2022-12-30 05:00:00  ... set current time");
   syslog->println("record=n   [n = 1..4]  ... record can response to buffer 1..4");
@@ -152,7 +152,7 @@ const MENU_ITEM menuItemsSource[MENU_SIZE] = {
     {MENU_SLEEP_TOP, MENU_SLEEP_MODE, MENU_OTHERS, "<- parent menu"},
     {MENU_SLEEP_MODE_MODE, MENU_SLEEP_MODE, MENU_NO_MENU, "Mode"},
     // 202408: removed: {MENU_SLEEP_MODE_WAKEINTERVAL, MENU_SLEEP_MODE, MENU_NO_MENU, "WakeUp Check"},
-    // 202408: removed: {MENU_SLEEP_MODE_SHUTDOWNHRS, MENU_SLEEP_MODE, MENU_NO_MENU, "Shutdown After"},
+    {MENU_SLEEP_MODE_SHUTDOWNHRS, MENU_SLEEP_MODE, MENU_NO_MENU, "Deep sleep after"},
 
     {MENU_REMOTE_UPLOAD_TOP, MENU_REMOTE_UPLOAD, MENU_OTHERS, "<- parent menu"},
     {MENU_REMOTE_UPLOAD_CONTRIBUTE_DATA_TO_EVDASH_DEV_TEAM, MENU_REMOTE_UPLOAD, MENU_NO_MENU, "Contribute data"},
@@ -176,6 +176,7 @@ const MENU_ITEM menuItemsSource[MENU_SIZE] = {
     {MENU_GPS_PORT, MENU_GPS, MENU_NO_MENU, "GPS port"},
     {MENU_GPS_SPEED, MENU_GPS, MENU_NO_MENU, "GPS speed"},
     {MENU_CAR_SPEED_TYPE, MENU_GPS, MENU_NO_MENU, "Car speed"},
+    {MENU_GPS_BINARY_NAV, MENU_GPS, MENU_NO_MENU, "Binary nav 10Hz"},
 
     {DEFAULT_SCREEN_TOP, MENU_DEFAULT_SCREEN, MENU_OTHERS, "<- parent menu"},
     {DEFAULT_SCREEN_AUTOMODE, MENU_DEFAULT_SCREEN, MENU_NO_MENU, "Auto mode"},
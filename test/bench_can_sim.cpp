@@ -0,0 +1,157 @@
+/**
+ * CanSimBus + IsoTpReassembler on a fake millisecond clock: the E-GMP demo
+ * script polled the way CommObd2Can does (one request in flight, flow
+ * control after the first frame, 500 ms rx timeout refreshed by matching
+ * frames, 7F xx 78 keeps waiting). Prints PIDs/s and timeout rate per
+ * scenario; deterministic for a given seed.
+ */
+#include "CanSimBus.h"
+#include "IsoTpReassembler.h"
+#include <mcp_can.h>
+#include <stdio.h>
+#include <string.h>
+
+uint32_t hostMillis = 0;
+
+static const uint16_t kRxTimeoutMs = 500; // LiveData::rxTimeoutMs
+
+struct Request
+{
+  uint16_t id;
+  uint8_t did[3];
+};
+
+// Requests answered by kCanSimDefaultScript
+static const Request kRequests[] = {
+    {0x770, {0x22, 0xBC, 0x03}},
+    {0x770, {0x22, 0xBC, 0x06}},
+    {0x7D1, {0x22, 0x01, 0x04}},
+    {0x7A0, {0x22, 0xC0, 0x0B}},
+    {0x7B3, {0x22, 0x01, 0x00}},
+    {0x7C6, {0x22, 0xB0, 0x02}},
+    {0x7E5, {0x22, 0xE0, 0x11}},
+    {0x7E4, {0x22, 0x01, 0x01}},
+    {0x7E4, {0x22, 0x01, 0x05}},
+    {0x7E4, {0x22, 0x01, 0x06}},
+};
+static const uint8_t kRequestCount = sizeof(kRequests) / sizeof(kRequests[0]);
+
+struct Result
+{
+  uint32_t answered;
+  uint32_t timeouts;
+  uint32_t negative;
+  uint32_t corrupt;
+  uint32_t latencySumMs;
+};
+
+static IsoTpReassembler isoTp;
+
+static Result poll(CanSimBus &bus, uint8_t stMinMs, uint32_t durationMs)
+{
+  Result result = {};
+  uint8_t next = 0;
+  bool waiting = false;
+  uint32_t sentMs = 0;
+  uint32_t lastDataMs = 0;
+  const uint32_t endMs = hostMillis + durationMs;
+
+  for (; hostMillis != endMs; hostMillis++)
+  {
+    const Request &request = kRequests[next];
+    if (!waiting)
+    {
+      uint8_t frame[8] = {0x03, request.did[0], request.did[1], request.did[2], 0xAA, 0xAA, 0xAA, 0xAA};
+      bus.sendMsgBuf(request.id, 0, 8, frame);
+      isoTp.reset();
+      waiting = true;
+      sentMs = hostMillis;
+      lastDataMs = hostMillis;
+    }
+
+    bool done = false;
+    while (!done && bus.checkReceive() == CAN_MSGAVAIL)
+    {
+      unsigned long id;
+      uint8_t length;
+      uint8_t buf[8];
+      bus.readMsgBuf(&id, &length, buf);
+      if (id != request.id + 8u)
+        continue; // broadcast noise
+      lastDataMs = hostMillis;
+      IsoTpReassembler::Result frameResult = IsoTpReassembler::ISOTP_PENDING;
+      switch (buf[0] >> 4)
+      {
+      case 0:
+        if (buf[1] == 0x7F && buf[3] == 0x78)
+          continue; // response pending, real answer follows
+        frameResult = isoTp.single(buf + 1, buf[0] & 0x0F);
+        break;
+      case 1:
+      {
+        frameResult = isoTp.first(uint16_t(((buf[0] & 0x0F) << 8) | buf[1]), buf + 2, 6);
+        uint8_t flowControl[8] = {0x30, 0, stMinMs, 0, 0, 0, 0, 0};
+        bus.sendMsgBuf(request.id, 0, 8, flowControl);
+        break;
+      }
+      case 2:
+        frameResult = isoTp.consecutive(buf[0] & 0x0F, buf + 1, 7);
+        break;
+      }
+      if (frameResult != IsoTpReassembler::ISOTP_COMPLETE)
+        continue;
+      if (isoTp.data()[0] == 0x7F)
+        result.negative++;
+      else if (isoTp.data()[0] != 0x62 || memcmp(isoTp.data() + 1, request.did + 1, 2) != 0)
+        result.corrupt++;
+      result.answered++;
+      result.latencySumMs += hostMillis - sentMs;
+      done = true;
+    }
+
+    if (!done && hostMillis - lastDataMs > kRxTimeoutMs)
+    {
+      result.timeouts++;
+      done = true;
+    }
+    if (done)
+    {
+      waiting = false;
+      next = (next + 1) % kRequestCount;
+    }
+  }
+  return result;
+}
+
+static void bench(const char *label, uint8_t stMinMs, uint8_t extraLossPerc, uint32_t seed)
+{
+  CanSimBus bus(seed);
+  bus.begin(0, 0, 0);
+  bus.setMode(MCP_NORMAL);
+  bus.loadScript(kCanSimDefaultScript);
+  if (extraLossPerc != 0)
+  {
+    for (uint8_t i = 0; i < kRequestCount; i++)
+      bus.setProfile(kRequests[i].id, 20, 10, extraLossPerc, 5);
+  }
+
+  const uint32_t durationMs = 10 * 60 * 1000;
+  const Result result = poll(bus, stMinMs, durationMs);
+  const uint32_t total = result.answered + result.timeouts;
+  const CanSimBus::Stats &stats = bus.stats();
+  printf("CanSimBus %-24s %5.1f PID/s, timeouts %u/%u (%.1f%%), avg latency %u ms, neg %u corrupt %u, "
+         "pending %u noise %u ovr %u\n",
+         label, result.answered * 1000.0 / durationMs, result.timeouts, total,
+         total ? result.timeouts * 100.0 / total : 0.0,
+         result.answered ? result.latencySumMs / result.answered : 0, result.negative, result.corrupt,
+         stats.pending, stats.noiseFrames, stats.overruns);
+}
+
+int main()
+{
+  bench("script, STmin 20 ms", 20, 0, 0x45564441);
+  bench("script, STmin 0", 0, 0, 0x45564441);
+  bench("10% loss, STmin 20 ms", 20, 10, 0x45564441);
+  bench("10% loss, STmin 0", 0, 10, 0x45564441);
+  return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ * CarSignalTable benchmark: decodeSignalRows() throughput on the E-GMP table.
+ */
+#include "CarSignalTable.h"
+#include "CarSignalsEgmp.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+int main()
+{
+  // One positive response per DID of the table, long enough for every row
+  struct Response
+  {
+    uint16_t ecu;
+    uint32_t request;
+    char hex[2 * 64 + 1];
+    uint16_t hexLength;
+  };
+  Response responses[16];
+  uint8_t count = 0;
+  for (uint16_t i = 0; i < kEgmpSignalCount && count < 16; i++)
+  {
+    const CarSignal &row = kEgmpSignals[i];
+    if (count > 0 && responses[count - 1].ecu == row.ecu && responses[count - 1].request == row.request)
+      continue;
+    Response &response = responses[count++];
+    response.ecu = row.ecu;
+    response.request = row.request;
+    response.hexLength = 2 * 64;
+    for (uint16_t c = 0; c < response.hexLength; c++)
+      response.hex[c] = "0123456789ABCDEF"[(c * 7 + i) % 16];
+    char header[7];
+    snprintf(header, sizeof(header), "%06X", unsigned(row.request + 0x400000));
+    memcpy(response.hex, header, 6);
+    response.hex[response.hexLength] = '\0';
+  }
+
+  PARAMS_STRUC params;
+  memset(&params, 0, sizeof(params));
+  const uint32_t rounds = 200000;
+  uint32_t written = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t round = 0; round < rounds; round++)
+  {
+    for (uint8_t r = 0; r < count; r++)
+      written += decodeSignalRows(kEgmpSignals, kEgmpSignalCount, responses[r].ecu, responses[r].request,
+                                  responses[r].hex, responses[r].hexLength, params);
+  }
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  const uint32_t decodes = rounds * count;
+  printf("CarSignalTable E-GMP: %u DIDs, %u rows: %.1f ns/response, %.1f ns/value, %.2f M values/s\n",
+         count, kEgmpSignalCount, ns / decodes, ns / written, written / ns * 1000.0);
+  return 0;
+}
@@ -0,0 +1,45 @@
+/**
+ * RawFrameTable benchmark: ns per put and longest probe for a poll cycle of 40 and 200 PIDs.
+ */
+#include "RawFrameTable.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+static RawFrameTable table;
+
+static void bench(uint8_t pids, uint32_t cycles)
+{
+  char keys[RawFrameTable::kMaxFrames][16];
+  uint16_t keyLengths[RawFrameTable::kMaxFrames];
+  static const uint16_t ecus[] = {0x7E4, 0x7E2, 0x7B3, 0x7A0, 0x7C6, 0x770, 0x7D1, 0x7E5};
+  for (uint8_t i = 0; i < pids; i++)
+    keyLengths[i] = snprintf(keys[i], sizeof(keys[i]), "%03X_22%04X", ecus[i % 8], 0x0101 + i);
+
+  // Typical response lengths, a few grow by one row every other cycle (moved + compacted values)
+  char value[160];
+  memset(value, 'A', sizeof(value));
+  table.clear();
+  uint32_t puts = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t cycle = 0; cycle < cycles; cycle++)
+  {
+    for (uint8_t i = 0; i < pids; i++)
+    {
+      const uint16_t length = 40 + (i * 13) % 100 + ((i % 10 == 0 && (cycle & 1)) ? 14 : 0);
+      value[0] = char('0' + cycle % 10);
+      table.put(keys[i], keyLengths[i], value, length, 20);
+      puts++;
+    }
+  }
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  printf("RawFrameTable %3u PIDs: %6.1f ns/put, max probe %u, arena %u B, drops %u\n",
+         pids, ns / puts, table.maxProbe(), table.arenaUsed(), table.drops());
+}
+
+int main()
+{
+  bench(40, 50000);
+  bench(200, 10000);
+  return 0;
+}
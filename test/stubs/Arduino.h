@@ -0,0 +1,14 @@
+#pragma once
+
+/**
+ * Host stand-in for the Arduino core: millis() reads a fake clock the
+ * bench or test advances itself.
+ */
+#include <stdint.h>
+
+extern uint32_t hostMillis;
+
+inline unsigned long millis()
+{
+  return hostMillis;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+/**
+ * Host stand-in for MCP_CAN_lib: return codes and modes used by CanSimBus
+ * (values from mcp_can_dfs.h).
+ */
+#define MCP2515_OK (0)
+#define CAN_OK (0)
+#define CAN_FAILTX (2)
+#define CAN_MSGAVAIL (3)
+#define CAN_NOMSG (4)
+#define MCP_NORMAL 0x00
+#define MCP_SLEEP 0x20
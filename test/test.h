@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * Minimal host test helpers, see Makefile.
+ */
+#include <stdio.h>
+
+static int testFailures = 0;
+
+#define CHECK(cond)                                                        \
+  do                                                                       \
+  {                                                                        \
+    if (!(cond))                                                           \
+    {                                                                      \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      testFailures++;                                                      \
+    }                                                                      \
+  } while (0)
+
+#define TEST_RESULT(name)                                        \
+  (printf("%s: %s\n", name, testFailures ? "FAILED" : "OK"), \
+   testFailures ? 1 : 0)
@@ -0,0 +1,94 @@
+/**
+ * CanAcceptance: MCP2515 masks/filters accept every registered response ID.
+ */
+#include "CanAcceptance.h"
+#include "test.h"
+
+static bool accepts(const CanFilterPlan &plan, uint16_t id)
+{
+  for (uint8_t f = 0; f < 6; f++)
+  {
+    if (((id ^ plan.filter[f]) & plan.mask[(f < 2) ? 0 : 1]) == 0)
+      return true;
+  }
+  return false;
+}
+
+static uint16_t acceptedCount(const CanFilterPlan &plan)
+{
+  uint16_t accepted = 0;
+  for (uint16_t id = 0; id <= 0x7FF; id++)
+  {
+    if (accepts(plan, id))
+      accepted++;
+  }
+  return accepted;
+}
+
+static void checkPlan(const uint16_t *ids, uint8_t count, uint16_t maxAccepted)
+{
+  CanAcceptance acceptance;
+  for (uint8_t i = 0; i < count; i++)
+    CHECK(acceptance.addResponseId(ids[i]));
+  CanFilterPlan plan;
+  CHECK(acceptance.filterPlan(plan));
+  for (uint8_t i = 0; i < count; i++)
+    CHECK(accepts(plan, ids[i]));
+  CHECK(plan.acceptedIds == acceptedCount(plan));
+  CHECK(plan.acceptedIds <= maxAccepted);
+}
+
+static void testEmptyAndExtended()
+{
+  CanAcceptance acceptance;
+  CanFilterPlan plan;
+  CHECK(!acceptance.filterPlan(plan));
+  CHECK(acceptance.addResponseId(0x7EC));
+  CHECK(acceptance.addResponseId(0x18DAF110)); // extended: acceptance stays open
+  CHECK(!acceptance.filterPlan(plan));
+  acceptance.clear();
+  CHECK(acceptance.idCount() == 0);
+}
+
+static void testDuplicatesAndLimit()
+{
+  CanAcceptance acceptance;
+  CHECK(acceptance.addResponseId(0x7EC));
+  CHECK(acceptance.addResponseId(0x7EC));
+  CHECK(acceptance.idCount() == 1);
+  for (uint16_t id = 0x700; id < 0x700 + CanAcceptance::kMaxIds - 1; id++)
+    CHECK(acceptance.addResponseId(id));
+  CHECK(acceptance.idCount() == CanAcceptance::kMaxIds);
+  CHECK(!acceptance.addResponseId(0x100));
+  CHECK(acceptance.addResponseId(0x7EC)); // already in the set
+}
+
+static void testExactFilters()
+{
+  const uint16_t one[] = {0x7EC};
+  checkPlan(one, 1, 1);
+  const uint16_t e208[] = {0x7E8, 0x58F, 0x682, 0x694}; // CarPeugeotE208::registerCanAcceptance()
+  checkPlan(e208, 4, 4);
+  const uint16_t six[] = {0x7E8, 0x7EC, 0x7BB, 0x7CE, 0x7AB, 0x7A8};
+  checkPlan(six, 6, 6);
+}
+
+static void testMergedFilters()
+{
+  // Hyundai/Kia style response IDs, more than the 6 filters
+  const uint16_t ids[] = {0x7A8, 0x7AB, 0x7BB, 0x7BD, 0x7CE, 0x7EA, 0x7EC, 0x7F1, 0x7C6, 0x7D1};
+  checkPlan(ids, 10, 32);
+
+  // Spread over the whole range: still correct, just less selective
+  const uint16_t spread[] = {0x001, 0x0FF, 0x123, 0x256, 0x3A5, 0x444, 0x555, 0x6D3, 0x700, 0x7FF, 0x080};
+  checkPlan(spread, 11, 0x800);
+}
+
+int main()
+{
+  testEmptyAndExtended();
+  testDuplicatesAndLimit();
+  testExactFilters();
+  testMergedFilters();
+  return TEST_RESULT("CanAcceptance");
+}
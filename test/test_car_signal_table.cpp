@@ -0,0 +1,157 @@
+/**
+ * CarSignalTable: decodeSignalRows() on a test table, the shared E-GMP table and random hex.
+ */
+#include "CarSignalTable.h"
+#include "CarSignalsEgmp.h"
+#include "test.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const CarSignal kTestSignals[] = {
+    {0x7E4, 0x220101, 8, 3, 2, false, 0.1, 0, &PARAMS_STRUC::batVoltage, 0, 1000},
+    {0x7E4, 0x220101, 8, 5, 2, true, 0.1, 0, &PARAMS_STRUC::batPowerKw, kSignalNoMin, kSignalNoMax},
+    {0x7E4, 0x220101, 8, 7, 1, true, 1, 0, &PARAMS_STRUC::batMinC, -40, 80},
+    {0x7E4, 0x220105, 4, 3, 1, false, 1, 0, &PARAMS_STRUC::auxVoltage, kSignalNoMin, kSignalNoMax},
+    {0x7E4, 0x220105, 8, 4, 4, false, 1, 0, &PARAMS_STRUC::odoKm, kSignalNoMin, kSignalNoMax}, // needs 8 bytes
+    {0x7E5, 0x0902, 3, 2, 1, false, 1, 0, &PARAMS_STRUC::batMaxC, kSignalNoMin, kSignalNoMax},
+};
+static const uint16_t kTestCount = sizeof(kTestSignals) / sizeof(kTestSignals[0]);
+
+static PARAMS_STRUC params;
+
+static uint8_t decode(uint16_t ecu, uint32_t request, const char *hex)
+{
+  return decodeSignalRows(kTestSignals, kTestCount, ecu, request, hex, strlen(hex), params);
+}
+
+static bool near(float a, float b)
+{
+  return fabsf(a - b) < 0.001f;
+}
+
+static void testDecode()
+{
+  memset(&params, 0, sizeof(params));
+  // 62 0101 | 0E10 = 360.0 V | FF38 = -20.0 kW | F6 = -10 C
+  CHECK(decode(0x7E4, 0x220101, "6201010E10FF38F6") == 3);
+  CHECK(near(params.batVoltage, 360.0f));
+  CHECK(near(params.batPowerKw, -20.0f));
+  CHECK(near(params.batMinC, -10.0f));
+
+  // Out of range value keeps the previous one (0x80 = -128 C)
+  CHECK(decode(0x7E4, 0x220101, "6201010E11FF3880") == 2);
+  CHECK(near(params.batVoltage, 360.1f));
+  CHECK(near(params.batMinC, -10.0f));
+
+  // Row minLength: aux needs 4 bytes, odo 8
+  CHECK(decode(0x7E4, 0x220105, "6201058C") == 1);
+  CHECK(near(params.auxVoltage, 140.0f));
+  CHECK(near(params.odoKm, 0.0f));
+  CHECK(decode(0x7E4, 0x220105, "6201057F0001E240") == 2);
+  CHECK(near(params.odoKm, 123456.0f));
+
+  // Two byte request (mode 09)
+  CHECK(decode(0x7E5, 0x0902, "49022A") == 1);
+  CHECK(near(params.batMaxC, 42.0f));
+}
+
+static void testRejected()
+{
+  memset(&params, 0, sizeof(params));
+  CHECK(decode(0x7E4, 0x220102, "6201020E10FF38F6") == 0); // no rows
+  CHECK(decode(0x7E6, 0x220101, "6201010E10FF38F6") == 0); // other ECU
+  CHECK(decode(0x7E4, 0x220101, "7F22310000000000") == 0); // negative response
+  CHECK(decode(0x7E4, 0x220101, "6201020E10FF38F6") == 0); // reply to another DID
+  CHECK(decode(0x7E4, 0x220101, "6201010E10FF38F") == 0);  // odd length
+  CHECK(decode(0x7E4, 0x220101, "6201010E10FF") == 0);     // too short for every row
+  CHECK(decode(0x7E4, 0x220101, "6201010E10ZZ38F6") == 2); // bad hex skips only that row
+  CHECK(near(params.batPowerKw, 0.0f));
+  CHECK(decodeSignalRows(kTestSignals, 0, 0x7E4, 0x220101, "6201010E10FF38F6", 16, params) == 0);
+}
+
+static void testEgmpTable()
+{
+  // Binary search in decodeSignalRows() needs rows sorted by (ecu, request)
+  for (uint16_t i = 1; i < kEgmpSignalCount; i++)
+  {
+    const CarSignal &a = kEgmpSignals[i - 1];
+    const CarSignal &b = kEgmpSignals[i];
+    CHECK(a.ecu < b.ecu || (a.ecu == b.ecu && a.request <= b.request));
+  }
+  for (uint16_t i = 0; i < kEgmpSignalCount; i++)
+  {
+    CHECK(kEgmpSignals[i].length >= 1 && kEgmpSignals[i].length <= 4);
+    CHECK(kEgmpSignals[i].byteOffset + kEgmpSignals[i].length <= kEgmpSignals[i].minLength);
+  }
+
+  // TPMS: front left 0xA0 (2.21 bar) at byte 7, 0x46 (20 C) at byte 8
+  char hex[24 * 2 + 1];
+  memset(hex, '0', sizeof(hex) - 1);
+  hex[sizeof(hex) - 1] = '\0';
+  memcpy(hex, "62C00B", 6);
+  memcpy(hex + 7 * 2, "A046", 4);
+  memset(&params, 0, sizeof(params));
+  CHECK(decodeSignalRows(kEgmpSignals, kEgmpSignalCount, 0x7A0, 0x22C00B, hex, strlen(hex), params) >= 2);
+  CHECK(near(params.tireFrontLeftPressureBar, 160 / 72.51886900361f));
+  CHECK(near(params.tireFrontLeftTempC, 20.0f));
+}
+
+static uint32_t fuzzState = 0x2545F491;
+static uint32_t fuzzRandom()
+{
+  fuzzState ^= fuzzState << 13;
+  fuzzState ^= fuzzState >> 17;
+  fuzzState ^= fuzzState << 5;
+  return fuzzState;
+}
+
+/**
+ * Random hex against the E-GMP rows: never reads past the text, writes only in-range values
+ */
+static void testFuzz()
+{
+  static const char kChars[] = "0123456789ABCDEF0123456789abcdefZ ";
+  char hex[160];
+  uint32_t decoded = 0;
+  for (uint32_t i = 0; i < 200000; i++)
+  {
+    const CarSignal &row = kEgmpSignals[fuzzRandom() % kEgmpSignalCount];
+    const uint16_t hexLength = fuzzRandom() % (sizeof(hex) - 1);
+    for (uint16_t c = 0; c < hexLength; c++)
+      hex[c] = kChars[fuzzRandom() % (sizeof(kChars) - 1)];
+    hex[hexLength] = '\0';
+    if ((fuzzRandom() & 1) && hexLength >= 6)
+    {
+      // Positive response header of the 3 byte request, the rest stays random
+      char header[7];
+      snprintf(header, sizeof(header), "%06X", unsigned(row.request + 0x400000));
+      memcpy(hex, header, 6);
+    }
+    memset(&params, 0xFF, sizeof(params)); // NaN: untouched
+    const uint8_t written = decodeSignalRows(kEgmpSignals, kEgmpSignalCount, row.ecu, row.request, hex, hexLength, params);
+    decoded += written;
+    uint8_t changed = 0;
+    for (uint16_t r = 0; r < kEgmpSignalCount; r++)
+    {
+      const float value = params.*(kEgmpSignals[r].target);
+      if (value == value)
+      {
+        changed++;
+        CHECK(kEgmpSignals[r].ecu == row.ecu && kEgmpSignals[r].request == row.request);
+        CHECK(value >= kEgmpSignals[r].minValue && value <= kEgmpSignals[r].maxValue);
+      }
+    }
+    CHECK(changed <= written);
+  }
+  CHECK(decoded > 0);
+}
+
+int main()
+{
+  testDecode();
+  testRejected();
+  testEgmpTable();
+  testFuzz();
+  return TEST_RESULT("CarSignalTable");
+}
@@ -0,0 +1,180 @@
+/**
+ * ElmResponseMerger fed with Elm327Sim output the way notifyCallback() gets
+ * it: BLE notifications of MTU size (or cut mid-row), echo, SEARCHING...,
+ * "03E" + "0:" "1:" rows, 7F xx 78 pending, NO DATA.
+ */
+#include "ElmResponseMerger.h"
+#include "Elm327Sim.h"
+#include "test.h"
+#include <string.h>
+#include <string>
+
+uint32_t hostMillis = 0;
+
+static const char *const kScript =
+    "PROFILE 7E4 20 10 0 0\n"
+    "PROFILE 7A0 25 5 0 100\n"
+    "PROFILE 7C6 10 0 100 0\n"
+    "ATSH7A0 22C00B 62C00BFFFFFFF80000000002000000000200000000020000000002FFFFFFFFFFFFFFFFFFAAAAAAAAAA\n"
+    "ATSH7C6 22B002 62B002E0000000FFB601FDB8000000AAAAAAAAAA\n"
+    "ATSH7E4 220101 620101EFFBE7EF6E000000000000591BD007050505050505002BB952B99100008D00051D8D00050DFC0003D282000391F20168C7B30002C9000000000665\n"
+    "ATSH7E4 220105 6201051FFB740F012C01012C0605050505050661146162000050120003B61D424C006D0000000000000005050505AAAA\n"
+    "ATSH7E4 220106 62010617F811000D000C000000000000000000000000000500EA000000000000000000000000AAAAAA\n";
+
+struct Link
+{
+  Elm327Sim sim;
+  ElmResponseMerger rows;
+  uint32_t prompts = 0;
+
+  // executeCommand() + notifyCallback() until the '>' prompt; merged response
+  std::string command(const char *text)
+  {
+    std::string merged;
+    std::string line = std::string(text) + "\r";
+    rows.reset();
+    sim.write(line.c_str(), line.length());
+    for (uint32_t startMs = hostMillis; hostMillis - startMs < 3000; hostMillis++)
+    {
+      sim.loop(hostMillis);
+      uint8_t notification[64];
+      uint8_t length;
+      while ((length = sim.read(notification, sizeof(notification), hostMillis)) != 0)
+      {
+        for (uint8_t i = 0; i < length; i++)
+        {
+          const ElmResponseMerger::Event event = rows.feed(char(notification[i]));
+          if (event == ElmResponseMerger::ELM_ROW)
+          {
+            const int8_t offset = ElmResponseMerger::payloadOffset(rows.row(), rows.rowLength());
+            if (offset >= 0)
+              merged += rows.row() + offset;
+          }
+          else if (event == ElmResponseMerger::ELM_PROMPT)
+          {
+            prompts++;
+            return merged;
+          }
+        }
+      }
+    }
+    return "<timeout>";
+  }
+};
+
+static std::string withoutSpaces(const std::string &text)
+{
+  std::string out;
+  for (char ch : text)
+    if (ch != ' ')
+      out += ch;
+  return out;
+}
+
+static const char *scriptResponse(const char *request)
+{
+  const char *line = strstr(kScript, request);
+  return line != nullptr ? line + strlen(request) + 1 : nullptr;
+}
+
+static bool matchesScript(const std::string &merged, const char *request)
+{
+  const char *expected = scriptResponse(request);
+  const char *end = strchr(expected, '\n');
+  return merged == std::string(expected, end - expected);
+}
+
+static void testRowSplitting()
+{
+  ElmResponseMerger rows;
+  // Row cut over two notifications is completed by the second one
+  const char *first = "0: 62 01";
+  for (const char *p = first; *p != '\0'; p++)
+    CHECK(rows.feed(*p) == ElmResponseMerger::ELM_NONE);
+  CHECK(rows.feed(' ') == ElmResponseMerger::ELM_NONE);
+  CHECK(rows.feed('0') == ElmResponseMerger::ELM_NONE);
+  CHECK(rows.feed('1') == ElmResponseMerger::ELM_NONE);
+  CHECK(rows.feed('\r') == ElmResponseMerger::ELM_ROW);
+  CHECK(strcmp(rows.row(), "0: 62 01 01") == 0);
+  CHECK(ElmResponseMerger::payloadOffset(rows.row(), rows.rowLength()) == 2);
+
+  // Empty rows are no rows, '>' only counts at the start of a row
+  CHECK(rows.feed('\r') == ElmResponseMerger::ELM_NONE);
+  CHECK(rows.feed('\n') == ElmResponseMerger::ELM_NONE);
+  CHECK(rows.feed('A') == ElmResponseMerger::ELM_NONE);
+  CHECK(rows.feed('>') == ElmResponseMerger::ELM_NONE);
+  CHECK(rows.feed('\0') == ElmResponseMerger::ELM_ROW);
+  CHECK(strcmp(rows.row(), "A>") == 0);
+  CHECK(rows.feed('>') == ElmResponseMerger::ELM_PROMPT);
+
+  // New command drops the unfinished fragment of the previous response
+  rows.feed('7');
+  rows.feed('F');
+  rows.reset();
+  rows.feed('4');
+  rows.feed('1');
+  CHECK(rows.feed('\r') == ElmResponseMerger::ELM_ROW);
+  CHECK(strcmp(rows.row(), "41") == 0);
+
+  // Overlong row is cut and counted once
+  for (uint16_t i = 0; i < 300; i++)
+    rows.feed('F');
+  CHECK(rows.feed('\r') == ElmResponseMerger::ELM_ROW);
+  CHECK(rows.rowLength() == ElmResponseMerger::kMaxRow && rows.overflows() == 1);
+
+  // Merge rule
+  CHECK(ElmResponseMerger::payloadOffset("1:0102", 6) == 2);
+  CHECK(ElmResponseMerger::payloadOffset("A: 01", 5) == 2);
+  CHECK(ElmResponseMerger::payloadOffset("03E", 3) == -1);
+  CHECK(ElmResponseMerger::payloadOffset("OK", 2) == -1);
+  CHECK(ElmResponseMerger::payloadOffset("41 0C", 5) == 0);
+  CHECK(ElmResponseMerger::payloadOffset("NO DATA", 7) == 0);
+}
+
+static void testElmSession(uint8_t mtuPayload, uint8_t splitPerc)
+{
+  Link link;
+  CHECK(link.sim.loadScript(kScript) == 8);
+  link.sim.setMtuPayload(mtuPayload);
+  link.sim.setSplitPerc(splitPerc);
+
+  CHECK(link.command("ATZ") == "ELM327 v1.5"); // echo "ATZ" is too short to merge
+  CHECK(link.command("ATE0") == "ATE0");       // echo of the command that turns it off
+  CHECK(link.command("ATSP6") == "");
+  CHECK(link.command("ATSH7E4") == "");
+
+  // First request after ATZ: SEARCHING... row in front, then 03E + 0:..8: rows
+  std::string merged = link.command("220101");
+  CHECK(merged.compare(0, 12, "SEARCHING...") == 0);
+  CHECK(matchesScript(withoutSpaces(merged.substr(12)), "220101"));
+
+  CHECK(matchesScript(withoutSpaces(link.command("220105")), "220105"));
+  CHECK(link.command("ATS0") == "");
+  merged = link.command("220106");
+  CHECK(merged.find(' ') == std::string::npos);
+  CHECK(matchesScript(merged, "220106"));
+
+  // Response pending is merged in front; parseRowMerged() strips it
+  CHECK(link.command("ATSH7A0") == "");
+  merged = link.command("22C00B");
+  CHECK(merged.compare(0, 6, "7F2278") == 0);
+  CHECK(matchesScript(merged.substr(6), "22C00B"));
+
+  // Unknown request: negative response, lost request: NO DATA after ATST
+  CHECK(link.command("22C00C") == "7F2231");
+  CHECK(link.command("ATSH7C6") == "");
+  CHECK(link.command("22B002") == "NO DATA");
+
+  CHECK(link.prompts == 13);
+  CHECK(link.rows.overflows() == 0);
+}
+
+int main()
+{
+  testRowSplitting();
+  testElmSession(Elm327Sim::kDefaultMtuPayload, 0);
+  testElmSession(Elm327Sim::kDefaultMtuPayload, 60);
+  testElmSession(1, 0);
+  testElmSession(61, 30);
+  return TEST_RESULT("ElmResponseMerger");
+}
@@ -0,0 +1,232 @@
+/**
+ * GpsBinaryParser: UBX NAV-PVT and CASIC NAV-PV byte streams, checksum
+ * failures and resync after garbage or lost bytes.
+ */
+#include "GpsBinaryParser.h"
+#include "test.h"
+#include <math.h>
+#include <string.h>
+
+static void putU2(uint8_t *p, uint16_t v)
+{
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+static void putU4(uint8_t *p, uint32_t v)
+{
+  for (uint8_t i = 0; i < 4; i++)
+    p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+static void putR4(uint8_t *p, float v)
+{
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  putU4(p, bits);
+}
+
+static void putR8(uint8_t *p, double v)
+{
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  putU4(p, uint32_t(bits));
+  putU4(p + 4, uint32_t(bits >> 32));
+}
+
+// B5 62 class id len payload ckA ckB, returns frame length
+static size_t ubxFrame(uint8_t *out, uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t length)
+{
+  out[0] = 0xB5;
+  out[1] = 0x62;
+  out[2] = msgClass;
+  out[3] = msgId;
+  putU2(out + 4, length);
+  memcpy(out + 6, payload, length);
+  GpsBinaryParser::ubxChecksum(out + 2, length + 4, out[6 + length], out[7 + length]);
+  return length + 8;
+}
+
+// BA CE len class id payload sum32, returns frame length
+static size_t casicFrame(uint8_t *out, uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t length)
+{
+  out[0] = 0xBA;
+  out[1] = 0xCE;
+  putU2(out + 2, length);
+  out[4] = msgClass;
+  out[5] = msgId;
+  memcpy(out + 6, payload, length);
+  uint32_t sum = uint32_t(length) | (uint32_t(msgClass) << 16) | (uint32_t(msgId) << 24);
+  for (uint16_t i = 0; i + 3 < length; i += 4)
+    sum += uint32_t(payload[i]) | (uint32_t(payload[i + 1]) << 8) | (uint32_t(payload[i + 2]) << 16) | (uint32_t(payload[i + 3]) << 24);
+  putU4(out + 6 + length, sum);
+  return length + 10;
+}
+
+static size_t navPvt(uint8_t *out, int32_t latE7, int32_t lonE7, int32_t speedMms, uint8_t sat, bool fixOk)
+{
+  uint8_t p[92] = {};
+  putU2(p + 4, 2026);
+  p[6] = 6;
+  p[7] = 15;
+  p[8] = 10;
+  p[9] = 15;
+  p[10] = 30;
+  p[11] = 0x07; // validDate, validTime, fullyResolved
+  p[20] = fixOk ? 3 : 0;
+  p[21] = fixOk ? 0x01 : 0x00;
+  p[23] = sat;
+  putU4(p + 24, uint32_t(lonE7));
+  putU4(p + 28, uint32_t(latE7));
+  putU4(p + 36, 152300); // hMSL mm
+  putU4(p + 60, uint32_t(speedMms));
+  putU4(p + 64, 9012345); // heading 1e-5 deg
+  return ubxFrame(out, 0x01, 0x07, p, sizeof(p));
+}
+
+static size_t navPv(uint8_t *out, double lat, double lon, float speedMs, uint8_t sat, uint8_t posValid)
+{
+  uint8_t p[80] = {};
+  p[4] = posValid;
+  p[5] = posValid;
+  p[7] = sat;
+  putR8(p + 16, lon);
+  putR8(p + 24, lat);
+  putR4(p + 32, 210.5f);
+  putR4(p + 64, speedMs);
+  putR4(p + 68, 270.0f);
+  return casicFrame(out, 0x01, 0x03, p, sizeof(p));
+}
+
+// Feeds bytes, returns number of completed navigation messages
+static uint32_t feed(GpsBinaryParser &parser, const uint8_t *data, size_t length)
+{
+  uint32_t navs = 0;
+  for (size_t i = 0; i < length; i++)
+  {
+    if (parser.encode(data[i]))
+      navs++;
+  }
+  return navs;
+}
+
+static void testUbxNavPvt()
+{
+  GpsBinaryParser parser;
+  uint8_t frame[128];
+  const size_t length = navPvt(frame, 481234567, 171234567, 13889, 14, true);
+  CHECK(length == 100);
+  CHECK(feed(parser, frame, length - 1) == 0); // nothing before the last checksum byte
+  CHECK(feed(parser, frame + length - 1, 1) == 1);
+
+  const GpsBinaryParser::Nav &nav = parser.nav();
+  CHECK(nav.positionValid && nav.speedValid);
+  CHECK(fabs(nav.lat - 48.1234567) < 1e-9);
+  CHECK(fabs(nav.lon - 17.1234567) < 1e-9);
+  CHECK(fabs(nav.altM - 152.3f) < 0.001f);
+  CHECK(fabs(nav.speedKmh - 50.0f) < 0.01f);
+  CHECK(fabs(nav.courseDeg - 90.12345f) < 0.001f);
+  CHECK(nav.sat == 14);
+  CHECK(nav.dateTimeValid && nav.year == 2026 && nav.month == 6 && nav.day == 15);
+  CHECK(nav.hour == 10 && nav.minute == 15 && nav.second == 30);
+  CHECK(parser.frameCount() == 1 && parser.checksumErrors() == 0);
+
+  // No fix: decoded, but position and speed flagged invalid
+  const size_t noFix = navPvt(frame, 0, 0, 0, 2, false);
+  CHECK(feed(parser, frame, noFix) == 1);
+  CHECK(!parser.nav().positionValid && !parser.nav().speedValid && parser.nav().sat == 2);
+}
+
+static void testCasicNavPv()
+{
+  GpsBinaryParser parser;
+  uint8_t frame[128];
+  const size_t length = navPv(frame, -33.8688, 151.2093, 25.0f, 11, 7);
+  CHECK(length == 90);
+  CHECK(feed(parser, frame, length) == 1);
+
+  const GpsBinaryParser::Nav &nav = parser.nav();
+  CHECK(nav.positionValid && nav.speedValid);
+  CHECK(nav.lat == -33.8688 && nav.lon == 151.2093);
+  CHECK(fabs(nav.altM - 210.5f) < 0.001f);
+  CHECK(fabs(nav.speedKmh - 90.0f) < 0.001f);
+  CHECK(nav.courseDeg == 270.0f);
+  CHECK(nav.sat == 11);
+  CHECK(!nav.dateTimeValid); // NAV-PV has no date/time, NMEA RMC provides it
+
+  const size_t invalid = navPv(frame, 0, 0, 0, 0, 1);
+  CHECK(feed(parser, frame, invalid) == 1);
+  CHECK(!parser.nav().positionValid && !parser.nav().speedValid);
+}
+
+static void testChecksumAndResync()
+{
+  GpsBinaryParser parser;
+  uint8_t stream[1024];
+  uint8_t frame[128];
+  size_t pos = 0;
+
+  // NMEA text and stray sync bytes before the first frame
+  const char *nmea = "$GNRMC,101530.00,A,,,,,,,150626,,,N*00\r\n\xB5\xB5\xBA\x01";
+  memcpy(stream + pos, nmea, strlen(nmea));
+  pos += strlen(nmea);
+  pos += navPvt(stream + pos, 100000000, 200000000, 1000, 8, true);
+
+  // Corrupted UBX payload and corrupted CASIC checksum
+  size_t length = navPvt(frame, 300000000, 200000000, 1000, 8, true);
+  frame[30] ^= 0x01;
+  memcpy(stream + pos, frame, length);
+  pos += length;
+  length = navPv(frame, 30.0, 20.0, 1.0f, 8, 7);
+  frame[length - 1] ^= 0x80;
+  memcpy(stream + pos, frame, length);
+  pos += length;
+
+  // Declared length over the buffer (garbage header): dropped at the header
+  const uint8_t bogus[] = {0xB5, 0x62, 0x01, 0x07, 0xFF, 0x7F};
+  memcpy(stream + pos, bogus, sizeof(bogus));
+  pos += sizeof(bogus);
+
+  // Other classes are checked and skipped (ACK-ACK)
+  const uint8_t ack[] = {0x06, 0x01};
+  pos += ubxFrame(stream + pos, 0x05, 0x01, ack, sizeof(ack));
+
+  pos += navPv(stream + pos, 40.0, 20.0, 2.0f, 9, 7);
+  CHECK(pos < sizeof(stream));
+
+  CHECK(feed(parser, stream, pos) == 2);
+  CHECK(parser.checksumErrors() == 2);
+  CHECK(parser.frameCount() == 3); // NAV-PVT, ACK, NAV-PV
+  CHECK(parser.nav().lat == 40.0 && parser.nav().sat == 9);
+}
+
+static void testLostBytes()
+{
+  // UART overrun drops the middle of a frame: the following frame is swallowed
+  // as payload and fails the checksum, the next two decode again
+  GpsBinaryParser parser;
+  uint8_t stream[512];
+  size_t pos = 0;
+  uint8_t frame[128];
+  const size_t length = navPvt(frame, 100000000, 200000000, 1000, 8, true);
+  memcpy(stream, frame, 40);
+  pos = 40;
+  pos += navPvt(stream + pos, 110000000, 200000000, 1000, 8, true);
+  pos += navPvt(stream + pos, 120000000, 200000000, 1000, 8, true);
+  pos += navPvt(stream + pos, 130000000, 200000000, 1000, 8, true);
+  CHECK(length == 100);
+
+  const uint32_t navs = feed(parser, stream, pos);
+  CHECK(navs == 2);
+  CHECK(parser.checksumErrors() == 1);
+  CHECK(fabs(parser.nav().lat - 13.0) < 1e-9);
+}
+
+int main()
+{
+  testUbxNavPvt();
+  testCasicNavPv();
+  testChecksumAndResync();
+  testLostBytes();
+  return TEST_RESULT("GpsBinaryParser");
+}
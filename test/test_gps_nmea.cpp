@@ -0,0 +1,200 @@
+/**
+ * GpsNmeaParser: 10 Hz GGA+RMC replay at 115200 baud, one fix per epoch
+ * stamped with the arrival of its completing sentence.
+ */
+#include "GpsNmeaParser.h"
+#include "test.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const int64_t kByteUs = 87; // 115200 baud, 10 bits per byte
+
+struct Replay
+{
+  GpsNmeaParser parser;
+  int64_t nowUs = 0;
+  int64_t lastEndUs = 0; // arrival of the last '\r'
+  uint32_t fixes = 0;
+  GpsFix last = {};
+  int64_t fixUs[64] = {};
+
+  // Wraps body into $...*CS\r\n and feeds it byte by byte
+  void sentence(const char *body, bool corrupt = false)
+  {
+    uint8_t checksum = 0;
+    for (const char *p = body; *p != '\0'; p++)
+      checksum ^= uint8_t(*p);
+    char line[128];
+    snprintf(line, sizeof(line), "$%s*%02X\r\n", body, corrupt ? uint8_t(checksum ^ 0x10) : checksum);
+    for (const char *p = line; *p != '\0'; p++)
+    {
+      nowUs += kByteUs;
+      if (*p == '\r')
+        lastEndUs = nowUs;
+      if (parser.encode(*p, nowUs))
+      {
+        last = parser.fix();
+        if (fixes < 64)
+          fixUs[fixes] = last.arrivalUs;
+        fixes++;
+      }
+    }
+  }
+};
+
+static void epochTime(uint32_t epoch, char *out, size_t size)
+{
+  const uint32_t tenths = 12 * 36000 + epoch; // from 12:00:00.0
+  snprintf(out, size, "%02u%02u%02u.%02u", tenths / 36000, (tenths / 600) % 60, (tenths / 10) % 60, (tenths % 10) * 10);
+}
+
+static void testTenHzReplay()
+{
+  Replay replay;
+  const uint32_t epochs = 50;
+  int64_t rmcEnd[epochs];
+  for (uint32_t epoch = 0; epoch < epochs; epoch++)
+  {
+    replay.nowUs = int64_t(epoch) * 100000;
+    char time[16];
+    epochTime(epoch, time, sizeof(time));
+    const float knots = 27.0f + epoch * 0.1f;
+    char body[100];
+    snprintf(body, sizeof(body), "GNGGA,%s,4807.%04u,N,01131.0000,E,1,09,0.9,545.4,M,46.9,M,,", time, 1000 + epoch);
+    replay.sentence(body);
+    CHECK(replay.fixes == epoch); // GGA alone does not complete the epoch
+    snprintf(body, sizeof(body), "GNRMC,%s,A,4807.%04u,N,01131.0000,E,%.1f,84.4,230326,,,A", time, 1000 + epoch, knots);
+    replay.sentence(body);
+    rmcEnd[epoch] = replay.lastEndUs;
+    CHECK(replay.fixes == epoch + 1);
+  }
+
+  CHECK(replay.fixes == epochs);
+  CHECK(replay.parser.checksumErrors() == 0);
+  CHECK(replay.parser.sentenceCount() == 2 * epochs);
+  for (uint32_t epoch = 0; epoch < epochs; epoch++)
+  {
+    CHECK(replay.fixUs[epoch] == rmcEnd[epoch]);
+    if (epoch > 0)
+      CHECK(replay.fixUs[epoch] - replay.fixUs[epoch - 1] == 100000);
+  }
+
+  const GpsFix &fix = replay.last;
+  CHECK(fix.locationValid);
+  CHECK(fabs(fix.lat - (48.0 + 7.1049 / 60.0)) < 1e-9);
+  CHECK(fabs(fix.lon - (11.0 + 31.0 / 60.0)) < 1e-9);
+  CHECK(fabs(fix.altM - 545.4f) < 0.01f);
+  CHECK(fix.satValid && fix.sat == 9);
+  CHECK(fix.speedValid && fabs(fix.speedKmh - 31.9f * 1.852f) < 0.01f);
+  CHECK(fix.courseValid && fabs(fix.courseDeg - 84.4f) < 0.01f);
+  CHECK(fix.dateTimeValid);
+  CHECK(fix.year == 2026 && fix.month == 3 && fix.day == 23);
+  CHECK(fix.hour == 12 && fix.minute == 0 && fix.second == 4);
+}
+
+static void testRmcOnly()
+{
+  // Module with GGA off: each epoch closes when the next one starts
+  Replay replay;
+  int64_t ends[3];
+  const char *times[3] = {"083559.00", "083559.20", "083559.40"};
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    char body[100];
+    snprintf(body, sizeof(body), "GPRMC,%s,A,4717.11437,S,00833.91522,W,0.004,77.52,091202,,,A", times[i]);
+    replay.sentence(body);
+    ends[i] = replay.lastEndUs;
+    CHECK(replay.fixes == i);
+  }
+  CHECK(replay.fixUs[0] == ends[0]);
+  CHECK(replay.fixUs[1] == ends[1]);
+  CHECK(replay.last.lat < -47.28 && replay.last.lat > -47.29);
+  CHECK(replay.last.lon < -8.56 && replay.last.lon > -8.57);
+  CHECK(!replay.last.satValid);
+  CHECK(replay.last.year == 2002 && replay.last.month == 12 && replay.last.day == 9);
+}
+
+static void testInvalidAndCorrupt()
+{
+  Replay replay;
+  // No fix yet: time only, location stays invalid
+  replay.sentence("GPGGA,120000.00,,,,,0,00,99.9,,,,,,");
+  replay.sentence("GPRMC,120000.00,V,,,,,,,010126,,,N");
+  CHECK(replay.fixes == 1);
+  CHECK(!replay.last.locationValid && !replay.last.speedValid);
+  CHECK(replay.last.satValid && replay.last.sat == 0);
+  CHECK(replay.last.dateTimeValid && replay.last.year == 2026);
+
+  // Fix acquired
+  replay.sentence("GPGGA,120001.00,5000.0000,N,01400.0000,E,1,05,1.2,300.0,M,,,,");
+  replay.sentence("GPRMC,120001.00,A,5000.0000,N,01400.0000,E,10.0,90.0,010126,,,A");
+  CHECK(replay.fixes == 2 && replay.last.locationValid && replay.last.lat == 50.0);
+
+  // Corrupted GGA is dropped, RMC alone completes on the next epoch
+  replay.sentence("GPGGA,120002.00,5100.0000,N,01400.0000,E,1,05,1.2,300.0,M,,,,", true);
+  CHECK(replay.parser.checksumErrors() == 1);
+  replay.sentence("GPRMC,120002.00,A,5000.0100,N,01400.0000,E,10.0,90.0,010126,,,A");
+  CHECK(replay.fixes == 2);
+  replay.sentence("GPGGA,120003.00,5000.0200,N,01400.0000,E,1,06,1.2,301.0,M,,,,");
+  CHECK(replay.fixes == 3);
+  CHECK(replay.last.second == 2 && fabs(replay.last.lat - (50.0 + 0.01 / 60.0)) < 1e-9);
+  CHECK(replay.last.sat == 5); // sticky until the next GGA
+
+  // Lost fix: last location sticks, like TinyGPS++
+  replay.sentence("GPRMC,120003.00,V,,,,,,,010126,,,N");
+  CHECK(replay.fixes == 4);
+  CHECK(replay.last.locationValid && fabs(replay.last.lat - (50.0 + 0.02 / 60.0)) < 1e-9);
+  CHECK(replay.last.sat == 6);
+
+  // Garbage, missing checksum and overlong lines are skipped
+  const char *noise = "\xB5\x62\x01\x07 $GPGGA,1200 no checksum\r\n";
+  for (const char *p = noise; *p != '\0'; p++)
+    replay.parser.encode(*p, 0);
+  char longLine[200];
+  memset(longLine, 'X', sizeof(longLine) - 1);
+  longLine[0] = '$';
+  longLine[sizeof(longLine) - 1] = '\0';
+  for (const char *p = longLine; *p != '\0'; p++)
+    replay.parser.encode(*p, 0);
+  replay.parser.encode('\r', 0);
+  CHECK(replay.parser.checksumErrors() == 2);
+  CHECK(replay.parser.fixCount() == 4);
+}
+
+static void testBinaryFixDate()
+{
+  GpsNmeaParser parser;
+  GpsBinaryParser::Nav nav = {};
+  nav.positionValid = true;
+  nav.lat = 48.1;
+  nav.lon = 17.1;
+  nav.sat = 12;
+  nav.speedValid = true;
+  nav.speedKmh = 50.0f;
+  GpsFix fix = parser.binaryFix(nav, 1234);
+  CHECK(fix.arrivalUs == 1234 && fix.locationValid && fix.sat == 12 && !fix.dateTimeValid);
+
+  // CASIC NAV-PV has no date/time: taken from the 1 Hz RMC
+  const char *rmc = "$GNRMC,101530.00,A,4806.0000,N,01706.0000,E,27.0,0.0,150626,,,A*";
+  uint8_t checksum = 0;
+  for (const char *p = rmc + 1; *p != '*'; p++)
+    checksum ^= uint8_t(*p);
+  char line[100];
+  snprintf(line, sizeof(line), "%s%02X\r\n", rmc, checksum);
+  for (const char *p = line; *p != '\0'; p++)
+    parser.encode(*p, 0);
+  fix = parser.binaryFix(nav, 5678);
+  CHECK(fix.dateTimeValid && fix.year == 2026 && fix.month == 6 && fix.day == 15);
+  CHECK(fix.hour == 10 && fix.minute == 15 && fix.second == 30);
+  CHECK(fix.lat == 48.1); // position still from NAV
+}
+
+int main()
+{
+  testTenHzReplay();
+  testRmcOnly();
+  testInvalidAndCorrupt();
+  testBinaryFixDate();
+  return TEST_RESULT("GpsNmeaParser");
+}
@@ -0,0 +1,148 @@
+/**
+ * IsoTpReassembler: in order, out of order, missing, duplicate and wrapping sequence numbers.
+ */
+#include "IsoTpReassembler.h"
+#include "test.h"
+#include <string.h>
+
+static IsoTpReassembler isoTp;
+static uint8_t message[IsoTpReassembler::kMaxLength];
+
+static void fillMessage(uint16_t length)
+{
+  for (uint16_t i = 0; i < length; i++)
+    message[i] = uint8_t(i * 7 + 3);
+}
+
+// First frame with 6 payload bytes, consecutive frames with 7 (classic CAN)
+static IsoTpReassembler::Result sendFirst(uint16_t length)
+{
+  return isoTp.first(length, message, 6);
+}
+
+static IsoTpReassembler::Result sendFrame(uint16_t frame)
+{
+  const uint16_t offset = 6 + (frame - 1) * 7;
+  return isoTp.consecutive(frame & 0x0F, message + offset, 7);
+}
+
+static void testSingle()
+{
+  const uint8_t data[] = {0x62, 0x01, 0x01, 0xAA};
+  CHECK(isoTp.single(data, sizeof(data)) == IsoTpReassembler::ISOTP_COMPLETE);
+  CHECK(isoTp.complete());
+  CHECK(isoTp.length() == sizeof(data));
+  CHECK(memcmp(isoTp.data(), data, sizeof(data)) == 0);
+  CHECK(isoTp.consecutive(1, data, 4) == IsoTpReassembler::ISOTP_IDLE);
+}
+
+static void testInOrder()
+{
+  fillMessage(62); // 1 first + 8 consecutive frames, last one padded
+  CHECK(sendFirst(62) == IsoTpReassembler::ISOTP_PENDING);
+  for (uint16_t frame = 1; frame < 8; frame++)
+    CHECK(sendFrame(frame) == IsoTpReassembler::ISOTP_PENDING);
+  CHECK(isoTp.remaining() == 7);
+  CHECK(sendFrame(8) == IsoTpReassembler::ISOTP_COMPLETE);
+  CHECK(isoTp.remaining() == 0);
+  CHECK(memcmp(isoTp.data(), message, 62) == 0);
+}
+
+static void testOutOfOrder()
+{
+  fillMessage(62);
+  const uint32_t gapsBefore = isoTp.gaps();
+  sendFirst(62);
+  const uint16_t order[] = {1, 3, 2, 4, 6, 5, 8, 7};
+  IsoTpReassembler::Result result = IsoTpReassembler::ISOTP_PENDING;
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    CHECK(result == IsoTpReassembler::ISOTP_PENDING);
+    result = sendFrame(order[i]);
+  }
+  CHECK(result == IsoTpReassembler::ISOTP_COMPLETE);
+  CHECK(memcmp(isoTp.data(), message, 62) == 0);
+  CHECK(isoTp.gaps() - gapsBefore == 3); // 3, 6 and 8 arrived early
+}
+
+static void testMissingAndDuplicate()
+{
+  fillMessage(62);
+  sendFirst(62);
+  sendFrame(1);
+  sendFrame(2);
+  sendFrame(4);
+  CHECK(isoTp.missingFrames() == 5);
+  const uint32_t duplicatesBefore = isoTp.duplicates();
+  CHECK(sendFrame(2) == IsoTpReassembler::ISOTP_DUPLICATE);
+  CHECK(isoTp.duplicates() - duplicatesBefore == 1);
+  CHECK(isoTp.missingFrames() == 5);
+  CHECK(!isoTp.complete());
+
+  // A new first frame drops the incomplete message
+  sendFirst(20);
+  CHECK(isoTp.missingFrames() == 2);
+}
+
+static void testWraparound()
+{
+  // 1 first + 40 consecutive frames: sequence numbers wrap twice
+  const uint16_t length = 6 + 40 * 7;
+  fillMessage(length);
+  sendFirst(length);
+  for (uint16_t frame = 1; frame <= 40; frame++)
+  {
+    if (frame == 17)
+      continue; // sequence 1 of the second cycle, sent late
+    CHECK(sendFrame(frame) == ((frame == 40) ? IsoTpReassembler::ISOTP_COMPLETE : IsoTpReassembler::ISOTP_PENDING));
+    if (frame == 20)
+    {
+      // 4 frames late, within the -8 .. 7 window around the next expected frame (21)
+      CHECK(sendFrame(17) == IsoTpReassembler::ISOTP_PENDING);
+    }
+  }
+  CHECK(isoTp.complete());
+  CHECK(memcmp(isoTp.data(), message, length) == 0);
+
+  // 9 frames late the same sequence number means frame 33, frame 17 stays missing
+  sendFirst(length);
+  for (uint16_t frame = 1; frame <= 25; frame++)
+  {
+    if (frame != 17)
+      sendFrame(frame);
+  }
+  CHECK(isoTp.missingFrames() == 16);
+  CHECK(sendFrame(17) == IsoTpReassembler::ISOTP_PENDING);
+  CHECK(isoTp.missingFrames() == 15);
+  for (uint16_t frame = 26; frame <= 40; frame++)
+    CHECK(sendFrame(frame) == ((frame == 33) ? IsoTpReassembler::ISOTP_DUPLICATE : IsoTpReassembler::ISOTP_PENDING));
+  CHECK(isoTp.missingFrames() == 1);
+  CHECK(!isoTp.complete());
+
+  // Beyond the last frame of the message
+  CHECK(isoTp.consecutive(0, message, 7) == IsoTpReassembler::ISOTP_OUT_OF_WINDOW);
+}
+
+static void testLengthLimit()
+{
+  fillMessage(IsoTpReassembler::kMaxLength);
+  CHECK(isoTp.first(5000, message, 6) == IsoTpReassembler::ISOTP_PENDING);
+  CHECK(isoTp.length() == IsoTpReassembler::kMaxLength);
+  uint16_t frame = 1;
+  IsoTpReassembler::Result result = IsoTpReassembler::ISOTP_PENDING;
+  while (result == IsoTpReassembler::ISOTP_PENDING && frame < IsoTpReassembler::kMaxFrames)
+    result = sendFrame(frame++);
+  CHECK(result == IsoTpReassembler::ISOTP_COMPLETE);
+  CHECK(memcmp(isoTp.data(), message, IsoTpReassembler::kMaxLength) == 0);
+}
+
+int main()
+{
+  testSingle();
+  testInOrder();
+  testOutOfOrder();
+  testMissingAndDuplicate();
+  testWraparound();
+  testLengthLimit();
+  return TEST_RESULT("IsoTpReassembler");
+}
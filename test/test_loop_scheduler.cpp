@@ -0,0 +1,133 @@
+/**
+ * LoopScheduler: priority order, periods, critical re-runs, budget deferral and histograms.
+ */
+#include "LoopScheduler.h"
+#include "test.h"
+#include <string.h>
+
+static int64_t clockUs = 0;
+static int64_t fakeClock()
+{
+  return clockUs;
+}
+
+struct FakeTask
+{
+  char id;
+  uint32_t durationUs;
+};
+
+static char runLog[64];
+static uint8_t runLogLength = 0;
+
+static void fakeTask(void *context)
+{
+  FakeTask *task = static_cast<FakeTask *>(context);
+  if (runLogLength < sizeof(runLog) - 1)
+    runLog[runLogLength++] = task->id;
+  runLog[runLogLength] = '\0';
+  clockUs += task->durationUs;
+}
+
+static void runLoop(LoopScheduler &scheduler, uint32_t nowMs)
+{
+  runLogLength = 0;
+  runLog[0] = '\0';
+  clockUs = int64_t(nowMs) * 1000;
+  scheduler.run(nowMs);
+}
+
+static void testOrderAndCritical()
+{
+  FakeTask comm = {'C', 100}, input = {'I', 100}, display = {'D', 100}, net = {'N', 100};
+  LoopScheduler scheduler(fakeClock);
+  // Added out of order, run by priority
+  CHECK(scheduler.addTask("NET", fakeTask, &net, 70, 0, 50));
+  CHECK(scheduler.addTask("DISPLAY", fakeTask, &display, 50, 0, 40));
+  CHECK(scheduler.addTask("COMM", fakeTask, &comm, 0, 0, 20, true));
+  CHECK(scheduler.addTask("INPUT", fakeTask, &input, 10, 0, 30, false, true));
+  CHECK(!scheduler.addTask("NULL", nullptr, nullptr, 5, 0, 0));
+  CHECK(scheduler.taskCount() == 4);
+  CHECK(strcmp(scheduler.task(0).name, "COMM") == 0);
+  CHECK(strcmp(scheduler.task(3).name, "NET") == 0);
+
+  runLoop(scheduler, 0);
+  // COMM first and again before every task after the first one
+  CHECK(strcmp(runLog, "CICDCN") == 0);
+  CHECK(scheduler.task(0).runs == 3);
+}
+
+static void testPeriod()
+{
+  FakeTask sd = {'S', 100}, gps = {'G', 100};
+  LoopScheduler scheduler(fakeClock);
+  scheduler.addTask("GPS", fakeTask, &gps, 40, 0, 5);
+  scheduler.addTask("SDCARD", fakeTask, &sd, 60, 100, 30);
+  runLoop(scheduler, 1000);
+  CHECK(strcmp(runLog, "GS") == 0); // first run always due
+  runLoop(scheduler, 1050);
+  CHECK(strcmp(runLog, "G") == 0);
+  runLoop(scheduler, 1100);
+  CHECK(strcmp(runLog, "GS") == 0);
+}
+
+static void testBudgetDeferral()
+{
+  FakeTask comm = {'C', 1000}, input = {'I', 100}, power = {'P', 100}, display = {'D', 70000}, sd = {'S', 100}, net = {'N', 100};
+  LoopScheduler scheduler(fakeClock);
+  scheduler.addTask("COMM", fakeTask, &comm, 0, 0, 20, true);
+  scheduler.addTask("DISPLAY", fakeTask, &display, 5, 0, 40); // slow redraw before input/power
+  scheduler.addTask("INPUT", fakeTask, &input, 10, 0, 30, false, true);
+  scheduler.addTask("POWER", fakeTask, &power, 20, 0, 10, false, true);
+  scheduler.addTask("SDCARD", fakeTask, &sd, 60, 0, 30);
+  scheduler.addTask("NET", fakeTask, &net, 70, 0, 50);
+
+  // Over budget after DISPLAY: INPUT/POWER still run, SD and NET move to the next loop
+  runLoop(scheduler, 0);
+  CHECK(strcmp(runLog, "CDCICP") == 0);
+  CHECK(scheduler.task(4).deferred == 1 && scheduler.task(5).deferred == 1);
+  CHECK(scheduler.task(1).overruns == 1);
+  CHECK(scheduler.loopOverruns() == 1);
+
+  // Over budget again: deferred tasks are not deferred twice in a row
+  runLoop(scheduler, 20);
+  CHECK(strcmp(runLog, "CDCICPCSCN") == 0);
+  CHECK(scheduler.task(4).deferred == 1 && scheduler.task(4).runs == 1);
+  CHECK(scheduler.task(2).deferred == 0 && scheduler.task(3).deferred == 0);
+
+  // Within budget: everything runs
+  display.durationUs = 1000;
+  runLoop(scheduler, 40);
+  CHECK(strcmp(runLog, "CDCICPCSCN") == 0);
+  CHECK(scheduler.loopOverruns() == 2);
+}
+
+static void testHistogram()
+{
+  CHECK(LoopScheduler::histogramBin(0) == 0);
+  CHECK(LoopScheduler::histogramBin(999) == 0);
+  CHECK(LoopScheduler::histogramBin(1000) == 1);
+  CHECK(LoopScheduler::histogramBin(49999) == 5);
+  CHECK(LoopScheduler::histogramBin(100000) == LoopScheduler::kHistogramBins - 1);
+
+  FakeTask task = {'T', 3000};
+  LoopScheduler scheduler(fakeClock);
+  scheduler.addTask("T", fakeTask, &task, 0, 0, 2);
+  runLoop(scheduler, 0);
+  task.durationUs = 500;
+  runLoop(scheduler, 10);
+  CHECK(scheduler.task(0).histogram[2] == 1 && scheduler.task(0).histogram[0] == 1);
+  CHECK(scheduler.task(0).maxUs == 3000 && scheduler.task(0).lastUs == 500);
+  CHECK(scheduler.task(0).overruns == 1);
+  CHECK(scheduler.loopMaxUs() == 3000 && scheduler.loopLastUs() == 500);
+  CHECK(scheduler.loopHistogram()[2] == 1);
+}
+
+int main()
+{
+  testOrderAndCritical();
+  testPeriod();
+  testBudgetDeferral();
+  testHistogram();
+  return TEST_RESULT("LoopScheduler");
+}
@@ -0,0 +1,87 @@
+/**
+ * MemStats accounting and the loop allocation budget. Built with
+ * EVDASH_MEM_BUDGET_STRICT (see Makefile): an overrun aborts, checked in a
+ * forked child.
+ */
+#include "MemStats.h"
+#include "test.h"
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static void testTaggedAllocs()
+{
+  void *a = memTaggedMalloc(MEM_TAG_JSON, 1000, 0);
+  void *b = memTaggedMalloc(MEM_TAG_JSON, 500, 0);
+  CHECK(a != nullptr && b != nullptr);
+  CHECK((reinterpret_cast<uintptr_t>(a) & 7) == 0);
+  MemTagStats stats = memTagStats(MEM_TAG_JSON);
+  CHECK(stats.currentBytes == 1500 && stats.peakBytes == 1500 && stats.allocs == 2);
+
+  // Realloc moves the size, frees need no size from the caller
+  a = memTaggedRealloc(MEM_TAG_JSON, a, 3000, 0);
+  CHECK(a != nullptr);
+  stats = memTagStats(MEM_TAG_JSON);
+  CHECK(stats.currentBytes == 3500 && stats.peakBytes == 3500 && stats.allocs == 3);
+  memTaggedFree(MEM_TAG_JSON, a);
+  memTaggedFree(MEM_TAG_JSON, b);
+  memTaggedFree(MEM_TAG_JSON, nullptr);
+  stats = memTagStats(MEM_TAG_JSON);
+  CHECK(stats.currentBytes == 0 && stats.peakBytes == 3500);
+
+  // Long lived buffers: growth counts as an allocation, shrinking does not
+  memTrackSet(MEM_TAG_HISTORY, 64000);
+  memTrackSet(MEM_TAG_HISTORY, 32000);
+  stats = memTagStats(MEM_TAG_HISTORY);
+  CHECK(stats.currentBytes == 32000 && stats.peakBytes == 64000 && stats.allocs == 1);
+  CHECK(memTagStats(MEM_TAG_TLS).allocs == 0);
+
+  // Rate over the elapsed time since the last tick
+  memTrackTick(1000);
+  for (uint8_t i = 0; i < 10; i++)
+    memTaggedFree(MEM_TAG_UPLOAD, memTaggedMalloc(MEM_TAG_UPLOAD, 16, 0));
+  memTrackTick(1500); // under a second: no update
+  CHECK(memTagStats(MEM_TAG_UPLOAD).allocsPerSec == 0);
+  memTrackTick(3000);
+  CHECK(memTagStats(MEM_TAG_UPLOAD).allocsPerSec == 5);
+}
+
+// Runs one main loop with the given number of tagged allocations in a child process
+static int loopInChild(uint16_t allocs)
+{
+  fflush(stdout);
+  const pid_t pid = fork();
+  if (pid == 0)
+  {
+    memLoopBegin();
+    for (uint16_t i = 0; i < allocs; i++)
+      memTaggedFree(MEM_TAG_MENU, memTaggedMalloc(MEM_TAG_MENU, 32, 0));
+    memLoopEnd();
+    _exit(0);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return status;
+}
+
+static void testLoopBudget()
+{
+  memLoopBegin();
+  for (uint16_t i = 0; i < kMemLoopAllocBudget; i++)
+    memTaggedFree(MEM_TAG_MENU, memTaggedMalloc(MEM_TAG_MENU, 32, 0));
+  memLoopEnd();
+  CHECK(memLoopAllocsMax() == kMemLoopAllocBudget);
+  CHECK(memLoopBudgetOverruns() == 0);
+
+  int status = loopInChild(kMemLoopAllocBudget);
+  CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  status = loopInChild(kMemLoopAllocBudget + 1);
+  CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+}
+
+int main()
+{
+  testTaggedAllocs();
+  testLoopBudget();
+  return TEST_RESULT("MemStats");
+}
@@ -0,0 +1,298 @@
+/**
+ * PowerStateMachine driven by recorded main loop traces: INA3221 voltage and
+ * current, GPS/gyro motion and CAN activity, one row per loop pass.
+ */
+#include "PowerState.h"
+#include "test.h"
+
+struct TraceRow
+{
+  uint32_t sec;
+  float auxVoltage;
+  float currentMa; // < 0 = no INA3221 sample
+  bool ignitionOn;
+  bool charging;
+  bool gyroMotion;
+  float gpsSpeedKmh;
+  bool validResponse; // car answered since wake up
+  bool canActive;     // CAN response in this pass
+  PowerState expected;
+};
+
+/**
+ * Stand-in for Board320_240::loopPower(): feeds the machine and applies its
+ * actions to the queue flags the way LiveData does.
+ */
+struct Board
+{
+  PowerStateMachine power;
+  PowerStateMachine::Inputs inputs;
+  PowerStateMachine::Result result;
+  uint32_t millisOffset = 0;
+  uint16_t wakes = 0;
+  uint16_t stops = 0;
+  uint16_t fallbacks = 0;
+  PowerShutdown shutdown = POWER_SHUTDOWN_NONE;
+
+  Board(bool voltmeter)
+  {
+    inputs = PowerStateMachine::Inputs();
+    inputs.doorsClosed = true;
+    inputs.gpsValid = true;
+    inputs.gpsSat = 7;
+    inputs.autoStop = true;
+    inputs.voltmeter = voltmeter;
+    inputs.voltmeterCutOff = 10.5f;
+    inputs.screenOnlySleep = true;
+    inputs.sentryShutdownHrs = 72;
+    inputs.deepSleepWakeSource = true;
+  }
+
+  void step(const TraceRow &row)
+  {
+    inputs.now = row.sec;
+    inputs.auxVoltage = row.auxVoltage;
+    inputs.voltmeterRead = inputs.voltmeter;
+    inputs.ignitionOn = row.ignitionOn;
+    inputs.charging = row.charging;
+    if (row.charging)
+      inputs.lastChargingOnTime = row.sec;
+    inputs.gyroMotion = row.gyroMotion;
+    inputs.gpsSpeedKmh = row.gpsSpeedKmh;
+    inputs.validResponse = row.validResponse;
+    if (row.canActive)
+      inputs.lastCanResponseTime = row.sec;
+    if (row.currentMa >= 0)
+      power.sampleCurrent(row.currentMa);
+
+    power.update(inputs, row.sec * 1000UL + millisOffset, result);
+    if (result.continueQueue)
+    {
+      inputs.stopPendingSince = 0;
+      inputs.queueStopped = false;
+    }
+    if (result.resumeComm)
+      wakes++;
+    if (result.prepareStop && inputs.stopPendingSince == 0)
+      inputs.stopPendingSince = row.sec;
+    if (result.canFallback)
+      fallbacks++;
+    if (result.stopQueue)
+    {
+      inputs.queueStopped = true;
+      stops++;
+    }
+    if (result.shutdown != POWER_SHUTDOWN_NONE)
+      shutdown = result.shutdown;
+  }
+
+  bool replay(const TraceRow *trace, uint16_t rows)
+  {
+    bool ok = true;
+    for (uint16_t i = 0; i < rows; i++)
+    {
+      step(trace[i]);
+      if (power.state() != trace[i].expected)
+      {
+        printf("row %u at %u s: %s, expected %s\n", i, trace[i].sec, PowerStateMachine::name(power.state()),
+               PowerStateMachine::name(trace[i].expected));
+        ok = false;
+      }
+    }
+    return ok;
+  }
+};
+
+#define ROWS(trace) (sizeof(trace) / sizeof(trace[0]))
+
+// Voltmeter: drive, park with doors closed, autostop after 60 s, DC-DC voltage wakes, low AUX stops at once
+static const TraceRow kVoltageTrace[] = {
+    {10, 14.2f, 300, true, false, false, 40, true, true, POWER_ACTIVE},
+    {70, 14.1f, 320, true, false, false, 0, true, true, POWER_ACTIVE},
+    {120, 12.6f, 280, false, false, false, 0, true, true, POWER_PARKED}, // ignition off
+    {150, 12.6f, 260, false, false, false, 0, true, false, POWER_PARKED},
+    {180, 12.5f, 120, false, false, false, 0, true, false, POWER_PARKED}, // exactly 60 s, still parked
+    {181, 12.5f, 100, false, false, false, 0, true, false, POWER_SENTRY},
+    {3781, 12.4f, 100, false, false, true, 20, true, false, POWER_SENTRY}, // motion ignored with voltmeter
+    {3782, 12.4f, 100, false, false, true, 20, true, false, POWER_SENTRY},
+    {3783, 12.4f, 100, false, false, true, 20, true, false, POWER_SENTRY},
+    {3790, 14.3f, 310, false, false, false, 0, true, true, POWER_PARKED}, // DC-DC, woken, doors closed: timer again
+    {3800, 14.3f, 310, true, false, false, 0, true, true, POWER_PARKED},  // ignition on, timer keeps running
+    {3900, 10.8f, 290, false, false, false, 0, true, true, POWER_SENTRY}, // AUX under 11 V
+};
+
+static void testVoltageTrace()
+{
+  Board board(true);
+  CHECK(board.replay(kVoltageTrace, ROWS(kVoltageTrace)));
+  CHECK(board.stops == 2);
+  CHECK(board.wakes == 1);
+  CHECK(board.power.gyroWakeCount() == 0 && board.power.gpsWakeCount() == 0);
+  CHECK(board.shutdown == POWER_SHUTDOWN_NONE);
+  // ACTIVE -> PARKED at 120 s, PARKED -> SENTRY at 181 s, woken at 3790 s
+  CHECK(board.power.totalMs(POWER_ACTIVE, 3900000) == 120000);
+  CHECK(board.power.totalMs(POWER_PARKED, 3900000) == 61000 + 110000);
+  CHECK(board.power.totalMs(POWER_SENTRY, 3900000) == 3609000);
+  CHECK(board.power.transitions() == 4);
+}
+
+// Screen only sleep: INA3221 under the cut-off powers the board off
+static const TraceRow kCutOffTrace[] = {
+    {10, 12.2f, 300, false, false, false, 0, true, true, POWER_PARKED},
+    {20, 10.4f, 280, false, false, false, 0, true, true, POWER_DEEP_SLEEP},
+};
+
+static void testCutOff()
+{
+  Board board(true);
+  CHECK(board.replay(kCutOffTrace, ROWS(kCutOffTrace)));
+  CHECK(board.shutdown == POWER_SHUTDOWN_AUX_CUTOFF);
+  CHECK(board.result.transitionCount == 1);
+  CHECK(board.result.transitions[0].from == POWER_PARKED && board.result.transitions[0].durationMs == 10000);
+  CHECK(board.result.transitions[0].avgCurrentMa == 280);
+}
+
+// No voltmeter: gyro needs 3 samples in a row, GPS 2 samples of 5+ km/h; one GPS wake per session
+static const TraceRow kMotionTrace[] = {
+    {10, 0, -1, false, false, false, 0, true, true, POWER_PARKED},
+    {71, 0, -1, false, false, false, 0, true, false, POWER_SENTRY},
+    {100, 0, -1, false, false, true, 0, true, false, POWER_SENTRY},
+    {101, 0, -1, false, false, true, 0, true, false, POWER_SENTRY},
+    {102, 0, -1, false, false, false, 0, true, false, POWER_SENTRY}, // bump, not driving
+    {103, 0, -1, false, false, true, 0, true, false, POWER_SENTRY},
+    {104, 0, -1, false, false, true, 0, true, false, POWER_SENTRY},
+    {105, 0, -1, false, false, true, 0, true, false, POWER_PARKED}, // gyro wake, car still parked
+    {166, 0, -1, false, false, false, 0, true, false, POWER_SENTRY},
+    {200, 0, -1, false, false, false, 8, true, false, POWER_SENTRY},
+    {201, 0, -1, false, false, false, 8, true, false, POWER_PARKED}, // GPS wake
+    {262, 0, -1, false, false, false, 0, true, false, POWER_SENTRY},
+    {300, 0, -1, false, false, false, 8, true, false, POWER_SENTRY},
+    {301, 0, -1, false, false, false, 8, true, false, POWER_SENTRY}, // GPS wake used up
+    {302, 0, -1, false, false, false, 8, true, false, POWER_SENTRY},
+    {1202, 0, -1, false, false, false, 8, true, false, POWER_SENTRY}, // 900 s without wake re-arms
+    {1203, 0, -1, false, false, false, 8, true, false, POWER_PARKED},
+};
+
+static void testMotionTrace()
+{
+  Board board(false);
+  CHECK(board.replay(kMotionTrace, ROWS(kMotionTrace)));
+  CHECK(board.wakes == 3);
+  CHECK(board.power.gpsWakeCount() == 1 && board.power.gyroWakeCount() == 0);
+  CHECK(board.power.sentrySessionActive());
+  CHECK(!board.power.motionWakeLocked());
+
+  // Ignition ends the session; the pending stop is left to the ignition wake after it
+  const TraceRow drive = {1210, 0, -1, true, false, false, 30, true, true, POWER_PARKED};
+  board.step(drive);
+  CHECK(board.power.state() == POWER_PARKED);
+  CHECK(!board.power.sentrySessionActive());
+  CHECK(board.power.gpsWakeCount() == 0);
+}
+
+// CAN: open door keeps the queue running while CAN is fresh, then stale door state is ignored
+static const TraceRow kCanTrace[] = {
+    {10, 0, -1, false, false, false, 0, false, false, POWER_ACTIVE},
+    {150, 0, -1, false, false, false, 0, false, false, POWER_ACTIVE}, // no CAN yet, grace period
+    {181, 0, -1, false, false, false, 0, false, false, POWER_PARKED}, // fallback autostop
+    {242, 0, -1, false, false, false, 0, false, false, POWER_SENTRY},
+};
+
+static void testCanTrace()
+{
+  Board board(false);
+  CHECK(board.replay(kCanTrace, ROWS(kCanTrace)));
+  CHECK(board.fallbacks == 1);
+
+  // DC-DC voltage blocks the fallback: car may be on, the adapter is just silent
+  Board dcdc(true);
+  const TraceRow running = {200, 14.1f, 300, false, false, false, 0, false, false, POWER_ACTIVE};
+  dcdc.step(running);
+  CHECK(dcdc.power.state() == POWER_ACTIVE && dcdc.fallbacks == 0);
+
+  // Door open with fresh CAN data: stay active; 15 s without CAN the door flag is stale
+  Board doors(false);
+  doors.inputs.doorsClosed = false;
+  const TraceRow open = {10, 0, -1, false, false, false, 0, true, true, POWER_ACTIVE};
+  const TraceRow fresh = {20, 0, -1, false, false, false, 0, true, false, POWER_ACTIVE};
+  const TraceRow stale = {26, 0, -1, false, false, false, 0, true, false, POWER_PARKED};
+  doors.step(open);
+  doors.step(fresh);
+  CHECK(doors.power.state() == POWER_ACTIVE);
+  doors.step(stale);
+  CHECK(doors.power.state() == POWER_PARKED);
+}
+
+// Charging cancels a pending stop and holds the queue for 3 minutes after the charger stops
+static const TraceRow kChargingTrace[] = {
+    {10, 12.6f, 200, false, false, false, 0, true, true, POWER_PARKED},
+    {40, 13.9f, 900, false, true, false, 0, true, true, POWER_ACTIVE},
+    {1000, 13.9f, 900, false, true, false, 0, true, true, POWER_ACTIVE},
+    {1100, 13.9f, 900, false, false, false, 0, true, true, POWER_ACTIVE}, // charger paused
+    {1180, 12.9f, 200, false, false, false, 0, true, true, POWER_ACTIVE},
+    {1181, 12.9f, 200, false, false, false, 0, true, true, POWER_PARKED},
+};
+
+static void testChargingTrace()
+{
+  Board board(true);
+  CHECK(board.replay(kChargingTrace, ROWS(kChargingTrace)));
+  CHECK(board.stops == 0);
+}
+
+// Sentry long enough for the deep sleep timeout, millis() wraps on the way
+static void testSentryTimeout()
+{
+  Board board(true);
+  board.millisOffset = 4294967296UL - 200000UL;
+  const TraceRow park = {10, 12.5f, 100, false, false, false, 0, true, true, POWER_PARKED};
+  const TraceRow sentry = {71, 12.5f, 100, false, false, false, 0, true, false, POWER_SENTRY};
+  board.step(park);
+  board.step(sentry);
+  const uint32_t sentryMs = 71000UL + board.millisOffset;
+
+  TraceRow row = {71 + 71 * 3600 + 3599, 12.4f, 90, false, false, false, 0, true, false, POWER_SENTRY};
+  board.step(row);
+  CHECK(board.power.state() == POWER_SENTRY && board.shutdown == POWER_SHUTDOWN_NONE);
+  row.sec++;
+  board.step(row);
+  CHECK(board.power.state() == POWER_DEEP_SLEEP && board.shutdown == POWER_SHUTDOWN_SENTRY_TIMEOUT);
+  CHECK(board.result.transitions[0].durationMs == 72UL * 3600000UL);
+  CHECK(board.power.timeInStateMs(sentryMs + 72UL * 3600000UL) == 0);
+
+  // 0 = never
+  Board off(true);
+  off.inputs.sentryShutdownHrs = 0;
+  off.step(park);
+  off.step(sentry);
+  off.step(row);
+  CHECK(off.power.state() == POWER_SENTRY);
+}
+
+// Woken from deep sleep by CAN noise: Sentry right away and back to sleep without a car response
+static void testSnapshotWake()
+{
+  Board board(true);
+  board.inputs.snapshotWake = true;
+  const TraceRow noise = {5, 10.9f, -1, false, false, false, 0, false, false, POWER_DEEP_SLEEP};
+  board.inputs.screenOnlySleep = false; // cut-off only in screen only mode
+  board.step(noise);
+  CHECK(board.power.state() == POWER_DEEP_SLEEP);
+  CHECK(board.shutdown == POWER_SHUTDOWN_NO_CAR);
+  CHECK(board.result.transitionCount == 2);
+  CHECK(board.result.transitions[0].to == POWER_SENTRY && board.result.transitions[1].to == POWER_DEEP_SLEEP);
+  CHECK(PowerStateMachine::name(POWER_STATE_COUNT)[0] == '?');
+  CHECK(board.power.totalMs(POWER_STATE_COUNT, 1000) == 0);
+}
+
+int main()
+{
+  testVoltageTrace();
+  testCutOff();
+  testMotionTrace();
+  testCanTrace();
+  testChargingTrace();
+  testSentryTimeout();
+  testSnapshotWake();
+  return TEST_RESULT("PowerStateMachine");
+}
@@ -0,0 +1,116 @@
+/**
+ * RawFrameTable: insert, in place and moved updates, compaction and limits.
+ */
+#include "RawFrameTable.h"
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+static RawFrameTable table;
+
+static bool put(const char *key, const char *value, uint16_t latencyMs = 0)
+{
+  return table.put(key, strlen(key), value, strlen(value), latencyMs);
+}
+
+static bool frameIs(uint8_t index, const char *key, const char *value)
+{
+  const RawFrameTable::Frame frame = table.frame(index);
+  return strcmp(frame.key, key) == 0 && strcmp(frame.value, value) == 0 && frame.valueLength == strlen(value);
+}
+
+static void testInsertAndUpdate()
+{
+  table.clear();
+  CHECK(put("7E4_220101", "620101FFF", 12));
+  CHECK(put("7E4_220105", "620105AAA"));
+  CHECK(table.count() == 2);
+  CHECK(frameIs(0, "7E4_220101", "620101FFF"));
+  CHECK(table.frame(0).latencyMs == 12);
+
+  // Shorter value stays in its block
+  const uint16_t arenaUsed = table.arenaUsed();
+  CHECK(put("7E4_220101", "6201", 30));
+  CHECK(table.count() == 2);
+  CHECK(table.arenaUsed() == arenaUsed);
+  CHECK(frameIs(0, "7E4_220101", "6201"));
+  CHECK(table.frame(0).latencyMs == 30);
+
+  // Longer value moves, insertion order is kept
+  CHECK(put("7E4_220101", "620101000102030405060708090A0B0C0D0E0F"));
+  CHECK(table.arenaUsed() > arenaUsed);
+  CHECK(frameIs(0, "7E4_220101", "620101000102030405060708090A0B0C0D0E0F"));
+  CHECK(frameIs(1, "7E4_220105", "620105AAA"));
+
+  CHECK(!table.put("", 0, "62", 2, 0));
+  CHECK(!table.put("7E4_220101", 10, "", 0, 0));
+  CHECK(table.drops() == 0);
+}
+
+static void testCompaction()
+{
+  table.clear();
+  static char value[4001];
+  memset(value, 'A', sizeof(value) - 1);
+  value[sizeof(value) - 1] = '\0';
+  CHECK(put("K1", value));
+  CHECK(put("K2", value));
+  CHECK(put("K3", value));
+
+  // K1 grows into a new block and leaves its old one behind
+  static char longer[4101];
+  memset(longer, 'B', sizeof(longer) - 1);
+  longer[sizeof(longer) - 1] = '\0';
+  CHECK(put("K1", longer));
+  const uint16_t arenaWithGarbage = table.arenaUsed();
+
+  // No room for K2 to grow until that block is compacted away
+  longer[0] = 'D';
+  CHECK(put("K2", longer));
+  CHECK(table.drops() == 0);
+  CHECK(table.arenaUsed() < arenaWithGarbage + 4112);
+  longer[0] = 'B';
+  CHECK(frameIs(0, "K1", longer));
+  longer[0] = 'D';
+  CHECK(frameIs(1, "K2", longer));
+  CHECK(frameIs(2, "K3", value));
+
+  // Nothing left to compact: dropped and counted, old value kept
+  static char huge[8001];
+  memset(huge, 'C', sizeof(huge) - 1);
+  huge[sizeof(huge) - 1] = '\0';
+  CHECK(!put("K4", huge));
+  CHECK(table.drops() == 1);
+  CHECK(table.count() == 3);
+  CHECK(!put("K3", huge));
+  CHECK(table.drops() == 2);
+  CHECK(frameIs(2, "K3", value));
+}
+
+static void testTableFull()
+{
+  table.clear();
+  char key[16];
+  for (uint16_t i = 0; i < RawFrameTable::kMaxFrames; i++)
+  {
+    snprintf(key, sizeof(key), "7E4_22%04X", i);
+    CHECK(put(key, "62"));
+  }
+  CHECK(table.count() == RawFrameTable::kMaxFrames);
+  CHECK(table.maxProbe() < 16);
+  CHECK(!put("7EC_220101", "62"));
+  CHECK(table.drops() == 1);
+  CHECK(put("7E4_220000", "6200")); // updates still work
+  CHECK(frameIs(0, "7E4_220000", "6200"));
+
+  table.clear();
+  CHECK(table.count() == 0 && table.arenaUsed() == 0 && table.drops() == 0);
+}
+
+int main()
+{
+  testInsertAndUpdate();
+  testCompaction();
+  testTableFull();
+  return TEST_RESULT("RawFrameTable");
+}
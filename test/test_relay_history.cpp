@@ -0,0 +1,178 @@
+/**
+ * Relay history backfill over a BLE stand-in: chunks while connected, nothing
+ * after a disconnect, full backfill again after the app reconnects and asks.
+ */
+#include "RelayHistoryJob.h"
+#include "test.h"
+#include <math.h>
+
+static const time_t kStart = 1700000000;
+
+static void recordDrive(LiveDataHistory &history, time_t from, time_t to)
+{
+  for (time_t t = from; t < to; t++)
+  {
+    float values[HISTORY_CHANNEL_COUNT];
+    for (uint8_t ch = 0; ch < HISTORY_CHANNEL_COUNT; ch++)
+      values[ch] = NAN;
+    values[HISTORY_SPEED_KMH] = float(t % 120);
+    values[HISTORY_SOC_PERC] = 90.0f - float(t - kStart) / 600.0f;
+    history.record(t, values);
+  }
+}
+
+/**
+ * Link to the phone as seen by EvDashMobileRelay::loop(): one chunk per loop
+ * while connected, job cancelled in onDisconnect.
+ */
+struct BleStandIn
+{
+  const LiveDataHistory &history;
+  RelayHistoryJob job;
+  bool connected = false;
+  bool ended = false;
+  time_t endTo = 0;
+  uint32_t chunks = 0;
+  uint32_t points[HISTORY_CHANNEL_COUNT] = {};
+  time_t lastTime[HISTORY_CHANNEL_COUNT] = {};
+  bool ordered = true;
+
+  explicit BleStandIn(const LiveDataHistory &h) : history(h) {}
+
+  void connect()
+  {
+    connected = true;
+    ended = false;
+    chunks = 0;
+    for (uint8_t ch = 0; ch < HISTORY_CHANNEL_COUNT; ch++)
+    {
+      points[ch] = 0;
+      lastTime[ch] = 0;
+    }
+  }
+
+  void disconnect()
+  {
+    connected = false;
+    job.cancel();
+  }
+
+  bool request(time_t since, time_t now, uint16_t mask)
+  {
+    return job.start(history, since, now, mask);
+  }
+
+  void loop()
+  {
+    if (!connected || !job.active())
+      return;
+    RelayHistoryJob::Chunk chunk;
+    if (!job.next(history, chunk))
+    {
+      ended = true;
+      endTo = job.to();
+      return;
+    }
+    chunks++;
+    for (size_t i = 0; i < chunk.count; i++)
+    {
+      // Buckets arrive oldest first, no duplicates across chunks
+      if (chunk.points[i].time <= lastTime[chunk.channel])
+        ordered = false;
+      lastTime[chunk.channel] = chunk.points[i].time;
+      points[chunk.channel]++;
+    }
+  }
+};
+
+static size_t expectedPoints(const LiveDataHistory &history, uint8_t channel, uint8_t tier, time_t from, time_t to)
+{
+  static HistoryPoint all[4096];
+  return history.query(channel, tier, from, to, all, 4096);
+}
+
+static void testDisconnectReconnect(LiveDataHistory &history)
+{
+  const uint16_t mask = (1U << HISTORY_SPEED_KMH) | (1U << HISTORY_SOC_PERC) | (1U << HISTORY_OUTDOOR_C);
+  time_t now = kStart + 7200;
+  const time_t since = now - 3600;
+
+  BleStandIn link(history);
+  link.connect();
+  CHECK(link.request(since, now, mask));
+  CHECK(link.job.tier() == HISTORY_TIER_10S);
+  for (uint8_t i = 0; i < 5; i++)
+    link.loop();
+  CHECK(link.chunks == 5);
+  CHECK(link.points[HISTORY_SPEED_KMH] == 5 * RelayHistoryJob::kChunkPoints);
+  CHECK(!link.ended);
+
+  // Phone walks away: nothing more is produced, not even after the car records on
+  link.disconnect();
+  CHECK(!link.job.active());
+  recordDrive(history, now, now + 30);
+  now += 30;
+  for (uint8_t i = 0; i < 10; i++)
+    link.loop();
+  CHECK(link.chunks == 5);
+
+  // Reconnect: no backfill until the app asks again
+  link.connect();
+  link.loop();
+  CHECK(link.chunks == 0 && !link.ended);
+  CHECK(link.request(since, now, mask));
+  for (uint16_t i = 0; i < 200 && !link.ended; i++)
+    link.loop();
+  CHECK(link.ended);
+  CHECK(link.endTo == now);
+  CHECK(link.ordered);
+
+  const size_t speed = expectedPoints(history, HISTORY_SPEED_KMH, HISTORY_TIER_10S, since, now);
+  CHECK(speed >= 360);
+  CHECK(link.points[HISTORY_SPEED_KMH] == speed);
+  CHECK(link.points[HISTORY_SOC_PERC] == expectedPoints(history, HISTORY_SOC_PERC, HISTORY_TIER_10S, since, now));
+  CHECK(link.points[HISTORY_OUTDOOR_C] == 0); // never recorded
+  CHECK(link.points[HISTORY_BAT_POWER_KW] == 0); // not requested
+  CHECK(link.lastTime[HISTORY_SPEED_KMH] == history.newestTime(HISTORY_TIER_10S));
+
+  // Disconnect in the middle of the second session, reconnect and finish
+  link.connect();
+  CHECK(link.request(since, now, 1U << HISTORY_SPEED_KMH));
+  link.loop();
+  link.disconnect();
+  link.connect();
+  CHECK(link.request(since, now, 1U << HISTORY_SPEED_KMH));
+  for (uint16_t i = 0; i < 200 && !link.ended; i++)
+    link.loop();
+  CHECK(link.ended && link.points[HISTORY_SPEED_KMH] == speed);
+}
+
+static void testTierAndRejects(LiveDataHistory &history)
+{
+  const time_t now = kStart + 7230;
+  RelayHistoryJob job;
+  CHECK(!job.start(history, now - 60, now, 0)); // no channels
+  CHECK(job.start(history, now - 300, now, 1U << HISTORY_SOC_PERC));
+  CHECK(job.tier() == HISTORY_TIER_1S);
+  CHECK(job.start(history, now - 20 * 3600, now, 1U << HISTORY_SOC_PERC));
+  CHECK(job.tier() == HISTORY_TIER_1MIN);
+
+  // Cancelled job does not resume on its own
+  job.cancel();
+  RelayHistoryJob::Chunk chunk;
+  CHECK(!job.next(history, chunk));
+
+  LiveDataHistory empty; // begin() not called: no history
+  CHECK(!job.start(empty, now - 60, now, 1U << HISTORY_SOC_PERC));
+  CHECK(!job.active());
+}
+
+int main()
+{
+  LiveDataHistory history;
+  CHECK(history.begin());
+  recordDrive(history, kStart, kStart + 7200);
+  testDisconnectReconnect(history);
+  testTierAndRejects(history);
+  return TEST_RESULT("RelayHistoryJob");
+}
@@ -0,0 +1,201 @@
+/**
+ * SettingsStore on the host file backend: per-field dirty commits, schema
+ * changes across "firmware updates" (text resize, numeric size change, new
+ * and removed fields) and factory reset.
+ */
+#include "SettingsStore.h"
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *kStoreFile = "evdash_settings.bin"; // kHostFile in SettingsStore.cpp
+
+struct SettingsV1
+{
+  uint8_t brightness = 50;
+  char name[32] = "evDash";
+  uint8_t units = 0;
+  float cutOff = 11.0f;
+  uint8_t removed = 7;
+};
+
+static const SettingsField kFieldsV1[] = {
+    SETTINGS_FIELD(SettingsV1, 1, brightness, false),
+    SETTINGS_FIELD(SettingsV1, 2, name, true),
+    SETTINGS_FIELD(SettingsV1, 3, units, false),
+    SETTINGS_FIELD(SettingsV1, 4, cutOff, false),
+    SETTINGS_FIELD(SettingsV1, 5, removed, false),
+};
+
+// Next firmware: name shrunk, units widened, field 5 dropped, field 6 added
+struct SettingsV2
+{
+  uint8_t brightness = 50;
+  char name[8] = "evDash";
+  uint16_t units = 2;
+  float cutOff = 11.0f;
+  uint8_t added = 9;
+};
+
+static const SettingsField kFieldsV2[] = {
+    SETTINGS_FIELD(SettingsV2, 1, brightness, false),
+    SETTINGS_FIELD(SettingsV2, 2, name, true),
+    SETTINGS_FIELD(SettingsV2, 3, units, false),
+    SETTINGS_FIELD(SettingsV2, 4, cutOff, false),
+    SETTINGS_FIELD(SettingsV2, 6, added, false),
+};
+
+// Field 2 grows back to 32 bytes
+struct SettingsV3
+{
+  uint8_t brightness = 50;
+  char name[32] = "evDash";
+};
+
+static const SettingsField kFieldsV3[] = {
+    SETTINGS_FIELD(SettingsV3, 1, brightness, false),
+    SETTINGS_FIELD(SettingsV3, 2, name, true),
+};
+
+static long storeFileSize()
+{
+  FILE *file = fopen(kStoreFile, "rb");
+  if (file == nullptr)
+    return -1;
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fclose(file);
+  return size;
+}
+
+static void testFirstBootAndDirtyCommits()
+{
+  SettingsV1 settings;
+  SettingsStore store;
+  CHECK(store.begin(&settings, sizeof(settings), kFieldsV1, 5));
+  CHECK(!store.load()); // empty store: legacy import / defaults
+  CHECK(store.commit(true) == 5);
+  CHECK(storeFileSize() > 0);
+
+  // Nothing changed: nothing written
+  CHECK(store.commit() == 0);
+
+  // One field changed: only that one is written, after the settings stayed unchanged
+  settings.brightness = 80;
+  store.requestCommit(1000);
+  CHECK(store.isDirty());
+  store.loop(1000 + SettingsStore::kCommitDelayMs - 1);
+  CHECK(store.fieldWrites() == 5);
+  store.loop(1000 + SettingsStore::kCommitDelayMs);
+  CHECK(!store.isDirty());
+  CHECK(store.fieldWrites() == 6);
+
+  // Further edits restart the delay
+  settings.units = 1;
+  store.requestCommit(5000);
+  strcpy(settings.name, "Ioniq 5 long range");
+  store.requestCommit(6500);
+  store.loop(5000 + SettingsStore::kCommitDelayMs);
+  CHECK(store.isDirty());
+  store.loop(6500 + SettingsStore::kCommitDelayMs);
+  CHECK(store.fieldWrites() == 8);
+
+  // Changed and changed back before the commit: no write
+  settings.cutOff = 10.5f;
+  settings.cutOff = 11.0f;
+  store.requestCommit(9000);
+  store.loop(9000 + SettingsStore::kCommitDelayMs);
+  CHECK(store.fieldWrites() == 8);
+
+  // Reboot with the same firmware
+  SettingsV1 reboot;
+  SettingsStore reloaded;
+  CHECK(reloaded.begin(&reboot, sizeof(reboot), kFieldsV1, 5));
+  CHECK(reloaded.load());
+  CHECK(reloaded.loadedFields() == 5);
+  CHECK(reboot.brightness == 80 && reboot.units == 1 && reboot.cutOff == 11.0f);
+  CHECK(strcmp(reboot.name, "Ioniq 5 long range") == 0);
+}
+
+static void testSchemaChanges()
+{
+  SettingsV2 settings;
+  SettingsStore store;
+  CHECK(store.begin(&settings, sizeof(settings), kFieldsV2, 5));
+  CHECK(store.load());
+  CHECK(store.loadedFields() == 3); // brightness, name, cutOff
+  CHECK(settings.brightness == 80);
+  CHECK(strcmp(settings.name, "Ioniq 5") == 0); // truncated, NUL terminated
+  CHECK(settings.units == 2);                   // size changed: keeps default
+  CHECK(settings.cutOff == 11.0f);
+  CHECK(settings.added == 9);                   // new field: keeps default
+  CHECK(store.commit() == 0);                   // load leaves nothing dirty
+
+  // Only the fields written in the new layout: 2 byte units, new field
+  settings.units = 1;
+  settings.added = 3;
+  store.requestCommit(0);
+  store.loop(SettingsStore::kCommitDelayMs);
+  CHECK(store.fieldWrites() == 2);
+
+  SettingsV2 reboot;
+  SettingsStore reloaded;
+  CHECK(reloaded.begin(&reboot, sizeof(reboot), kFieldsV2, 5));
+  CHECK(reloaded.load());
+  CHECK(reloaded.loadedFields() == 5);
+  CHECK(reboot.units == 1 && reboot.added == 3);
+
+  // Truncation happens on load only, the longer record stays until the field is written
+  settings.brightness = 81;
+  strcpy(settings.name, "Kona");
+  CHECK(store.commit() == 2);
+
+  // Text field grows again: stored text comes back, the rest stays empty
+  SettingsV3 grown;
+  memset(grown.name, 'X', sizeof(grown.name));
+  SettingsStore grownStore;
+  CHECK(grownStore.begin(&grown, sizeof(grown), kFieldsV3, 2));
+  CHECK(grownStore.load());
+  CHECK(grown.brightness == 81);
+  CHECK(strcmp(grown.name, "Kona") == 0);
+  CHECK(grown.name[5] == '\0');
+
+  // Text stored without the unused tail: a long name grows the record
+  const long before = storeFileSize();
+  strcpy(grown.name, "Ioniq 5 long range AWD");
+  CHECK(grownStore.commit() == 1);
+  CHECK(storeFileSize() - before == long(strlen("Ioniq 5 long range AWD") - strlen("Kona")));
+}
+
+static void testErase()
+{
+  SettingsV1 settings;
+  SettingsStore store;
+  CHECK(store.begin(&settings, sizeof(settings), kFieldsV1, 5));
+  CHECK(store.load());
+  settings.brightness = 20;
+  store.requestCommit(0);
+  CHECK(store.erase());
+  CHECK(!store.isDirty());
+
+  // Nothing may be written after a factory reset, not even a pending commit
+  store.loop(SettingsStore::kCommitDelayMs);
+  CHECK(store.commit(true) == 0);
+
+  SettingsV1 reboot;
+  SettingsStore reloaded;
+  CHECK(reloaded.begin(&reboot, sizeof(reboot), kFieldsV1, 5));
+  CHECK(!reloaded.load());
+  CHECK(reloaded.loadedFields() == 0);
+  CHECK(reboot.brightness == 50 && strcmp(reboot.name, "evDash") == 0);
+}
+
+int main()
+{
+  remove(kStoreFile);
+  testFirstBootAndDirtyCommits();
+  testSchemaChanges();
+  testErase();
+  remove(kStoreFile);
+  return TEST_RESULT("SettingsStore");
+}